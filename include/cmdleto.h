@@ -92,7 +92,7 @@
 /* with ulAreaID        */
 /* a - z    { | } ~     */
 /* 0x61-0x7e   97 -126  */
-/* FREE:  v | } ~       */
+/* FREE:  ~             */
 
 #define LETOCMD_add        'a'
 #define LETOCMD_dbi        'b'
@@ -121,6 +121,8 @@
 #define LETOCMD_rcou       'y'
 #define LETOCMD_zap        'z'
 #define LETOCMD_trans      '{'
+#define LETOCMD_golist     '|'
+#define LETOCMD_seeklist   '}'
 
 
 /* - sub command values -  */
@@ -90,6 +90,12 @@
 #define LETO_VERSION_STRING     "3.00"
 #define LETO_RELEASE_STRING     "LetoDBf Server"
 #define LETO_DEFAULT_PORT       2812
+#if defined( HB_OS_UNIX ) && ! defined( LETO_NO_LOCALSOCKET )
+   /* Unix domain socket for clients at same machine, in a directory only the server user can write,
+    * %u = effective uid of server, %d = server port */
+   #define LETO_LOCAL_SOCKETDIR "/tmp/.letodbf-%u"
+   #define LETO_LOCAL_SOCKET    LETO_LOCAL_SOCKETDIR "/%d"
+#endif
 
 #define LETO_MAX_USERNAME       16
 #define LETO_MAX_KEYLENGTH      32
@@ -101,6 +107,13 @@
 
 /* 0xFFFFFFF  268 435 455 */
 #define LETO_MAX_RECV_BLOCK     0x7FFFFFFF  /* 2 147 483 647  ( 2GB - 1 ) */
+/* FileRead stream: default and max. data size of one message */
+#define LETO_FILESTREAM_STEP    0x100000
+#define LETO_FILESTREAM_MAXSTEP 0x4000000
+/* max. amount of RecNo in one LETOCMD_golist request */
+#define LETO_GOTOLIST_MAX       1000
+/* max. amount of keys in one LETOCMD_seeklist request */
+#define LETO_SEEKLIST_MAX       1000
 /* In the absolute worst case of a single-byte input stream,
  * the overhead  is eleven bytes of overhead, includes one byte of actual data
  * plus LetoDBf 8 bytes for two 32 bit lengths  */
@@ -170,6 +183,7 @@
 #define LETO_FLG_LOCKED        0x04
 #define LETO_FLG_DEL           0x08
 #define LETO_FLG_FOUND         0x10
+#define LETO_FLG_PARTIAL       0x20   /* only fields of projection set by DBI_LETOFIELDS */
 
 /* client flags for update state of tables */
 #define LETO_FLAG_UPD_NONE     0x00
@@ -203,6 +217,35 @@ extern void leto_hexchar2byte( const char * ptri, int iLen, char * ptro );
 extern HB_UINT ultostr( HB_U64 ulValue, char * ptr );
 extern int eprintf( char * d, const char * fmt, ... );
 
+/* precompiled encoding of record fields for iZipRecord < 0, see leto_rec() of server */
+#define LETO_RECOP_COPY        1      /* raw copy, run of following fixed width fields */
+#define LETO_RECOP_STR         2      /* right trimmed string, length byte */
+#define LETO_RECOP_STRLONG     3      /* right trimmed string > 255, length of length + length */
+#define LETO_RECOP_STRBIN      4      /* binary string, full length with prefix as STR[LONG] */
+#define LETO_RECOP_NUM         5      /* left trimmed number, '\0' for zero */
+#define LETO_RECOP_DATE        6      /* 8 byte date, '\0' for empty */
+#define LETO_RECOP_MEMO        7      /* 10 byte memo pointer, '\0' empty or '1' */
+
+typedef struct _LETORECOP
+{
+   HB_USHORT         uiOp;                     /* LETO_RECOP_* */
+   HB_USHORT         uiOffset;                 /* in record buffer, including delete flag */
+   HB_USHORT         uiLen;                    /* field length, for COPY of all fields in run */
+} LETORECOP;
+
+typedef struct _LETORECPLAN
+{
+   HB_USHORT         uiOps;                    /* used ops */
+   HB_USHORT         uiOffset;                 /* offset of next field added */
+   LETORECOP *       pOps;                     /* one per field at most */
+} LETORECPLAN, * PLETORECPLAN;
+
+extern PLETORECPLAN leto_RecPlanNew( HB_USHORT uiFields );
+extern HB_BOOL leto_RecPlanAdd( PLETORECPLAN pPlan, HB_USHORT uiType, HB_USHORT uiLen, HB_USHORT uiFlags );
+extern char * leto_RecPlanEncode( const LETORECPLAN * pPlan, const HB_BYTE * pRecord, char * pData );
+extern void leto_RecPlanFree( PLETORECPLAN pPlan );
+extern HB_SIZE leto_RTrimLen( const char * ptr, HB_SIZE nLen );
+
 #ifdef USE_LZ4
    #include "lz4.h"
 
@@ -210,10 +253,35 @@ extern int eprintf( char * d, const char * fmt, ... );
    typedef struct _HB_LZ4NET * PHB_LZ4NET;
 
    extern HB_BOOL hb_lz4netEncryptTest( const PHB_LZ4NET pStream, const HB_ULONG ulLen );
+   extern HB_BOOL hb_lz4netMsgBuffered( PHB_LZ4NET pStream, const HB_ULONG ulLen );
    extern HB_ULONG hb_lz4netEncrypt( PHB_LZ4NET pStream, char ** pData, HB_ULONG ulLen, HB_ULONG * pulDataLen, const char * szData );
    extern HB_ULONG hb_lz4netDecrypt( PHB_LZ4NET pStream, char ** pData, HB_ULONG ulLen, HB_ULONG * pulDataLen, HB_BOOL fCompressed );
    extern PHB_LZ4NET hb_lz4netOpen( int iLevel, int strategy );
    extern void hb_lz4netClose( PHB_LZ4NET pStream );
    extern void hb_lz4netEncryptKey( PHB_LZ4NET pStream, const char * keydata, int keylen );
+   extern void hb_lz4netBandwidth( PHB_LZ4NET pStream, HB_ULONG ulBytes, HB_U64 ullMicroSec );
+   extern int hb_lz4netStat( PHB_LZ4NET pStream, HB_U64 * pullIn, HB_U64 * pullOut, HB_ULONG * pulPacked,
+                             HB_ULONG * pulRaw, HB_ULONG * pulSkipped, HB_BOOL fReset );
+   extern int hb_lz4netDictAdd( PHB_LZ4NET pStream, int iID, const char * pDict, HB_ULONG ulLen );
+   extern int hb_lz4netDictFind( PHB_LZ4NET pStream, const char * pDict, HB_ULONG ulLen );
+   extern void hb_lz4netDictUse( PHB_LZ4NET pStream, int iID );
+   extern HB_BOOL hb_lz4netStreamMode( PHB_LZ4NET pStream, HB_BOOL fStream );
+   extern HB_BOOL hb_lz4netStreamFailed( PHB_LZ4NET pStream );
+   extern void hb_lz4netCipher( PHB_LZ4NET pStream, int iCipher, const char * pSalt, HB_BOOL fServer );
+   extern HB_BOOL hb_lz4netRandom( char * pBuf, int iLen );
+
+   #define LETO_CIPHER_BLOWFISH  0      /* traffic encryption: Blowfish CBC */
+   #define LETO_CIPHER_CHACHA20  1      /* traffic encryption: ChaCha20-Poly1305, much faster */
+   #define LETO_CRYPT_SALTLEN    16     /* random bytes from each side for the ChaCha20 key derivation */
+   #ifndef LETO_CRYPT_CHACHA
+      #define LETO_CRYPT_CHACHA  1      /* client offers ChaCha20, 0 = stay with Blowfish */
+   #endif
+
+   #ifndef LETO_LZ4DICT_SIZE
+      #define LETO_LZ4DICT_SIZE  8192   /* max. size of a per table LZ4 dictionary */
+   #endif
+   #ifndef LETO_LZ4DICT_GROWTH
+      #define LETO_LZ4DICT_GROWTH  2    /* re-sample dictionary when table has grown by this factor */
+   #endif
 #endif
 
@@ -86,6 +86,7 @@
 #define leto_firstchar( pConnection )  pConnection->szBuffer + 1
 #define LETO_DEFAULT_TIMEOUT           120000  /* two minutes */
 #define LETO_INITIAL_TIMEOUT             6000
+#define LETO_PIPELINE_MAX                  16  /* max requests in flight, see LetoAsyncSend() */
 
 #ifndef LETO_DOPCODE_LEN
    #define LETO_DOPCODE_LEN         7
@@ -107,7 +108,49 @@ typedef struct _LETOBUFFER_
    unsigned long     ulBufLen;        /* allocated buffer length */
    unsigned long     ulBufDataLen;    /* data length in buffer */
    unsigned long     ulShoots;        /* using statistic */
-} LETOBUFFER;                         /* 32 */
+   unsigned long     ulFetches;       /* buffers fetched from server, with ulShoots gives hit ratio */
+} LETOBUFFER;                         /* 40 */
+
+typedef struct _LETORECENTRY_
+{
+   unsigned long     ulRecNo;         /* 0 == free slot */
+   HB_U64            llTime;          /* timepoint received from server */
+   unsigned char *   pData;           /* record as received: HB_UINT24 len + data */
+   unsigned int      uiPrev;          /* LRU chain, index + 1, 0 == end */
+   unsigned int      uiNext;
+   unsigned int      uiHashNext;      /* hash collision chain, index + 1, for free slots next free */
+} LETORECENTRY;
+
+typedef struct _LETORECCACHE_
+{
+   LETORECENTRY *    pEntries;
+   unsigned int *    puiHash;         /* buckets with index + 1 into pEntries */
+   unsigned int      uiSize;          /* max. entries, also number of buckets, power of 2 */
+   unsigned int      uiUsed;
+   unsigned int      uiFree;          /* chain of free slots */
+   unsigned int      uiHead;          /* LRU: most recent used */
+   unsigned int      uiTail;          /* LRU: first to evict */
+   unsigned long     ulBytes;         /* memory of record data */
+   unsigned long     ulMaxBytes;
+} LETORECCACHE;
+
+#define LETO_NOTIFY_EVENTS  64
+
+typedef struct _LETONOTIFYEVENT_
+{
+   unsigned long     hTable;
+   unsigned long     ulFrom;
+   unsigned long     ulTo;
+   char              cType;           /* 'U' records ulFrom - ulTo changed, 'A' append, 'Z' zap, 'P' pack, 'X' any */
+} LETONOTIFYEVENT;
+
+typedef struct _LETONOTIFY_
+{
+   LETONOTIFYEVENT   aEvents[ LETO_NOTIFY_EVENTS ];  /* ring filled by leto_elch() thread */
+   unsigned long     ulSeq;           /* count of all received change notes */
+   int               iRefs;           /* connection and leto_elch() thread, last one frees */
+   HB_BOOL           fAlive;          /* leto_elch() thread is running */
+} LETONOTIFY;
 
 typedef struct _LETOFIELD
 {
@@ -210,6 +253,25 @@ typedef struct _LETOTABLE
    HB_USHORT         uiLockScheme;      /* elch new */
    HB_U64            llCentiSec;        /* timepoint last access record[-buffer] data in 1/ 1000 s */
    PHB_ITEM          pFilterVar;        /* PHB_ITEM array with LETO_VAR in filter expression to sync */
+   unsigned char *   pFieldSel;         /* field projection set by DBI_LETOFIELDS, NULL = all fields */
+   HB_BOOL           fRecPartial;       /* record buffer contains only the fields of pFieldSel */
+   HB_BOOL           fPrefetch;         /* read-ahead of next skip buffer, set by DBI_BUFPREFETCH */
+   unsigned long     ulPrefetchID;      /* pipelined request ID of pending read-ahead, 0 = none */
+   unsigned long     ulPrefetchRec;     /* record number the read-ahead skips from */
+   HB_U64            llPrefetchTime;    /* timepoint read-ahead was send */
+   LETORECCACHE *    pRecCache;         /* records by RecNo for LetoDbGoTo(), set by DBI_RECCACHE */
+   HB_BOOL           fNotify;           /* buffers valid until change note of server, set by DBI_NOTIFY */
+   unsigned long     ulNotifySeq;       /* last applied change note of LETONOTIFY */
+   HB_BOOL           fRecStale;         /* active record changed by other */
+   unsigned long     ulMemoInline;      /* memo content up to this length is send with record, set by DBI_MEMOINLINE */
+   unsigned char *   pMemoInline;       /* memos of active record: HB_UINT16 field, HB_UINT24 len, data + '\0' */
+   unsigned long     ulMemoInlineLen;
+   unsigned long     ulMemoInlineAlloc;
+   HB_BOOL           fLazyDecode;       /* fields decoded at first access, set by DBI_LAZYDECODE */
+   unsigned char *   pLazyRec;          /* field data of active record as received */
+   unsigned long     ulLazyAlloc;
+   unsigned long *   pulLazyPos;        /* per field offset + 1 in pLazyRec, 0 = decoded */
+   HB_USHORT         uiLazyPending;     /* count of not decoded fields */
 } LETOTABLE;                            /* 344 */
 
 typedef struct
@@ -224,6 +286,9 @@ typedef struct
    HB_ULONG          ulRecNo;
 } TRANSACTWA;
 
+/* receiver of data blocks for LetoFileReadStream(), return HB_FALSE to signal failure */
+typedef HB_BOOL ( * LETO_FILESTREAM_FUNC )( void * cargo, const char * pData, unsigned long ulLen );
+
 typedef struct _LETOCONNECTION_
 {
    unsigned int      iConnection;          /* ID of connection */
@@ -273,6 +338,7 @@ typedef struct _LETOCONNECTION_
    HB_ULONG          ulBufCryptLen;
    int               iZipRecord;
    HB_BOOL           fZipCrypt;
+   HB_BOOL           fZipStream;           /* request LZ4 streaming mode with next LetoToggleZip() */
    HB_BOOL           fDbEvalCompat;        /* enable scope to REST if WHILE/NEXT given */
    int               iBufRefreshTime;      /* in 0.001 sec, afterwards SKIP buffer refresh */
    HB_USHORT         uiDriver;             /* default driver 0 = NTX, 1 = CDX */
@@ -295,7 +361,10 @@ typedef struct _LETOCONNECTION_
    HB_BOOL           fMustResync;          /* future idea, e.g. after missing answer for a request */
    HB_BOOL           fCryptTraf;           /* if true, server demands! for network traffic encryotion */
    PHB_ITEM          whoCares;             /* temporary tasks, e.g. collect WA relations for Leto_ReConnect() */
-} LETOCONNECTION;                          /* 408 */
+   HB_ULONG          ulPipeSent;           /* ID of last pipelined request send with LetoAsyncSend() */
+   HB_ULONG          ulPipeRecv;           /* ID of last pipelined request with collected answer */
+   LETONOTIFY *      pNotify;              /* change notes for tables, NULL without second socket */
+} LETOCONNECTION;                          /* 424 */
 
 
 extern HB_EXPORT void LetoInit( void );
@@ -310,6 +379,16 @@ extern HB_EXPORT int LetoCloseAll( LETOCONNECTION * pConnection );
 extern HB_EXPORT const char * LetoGetServerVer( LETOCONNECTION * pConnection );
 extern HB_EXPORT HB_BOOL LetoPing( LETOCONNECTION * pConnection );
 extern HB_EXPORT int LetoToggleZip( LETOCONNECTION * pConnection, int iZipRecord, const char * szPassword );
+extern HB_EXPORT HB_ERRCODE LetoDbSetFields( LETOTABLE * pTable, const char * szFields );
+extern HB_EXPORT HB_ERRCODE LetoDbRecFull( LETOTABLE * pTable );
+extern HB_EXPORT HB_ERRCODE LetoDbRecCache( LETOTABLE * pTable, unsigned int uiRecords, unsigned long ulMaxBytes );
+extern HB_EXPORT HB_ERRCODE LetoDbNotify( LETOTABLE * pTable, HB_BOOL fNotify );
+extern HB_EXPORT HB_ERRCODE LetoDbMemoInline( LETOTABLE * pTable, unsigned long ulMaxLen );
+extern HB_EXPORT const char * LetoDbFilterExplain( LETOTABLE * pTable, unsigned long * pulLen );
+extern HB_EXPORT HB_ERRCODE LetoDbLazyDecode( LETOTABLE * pTable, HB_BOOL fLazy );
+extern HB_EXPORT HB_ERRCODE LetoDbGoToList( LETOTABLE * pTable, const unsigned long * pulRecNo, unsigned long ulCount );
+extern HB_EXPORT HB_ERRCODE LetoDbSeekList( LETOTABLE * pTable, const char ** pszKeys, const HB_USHORT * puiKeyLen, unsigned long ulCount,
+                                            HB_BOOL fSoftSeek, HB_BOOL fRecords, unsigned long * pulRecNo, HB_BOOL * pfFound );
 extern HB_EXPORT HB_BOOL LetoUdf( LETOCONNECTION * pConnection, LETOTABLE * pTable, HB_BOOL fInThread, const char * szFuncName, PHB_ITEM * pItem );
 
 extern HB_EXPORT void LetoDbFreeTag( LETOTAGINFO * pTagInfo );
@@ -369,6 +448,10 @@ extern HB_EXPORT unsigned int LetoDbFieldDec( LETOTABLE * pTable, HB_USHORT uiIn
 extern HB_EXPORT void LetoFreeStr( char * szStr );
 extern HB_EXPORT void LetoSetAddress( int argc, char * argv[], char * szAddr, int * iPort );
 extern HB_EXPORT unsigned int LetoVarGetC( LETOCONNECTION * pConnection, const char * szGroup, const char * szVar, char * szValue, unsigned long * pulLen );
+extern HB_EXPORT unsigned long LetoAsyncSend( LETOCONNECTION * pConnection, const char * szData, unsigned long ulLen );
+extern HB_EXPORT long LetoAsyncRecv( LETOCONNECTION * pConnection, unsigned long * pulID );
+extern HB_EXPORT unsigned int LetoAsyncPending( LETOCONNECTION * pConnection );
+extern HB_EXPORT unsigned long LetoDbGetMemoAsync( LETOTABLE * pTable, unsigned int uiIndex );
 
 long leto_DataSendRecv( LETOCONNECTION * pConnection, const char * sData, unsigned long ulLen );
 unsigned long leto_SendRecv2( LETOCONNECTION * pConnection, const char * szData, unsigned long ulLen, int iErr );
@@ -414,6 +497,7 @@ extern HB_EXPORT const char * LetoFileMD5( LETOCONNECTION * pConnection, const c
 extern HB_EXPORT const char * LetoMemoRead( LETOCONNECTION * pConnection, const char * szFile, unsigned long * ulMemoLen );
 extern HB_EXPORT HB_BOOL LetoMemoWrite( LETOCONNECTION * pConnection, const char * szFile, const char * szValue, unsigned long ulLen );
 extern HB_EXPORT const char * LetoFileRead( LETOCONNECTION * pConnection, const char * szFile, unsigned long ulStart, unsigned long * ulLen );
+extern HB_EXPORT int LetoFileReadStream( LETOCONNECTION * pConnection, const char * szFile, unsigned long ulStart, unsigned long ulLen, unsigned long ulStep, LETO_FILESTREAM_FUNC pFunc, void * cargo );
 extern HB_EXPORT HB_BOOL LetoFileWrite( LETOCONNECTION * pConnection, const char * szFile, const char * szValue, unsigned long ulStart, unsigned long ulLen );
 extern HB_EXPORT long LetoFileSize( LETOCONNECTION * pConnection, const char * szFile );
 extern HB_EXPORT HB_BOOL LetoFileTime( LETOCONNECTION * pConnection, const char * szFile, long * lJulian, long * lMillis );
@@ -425,6 +509,11 @@ extern HB_EXPORT HB_BYTE LetoDirRemove( LETOCONNECTION * pConnection, const char
 
 void leto_ParseRecord( LETOCONNECTION * pConnection, LETOTABLE * pTable, const char * szData );
 void leto_SetUpdated( LETOTABLE * pTable, HB_USHORT uiUpdated );
+void leto_RecCacheClear( LETOTABLE * pTable );
+HB_BOOL leto_RecStale( LETOTABLE * pTable );
+void leto_RecDecode( LETOTABLE * pTable, HB_USHORT uiIndex );
+void leto_RecDecodeAll( LETOTABLE * pTable );
+const char * leto_MemoInline( LETOTABLE * pTable, unsigned int uiIndex, unsigned long * pulLen );
 const char * leto_ParseTagInfo( LETOTABLE * pTable, const char * pBuffer );
 void leto_AddKeyToBuf( char * szData, const char * szKey, unsigned int uiKeyLen, unsigned long * pulLen );
 
@@ -86,6 +86,7 @@
    #endif
    #include <unistd.h>
    #include <sys/socket.h>   /* only with above __USE_GNU: MSG_MORE flag */
+   #include <sys/uio.h>      /* struct iovec for sendmsg() */
    #if defined( HB_OS_BSD ) || ( defined( _POSIX_C_SOURCE ) && _POSIX_C_SOURCE >= 200112L )
       #define HB_HAS_POLL
       #include <poll.h>
@@ -98,6 +99,21 @@
    #if defined( HB_OS_LINUX ) && defined( USE_SPLICE )
       #include <splice.h>
    #endif
+   /* event driven connection engine, epoll() reactor + worker pool -- not for ZLIB traffic */
+   #if defined( HB_OS_LINUX ) && defined( USE_LZ4 ) && ! defined( LETO_NO_EPOLL )
+      #define LETO_HAS_EPOLL
+      #include <sys/epoll.h>
+   #endif
+   /* zero-copy file download for uncompressed traffic */
+   #if defined( HB_OS_LINUX ) && defined( USE_LZ4 ) && ! defined( LETO_NO_SENDFILE )
+      #define LETO_HAS_SENDFILE
+      #include <sys/sendfile.h>
+   #endif
+   /* io_uring network backend, build with -env:__URING=yes [ needs liburing ] */
+   #if defined( HB_OS_LINUX ) && defined( USE_LZ4 ) && defined( USE_URING )
+      #define LETO_HAS_URING
+      #include <liburing.h>
+   #endif
 #endif
 
 typedef struct _LETO_LIST_ITEM
@@ -160,6 +176,8 @@ typedef struct _LETOTAG
    struct _LETOTAG * pNext;
 } LETOTAG;
 
+#define LETO_TOUCHLOG   32                     /* last changed records of a table, for patching index plans */
+
 typedef struct
 {
    char *            szCdp;                    /* CP or NULL for default */
@@ -174,7 +192,10 @@ typedef struct
    HB_BOOL           bLocked;                  /* table filelock [ not reclock ] */
    unsigned char     uMemoType;                /* MEMO type DBT 1/ FPT 2/ SMT 3 */
    HB_ULONG          ulAreas;                  /* Number of references */
-} GLOBESTRU, * PGLOBESTRU;                     /* 48 */
+   HB_ULONG          ulVersion;                /* change counter for the filter result cache */
+   HB_ULONG          ulTouchStamp[ LETO_TOUCHLOG ];  /* version + epoch after a change ... */
+   HB_ULONG          ulTouchRec[ LETO_TOUCHLOG ];    /* ... of this record, 0 = unknown */
+} GLOBESTRU, * PGLOBESTRU;                     /* 56 */
 
 typedef struct
 {
@@ -196,6 +217,10 @@ typedef struct
    HB_ULONG          ulFlags;                  /* Lock flags, some prehistoric relict ;-) */
    PGLOBESTRU        pGlobe;                   /* 1 to 1 relation into GLOBESTRU, for s_bNoSaveWA: n to 1 */
    HB_BOOL           bModStamp;                /* table with HB_FT_MODTIME/ HB_FT_ROWVER fields */
+   HB_BYTE *         pLZ4Dict;                 /* LZ4 dictionary sampled from records, build on demand */
+   HB_ULONG          ulLZ4Dict;                /* length of pLZ4Dict */
+   HB_ULONG          ulLZ4DictRecs;            /* record count when pLZ4Dict was sampled */
+   PLETORECPLAN      pRecPlan;                 /* encoding of fields for leto_rec(), NULL if not possible */
 } TABLESTRU, * PTABLESTRU;                     /* 216 */
 
 typedef struct
@@ -210,11 +235,26 @@ typedef struct
    LETOTAG *         pTagCurrent;              /* Last used index tag */
    PHB_ITEM          itmFltExpr;               /* CB with filter condition */
    HB_BOOL           itmFltOptimized;          /* optimized filter if not contain [user]function */
+   void *            pFltPrg;                  /* filter compiled by leto_FltCompile(), NULL = use itmFltExpr */
+   PHB_ITEM          itmFltNative;             /* CB {|| LETO_FLTNATIVE( nAreaID ) } evaluating pFltPrg */
+   void *            pRBM;                     /* record number bitmap of LBM_*() filter, NULL = none */
+   PHB_ITEM          itmFltBM;                 /* CB {|| LETO_BMFILTER( nAreaID ) } checking pRBM */
+   void *            pPlan;                    /* index plan of filter, its candidates are pRBM, NULL = none */
+   HB_ULONG          ulPlanStamp;              /* table version pRBM of pPlan was walked at */
    char              szAlias[ HB_RDD_MAX_ALIAS_LEN + 1 ];        /* !client! alias -- 63 + 1 */
    HB_U32            uiCrc;                    /* hash value for szAlias name speed search */
    HB_BOOL           bNotDetached;             /* Detached */
    HB_ULONG          ulUdf;                    /* pUStru->iUserStru ID if table was new opened/ created in UDP mode */
    HB_BOOL           bUseSkipBuffer;           /* for temporary disable uiSkipBuf */
+   HB_USHORT         uiSkipCur;                /* adaptive size of next skip buffer, 0 = start with uiSkipBuf */
+   char              cSkipDir;                 /* direction of last skip buffer */
+   HB_ULONG          ulSkipLast;               /* last record sent in skip buffer */
+   int               iLZ4Dict;                 /* ID of LZ4 dictionary registered for connection, 0 = none */
+   HB_BYTE *         pFieldSel;                /* field projection: send only fields flagged here, NULL = all */
+   HB_BOOL           bFullRec;                 /* temporary ignore pFieldSel */
+   HB_BOOL           bNotify;                  /* subscribed for change notes of other, set by DBI_NOTIFY */
+   HB_ULONG          ulMemoInline;             /* memo up to this length send with record, set by DBI_MEMOINLINE */
+   HB_USHORT         uiMemoFields;             /* number of memo fields, for leto_recLen() */
 #ifdef __BM
    void *            pBM;
 #endif
@@ -285,6 +325,17 @@ typedef struct
    HB_BOOL           bHaveUrgentTask;         /* flag is set by client when backup-mode was refused, cleared by server */
    HB_MAXINT *       pOpenHandles;            /* list of files opened by Leto_Fopen()/ Leto_FCreate() */
    HB_ULONG          ulOpenHandles;           /* number of open file handles */
+   int               iEvState;                /* event mode: LETO_EV_* state of connection, 0 = thread2() */
+   HB_ULONG          ulEvRecv;                /* event mode: received bytes of request including size head */
+   HB_ULONG          ulEvSize;                /* event mode: size head of request, high bit = compressed */
+   void *            pHbSet;                  /* event mode: parked SET values while connection is not served */
+   char              szRddDef[ HB_RDD_MAX_DRIVERNAME_LEN + 1 ];   /* event mode: parked default RDD */
+   HB_BYTE *         pErrSockBuf;             /* frames queued for second socket, send by leto_errSockThread() */
+   HB_ULONG          ulErrSockLen;
+   HB_ULONG          ulErrSockAlloc;
+   HB_U64            llErrSockStall;          /* time since second socket takes nothing, 0 = fine */
+   HB_BOOL           bErrSockBusy;            /* leto_errSockThread() is sending */
+   HB_BOOL           bErrSockDrop;            /* second socket given up, accepts no more frames */
 } USERSTRU, * PUSERSTRU;                      /* 544 */
 
 typedef struct
@@ -221,6 +221,7 @@ static HB_ERRCODE leto_ClearBuffer( AREAP pArea, void * p )
    if( leto_CheckAreaConn( pArea, ( LETOCONNECTION * ) p ) )
    {
       ( ( LETOAREAP ) pArea )->pTable->ptrBuf = NULL;
+      leto_RecCacheClear( ( ( LETOAREAP ) pArea )->pTable );
       SELF_SKIP( pArea, 0 );
    }
 
@@ -954,20 +955,28 @@ static HB_ERRCODE letoGetRec( LETOAREAP pArea, HB_BYTE ** pBuffer )
          return HB_FAILURE;
    }
 
+   if( pArea->pTable->fRecPartial && LetoDbRecFull( pArea->pTable ) != HB_SUCCESS )
+      return HB_FAILURE;
+   leto_RecDecodeAll( pArea->pTable );
+
    if( pBuffer != NULL )
       *pBuffer = pArea->pTable->pRecord;
    return HB_SUCCESS;
 }
 
-static HB_ERRCODE leto_GetMemoValue( LETOAREAP pArea, HB_USHORT uiIndex, PHB_ITEM pItem, HB_USHORT uiType )
+/* field not in projection ( DBI_LETOFIELDS ) of active record: fetch whole record,
+   field not yet decoded ( DBI_LAZYDECODE ): decode it, uiIndex zero based */
+static HB_ERRCODE leto_FieldFetch( LETOTABLE * pTable, HB_USHORT uiIndex )
 {
-   LETOTABLE *  pTable = pArea->pTable;
-   HB_ULONG     ulLen;
-   const char * ptr = LetoDbGetMemo( pTable, uiIndex + 1, ( unsigned long * ) &ulLen );
+   if( pTable->fRecPartial && ! pTable->pFieldSel[ uiIndex ] )
+      return LetoDbRecFull( pTable );
+   leto_RecDecode( pTable, uiIndex );
+   return HB_SUCCESS;
+}
 
-   if( ! ptr )
-      return HB_FAILURE;
-   else if( ! ulLen )
+static void leto_MemoToItem( LETOAREAP pArea, const char * ptr, HB_ULONG ulLen, PHB_ITEM pItem, HB_USHORT uiType )
+{
+   if( ! ulLen )
       hb_itemPutC( pItem, "" );
    else
    {
@@ -1000,18 +1009,41 @@ static HB_ERRCODE leto_GetMemoValue( LETOAREAP pArea, HB_USHORT uiIndex, PHB_ITE
          hb_itemPutCL( pItem, ptr, ulLen );
 #endif
    }
+}
+
+static HB_ERRCODE leto_GetMemoValue( LETOAREAP pArea, HB_USHORT uiIndex, PHB_ITEM pItem, HB_USHORT uiType )
+{
+   HB_ULONG     ulLen;
+   const char * ptr = LetoDbGetMemo( pArea->pTable, uiIndex + 1, ( unsigned long * ) &ulLen );
+
+   if( ! ptr )
+      return HB_FAILURE;
+   leto_MemoToItem( pArea, ptr, ulLen, pItem, uiType );
    return HB_SUCCESS;
 }
 
-static HB_ERRCODE letoGetValue( LETOAREAP pArea, HB_USHORT uiIndex, PHB_ITEM pItem )
+/* memo content not in record buffer, must be requested from server */
+static HB_BOOL leto_MemoIsEmpty( LETOAREAP pArea, HB_USHORT uiIndex )
 {
    LETOTABLE * pTable = pArea->pTable;
-   LPFIELD     pField;
+   LPFIELD     pField = pArea->area.lpFields + uiIndex;
+   HB_BOOL     fEmpty;
 
-   HB_TRACE( HB_TR_DEBUG, ( "letoGetValue(%p, %hu, %p)", pArea, uiIndex, pItem ) );
+   leto_FieldFetch( pTable, uiIndex );
+   if( pField->uiLen == 4 )
+      fEmpty = HB_GET_LE_UINT32( &pTable->pRecord[ pTable->pFieldOffset[ uiIndex ] ] ) == 0;
+   else  /* empty if the rightmost char is a whitespace */
+      fEmpty = ( pTable->pRecord[ pTable->pFieldOffset[ uiIndex ] + pField->uiLen - 1 ] == ' ' );
+
+   /* uiUpdated is set with append */
+   return ( pTable->uiUpdated & LETO_FLAG_UPD_APPEND ) || pArea->area.fEof || fEmpty;
+}
+
+/* relations and automatic refresh before field access */
+static HB_ERRCODE leto_GetValuePrepare( LETOAREAP pArea )
+{
+   LETOTABLE * pTable = pArea->pTable;
 
-   if( ! uiIndex || uiIndex > pArea->area.uiFieldCount )
-      return HB_FAILURE;
    if( pArea->lpdbPendingRel )
    {
       if( SELF_FORCEREL( ( AREAP ) pArea ) != HB_SUCCESS )
@@ -1021,10 +1053,121 @@ static HB_ERRCODE letoGetValue( LETOAREAP pArea, HB_USHORT uiIndex, PHB_ITEM pIt
    /* automatic refresh data if record is accessible to other; 0 == infinite cache */
    if( pTable->fAutoRefresh && pTable->fShared && ! pTable->fFLocked && ! pTable->fRecLocked && ! pTable->fReadonly )
    {
-      if( pTable->iBufRefreshTime && ( int ) leto_MilliDiff( pTable->llCentiSec ) >= pTable->iBufRefreshTime )
+      if( leto_RecStale( pTable ) )
          LetoDbSkip( pTable, 0 );
    }
 
+   return HB_SUCCESS;
+}
+
+/* values of all memo fields into array pArray, the requests for them pipelined with one roundtrip */
+static HB_ERRCODE leto_GetMemoValues( LETOAREAP pArea, PHB_ITEM pArray )
+{
+   LETOTABLE *      pTable = pArea->pTable;
+   LETOCONNECTION * pConnection = letoGetConnPool( pTable->uiConnection );
+   HB_USHORT        uiMemos = 0, uiField, uiSent = 0, uiRecv = 0;
+   HB_USHORT *      puiPos;
+   HB_BOOL          fSendErr = HB_FALSE;
+   HB_ERRCODE       errCode = HB_SUCCESS;
+
+   if( leto_GetValuePrepare( pArea ) != HB_SUCCESS )
+      return HB_FAILURE;
+
+   puiPos = ( HB_USHORT * ) hb_xgrab( sizeof( HB_USHORT ) * ( pArea->area.uiFieldCount + 1 ) );
+   for( uiField = 0; uiField < pArea->area.uiFieldCount; uiField++ )
+   {
+      HB_USHORT uiType = pArea->area.lpFields[ uiField ].uiType;
+
+      if( uiType == HB_FT_MEMO || uiType == HB_FT_PICTURE || uiType == HB_FT_BLOB || uiType == HB_FT_OLE )
+         puiPos[ uiMemos++ ] = uiField;
+   }
+   hb_arrayNew( pArray, uiMemos );
+
+   /* transaction buffer is searched by LetoDbGetMemo() */
+   if( pConnection->fTransActive )
+   {
+      for( uiField = 0; uiField < uiMemos && errCode == HB_SUCCESS; uiField++ )
+         errCode = SELF_GETVALUE( ( AREAP ) pArea, puiPos[ uiField ] + 1, hb_arrayGetItemPtr( pArray, uiField + 1 ) );
+      hb_xfree( puiPos );
+      return errCode;
+   }
+
+   while( uiRecv < uiMemos )
+   {
+      /* fill the pipeline */
+      while( uiSent < uiMemos && LetoAsyncPending( pConnection ) < LETO_PIPELINE_MAX )
+      {
+         PHB_ITEM      pItem = hb_arrayGetItemPtr( pArray, uiSent + 1 );
+         const char *  ptr;
+         unsigned long ulLen;
+
+         uiField = puiPos[ uiSent ];
+         if( leto_MemoIsEmpty( pArea, uiField ) )
+         {
+            hb_itemPutC( pItem, "" );
+            hb_itemSetCMemo( pItem );
+         }
+         else if( ( ptr = leto_MemoInline( pTable, uiField + 1, &ulLen ) ) != NULL )
+         {
+            leto_MemoToItem( pArea, ptr, ulLen, pItem, pArea->area.lpFields[ uiField ].uiType );
+            hb_itemSetCMemo( pItem );
+         }
+         else if( ! LetoDbGetMemoAsync( pTable, uiField + 1 ) )
+         {
+            fSendErr = HB_TRUE;
+            break;
+         }
+         else
+            hb_itemPutNI( pItem, 0 );  /* marks answer to come */
+         uiSent++;
+      }
+
+      /* collect the answers in same order */
+      while( uiRecv < uiSent )
+      {
+         PHB_ITEM pItem = hb_arrayGetItemPtr( pArray, uiRecv + 1 );
+
+         if( HB_IS_NUMERIC( pItem ) )
+         {
+            unsigned long ulLen;
+            const char *  ptr;
+
+            if( ! LetoAsyncRecv( pConnection, NULL ) )
+               break;
+            ptr = leto_DecryptText( pConnection, &ulLen, pConnection->szBuffer );
+            uiField = puiPos[ uiRecv ];
+            leto_MemoToItem( pArea, ptr, ulLen, pItem, pArea->area.lpFields[ uiField ].uiType );
+            hb_itemSetCMemo( pItem );
+         }
+         uiRecv++;
+      }
+
+      if( uiRecv < uiSent || fSendErr )
+      {
+         commonError( pArea, EG_DATAWIDTH, 1000, 0, NULL, 0, "CONNECTION ERROR" );
+         errCode = HB_FAILURE;
+         break;
+      }
+   }
+
+   hb_xfree( puiPos );
+   return errCode;
+}
+
+static HB_ERRCODE letoGetValue( LETOAREAP pArea, HB_USHORT uiIndex, PHB_ITEM pItem )
+{
+   LETOTABLE * pTable = pArea->pTable;
+   LPFIELD     pField;
+
+   HB_TRACE( HB_TR_DEBUG, ( "letoGetValue(%p, %hu, %p)", pArea, uiIndex, pItem ) );
+
+   if( ! uiIndex || uiIndex > pArea->area.uiFieldCount )
+      return HB_FAILURE;
+   if( leto_GetValuePrepare( pArea ) != HB_SUCCESS )
+      return HB_FAILURE;
+   if( leto_FieldFetch( pTable, uiIndex - 1 ) != HB_SUCCESS )
+      return HB_FAILURE;
+
    pField = pArea->area.lpFields + --uiIndex;
    switch( pField->uiType )
    {
@@ -1090,16 +1233,7 @@ static HB_ERRCODE letoGetValue( LETOAREAP pArea, HB_USHORT uiIndex, PHB_ITEM pIt
       case HB_FT_BLOB:
       case HB_FT_PICTURE:
       case HB_FT_OLE:
-      {
-         HB_BOOL fEmpty;
-
-         if( pField->uiLen == 4 )
-            fEmpty = HB_GET_LE_UINT32( &pTable->pRecord[ pTable->pFieldOffset[ uiIndex ] ] ) == 0;
-         else  /* empty if the rightmost char is a whitespace */
-            fEmpty = ( pTable->pRecord[ pTable->pFieldOffset[ uiIndex ] + pField->uiLen - 1 ] == ' ' );
-
-         /* uiUpdated is set with append */
-         if( ( pTable->uiUpdated & LETO_FLAG_UPD_APPEND ) || pArea->area.fEof || fEmpty )
+         if( leto_MemoIsEmpty( pArea, uiIndex ) )
             hb_itemPutC( pItem, "" );
          else
          {
@@ -1108,7 +1242,6 @@ static HB_ERRCODE letoGetValue( LETOAREAP pArea, HB_USHORT uiIndex, PHB_ITEM pIt
          }
          hb_itemSetCMemo( pItem );
          break;
-      }
 
       case HB_FT_FLOAT:
       {
@@ -1295,6 +1428,7 @@ static HB_ERRCODE letoPutRec( LETOAREAP pArea, HB_BYTE * pBuffer )
          if( SELF_FORCEREL( ( AREAP ) pArea ) != HB_SUCCESS )
             return HB_FAILURE;
       }
+      leto_RecDecodeAll( pTable );
       memcpy( pTable->pRecord, pBuffer, pTable->uiRecordLen );
       pTable->uiUpdated |= LETO_FLAG_UPD_CHANGE;
       pTable->fDeleted = ( pTable->pRecord[ 0 ] == '*' );
@@ -1369,6 +1503,9 @@ static HB_ERRCODE letoPutValue( LETOAREAP pArea, HB_USHORT uiIndex, PHB_ITEM pIt
 
    /* decrease uiIndex to zero based */
    pField = pArea->area.lpFields + --uiIndex;
+   /* else a later fetch of whole record would overwrite this change */
+   if( leto_FieldFetch( pTable, uiIndex ) != HB_SUCCESS )
+      return HB_FAILURE;
 
    switch( pField->uiType )
    {
@@ -1918,6 +2055,7 @@ static HB_ERRCODE letoRecInfo( LETOAREAP pArea, PHB_ITEM pRecID, HB_USHORT uiInf
 #endif
 
       case DBRI_RAWRECORD:
+         leto_RecDecodeAll( pTable );
          hb_itemPutCL( pInfo, ( char * ) pTable->pRecord, pTable->uiRecordLen );
          break;
 
@@ -1930,30 +2068,26 @@ static HB_ERRCODE letoRecInfo( LETOAREAP pArea, PHB_ITEM pRecID, HB_USHORT uiInf
 
          ulLength = uiInfoType == DBRI_RAWDATA ? pTable->uiRecordLen : 0;
          pResult = ( HB_BYTE * ) hb_xgrab( ulLength + 1 );
+         leto_RecDecodeAll( pTable );
          if( ulLength )
             memcpy( pResult, pTable->pRecord, ulLength );
 
          if( pTable->uiMemoVersion )
          {
-            for( uiFields = 0; uiFields < pArea->area.uiFieldCount; uiFields++ )
+            PHB_ITEM pMemos = hb_itemNew( NULL );
+
+            errCode = leto_GetMemoValues( pArea, pMemos );
+            for( uiFields = 1; errCode == HB_SUCCESS && uiFields <= ( HB_USHORT ) hb_arrayLen( pMemos ); uiFields++ )
             {
-               if( pArea->area.lpFields[ uiFields ].uiType == HB_FT_MEMO ||
-                   pArea->area.lpFields[ uiFields ].uiType == HB_FT_PICTURE ||
-                   pArea->area.lpFields[ uiFields ].uiType == HB_FT_BLOB ||
-                   pArea->area.lpFields[ uiFields ].uiType == HB_FT_OLE )
+               ulLen = hb_arrayGetCLen( pMemos, uiFields );
+               if( ulLen > 0 )
                {
-                  errCode = SELF_GETVALUE( ( AREAP ) pArea, uiFields + 1, pInfo );
-                  if( errCode != HB_SUCCESS )
-                     break;
-                  ulLen = hb_itemGetCLen( pInfo );
-                  if( ulLen > 0 )
-                  {
-                     pResult = ( HB_BYTE * ) hb_xrealloc( pResult, ulLength + ulLen + 1 );
-                     memcpy( pResult + ulLength, hb_itemGetCPtr( pInfo ), ulLen );
-                     ulLength += ulLen;
-                  }
+                  pResult = ( HB_BYTE * ) hb_xrealloc( pResult, ulLength + ulLen + 1 );
+                  memcpy( pResult + ulLength, hb_arrayGetCPtr( pMemos, uiFields ), ulLen );
+                  ulLength += ulLen;
                }
             }
+            hb_itemRelease( pMemos );
          }
          hb_itemPutCLPtr( pInfo, ( char * ) pResult, ulLength );
          break;
@@ -2024,6 +2158,16 @@ static HB_ERRCODE leto_doFreeTable( AREAP pArea, void * p )
             hb_xfree( pTable->pFieldIsBinary );
          if( pTable->pFieldUpd )
             hb_xfree( pTable->pFieldUpd );
+         if( pTable->pFieldSel )
+            hb_xfree( pTable->pFieldSel );
+         if( pTable->pRecCache )
+            LetoDbRecCache( pTable, 0, 0 );
+         if( pTable->pMemoInline )
+            hb_xfree( pTable->pMemoInline );
+         if( pTable->pLazyRec )
+            hb_xfree( pTable->pLazyRec );
+         if( pTable->pulLazyPos )
+            hb_xfree( pTable->pulLazyPos );
          if( pTable->pRecord )
             hb_xfree( pTable->pRecord );
          if( pTable->pFields )
@@ -2845,10 +2989,171 @@ static HB_ERRCODE letoInfo( LETOAREAP pArea, HB_USHORT uiIndex, PHB_ITEM pItem )
 
       case DBI_CLEARBUFFER:
          pTable->ptrBuf = NULL;
+         leto_RecCacheClear( pTable );
          SELF_SKIP( ( AREAP ) pArea, 0 );
          pTable->llCentiSec = 0;
          break;
 
+      case DBI_RECCACHE:  /* size of record cache used by GoTo, 0 = off */
+      {
+         int iOldSize = pTable->pRecCache ? ( int ) pTable->pRecCache->uiSize : 0;
+
+         if( HB_IS_NUMERIC( pItem ) )
+            LetoDbRecCache( pTable, ( unsigned int ) HB_MAX( hb_itemGetNI( pItem ), 0 ), 0 );
+         hb_itemPutNI( pItem, iOldSize );
+         break;
+      }
+
+      case DBI_MEMOINLINE:  /* memo content up to this length received with record */
+      {
+         long lOld = ( long ) pTable->ulMemoInline;
+
+         if( HB_IS_NUMERIC( pItem ) )
+            LetoDbMemoInline( pTable, ( unsigned long ) HB_MAX( hb_itemGetNL( pItem ), 0 ) );
+         hb_itemPutNL( pItem, lOld );
+         break;
+      }
+
+      case DBI_LAZYDECODE:  /* fields of received records decoded at first access */
+      {
+         HB_BOOL fLazy = pTable->fLazyDecode;
+
+         if( HB_IS_LOGICAL( pItem ) )
+            LetoDbLazyDecode( pTable, hb_itemGetL( pItem ) );
+         hb_itemPutL( pItem, fLazy );
+         break;
+      }
+
+      case DBI_FILTEREXPLAIN:  /* how the server evaluates the filter, index ranges used */
+      {
+         unsigned long ulLen = 0;
+         const char *  szExplain = LetoDbFilterExplain( pTable, &ulLen );
+
+         hb_itemPutCL( pItem, szExplain ? szExplain : "", ulLen );
+         break;
+      }
+
+      case DBI_NOTIFY:  /* buffers valid until server notes a change by other */
+      {
+         HB_BOOL fNotify = pTable->fNotify;
+
+         if( HB_IS_LOGICAL( pItem ) && hb_itemGetL( pItem ) != fNotify )
+            LetoDbNotify( pTable, hb_itemGetL( pItem ) );
+         hb_itemPutL( pItem, fNotify );
+         break;
+      }
+
+      case DBI_BUFPREFETCH:  /* read-ahead of next skip buffer */
+      {
+         HB_BOOL fPrefetch = pTable->fPrefetch;
+
+         if( HB_IS_LOGICAL( pItem ) )
+            pTable->fPrefetch = hb_itemGetL( pItem );
+         hb_itemPutL( pItem, fPrefetch );
+         break;
+      }
+
+      case DBI_BUFHITRATIO:  /* percentage of skip/ goto served by skip buffer */
+      {
+         HB_ULONG ulAll = pTable->Buffer.ulShoots + pTable->Buffer.ulFetches;
+
+         if( HB_IS_LOGICAL( pItem ) && hb_itemGetL( pItem ) )  /* reset statistic */
+         {
+            pTable->Buffer.ulShoots = 0;
+            pTable->Buffer.ulFetches = 0;
+         }
+         hb_itemPutNDDec( pItem, ulAll ? ( double ) pTable->Buffer.ulShoots * 100 / ulAll : 0.0, 2 );
+         break;
+      }
+
+      case DBI_LETOFIELDS:  /* field projection: records are send with only these fields */
+      {
+         PHB_ITEM  pResult = NULL;
+         HB_USHORT uiField;
+         HB_SIZE   nLen = 0;
+
+         /* result: comma separated names of active projection, empty for all */
+         for( uiField = 0; pTable->pFieldSel && uiField < pArea->area.uiFieldCount; uiField++ )
+         {
+            if( pTable->pFieldSel[ uiField ] )
+               nLen += strlen( pTable->pFields[ uiField ].szName ) + 1;
+         }
+         if( nLen )
+         {
+            char * szNames = ( char * ) hb_xgrab( nLen + 1 );
+
+            szNames[ 0 ] = '\0';
+            for( uiField = 0; uiField < pArea->area.uiFieldCount; uiField++ )
+            {
+               if( pTable->pFieldSel[ uiField ] )
+               {
+                  if( *szNames )
+                     strcat( szNames, "," );
+                  strcat( szNames, pTable->pFields[ uiField ].szName );
+               }
+            }
+            pResult = hb_itemPutCLPtr( NULL, szNames, strlen( szNames ) );
+         }
+
+         /* new projection given as array of names or numbers, or comma separated names */
+         if( HB_IS_ARRAY( pItem ) || HB_IS_STRING( pItem ) )
+         {
+            HB_SIZE nItems = HB_IS_ARRAY( pItem ) ? hb_arrayLen( pItem ) : 0;
+            char *  szFields = ( char * ) hb_xgrab( ( HB_SIZE ) pArea->area.uiFieldCount * 6 + 1 );
+            char *  ptr = szFields;
+            HB_SIZE n;
+
+            if( HB_IS_STRING( pItem ) )
+            {
+               char * szList = hb_strdup( hb_itemGetCPtr( pItem ) );
+               char * szName = szList, * ptrEnd;
+
+               while( szName && *szName )
+               {
+                  if( ( ptrEnd = strchr( szName, ',' ) ) != NULL )
+                     *ptrEnd++ = '\0';
+                  uiField = hb_rddFieldIndex( ( AREAP ) pArea, hb_strUpper( szName, strlen( szName ) ) );
+                  if( uiField && ptr - szFields < pArea->area.uiFieldCount * 6 )
+                     ptr += eprintf( ptr, "%u,", ( unsigned int ) uiField );
+                  szName = ptrEnd;
+               }
+               hb_xfree( szList );
+            }
+            for( n = 1; n <= nItems && ptr - szFields < pArea->area.uiFieldCount * 6; n++ )
+            {
+               if( hb_arrayGetType( pItem, n ) & HB_IT_NUMERIC )
+                  uiField = ( HB_USHORT ) hb_arrayGetNI( pItem, n );
+               else
+                  uiField = hb_rddFieldIndex( ( AREAP ) pArea, hb_arrayGetCPtr( pItem, n ) );
+               if( uiField && uiField <= pArea->area.uiFieldCount )
+                  ptr += eprintf( ptr, "%u,", ( unsigned int ) uiField );
+            }
+            if( ptr > szFields )
+               ptr--;  /* last ',' */
+            *ptr = '\0';
+
+            if( pTable->uiUpdated )
+               LetoDbPutRecord( pTable );
+            if( LetoDbSetFields( pTable, szFields ) != HB_SUCCESS )
+            {
+               hb_xfree( szFields );
+               if( pResult )
+                  hb_itemRelease( pResult );
+               return HB_FAILURE;
+            }
+            hb_xfree( szFields );
+         }
+
+         if( pResult )
+         {
+            hb_itemMove( pItem, pResult );
+            hb_itemRelease( pResult );
+         }
+         else
+            hb_itemPutC( pItem, "" );
+         break;
+      }
+
       case DBI_CHILDPARENT:  /* have this WA a LETO parent [ return first found ] */
          pConnection = letoGetConnPool( pTable->uiConnection );
          pConnection->whoCares = hb_itemPutNI( NULL, ( ( AREAP ) pArea )->uiArea );
@@ -7357,10 +7662,20 @@ HB_FUNC( LETO_DBEVAL )
    hb_itemRelease( pRefresh );
 }
 
+/* requested threads for a parallel scan at server as optional last parameter behind the scope keys */
+static char * leto_AddScanThreads( char * pData, int iParam )
+{
+   int iThreads = HB_ISNUM( iParam ) ? hb_parni( iParam ) : 0;
+
+   if( iThreads > 1 )
+      pData += eprintf( pData, "%d;", iThreads );
+   return pData;
+}
+
 HB_FUNC( LETO_GROUPBY )
 {
    LETOAREAP    pArea = ( LETOAREAP ) hb_rddGetCurrentWorkAreaPointer();
-   char         szData[ LETO_MAX_EXP * 2 + LETO_MAX_EXP + LETO_MAX_TAGNAME + 47 ], * pData;
+   char         szData[ LETO_MAX_EXP * 2 + LETO_MAX_EXP + LETO_MAX_TAGNAME + 59 ], * pData;
    const char * szGroup = ( HB_ISCHAR( 1 ) ? hb_parc( 1 ) : NULL );
    const char * szField, * szFilter;
    HB_ULONG     ulLen;
@@ -7386,6 +7701,7 @@ HB_FUNC( LETO_GROUPBY )
                        szGroup, szField, szFilter,
                        ( char ) ( ( ( hb_setGetDeleted() ) ? 0x41 : 0x40 ) ) );
       pData = leto_AddScopeExp( pArea, szData + ulLen, 4 );
+      pData = leto_AddScanThreads( pData, 6 );
       ulLen = pData - szData;
 
       if( ! leto_SendRecv( pConnection, pArea, szData, ulLen, 1020 ) )
@@ -7491,7 +7807,7 @@ HB_FUNC( LETO_GROUPBY )
 HB_FUNC( LETO_SUM )
 {
    LETOAREAP    pArea = ( LETOAREAP ) hb_rddGetCurrentWorkAreaPointer();
-   char         szData[ LETO_MAX_EXP * 2 + LETO_MAX_EXP + LETO_MAX_TAGNAME + 35 ], * pData;
+   char         szData[ LETO_MAX_EXP * 2 + LETO_MAX_EXP + LETO_MAX_TAGNAME + 47 ], * pData;
    const char * szField, * szFilter;
    HB_ULONG     ulLen;
 
@@ -7511,6 +7827,7 @@ HB_FUNC( LETO_SUM )
                        szField, szFilter,
                        ( char ) ( ( ( hb_setGetDeleted() ) ? 0x41 : 0x40 ) ) );
       pData = leto_AddScopeExp( pArea, szData + ulLen, 3 );
+      pData = leto_AddScanThreads( pData, 5 );
       ulLen = pData - szData;
 
       if( ! leto_SendRecv( pConnection, pArea, szData, ulLen, 1020 ) )
@@ -9098,6 +9415,7 @@ HB_FUNC( LETO_MEMOISEMPTY )
       {
          LPFIELD pField = pArea->area.lpFields + --uiFieldPos;
 
+         leto_RecDecode( pTable, uiFieldPos );
          switch( pField->uiType )
          {
             case HB_FT_MEMO:
@@ -9296,6 +9614,89 @@ HB_FUNC( LETO_SETSKIPBUFFER )
       hb_retni( 0 );
 }
 
+/* LETO_GOTOLIST( aRecNo ) ==> lSuccess -- records into client record cache for following DbGoto() */
+HB_FUNC( LETO_GOTOLIST )
+{
+   LETOAREAP pArea = ( LETOAREAP ) hb_rddGetCurrentWorkAreaPointer();
+   PHB_ITEM  pArray = hb_param( 1, HB_IT_ARRAY );
+   HB_BOOL   fRet = HB_FALSE;
+
+   if( pArea && leto_CheckArea( pArea ) && pArea->pTable && pArray )
+   {
+      HB_SIZE         nLen = hb_arrayLen( pArray ), n;
+      unsigned long * pulRecNo = ( unsigned long * ) hb_xgrab( ( nLen + 1 ) * sizeof( unsigned long ) );
+
+      for( n = 0; n < nLen; n++ )
+         pulRecNo[ n ] = ( unsigned long ) hb_arrayGetNL( pArray, n + 1 );
+      fRet = LetoDbGoToList( pArea->pTable, pulRecNo, ( unsigned long ) nLen ) == HB_SUCCESS;
+      hb_xfree( pulRecNo );
+   }
+   hb_retl( fRet );
+}
+
+/* LETO_SEEKLIST( aKeys [, lSoftSeek ] [, lRecords ] [, @aFound ] ) ==> aRecNo -- keys for active order,
+ * RecNo 0 if not found; with lRecords the records go into client record cache for following DbGoto() */
+HB_FUNC( LETO_SEEKLIST )
+{
+   LETOAREAP pArea = ( LETOAREAP ) hb_rddGetCurrentWorkAreaPointer();
+   PHB_ITEM  pArray = hb_param( 1, HB_IT_ARRAY );
+
+   if( pArea && leto_CheckArea( pArea ) && pArea->pTable && pArea->pTable->pTagCurrent && pArray )
+   {
+      LETOTAGINFO *   pTagInfo = pArea->pTable->pTagCurrent;
+      HB_SIZE         nLen = hb_arrayLen( pArray ), n;
+      unsigned long   ulCount = 0, ul;
+      char *          pKeys = ( char * ) hb_xgrab( nLen * LETO_MAX_KEY + 1 );
+      const char **   pszKeys = ( const char ** ) hb_xgrab( ( nLen + 1 ) * sizeof( char * ) );
+      HB_USHORT *     puiKeyLen = ( HB_USHORT * ) hb_xgrab( ( nLen + 1 ) * sizeof( HB_USHORT ) );
+      HB_SIZE *       pnPos = ( HB_SIZE * ) hb_xgrab( ( nLen + 1 ) * sizeof( HB_SIZE ) );
+      unsigned long * pulRecNo = ( unsigned long * ) hb_xgrabz( ( nLen + 1 ) * sizeof( unsigned long ) );
+      HB_BOOL *       pfFound = ( HB_BOOL * ) hb_xgrabz( ( nLen + 1 ) * sizeof( HB_BOOL ) );
+      PHB_ITEM        pResult = hb_itemArrayNew( nLen );
+      PHB_ITEM        pFound = hb_itemArrayNew( nLen );
+      PHB_ITEM        pKey;
+
+      if( pArea->pTable->uiUpdated )
+         leto_PutRec( pArea );
+      for( n = 0; n < nLen; n++ )  /* keys of other type as index can't be found */
+      {
+         pKey = hb_arrayGetItemPtr( pArray, n + 1 );
+         if( leto_ItemType( pKey ) == pTagInfo->cKeyType )
+         {
+            pszKeys[ ulCount ] = pKeys + n * LETO_MAX_KEY;
+            puiKeyLen[ ulCount ] = leto_KeyToStr( pArea, pKeys + n * LETO_MAX_KEY, pTagInfo->cKeyType, pKey, pTagInfo->uiKeySize );
+            pnPos[ ulCount++ ] = n + 1;
+         }
+      }
+
+      if( LetoDbSeekList( pArea->pTable, pszKeys, puiKeyLen, ulCount, hb_parl( 2 ), hb_parl( 3 ), pulRecNo, pfFound ) == HB_SUCCESS )
+      {
+         for( n = 1; n <= nLen; n++ )
+         {
+            hb_arraySetNL( pResult, n, 0 );
+            hb_arraySetL( pFound, n, HB_FALSE );
+         }
+         for( ul = 0; ul < ulCount; ul++ )
+         {
+            hb_arraySetNL( pResult, pnPos[ ul ], pulRecNo[ ul ] );
+            hb_arraySetL( pFound, pnPos[ ul ], pfFound[ ul ] );
+         }
+      }
+      hb_itemParamStoreForward( 4, pFound );
+      hb_itemRelease( pFound );
+      hb_itemReturnRelease( pResult );
+
+      hb_xfree( pKeys );
+      hb_xfree( pszKeys );
+      hb_xfree( puiKeyLen );
+      hb_xfree( pnPos );
+      hb_xfree( pulRecNo );
+      hb_xfree( pfFound );
+   }
+   else
+      hb_reta( 0 );
+}
+
 /* deprecated */
 HB_FUNC( LETO_SETSEEKBUFFER )
 {
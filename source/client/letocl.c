@@ -63,6 +63,7 @@
       #endif
    #endif
    #include <errno.h>
+   #include <sys/stat.h>
 #endif
 
 #if ! defined( K_ESC )
@@ -83,6 +84,9 @@
       #define HB_GC_LOCKE()    hb_threadEnterCriticalSection( &s_ErrorMtx )
       #define HB_GC_UNLOCKE()  hb_threadLeaveCriticalSection( &s_ErrorMtx )
    #endif
+#else
+   #define HB_GC_LOCKE()
+   #define HB_GC_UNLOCKE()
 #endif
 
 #if defined( __LETO_C_API__ )
@@ -946,6 +950,76 @@ static void leto_ipCleanup( void )
    }
 }
 
+#if defined( LETO_LOCAL_SOCKET )
+/* uid of process at other end of local socket, -1 if unknown */
+static long leto_localPeerUid( HB_SOCKET sd )
+{
+#if defined( SO_PEERCRED ) && defined( HB_OS_LINUX )
+   struct ucred cred;
+   socklen_t    len = sizeof( cred );
+
+   if( getsockopt( sd, SOL_SOCKET, SO_PEERCRED, &cred, &len ) == 0 )
+      return ( long ) cred.uid;
+#elif defined( HB_OS_BSD ) || defined( HB_OS_DARWIN )
+   uid_t uid;
+   gid_t gid;
+
+   if( getpeereid( sd, &uid, &gid ) == 0 )
+      return ( long ) uid;
+#else
+   HB_SYMBOL_UNUSED( sd );
+#endif
+   return -1;
+}
+
+/* Unix domain socket of server running as user uid, only used if directory and socket belong to
+ * that user, the directory is not writable by others and the listening process runs as that user */
+static HB_SOCKET leto_localConnectUid( uid_t uid, int iPort, int iTimeOut )
+{
+   HB_SOCKET   sd;
+   char        szPath[ HB_PATH_MAX ];
+   void *      pSockAddr = NULL;
+   unsigned    uiLen;
+   struct stat st;
+
+   hb_snprintf( szPath, HB_PATH_MAX, LETO_LOCAL_SOCKETDIR, ( unsigned ) uid );
+   if( lstat( szPath, &st ) != 0 || ! S_ISDIR( st.st_mode ) || st.st_uid != uid ||
+       ( st.st_mode & ( S_IWGRP | S_IWOTH ) ) )
+      return HB_NO_SOCKET;
+   hb_snprintf( szPath, HB_PATH_MAX, LETO_LOCAL_SOCKET, ( unsigned ) uid, iPort );
+   if( lstat( szPath, &st ) != 0 || ! S_ISSOCK( st.st_mode ) || st.st_uid != uid )
+      return HB_NO_SOCKET;
+
+   sd = hb_socketOpen( HB_SOCKET_PF_LOCAL, HB_SOCKET_PT_STREAM, 0 );
+   if( sd != HB_NO_SOCKET )
+   {
+      if( ! hb_socketLocalAddr( &pSockAddr, &uiLen, szPath ) ||
+          hb_socketConnect( sd, pSockAddr, uiLen, iTimeOut ) != 0 ||
+          leto_localPeerUid( sd ) != ( long ) uid )
+      {
+         hb_socketClose( sd );
+         sd = HB_NO_SOCKET;
+      }
+      if( pSockAddr )
+         hb_xfree( pSockAddr );
+   }
+
+   return sd;
+}
+
+/* try Unix domain socket of a server at same machine running as same user or root,
+ * silent fail if not offered or not trusted: then TCP is used */
+static HB_SOCKET leto_localConnect( int iPort, int iTimeOut )
+{
+   HB_SOCKET sd = leto_localConnectUid( geteuid(), iPort, iTimeOut );
+
+   if( sd == HB_NO_SOCKET && geteuid() != 0 )
+      sd = leto_localConnectUid( 0, iPort, iTimeOut );
+
+   return sd;
+}
+#endif
+
 static HB_SOCKET leto_ipConnect( const char * szHost, int iPort, int iTimeOut, LETOCONNECTION * pConnection )
 {
    HB_SOCKET sd;
@@ -956,6 +1030,21 @@ static HB_SOCKET leto_ipConnect( const char * szHost, int iPort, int iTimeOut, L
    if( pszIpAddres == NULL )
       return HB_NO_SOCKET;
 
+#if defined( LETO_LOCAL_SOCKET )
+   /* loopback address: prefer Unix domain socket, else go on with TCP */
+   if( ! strncmp( pszIpAddres, "127.", 4 ) && ( sd = leto_localConnect( iPort, iTimeOut ) ) != HB_NO_SOCKET )
+   {
+      if( pConnection )
+      {
+         if( ! pConnection->pAddrDNS && strcmp( pszIpAddres, szHost ) )
+            pConnection->pAddrDNS = leto_strdup( szHost );
+         pConnection->iErrorCode = 0;
+      }
+      hb_xfree( pszIpAddres );
+      return sd;
+   }
+#endif
+
    sd = hb_socketOpen( HB_SOCKET_PF_INET, HB_SOCKET_PT_STREAM, 0 );
    if( sd != HB_NO_SOCKET )
    {
@@ -1386,6 +1475,7 @@ static int leto_socketSelectRead( HB_SOCKET hSocket, HB_MAXINT lTimeOut )
  * -2 == received less bytes as 4 ( LETO_MSGSIZE_LEN )
  * -3 == invalid LETO_MSGSIZE_LEN
  * -4 == received less than expected
+ * -5 == LZ4 stream out of sync or message not authentic, socket is shut down
  */
 static long leto_Recv( LETOCONNECTION * pConnection )
 {
@@ -1501,7 +1591,18 @@ static long leto_Recv( LETOCONNECTION * pConnection )
 
 #ifdef USE_LZ4
    if( fCompressed || pConnection->fZipCrypt )  /* means compressed and/or encrypted */
+   {
       ulRead = hb_lz4netDecrypt( ( PHB_LZ4NET ) pConnection->zstream, &pConnection->szBuffer, ulRead, &pConnection->ulBufferLen, fCompressed );
+      if( ! ulRead && hb_lz4netStreamFailed( ( PHB_LZ4NET ) pConnection->zstream ) )
+      {  /* lost LZ4 history or a not authentic answer, nothing further is trustable: connection is dead */
+#ifdef LETO_CLIENTLOG
+         leto_clientlog( NULL, 0, "leto_Recv() LZ4 stream out of sync or not authentic, connection closed" );
+#endif
+         pConnection->iConnectRes = LETO_ERR_PROTO;
+         hb_socketShutdown( pConnection->hSocket, HB_SOCKET_SHUT_RDWR );
+         return -5;
+      }
+   }
 #endif
 
 #ifdef LETO_CLIENTLOG
@@ -1560,7 +1661,7 @@ static long leto_Send( LETOCONNECTION * pConnection, const char * szData, unsign
    }
    else
    #else
-   fUseLZ4Buffer = hb_lz4netEncryptTest( ( PHB_LZ4NET ) pConnection->zstream, ulLen );
+   fUseLZ4Buffer = hb_lz4netMsgBuffered( ( PHB_LZ4NET ) pConnection->zstream, ulLen );
    if( ! fUseLZ4Buffer )
    #endif
    {
@@ -1591,7 +1692,7 @@ static long leto_Send( LETOCONNECTION * pConnection, const char * szData, unsign
 #else  /* _!_ MSG_MORE */
 
    #ifdef USE_LZ4
-   fUseLZ4Buffer = hb_lz4netEncryptTest( ( PHB_LZ4NET ) pConnection->zstream, ulLen );
+   fUseLZ4Buffer = hb_lz4netMsgBuffered( ( PHB_LZ4NET ) pConnection->zstream, ulLen );
    if( ! fUseLZ4Buffer )
    #endif
    {
@@ -1688,6 +1789,94 @@ static long leto_Send( LETOCONNECTION * pConnection, const char * szData, unsign
    return ( long ) ulSent;
 }
 
+/* request pipelining: the server executes the requests of a connection one after another,
+ * so answers arrive in the order of the requests. LetoAsyncSend() sends without waiting and returns
+ * a request ID, LetoAsyncRecv() collects the answer of the oldest pending request into szBuffer.
+ * Only for requests which are always answered, not for these send with leto_SendRecv2() */
+static void leto_AsyncReset( LETOCONNECTION * pConnection )
+{
+   pConnection->ulPipeRecv = pConnection->ulPipeSent;
+}
+
+unsigned int LetoAsyncPending( LETOCONNECTION * pConnection )
+{
+   return ( unsigned int ) ( pConnection->ulPipeSent - pConnection->ulPipeRecv );
+}
+
+unsigned long LetoAsyncSend( LETOCONNECTION * pConnection, const char * szData, unsigned long ulLen )
+{
+   if( ! ulLen )
+      ulLen = strlen( szData );
+
+   /* more in flight may deadlock, if both sides block in send() with full socket buffers */
+   if( pConnection->fMustResync || LetoAsyncPending( pConnection ) >= LETO_PIPELINE_MAX )
+   {
+      pConnection->iError = 1000;
+      return 0;
+   }
+
+   if( ! leto_Send( pConnection, szData, ulLen ) )
+   {
+#if ! defined( __HARBOUR30__ ) && ! defined( __LETO_C_API__ )  /* new function since 2015/08/17 */
+      hb_socketSetError( LETO_SOCK_GETERROR() );
+#endif
+#ifdef LETO_CLIENTLOG
+      leto_clientlog( NULL, 0, "LetoAsyncSend() write error" );
+#endif
+      leto_AsyncReset( pConnection );
+      pConnection->fMustResync = HB_TRUE;
+      pConnection->iError = 1000;
+      return 0;
+   }
+
+   pConnection->iError = 0;
+   if( ! ++pConnection->ulPipeSent )  /* 0 is not a valid ID */
+   {
+      pConnection->ulPipeSent++;
+      pConnection->ulPipeRecv++;
+   }
+
+   return pConnection->ulPipeSent;
+}
+
+/* answer in pConnection->szBuffer, *pulID set to the ID of its request; 0 == nothing pending or error */
+long LetoAsyncRecv( LETOCONNECTION * pConnection, unsigned long * pulID )
+{
+   long lRecv = 0;
+
+   if( LetoAsyncPending( pConnection ) && ! pConnection->fMustResync )
+   {
+      lRecv = leto_Recv( pConnection );
+      if( lRecv <= 0 )
+      {
+#if ! defined( __HARBOUR30__ ) && ! defined( __LETO_C_API__ )  /* new function since 2015/08/17 */
+         hb_socketSetError( LETO_SOCK_GETERROR() );
+#endif
+#ifdef LETO_CLIENTLOG
+         leto_clientlog( NULL, 0, "LetoAsyncRecv() read error %ld", lRecv );
+#endif
+         lRecv = 0;
+         leto_AsyncReset( pConnection );
+         pConnection->fMustResync = HB_TRUE;
+         pConnection->iError = 1000;
+      }
+      else
+      {
+         if( ! ++pConnection->ulPipeRecv )
+            pConnection->ulPipeRecv++;
+         if( pulID )
+            *pulID = pConnection->ulPipeRecv;
+#ifndef LETO_NO_THREAD
+         pConnection->iError = delayedError();
+#else
+         pConnection->iError = 0;
+#endif
+      }
+   }
+
+   return lRecv;
+}
+
 /* splitted send and receive -- this func calls both after another */
 long leto_DataSendRecv( LETOCONNECTION * pConnection, const char * szData, unsigned long ulLen )
 {
@@ -1696,6 +1885,13 @@ long leto_DataSendRecv( LETOCONNECTION * pConnection, const char * szData, unsig
    if( ! ulLen )
       ulLen = strlen( szData );
 
+   /* answers of uncollected pipelined requests would be taken as answer for this request */
+   while( LetoAsyncPending( pConnection ) )
+   {
+      if( ! LetoAsyncRecv( pConnection, NULL ) )
+         return 0;
+   }
+
    lRecv = leto_Send( pConnection, szData, ulLen );
 #ifndef LETO_NO_THREAD
    pConnection->iError = delayedError();
@@ -2247,11 +2443,23 @@ static _HB_INLINE_ unsigned int leto_IsBinaryField( unsigned int uiType, unsigne
           uiType == HB_FT_CURRENCY;
 }
 
+/* forget the not yet decoded fields of active record */
+static _HB_INLINE_ void leto_LazyReset( LETOTABLE * pTable )
+{
+   if( pTable->uiLazyPending )
+   {
+      memset( pTable->pulLazyPos, 0, pTable->uiFieldExtent * sizeof( unsigned long ) );
+      pTable->uiLazyPending = 0;
+   }
+}
+
 /* blanks all fields content to ' ', then only binary fields to '\0' */
 static void leto_SetBlankRecord( LETOTABLE * pTable )
 {
+   leto_LazyReset( pTable );
    /* set all to white space, revert later for binary fields to '\0' */
    memset( pTable->pRecord, ' ', pTable->uiRecordLen );
+   pTable->fRecPartial = HB_FALSE;
    if( pTable->fHaveBinary )
    {
       LETOFIELD * pField = pTable->pFields;
@@ -2277,17 +2485,30 @@ static void leto_SetBlankRecord( LETOTABLE * pTable )
    }
 }
 
-/* optimized: hb_setGetDeleted() change checked with LETO_SET() */
-static _HB_INLINE_ HB_BOOL leto_HotBuffer( LETOTABLE * pTable )
+/* data received at llTime is still valid, for DBI_NOTIFY until a change note arrives */
+static _HB_INLINE_ HB_BOOL leto_HotTime( LETOTABLE * pTable, HB_U64 llTime )
 {
+   if( pTable->fNotify )
+   {
+      LETONOTIFY * pNotify = letoGetConnPool( pTable->uiConnection )->pNotify;
+
+      if( pNotify && pNotify->fAlive )
+         return HB_TRUE;
+   }
 #ifdef LETO_EXCL_HOTBUFFER
    return ( ! pTable->iBufRefreshTime || ! pTable->fShared ||
-            ( int ) leto_MilliDiff( pTable->llCentiSec ) < pTable->iBufRefreshTime );
+            ( int ) leto_MilliDiff( llTime ) < pTable->iBufRefreshTime );
 #else
-   return ( ( int ) leto_MilliDiff( pTable->llCentiSec ) < pTable->iBufRefreshTime || pTable->iBufRefreshTime == 0 );
+   return ( ( int ) leto_MilliDiff( llTime ) < pTable->iBufRefreshTime || pTable->iBufRefreshTime == 0 );
 #endif
 }
 
+/* optimized: hb_setGetDeleted() change checked with LETO_SET() */
+static _HB_INLINE_ HB_BOOL leto_HotBuffer( LETOTABLE * pTable )
+{
+   return leto_HotTime( pTable, pTable->llCentiSec );
+}
+
 static _HB_INLINE_ HB_BOOL leto_OutBuffer( LETOBUFFER * pLetoBuf, char * ptr )
 {
    return ( ( unsigned long ) ( ptr - ( char * ) pLetoBuf->pBuffer ) ) >= pLetoBuf->ulBufDataLen - 1;
@@ -2295,7 +2516,8 @@ static _HB_INLINE_ HB_BOOL leto_OutBuffer( LETOBUFFER * pLetoBuf, char * ptr )
 
 static _HB_INLINE_ void leto_setSkipBuf( LETOTABLE * pTable, const char * ptr, unsigned long ulDataLen )
 {
-   LETOBUFFER * pLetoBuf = &pTable->Buffer;
+   LETOBUFFER *  pLetoBuf = &pTable->Buffer;
+   unsigned long ulFwd = 0, ulRecLen = 0;
 
    if( ulDataLen > pLetoBuf->ulBufLen )
    {
@@ -2306,11 +2528,52 @@ static _HB_INLINE_ void leto_setSkipBuf( LETOTABLE * pTable, const char * ptr, u
       pLetoBuf->ulBufLen = ulDataLen;
    }
    pLetoBuf->ulBufDataLen = ulDataLen;
-
-   memcpy( ( char * ) pTable->Buffer.pBuffer, ptr, ulDataLen );
-   pTable->ptrBuf = pTable->Buffer.pBuffer;
    pTable->uiRecInBuf = 0;
+
+   /* records in skip direction, optional after an empty UINT24 a window of records on the other side,
+    * these are re-ordered before, so buffer is one sequence in skip direction with ptrBuf at target */
+   while( ulFwd + 3 <= ulDataLen && ( ulRecLen = HB_GET_LE_UINT24( ptr + ulFwd ) ) != 0 &&
+          ulRecLen <= ulDataLen - ulFwd - 3 )
+      ulFwd += ulRecLen + 3;
+   if( ulFwd + 3 <= ulDataLen && ! ulRecLen )
+   {
+      const char *  pBack = ptr + ulFwd + 3;
+      unsigned long ulBackLen = ulDataLen - ulFwd - 3, ulPos = ulBackLen;
+
+      while( ulPos > 3 && ( ulRecLen = HB_GET_LE_UINT24( pBack ) ) != 0 && ulRecLen + 3 <= ulPos )
+      {
+         ulPos -= ulRecLen + 3;
+         memcpy( pLetoBuf->pBuffer + ulPos, pBack, ulRecLen + 3 );
+         pBack += ulRecLen + 3;
+         pTable->uiRecInBuf++;
+      }
+      if( ulPos )  /* incomplete window */
+      {
+         memmove( pLetoBuf->pBuffer, pLetoBuf->pBuffer + ulPos, ulBackLen - ulPos );
+         ulBackLen -= ulPos;
+      }
+      memcpy( pLetoBuf->pBuffer + ulBackLen, ptr, ulFwd );
+      pLetoBuf->ulBufDataLen = ulBackLen + ulFwd;
+      pTable->ptrBuf = pLetoBuf->pBuffer + ulBackLen;
+   }
+   else
+   {
+      memcpy( ( char * ) pLetoBuf->pBuffer, ptr, ulDataLen );
+      pTable->ptrBuf = pLetoBuf->pBuffer;
+   }
    pTable->llCentiSec = leto_MilliSec();
+
+   if( pTable->pRecCache )
+   {
+      unsigned char * ptrBuf = pLetoBuf->pBuffer;
+
+      do
+      {
+         leto_RecCacheAdd( pTable, ( const char * ) ptrBuf );
+         ptrBuf += HB_GET_LE_UINT24( ptrBuf ) + 3;
+      }
+      while( ! leto_OutBuffer( pLetoBuf, ( char * ) ptrBuf ) );
+   }
 }
 
 /* pTable->ptrBuf must be pre-checked to be not NULL */
@@ -2365,7 +2628,7 @@ static unsigned char * leto_replSkipBuf( LETOTABLE * pTable, unsigned long ulRec
 
       if( lDiffLen <= 0 )  /* dislike! to re-alloc this! temporary buffer */
       {
-         HB_LONG lRestLen = pTable->Buffer.ulBufDataLen - ( pPos + ulOldLen - pTable->ptrBuf );
+         HB_LONG lRestLen = pTable->Buffer.ulBufDataLen - ( pPos + ulOldLen - pTable->Buffer.pBuffer );
 
          memcpy( pPos, pNewData, ulNewLen );
          if( lDiffLen < 0 )
@@ -2373,6 +2636,8 @@ static unsigned char * leto_replSkipBuf( LETOTABLE * pTable, unsigned long ulRec
             if( lRestLen > 0 )
                memmove( pPos + ulNewLen, pPos + ulNewLen - lDiffLen, lRestLen );
             pTable->Buffer.ulBufDataLen += lDiffLen;
+            if( pTable->ptrBuf > pPos )
+               pTable->ptrBuf += lDiffLen;
          }
          pPos = NULL;
 #ifdef LETO_CLIENTLOG
@@ -2384,6 +2649,360 @@ static unsigned char * leto_replSkipBuf( LETOTABLE * pTable, unsigned long ulRec
    return pPos;
 }
 
+/* client record cache: records seen by RecNo in a hash with LRU chain, bounded by count and memory,
+ * valid for the hotbuffer timeout, own changes remove the record, table wide actions clear it */
+#define LETO_RECCACHE_MAXBYTES  0x100000
+
+static void leto_RecCacheUnlink( LETORECCACHE * pCache, unsigned int ui )
+{
+   LETORECENTRY * pEntry = pCache->pEntries + ui - 1;
+
+   if( pEntry->uiPrev )
+      pCache->pEntries[ pEntry->uiPrev - 1 ].uiNext = pEntry->uiNext;
+   else
+      pCache->uiHead = pEntry->uiNext;
+   if( pEntry->uiNext )
+      pCache->pEntries[ pEntry->uiNext - 1 ].uiPrev = pEntry->uiPrev;
+   else
+      pCache->uiTail = pEntry->uiPrev;
+   pEntry->uiPrev = pEntry->uiNext = 0;
+}
+
+static void leto_RecCacheLinkHead( LETORECCACHE * pCache, unsigned int ui )
+{
+   LETORECENTRY * pEntry = pCache->pEntries + ui - 1;
+
+   pEntry->uiPrev = 0;
+   pEntry->uiNext = pCache->uiHead;
+   if( pCache->uiHead )
+      pCache->pEntries[ pCache->uiHead - 1 ].uiPrev = ui;
+   else
+      pCache->uiTail = ui;
+   pCache->uiHead = ui;
+}
+
+static unsigned int leto_RecCacheFind( LETORECCACHE * pCache, unsigned long ulRecNo )
+{
+   unsigned int ui = pCache->puiHash[ ulRecNo & ( pCache->uiSize - 1 ) ];
+
+   while( ui && pCache->pEntries[ ui - 1 ].ulRecNo != ulRecNo )
+      ui = pCache->pEntries[ ui - 1 ].uiHashNext;
+
+   return ui;
+}
+
+static void leto_RecCacheRemove( LETORECCACHE * pCache, unsigned int ui )
+{
+   LETORECENTRY * pEntry = pCache->pEntries + ui - 1;
+   unsigned int * puiLink = pCache->puiHash + ( pEntry->ulRecNo & ( pCache->uiSize - 1 ) );
+
+   while( *puiLink != ui )
+      puiLink = &pCache->pEntries[ *puiLink - 1 ].uiHashNext;
+   *puiLink = pEntry->uiHashNext;
+   leto_RecCacheUnlink( pCache, ui );
+
+   pCache->ulBytes -= HB_GET_LE_UINT24( pEntry->pData ) + 3;
+   hb_xfree( pEntry->pData );
+   pEntry->pData = NULL;
+   pEntry->ulRecNo = 0;
+   pEntry->uiHashNext = pCache->uiFree;
+   pCache->uiFree = ui;
+   pCache->uiUsed--;
+}
+
+static void leto_RecCacheDel( LETOTABLE * pTable, unsigned long ulRecNo )
+{
+   if( pTable->pRecCache && ulRecNo )
+   {
+      unsigned int ui = leto_RecCacheFind( pTable->pRecCache, ulRecNo );
+
+      if( ui )
+         leto_RecCacheRemove( pTable->pRecCache, ui );
+   }
+}
+
+void leto_RecCacheClear( LETOTABLE * pTable )
+{
+   LETORECCACHE * pCache = pTable->pRecCache;
+
+   while( pCache && pCache->uiHead )
+      leto_RecCacheRemove( pCache, pCache->uiHead );
+}
+
+/* pRec: record data with leading HB_UINT24 length as in skip buffer */
+static void leto_RecCacheAdd( LETOTABLE * pTable, const char * pRec )
+{
+   LETORECCACHE * pCache = pTable->pRecCache;
+   LETORECENTRY * pEntry;
+   unsigned long  ulRecLen = HB_GET_LE_UINT24( pRec ) + 3;
+   unsigned long  ulRecNo = HB_GET_LE_UINT32( pRec + 4 );
+   unsigned int   ui;
+
+   if( ! ulRecNo || ( pRec[ 3 ] & LETO_FLG_EOF ) || ulRecLen > pCache->ulMaxBytes / 4 )
+      return;
+
+   if( ( ui = leto_RecCacheFind( pCache, ulRecNo ) ) != 0 )
+      leto_RecCacheRemove( pCache, ui );
+   while( pCache->uiTail && ( pCache->uiUsed >= pCache->uiSize || pCache->ulBytes + ulRecLen > pCache->ulMaxBytes ) )
+      leto_RecCacheRemove( pCache, pCache->uiTail );
+
+   ui = pCache->uiFree;
+   pEntry = pCache->pEntries + ui - 1;
+   pCache->uiFree = pEntry->uiHashNext;
+   pEntry->ulRecNo = ulRecNo;
+   pEntry->llTime = leto_MilliSec();
+   pEntry->pData = ( unsigned char * ) hb_xgrab( ulRecLen );
+   memcpy( pEntry->pData, pRec, ulRecLen );
+   pEntry->uiHashNext = pCache->puiHash[ ulRecNo & ( pCache->uiSize - 1 ) ];
+   pCache->puiHash[ ulRecNo & ( pCache->uiSize - 1 ) ] = ui;
+   leto_RecCacheLinkHead( pCache, ui );
+   pCache->uiUsed++;
+   pCache->ulBytes += ulRecLen;
+}
+
+/* record from cache if valid, not for own locked records which are refreshed by locking */
+static HB_BOOL leto_RecCacheGet( LETOCONNECTION * pConnection, LETOTABLE * pTable, unsigned long ulRecNo )
+{
+   LETORECCACHE * pCache = pTable->pRecCache;
+   unsigned int   ui;
+
+   if( pConnection->fBufKeyNo || pConnection->fBufKeyCount || pTable->fFLocked || leto_IsRecLocked( pTable, ulRecNo ) )
+      return HB_FALSE;  /* key position in record data is bound to order and moment */
+
+   if( ( ui = leto_RecCacheFind( pCache, ulRecNo ) ) != 0 )
+   {
+      LETORECENTRY * pEntry = pCache->pEntries + ui - 1;
+
+      if( leto_HotTime( pTable, pEntry->llTime ) )
+      {
+         unsigned long ulRecCount = pTable->ulRecCount;
+
+         leto_ParseRecord( pConnection, pTable, ( char * ) pEntry->pData );
+         pTable->fBof = pTable->fEof = pTable->fFound = HB_FALSE;
+         if( pTable->ulRecCount < ulRecCount )
+            pTable->ulRecCount = ulRecCount;
+         leto_RecCacheUnlink( pCache, ui );
+         leto_RecCacheLinkHead( pCache, ui );
+         return HB_TRUE;
+      }
+      leto_RecCacheRemove( pCache, ui );
+   }
+
+   return HB_FALSE;
+}
+
+/* uiRecords rounded up to power of 2, 0 disables; ulMaxBytes 0 for default 1 MB */
+HB_ERRCODE LetoDbRecCache( LETOTABLE * pTable, unsigned int uiRecords, unsigned long ulMaxBytes )
+{
+   LETORECCACHE * pCache = pTable->pRecCache;
+
+   if( pCache )
+   {
+      leto_RecCacheClear( pTable );
+      hb_xfree( pCache->pEntries );
+      hb_xfree( pCache->puiHash );
+      hb_xfree( pCache );
+      pTable->pRecCache = NULL;
+   }
+
+   if( uiRecords )
+   {
+      unsigned int ui = 16;
+
+      while( ui < uiRecords && ui < 0x10000 )
+         ui <<= 1;
+      pCache = ( LETORECCACHE * ) hb_xgrabz( sizeof( LETORECCACHE ) );
+      pCache->uiSize = ui;
+      pCache->pEntries = ( LETORECENTRY * ) hb_xgrabz( ui * sizeof( LETORECENTRY ) );
+      pCache->puiHash = ( unsigned int * ) hb_xgrabz( ui * sizeof( unsigned int ) );
+      pCache->ulMaxBytes = ulMaxBytes ? ulMaxBytes : LETO_RECCACHE_MAXBYTES;
+      for( ; ui; ui-- )
+      {
+         pCache->pEntries[ ui - 1 ].uiHashNext = pCache->uiFree;
+         pCache->uiFree = ui;
+      }
+      pTable->pRecCache = pCache;
+   }
+
+   return HB_SUCCESS;
+}
+
+/* skip buffer contains a record of range ulFrom - ulTo */
+static HB_BOOL leto_NotifyInBuf( LETOTABLE * pTable, unsigned long ulFrom, unsigned long ulTo )
+{
+   HB_UCHAR *    ptrBuf = pTable->Buffer.pBuffer;
+   unsigned long ulRecLen, ulRecNo;
+
+   while( ! leto_OutBuffer( &pTable->Buffer, ( char * ) ptrBuf ) )
+   {
+      ulRecLen = HB_GET_LE_UINT24( ptrBuf );
+      if( ! ulRecLen )  /* separator before window records */
+      {
+         ptrBuf += 3;
+         continue;
+      }
+      ulRecNo = HB_GET_LE_UINT32( ptrBuf + 4 );
+      if( ulRecNo >= ulFrom && ulRecNo <= ulTo )
+         return HB_TRUE;
+      ptrBuf += ulRecLen + 3;
+   }
+
+   return HB_FALSE;
+}
+
+/* apply change notes collected by leto_elch() since last call: drop affected records of skip buffer
+ * and record cache, mark active record as stale. Ring overflow invalidates all */
+static void leto_NotifyApply( LETOCONNECTION * pConnection, LETOTABLE * pTable )
+{
+   LETONOTIFY *    pNotify = pConnection->pNotify;
+   LETONOTIFYEVENT aEvents[ LETO_NOTIFY_EVENTS ];
+   unsigned long   ulSeq, ulCount, ul;
+   HB_BOOL         fAll = HB_FALSE;
+
+   if( ! pTable->fNotify || ! pNotify || pNotify->ulSeq == pTable->ulNotifySeq )  /* quick pre-test */
+      return;
+
+   HB_GC_LOCKE();
+   ulSeq = pNotify->ulSeq;
+   ulCount = ulSeq - pTable->ulNotifySeq;
+   if( ulCount > LETO_NOTIFY_EVENTS )
+      fAll = HB_TRUE;
+   else
+   {
+      for( ul = 0; ul < ulCount; ul++ )
+         aEvents[ ul ] = pNotify->aEvents[ ( pTable->ulNotifySeq + ul ) % LETO_NOTIFY_EVENTS ];
+   }
+   HB_GC_UNLOCKE();
+   pTable->ulNotifySeq = ulSeq;
+
+   for( ul = 0; ul < ulCount && ! fAll; ul++ )
+   {
+      LETONOTIFYEVENT * pEvent = aEvents + ul;
+
+      if( pEvent->hTable != pTable->hTable )
+         continue;
+      if( pEvent->cType == 'U' && pEvent->ulTo - pEvent->ulFrom < 64 )
+      {
+         unsigned long ulRecNo;
+
+         for( ulRecNo = pEvent->ulFrom; ulRecNo <= pEvent->ulTo; ulRecNo++ )
+            leto_RecCacheDel( pTable, ulRecNo );
+         if( pTable->ptrBuf && leto_NotifyInBuf( pTable, pEvent->ulFrom, pEvent->ulTo ) )
+            pTable->ptrBuf = NULL;
+         if( pTable->ulRecNo >= pEvent->ulFrom && pTable->ulRecNo <= pEvent->ulTo )
+         {
+            pTable->fRecStale = HB_TRUE;
+            pTable->ptrBuf = NULL;
+         }
+      }
+      else if( pEvent->cType == 'A' )  /* new record may belong into range of skip buffer */
+         pTable->ptrBuf = NULL;
+      else
+         fAll = HB_TRUE;
+   }
+
+   if( fAll )
+   {
+      pTable->ptrBuf = NULL;
+      leto_RecCacheClear( pTable );
+      pTable->fRecStale = HB_TRUE;
+   }
+}
+
+/* active record needs a refresh: for DBI_NOTIFY after change note, else after hotbuffer timeout */
+HB_BOOL leto_RecStale( LETOTABLE * pTable )
+{
+   if( pTable->fNotify )
+   {
+      LETOCONNECTION * pConnection = letoGetConnPool( pTable->uiConnection );
+
+      if( pConnection->pNotify && pConnection->pNotify->fAlive )
+      {
+         leto_NotifyApply( pConnection, pTable );
+         return pTable->fRecStale;
+      }
+   }
+
+   return pTable->iBufRefreshTime && ( int ) leto_MilliDiff( pTable->llCentiSec ) >= pTable->iBufRefreshTime;
+}
+
+/* fields of received records decoded into record buffer at first access, only without record ZIP */
+HB_ERRCODE LetoDbLazyDecode( LETOTABLE * pTable, HB_BOOL fLazy )
+{
+   if( fLazy && ! pTable->pulLazyPos )
+      pTable->pulLazyPos = ( unsigned long * ) hb_xgrabz( pTable->uiFieldExtent * sizeof( unsigned long ) );
+   else if( ! fLazy )
+      leto_RecDecodeAll( pTable );
+   pTable->fLazyDecode = fLazy;
+
+   return HB_SUCCESS;
+}
+
+/* memo content up to ulMaxLen send by server with records, 0 disables */
+HB_ERRCODE LetoDbMemoInline( LETOTABLE * pTable, unsigned long ulMaxLen )
+{
+   LETOCONNECTION * pConnection = letoGetConnPool( pTable->uiConnection );
+   char             szData[ 48 ];
+
+   eprintf( szData, "%c;%lu;%d;%lu;", LETOCMD_dbi, pTable->hTable, DBI_MEMOINLINE, ulMaxLen );
+   if( ! leto_DataSendRecv( pConnection, szData, 0 ) || *pConnection->szBuffer != '+' )
+      return HB_FAILURE;
+
+   pTable->ulMemoInline = strtoul( pConnection->szBuffer + 1, NULL, 10 );
+   pTable->ulMemoInlineLen = 0;
+   pTable->ptrBuf = NULL;  /* skip buffer records without memo content */
+   leto_RecCacheClear( pTable );
+
+   return HB_SUCCESS;
+}
+
+/* subscribe for change notes of other at second socket, fails if server or connection can't */
+HB_ERRCODE LetoDbNotify( LETOTABLE * pTable, HB_BOOL fNotify )
+{
+   LETOCONNECTION * pConnection = letoGetConnPool( pTable->uiConnection );
+   char             szData[ 42 ];
+
+   if( fNotify && ( ! pConnection->pNotify || ! pConnection->pNotify->fAlive ) )
+      return HB_FAILURE;
+   if( pTable->fNotify == fNotify )
+      return HB_SUCCESS;
+
+   eprintf( szData, "%c;%lu;%d;%c;", LETOCMD_dbi, pTable->hTable, DBI_NOTIFY, fNotify ? '1' : '0' );
+   if( ! leto_DataSendRecv( pConnection, szData, 0 ) || *pConnection->szBuffer != '+' )
+      return HB_FAILURE;
+
+   if( fNotify )
+   {
+      if( pConnection->szBuffer[ 1 ] != '1' )
+         return HB_FAILURE;
+      HB_GC_LOCKE();
+      pTable->ulNotifySeq = pConnection->pNotify->ulSeq;
+      HB_GC_UNLOCKE();
+   }
+   pTable->fNotify = fNotify;
+   pTable->ptrBuf = NULL;  /* fetched without guard of change notes */
+   leto_RecCacheClear( pTable );
+
+   return HB_SUCCESS;
+}
+
+/* description how the server evaluates the filter, with the index ranges used for it;
+ * pointer into the connection buffer, valid until next request, NULL on error */
+const char * LetoDbFilterExplain( LETOTABLE * pTable, unsigned long * pulLen )
+{
+   LETOCONNECTION * pConnection = letoGetConnPool( pTable->uiConnection );
+   char             szData[ 32 ];
+   long             lRecv;
+
+   eprintf( szData, "%c;%lu;%d;;", LETOCMD_dbi, pTable->hTable, DBI_FILTEREXPLAIN );
+   lRecv = leto_DataSendRecv( pConnection, szData, 0 );
+   if( lRecv < 1 || *pConnection->szBuffer != '+' )
+      return NULL;
+
+   *pulLen = ( unsigned long ) lRecv - 1;
+   return pConnection->szBuffer + 1;
+}
+
 static _HB_INLINE_ HB_ULONG leto_TransBlockLen( LETOCONNECTION * pConnection, HB_ULONG ulLen )
 {
    return pConnection->ulTransBlockLen ? pConnection->ulTransBlockLen : ( ulLen < 512 ) ? 8192 : ulLen * 16;
@@ -2746,12 +3365,281 @@ void leto_SetUpdated( LETOTABLE * pTable, HB_USHORT uiUpdated )
    memset( pTable->pFieldUpd, 0, pTable->uiFieldExtent * sizeof( HB_UCHAR ) );
 }
 
+/* memo contents behind record info, ptrEnd is end of record data */
+static void leto_ParseMemoInline( LETOTABLE * pTable, const char * ptr, const char * ptrEnd )
+{
+   unsigned long ulLen;
+
+   if( *ptr == '#' )
+      ptr++;
+   else
+   {
+      if( *ptr == '%' )
+         ptr += 5;
+      if( *ptr == '$' )
+         ptr += 5;
+   }
+   if( ptr >= ptrEnd || *ptr++ != '&' )
+      return;
+
+   /* each memo is terminated, so LetoDbGetMemo() returns a C string; entries are >= 5 bytes */
+   ulLen = ( unsigned long ) ( ptrEnd - ptr );
+   ulLen += ulLen / 5 + 1;
+   if( ulLen > pTable->ulMemoInlineAlloc )
+   {
+      pTable->pMemoInline = ( unsigned char * ) hb_xrealloc( pTable->pMemoInline, ulLen );
+      pTable->ulMemoInlineAlloc = ulLen;
+   }
+   while( ptr + 5 <= ptrEnd )
+   {
+      ulLen = HB_GET_LE_UINT24( ptr + 2 );
+      if( ptr + 5 + ulLen > ptrEnd )  /* malicious data */
+         break;
+      memcpy( pTable->pMemoInline + pTable->ulMemoInlineLen, ptr, ulLen + 5 );
+      pTable->ulMemoInlineLen += ulLen + 5;
+      pTable->pMemoInline[ pTable->ulMemoInlineLen++ ] = '\0';
+      ptr += ulLen + 5;
+   }
+}
+
+/* memo field content received with active record, else NULL */
+const char * leto_MemoInline( LETOTABLE * pTable, unsigned int uiIndex, unsigned long * pulLen )
+{
+   const unsigned char * ptr = pTable->pMemoInline;
+   const unsigned char * ptrEnd = ptr + pTable->ulMemoInlineLen;
+   unsigned long         ulLen;
+
+   while( ptr < ptrEnd )
+   {
+      ulLen = HB_GET_LE_UINT24( ptr + 2 );
+      if( HB_GET_LE_UINT16( ptr ) == uiIndex )
+      {
+         *pulLen = ulLen;
+         return ( const char * ) ptr + 5;
+      }
+      ptr += ulLen + 6;
+   }
+
+   return NULL;
+}
+
+/* decode one field of received record data into record buffer, which is blanked to ' ' */
+static const char * leto_ParseField( LETOTABLE * pTable, HB_USHORT uiIndex, const char * ptr )
+{
+   LETOFIELD * pField = pTable->pFields + uiIndex;
+   char *      ptrRec;
+   HB_UCHAR    uLenLen;
+   HB_USHORT   uiLen;
+
+   ptrRec = ( char * ) pTable->pRecord + pTable->pFieldOffset[ uiIndex ];
+   uLenLen = ( ( HB_UCHAR ) *ptr ) & 0xFF;
+
+   if( ! uLenLen && ! pTable->pFieldIsBinary[ uiIndex ] )
+   {
+      if( pField->uiType == HB_FT_LOGICAL )
+         *ptrRec = 'F';
+
+      ptr++;
+      if( pField->uiType == HB_FT_STRING && pField->uiLen > 255 )
+         ptr++;
+   }
+   else  /* not empty field or binary type */
+   {
+      switch( pField->uiType )
+      {
+         case HB_FT_STRING:
+            ptr++;
+            if( pField->uiLen < 256 )
+            {
+               memcpy( ptrRec, ptr, uLenLen );
+               ptr += uLenLen;
+            }
+            else
+            {
+               uiLen = ( HB_USHORT ) leto_b2n( ptr, uLenLen );
+               ptr += uLenLen;
+               memcpy( ptrRec, ptr, uiLen );
+               ptr += uiLen;
+            }
+            break;
+
+         case HB_FT_LONG:
+         case HB_FT_FLOAT:
+            ptr++;
+            ptrRec += ( pField->uiLen - uLenLen );
+            memcpy( ptrRec, ptr, uLenLen );
+            ptr += uLenLen;
+            break;
+
+         case HB_FT_DATE:
+            memcpy( ptrRec, ptr, pField->uiLen );
+            ptr += pField->uiLen;
+            break;
+
+         case HB_FT_LOGICAL:
+            *ptrRec = *ptr++;
+            break;
+
+         case HB_FT_MEMO:
+         case HB_FT_BLOB:
+         case HB_FT_PICTURE:
+         case HB_FT_OLE:
+            /* empty memo field allready sorted out */
+            if( pField->uiLen == 4 )
+            {
+               memcpy( ptrRec, ptr, pField->uiLen );
+               ptr += pField->uiLen;
+            }
+            else  /* changed to be conform with ZIP traffic: using rightmost char */
+            {
+               ptrRec[ pField->uiLen - 1 ] = '1';
+               ptr++;
+            }
+            break;
+
+         /* binary fields */
+         case HB_FT_INTEGER:
+         case HB_FT_CURRENCY:
+         case HB_FT_DOUBLE:
+         case HB_FT_CURDOUBLE:
+         case HB_FT_TIME:
+         case HB_FT_MODTIME:
+         case HB_FT_TIMESTAMP:
+         case HB_FT_AUTOINC:
+         case HB_FT_ROWVER:
+            memcpy( ptrRec, ptr, pField->uiLen );
+            ptr += pField->uiLen;
+            break;
+
+         case HB_FT_ANY:
+            if( pField->uiLen == 3 || pField->uiLen == 4 )
+            {
+               memcpy( ptrRec, ptr, pField->uiLen );
+               ptr += pField->uiLen;
+            }
+            else
+            {
+               *ptrRec++ = *ptr;
+               switch( *ptr++ )
+               {
+                  case 'D':
+                     memcpy( ptrRec, ptr, 8 );  /* reverse for hb_itemGetDS() */
+                     ptr += 8;
+                     break;
+
+                  case 'L':
+                     *ptrRec = *ptr++;
+                     break;
+
+                  case 'N':
+                     uiLen = ( ( HB_UCHAR ) *ptr ) & 0xFF;
+                     memcpy( ptrRec + ( pField->uiLen - uiLen ), ptr, uiLen );
+                     ptr += uiLen + 1;
+                     break;
+
+                  case 'C':
+                     uiLen = ( HB_USHORT ) leto_b2n( ptr, 2 );
+                     memcpy( ptrRec, ptr, uiLen + 2 );
+                     ptr += uiLen + 2;
+                     break;
+               }
+            }
+            break;
+      }
+   }
+
+   return ptr;
+}
+
+/* length of one field in received record data, must mirror leto_ParseField() */
+static const char * leto_SkipField( LETOTABLE * pTable, HB_USHORT uiIndex, const char * ptr )
+{
+   LETOFIELD * pField = pTable->pFields + uiIndex;
+   HB_UCHAR    uLenLen = ( ( HB_UCHAR ) *ptr ) & 0xFF;
+
+   if( ! uLenLen && ! pTable->pFieldIsBinary[ uiIndex ] )
+      return ptr + ( ( pField->uiType == HB_FT_STRING && pField->uiLen > 255 ) ? 2 : 1 );
+
+   switch( pField->uiType )
+   {
+      case HB_FT_STRING:
+         if( pField->uiLen < 256 )
+            return ptr + 1 + uLenLen;
+         return ptr + 1 + uLenLen + leto_b2n( ptr + 1, uLenLen );
+
+      case HB_FT_LONG:
+      case HB_FT_FLOAT:
+         return ptr + 1 + uLenLen;
+
+      case HB_FT_LOGICAL:
+         return ptr + 1;
+
+      case HB_FT_MEMO:
+      case HB_FT_BLOB:
+      case HB_FT_PICTURE:
+      case HB_FT_OLE:
+         return ptr + ( pField->uiLen == 4 ? 4 : 1 );
+
+      case HB_FT_DATE:
+      case HB_FT_INTEGER:
+      case HB_FT_CURRENCY:
+      case HB_FT_DOUBLE:
+      case HB_FT_CURDOUBLE:
+      case HB_FT_TIME:
+      case HB_FT_MODTIME:
+      case HB_FT_TIMESTAMP:
+      case HB_FT_AUTOINC:
+      case HB_FT_ROWVER:
+         return ptr + pField->uiLen;
+
+      case HB_FT_ANY:
+         if( pField->uiLen == 3 || pField->uiLen == 4 )
+            return ptr + pField->uiLen;
+         switch( *ptr )
+         {
+            case 'D':
+               return ptr + 9;
+
+            case 'L':
+               return ptr + 2;
+
+            case 'N':
+               return ptr + 2 + ( ( ( HB_UCHAR ) ptr[ 1 ] ) & 0xFF );
+
+            case 'C':
+               return ptr + 3 + leto_b2n( ptr + 1, 2 );
+         }
+         return ptr + 1;
+   }
+
+   return ptr;
+}
+
+/* decode a field of active record left by DBI_LAZYDECODE, uiIndex zero based */
+void leto_RecDecode( LETOTABLE * pTable, HB_USHORT uiIndex )
+{
+   if( pTable->uiLazyPending && pTable->pulLazyPos[ uiIndex ] )
+   {
+      leto_ParseField( pTable, uiIndex, ( const char * ) pTable->pLazyRec + pTable->pulLazyPos[ uiIndex ] - 1 );
+      pTable->pulLazyPos[ uiIndex ] = 0;
+      pTable->uiLazyPending--;
+   }
+}
+
+void leto_RecDecodeAll( LETOTABLE * pTable )
+{
+   HB_USHORT uiIndex;
+
+   for( uiIndex = 0; pTable->uiLazyPending && uiIndex < pTable->uiFieldExtent; uiIndex++ )
+      leto_RecDecode( pTable, uiIndex );
+}
+
 void leto_ParseRecord( LETOCONNECTION * pConnection, LETOTABLE * pTable, const char * szData )
 {
    const char * ptr = szData + 3;  /* after leading UINT24 */
 
    if( *ptr == 0x40 )
-      pTable->fBof = pTable->fEof = pTable->fRecLocked = pTable->fDeleted = pTable->fFound = HB_FALSE;
+      pTable->fBof = pTable->fEof = pTable->fRecLocked = pTable->fDeleted = pTable->fFound = pTable->fRecPartial = HB_FALSE;
    else
    {
       pTable->fBof = ( *ptr & LETO_FLG_BOF );
@@ -2759,11 +3647,29 @@ void leto_ParseRecord( LETOCONNECTION * pConnection, LETOTABLE * pTable, const c
       pTable->fRecLocked = ( *ptr & LETO_FLG_LOCKED );
       pTable->fDeleted = ( *ptr & LETO_FLG_DEL );
       pTable->fFound = ( *ptr & LETO_FLG_FOUND );
+      pTable->fRecPartial = ( *ptr & LETO_FLG_PARTIAL ) && pTable->pFieldSel;
    }
    pTable->ulRecNo = HB_GET_LE_UINT32( ( const HB_BYTE * ) ( ptr + 1 ) );
+   pTable->fRecStale = HB_FALSE;
    ptr += 6;  /* data above + ';' */
+   leto_LazyReset( pTable );
 
-   if( pConnection->iZipRecord >= 0 )
+   if( pConnection->iZipRecord >= 0 && pTable->fRecPartial )  /* delete flag plus selected fields */
+   {
+      HB_USHORT uiCount;
+
+      memset( pTable->pRecord, ' ', pTable->uiRecordLen );
+      pTable->pRecord[ 0 ] = *ptr++;
+      for( uiCount = 0; uiCount < pTable->uiFieldExtent; uiCount++ )
+      {
+         if( pTable->pFieldSel[ uiCount ] )
+         {
+            memcpy( pTable->pRecord + pTable->pFieldOffset[ uiCount ], ptr, pTable->pFields[ uiCount ].uiLen );
+            ptr += pTable->pFields[ uiCount ].uiLen;
+         }
+      }
+   }
+   else if( pConnection->iZipRecord >= 0 )
    {
       memcpy( pTable->pRecord, ptr, pTable->uiRecordLen );   /* new: WITH delete flag */
       ptr += pTable->uiRecordLen;
@@ -2775,139 +3681,53 @@ void leto_ParseRecord( LETOCONNECTION * pConnection, LETOTABLE * pTable, const c
    }
    else
    {
-      LETOFIELD * pField = pTable->pFields;
-      HB_UCHAR    uLenLen;
-      HB_USHORT   uiLen, uiCount;
-      char *      ptrRec;
+      HB_USHORT uiCount;
 
       /* blank whole record with most common ' ' to spare these tiny memset's in loop */
       memset( pTable->pRecord, ' ', pTable->uiRecordLen );
       if( pTable->fDeleted )
          pTable->pRecord[ 0 ] = '*';
 
-      for( uiCount = 0; uiCount < pTable->uiFieldExtent; uiCount++, pField++ )
+      if( pTable->fLazyDecode )  /* only note field positions, decoded at first access */
       {
-         ptrRec = ( char * ) pTable->pRecord + pTable->pFieldOffset[ uiCount ];
-         uLenLen = ( ( HB_UCHAR ) *ptr ) & 0xFF;
-
-         if( ! uLenLen && ! pTable->pFieldIsBinary[ uiCount ] )
-         {
-            if( pField->uiType == HB_FT_LOGICAL )
-               *ptrRec = 'F';
-
-            ptr++;
-            if( pField->uiType == HB_FT_STRING && pField->uiLen > 255 )
-               ptr++;
-         }
-         else  /* not empty field or binary type */
-         {
-            switch( pField->uiType )
-            {
-               case HB_FT_STRING:
-                  ptr++;
-                  if( pField->uiLen < 256 )
-                  {
-                     memcpy( ptrRec, ptr, uLenLen );
-                     ptr += uLenLen;
-                  }
-                  else
-                  {
-                     uiLen = ( HB_USHORT ) leto_b2n( ptr, uLenLen );
-                     ptr += uLenLen;
-                     memcpy( ptrRec, ptr, uiLen );
-                     ptr += uiLen;
-                  }
-                  break;
-
-               case HB_FT_LONG:
-               case HB_FT_FLOAT:
-                  ptr++;
-                  ptrRec += ( pField->uiLen - uLenLen );
-                  memcpy( ptrRec, ptr, uLenLen );
-                  ptr += uLenLen;
-                  break;
-
-               case HB_FT_DATE:
-                  memcpy( ptrRec, ptr, pField->uiLen );
-                  ptr += pField->uiLen;
-                  break;
-
-               case HB_FT_LOGICAL:
-                  *ptrRec = *ptr++;
-                  break;
-
-               case HB_FT_MEMO:
-               case HB_FT_BLOB:
-               case HB_FT_PICTURE:
-               case HB_FT_OLE:
-                  /* empty memo field allready sorted out */
-                  if( pField->uiLen == 4 )
-                  {
-                     memcpy( ptrRec, ptr, pField->uiLen );
-                     ptr += pField->uiLen;
-                  }
-                  else  /* changed to be conform with ZIP traffic: using rightmost char */
-                  {
-                     ptrRec[ pField->uiLen - 1 ] = '1';
-                     ptr++;
-                  }
-                  break;
-
-               /* binary fields */
-               case HB_FT_INTEGER:
-               case HB_FT_CURRENCY:
-               case HB_FT_DOUBLE:
-               case HB_FT_CURDOUBLE:
-               case HB_FT_TIME:
-               case HB_FT_MODTIME:
-               case HB_FT_TIMESTAMP:
-               case HB_FT_AUTOINC:
-               case HB_FT_ROWVER:
-                  memcpy( ptrRec, ptr, pField->uiLen );
-                  ptr += pField->uiLen;
-                  break;
-
-               case HB_FT_ANY:
-                  if( pField->uiLen == 3 || pField->uiLen == 4 )
-                  {
-                     memcpy( ptrRec, ptr, pField->uiLen );
-                     ptr += pField->uiLen;
-                  }
-                  else
-                  {
-                     *ptrRec++ = *ptr;
-                     switch( *ptr++ )
-                     {
-                        case 'D':
-                           memcpy( ptrRec, ptr, 8 );  /* reverse for hb_itemGetDS() */
-                           ptr += 8;
-                           break;
-
-                        case 'L':
-                           *ptrRec = *ptr++;
-                           break;
-
-                        case 'N':
-                           uiLen = ( ( HB_UCHAR ) *ptr ) & 0xFF;
-                           memcpy( ptrRec + ( pField->uiLen - uiLen ), ptr, uiLen );
-                           ptr += uiLen + 1;
-                           break;
+         const char *  ptrStart = ptr;
+         unsigned long ulLen;
 
-                        case 'C':
-                           uiLen = ( HB_USHORT ) leto_b2n( ptr, 2 );
-                           memcpy( ptrRec, ptr, uiLen + 2 );
-                           ptr += uiLen + 2;
-                           break;
-                     }
-                  }
-                  break;
-            }
+         for( uiCount = 0; uiCount < pTable->uiFieldExtent; uiCount++ )
+         {
+            if( pTable->fRecPartial && ! pTable->pFieldSel[ uiCount ] )
+               continue;
+            pTable->pulLazyPos[ uiCount ] = ( unsigned long ) ( ptr - ptrStart ) + 1;
+            ptr = leto_SkipField( pTable, uiCount, ptr );
+            pTable->uiLazyPending++;
+         }
+
+         /* copy, as skip buffer or record cache may be released before access */
+         ulLen = ( unsigned long ) ( ptr - ptrStart );
+         if( ulLen > pTable->ulLazyAlloc )
+         {
+            pTable->ulLazyAlloc = ulLen + ulLen / 4;
+            pTable->pLazyRec = ( unsigned char * ) hb_xrealloc( pTable->pLazyRec, pTable->ulLazyAlloc );
+         }
+         memcpy( pTable->pLazyRec, ptrStart, ulLen );
+      }
+      else
+      {
+         for( uiCount = 0; uiCount < pTable->uiFieldExtent; uiCount++ )
+         {
+            if( pTable->fRecPartial && ! pTable->pFieldSel[ uiCount ] )  /* not in projection, fetched on demand */
+               continue;
+            ptr = leto_ParseField( pTable, uiCount, ptr );
          }
       }
    }
 
    pTable->ulRecCount = HB_GET_LE_UINT32( ( const HB_BYTE * ) ptr + 1 );  /* after a ';' */
 
+   pTable->ulMemoInlineLen = 0;
+   if( pTable->ulMemoInline && ! pTable->fEof )
+      leto_ParseMemoInline( pTable, ptr + 5, szData + 3 + HB_GET_LE_UINT24( szData ) );
+
 #ifdef LETO_CLIENTLOG
    leto_clientlog( NULL, 0, "leto_ParseRecord() processed record %lu of %lu", pTable->ulRecNo, pTable->ulRecCount );
 #endif
@@ -2960,6 +3780,7 @@ void leto_ParseRecord( LETOCONNECTION * pConnection, LETOTABLE * pTable, const c
                      long         lUpd, l;
                      char *       ptrRec;
 
+                     leto_RecDecodeAll( pTable );
                      lUpd = strtol( ++ptrPar, &ptrPar, 10 );
 #ifdef LETO_CLIENTLOG
                      leto_clientlog( NULL, 0, "leto_ParseRecord transaction recno %lu WA %lu fields %ld", pTable->ulRecNo, pTable->hTable, lUpd );
@@ -3119,9 +3940,23 @@ static const char * leto_ReadMemoInfo( LETOTABLE * pTable, const char * ptr )
 
 #ifndef LETO_NO_THREAD
 
+/* LETONOTIFY is shared by connection and detached leto_elch() thread, the last one frees it */
+static void leto_NotifyRelease( LETONOTIFY * pNotify )
+{
+   HB_BOOL fFree;
+
+   HB_GC_LOCKE();
+   pNotify->fAlive = HB_FALSE;
+   fFree = --pNotify->iRefs == 0;
+   HB_GC_UNLOCKE();
+   if( fFree )
+      hb_xfree( pNotify );
+}
+
 static HB_THREAD_STARTFUNC( leto_elch )
 {
    LETOCONNECTION * pConnection = ( LETOCONNECTION * ) Cargo;
+   LETONOTIFY *     pNotify = pConnection->pNotify;
    HB_SOCKET        hSocket = pConnection->hSocketErr;
    HB_BOOL          fPipeControl = pConnection->hSockPipe[ 0 ] != FS_ERROR;
    HB_FHANDLE       hPipe = pConnection->hSockPipe[ 0 ];
@@ -3242,6 +4077,25 @@ static HB_THREAD_STARTFUNC( leto_elch )
             else
                break;
          }
+         else if( *ptr == '!' && *( ptr + 1 ) == 'N' )  /* change note: "!N;hTable;cType;ulFrom;ulTo;" */
+         {
+            if( pNotify && ulRead > 4 )
+            {
+               LETONOTIFYEVENT   Event;
+               LETONOTIFYEVENT * pEvent;
+
+               Event.hTable = strtoul( ptr + 3, &ptr, 10 );
+               Event.cType = *( ++ptr );
+               Event.ulFrom = strtoul( ptr + 2, &ptr, 10 );
+               Event.ulTo = strtoul( ptr + 1, NULL, 10 );
+
+               HB_GC_LOCKE();
+               pEvent = pNotify->aEvents + pNotify->ulSeq % LETO_NOTIFY_EVENTS;
+               *pEvent = Event;
+               pNotify->ulSeq++;
+               HB_GC_UNLOCKE();
+            }
+         }
          else if( *ptr == '-' )  /* should be an error */
          {
             int    iError = 0;
@@ -3365,6 +4219,9 @@ static HB_THREAD_STARTFUNC( leto_elch )
    leto_clientlog( NULL, 0, "DEBUG thread leto_elch( %u ) ended", uiConnection );
 #endif
 
+   if( pNotify )
+      leto_NotifyRelease( pNotify );
+
    HB_THREAD_END
 }
 
@@ -3617,6 +4474,9 @@ void LetoConnectionOpen( LETOCONNECTION * pConnection, const char * szAddr, int
                            else
    #endif
                            {
+                              pConnection->pNotify = ( LETONOTIFY * ) hb_xgrabz( sizeof( LETONOTIFY ) );
+                              pConnection->pNotify->iRefs = 2;
+                              pConnection->pNotify->fAlive = HB_TRUE;
    #ifndef __XHARBOUR__
                               pConnection->hThread = hb_threadCreate( &pConnection->hThreadID, leto_elch, ( void * ) pConnection );
    #else
@@ -3624,6 +4484,8 @@ void LetoConnectionOpen( LETOCONNECTION * pConnection, const char * szAddr, int
    #endif
                               if( pConnection->hThread )
                                  hb_threadDetach( pConnection->hThread );
+                              else
+                                 leto_NotifyRelease( pConnection->pNotify );  /* instead of thread */
                            }
 #endif
                         }
@@ -3824,6 +4686,11 @@ void LetoConnectionClose( LETOCONNECTION * pConnection )
    }
 
 #ifndef LETO_NO_THREAD
+   if( pConnection->pNotify )
+   {
+      leto_NotifyRelease( pConnection->pNotify );
+      pConnection->pNotify = NULL;
+   }
    if( pConnection->hSocketErr )
    {
       hb_socketShutdown( pConnection->hSocketErr, HB_SOCKET_SHUT_RDWR  );
@@ -4346,6 +5213,35 @@ HB_ERRCODE LetoDbExists( LETOCONNECTION * pConnection, const char * szTFileName,
    return HB_FAILURE;
 }
 
+#if defined( USE_LZ4 ) && ! defined( LETO_NO_LZ4DICT )
+/* with active compression fetch the dictionary the server has sampled from records of the table,
+ * the server then uses it for all answers of this area -- registered for the connection with same ID;
+ * a zero length means the dictionary for this ID is already known from another table */
+static void leto_LZ4DictRequest( LETOCONNECTION * pConnection, LETOTABLE * pTable )
+{
+   char     szData[ 48 ];
+   HB_ULONG ulLen;
+
+   if( ! pConnection->zstream || pConnection->iZipRecord <= 0 || pTable->fMemIO )
+      return;
+
+   ulLen = eprintf( szData, "%c;%lu;%d;;", LETOCMD_dbi, pTable->hTable, DBI_LZ4DICT );
+   if( leto_DataSendRecv( pConnection, szData, ulLen ) && *pConnection->szBuffer == '+' )
+   {
+      char * ptr;
+      int    iID = ( int ) strtol( pConnection->szBuffer + 1, &ptr, 10 );
+
+      if( iID > 0 && *ptr == ';' )
+      {
+         HB_ULONG ulDict = strtoul( ptr + 1, &ptr, 10 );
+
+         if( ulDict && *ptr == ';' )
+            hb_lz4netDictAdd( ( PHB_LZ4NET ) pConnection->zstream, iID, ptr + 1, ulDict );
+      }
+   }
+}
+#endif
+
 LETOTABLE * LetoDbOpenTable( LETOCONNECTION * pConnection, const char * szFile, const char * szAlias,
                                        HB_BOOL fShared, HB_BOOL fReadOnly, const char * szCdp, unsigned int uiArea )
 {
@@ -4474,6 +5370,9 @@ LETOTABLE * LetoDbOpenTable( LETOCONNECTION * pConnection, const char * szFile,
 
    ptr = leto_ParseTagInfo( pTable, ptr );
    leto_ParseRecord( pConnection, pTable, ptr );
+#if defined( USE_LZ4 ) && ! defined( LETO_NO_LZ4DICT )
+   leto_LZ4DictRequest( pConnection, pTable );
+#endif
 
    return pTable;
 }
@@ -4523,6 +5422,28 @@ HB_ERRCODE LetoDbCloseTable( LETOTABLE * pTable )
       hb_xfree( pTable->pFieldUpd );
       pTable->pFieldUpd = NULL;
    }
+   if( pTable->pFieldSel )
+   {
+      hb_xfree( pTable->pFieldSel );
+      pTable->pFieldSel = NULL;
+   }
+   if( pTable->pRecCache )
+      LetoDbRecCache( pTable, 0, 0 );
+   if( pTable->pLazyRec )
+   {
+      hb_xfree( pTable->pLazyRec );
+      pTable->pLazyRec = NULL;
+   }
+   if( pTable->pulLazyPos )
+   {
+      hb_xfree( pTable->pulLazyPos );
+      pTable->pulLazyPos = NULL;
+   }
+   if( pTable->pMemoInline )
+   {
+      hb_xfree( pTable->pMemoInline );
+      pTable->pMemoInline = NULL;
+   }
 
    if( pTable->pRecord )
    {
@@ -4659,6 +5580,14 @@ const char * LetoDbGetMemo( LETOTABLE * pTable, unsigned int uiIndex, unsigned l
       }
    }
 
+   if( pTable->ulMemoInlineLen )
+   {
+      const char * ptr = leto_MemoInline( pTable, uiIndex, ulLenMemo );
+
+      if( ptr )
+         return ptr;
+   }
+
    ulLen = eprintf( szData, "%c;%lu;%c;%lu;%d;",
                     LETOCMD_memo, pTable->hTable, LETOSUB_get, pTable->ulRecNo, uiIndex );
    if( leto_SendRecv( pConnection, szData, ulLen, 0 ) )
@@ -4667,6 +5596,22 @@ const char * LetoDbGetMemo( LETOTABLE * pTable, unsigned int uiIndex, unsigned l
       return NULL;
 }
 
+/* pipelined request of a memo field, answer fetched with LetoAsyncRecv(), then decoded with leto_DecryptText().
+ * Not for records changed in an active transaction, use LetoDbGetMemo() for them */
+unsigned long LetoDbGetMemoAsync( LETOTABLE * pTable, unsigned int uiIndex )
+{
+   LETOCONNECTION * pConnection = letoGetConnPool( pTable->uiConnection );
+   char             szData[ 32 ];
+   unsigned long    ulLen;
+
+   if( ! pTable->ulRecNo || ! uiIndex || ( ( HB_USHORT ) uiIndex ) > pTable->uiFieldExtent )
+      return 0;
+
+   ulLen = eprintf( szData, "%c;%lu;%c;%lu;%d;",
+                    LETOCMD_memo, pTable->hTable, LETOSUB_get, pTable->ulRecNo, uiIndex );
+   return LetoAsyncSend( pConnection, szData, ulLen );
+}
+
 /* unused */
 unsigned int LetoDbGetField( LETOTABLE * pTable, HB_USHORT uiIndex, char * szRet, unsigned long * ulLen )
 {
@@ -4716,6 +5661,7 @@ unsigned int LetoDbGetField( LETOTABLE * pTable, HB_USHORT uiIndex, char * szRet
    }
    *ulLen = ulFldLen;
 
+   leto_RecDecode( pTable, uiIndex - 1 );
    memcpy( szRet, pTable->pRecord + pTable->pFieldOffset[ uiIndex - 1 ], ulFldLen );
    *( szRet + ulFldLen ) = '\0';
 
@@ -4766,10 +5712,17 @@ HB_ERRCODE LetoDbPutMemo( LETOTABLE * pTable, unsigned int uiIndex, const char *
       return HB_FAILURE;
 
    pField = pTable->pFields + uiIndex - 1;
+   leto_RecDecode( pTable, uiIndex - 1 );
    if( pField->uiLen == 4 )
       HB_PUT_LE_UINT32( &pTable->pRecord[ pTable->pFieldOffset[ uiIndex - 1 ] ], ( ulLenMemo ) ? 1 : 0 );
    else
       pTable->pRecord[ pTable->pFieldOffset[ uiIndex - 1 ] + pField->uiLen - 1 ] = ( ulLenMemo ) ? '1' : ' ';
+   leto_RecCacheDel( pTable, pTable->ulRecNo );
+   if( pTable->ulMemoInline )
+   {
+      pTable->ulMemoInlineLen = 0;
+      pTable->ptrBuf = NULL;  /* old memo content in skip buffer */
+   }
 
    if( pConnection->fTransActive && fAppend )
    {
@@ -4833,6 +5786,7 @@ unsigned int LetoDbPutField( LETOTABLE * pTable, HB_USHORT uiIndex, const char *
    if( ! ulLen || ulLen > ( unsigned long ) pField->uiLen )  /* poss. binary ! */
       return 1;
 
+   leto_RecDecode( pTable, uiIndex - 1 );
    ptr = pTable->pRecord + pTable->pFieldOffset[ uiIndex - 1 ];
 
    if( pField->uiType == HB_FT_DATE )
@@ -5055,6 +6009,7 @@ HB_ERRCODE LetoDbGoTo( LETOTABLE * pTable, unsigned long ulRecNo )
    HB_BOOL          fFound = HB_FALSE;
 
    Leto_VarExprSync( pConnection, pTable->pFilterVar, HB_FALSE );
+   leto_NotifyApply( pConnection, pTable );
 
    /* check hotbuffer also for same ulRecno */
    if( ulRecNo && ulRecNo <= pTable->ulRecCount && pTable->ptrBuf && leto_HotBuffer( pTable ) )
@@ -5091,6 +6046,16 @@ HB_ERRCODE LetoDbGoTo( LETOTABLE * pTable, unsigned long ulRecNo )
 
    }
 
+   if( ! fFound && ulRecNo && pTable->pRecCache && leto_RecCacheGet( pConnection, pTable, ulRecNo ) )
+   {
+#ifdef LETO_CLIENTLOG
+      leto_clientlog( NULL, 0, "LetoDbGoTo found record %lu in record cache", pTable->ulRecNo );
+#endif
+      pTable->ptrBuf = NULL;
+      pTable->Buffer.ulShoots++;
+      fFound = HB_TRUE;
+   }
+
    if( ! fFound )
    {
       char     szData[ 32 ];
@@ -5101,6 +6066,8 @@ HB_ERRCODE LetoDbGoTo( LETOTABLE * pTable, unsigned long ulRecNo )
       if( ! leto_SendRecv( pConnection, szData, ulLen, 1021 ) )
          return 1;
       leto_ParseRecord( pConnection, pTable, leto_firstchar( pConnection ) );
+      if( pTable->pRecCache )
+         leto_RecCacheAdd( pTable, leto_firstchar( pConnection ) );
       pTable->ptrBuf = NULL;
       if( pTable->fAutoRefresh )
          pTable->llCentiSec = leto_MilliSec();
@@ -5109,6 +6076,147 @@ HB_ERRCODE LetoDbGoTo( LETOTABLE * pTable, unsigned long ulRecNo )
    return 0;
 }
 
+/* activate record cache sized for ulCount records, if not already done */
+static void leto_RecCacheFor( LETOTABLE * pTable, unsigned long ulCount )
+{
+   if( ! pTable->pRecCache )
+   {
+      unsigned long ulRecs = HB_MIN( ulCount, 0x10000 );
+      unsigned long ulBytes = HB_MIN( ulRecs * ( pTable->uiRecordLen + 16 ), 0x4000000 );
+
+      LetoDbRecCache( pTable, ( unsigned int ) ulRecs, HB_MAX( ulBytes, LETO_RECCACHE_MAXBYTES ) );
+   }
+}
+
+/* fetch records of RecNo list into record cache with one request per LETO_GOTOLIST_MAX,
+ * so following LetoDbGoTo() need no server; active record and skip buffer are not touched */
+HB_ERRCODE LetoDbGoToList( LETOTABLE * pTable, const unsigned long * pulRecNo, unsigned long ulCount )
+{
+   LETOCONNECTION * pConnection = letoGetConnPool( pTable->uiConnection );
+   unsigned long    ul = 0, ulChunk, ulLen;
+   char *           szData;
+
+   if( ! ulCount || pConnection->fBufKeyNo || pConnection->fBufKeyCount )
+      return HB_SUCCESS;  /* record cache not used */
+
+   leto_RecCacheFor( pTable, ulCount );
+
+   szData = ( char * ) hb_xgrab( HB_MIN( ulCount, LETO_GOTOLIST_MAX ) * 11 + 42 );
+   while( ul < ulCount )
+   {
+      const char *  ptr, * ptrEnd;
+      unsigned long ulRecLen, ulNext = ul;
+
+      for( ulChunk = 0; ulNext < ulCount && ulChunk < LETO_GOTOLIST_MAX; ulNext++ )
+      {
+         if( pulRecNo[ ulNext ] )
+            ulChunk++;
+      }
+      if( ! ulChunk )
+         break;
+      ulLen = eprintf( szData, "%c;%lu;%lu", LETOCMD_golist, pTable->hTable, ulChunk );
+      for( ulChunk = 0; ul < ulNext; ul++ )
+      {
+         if( pulRecNo[ ul ] )
+            ulLen += eprintf( szData + ulLen, "%c%lu", ( char ) ( ulChunk++ ? ',' : ';' ), pulRecNo[ ul ] );
+      }
+      szData[ ulLen++ ] = ';';
+      szData[ ulLen ] = '\0';
+
+      if( ! ( ulLen = leto_SendRecv( pConnection, szData, ulLen, 1021 ) ) )
+      {
+         hb_xfree( szData );
+         return HB_FAILURE;
+      }
+      ptr = leto_firstchar( pConnection );
+      ptrEnd = pConnection->szBuffer + ulLen;
+      while( ptr + 3 < ptrEnd )
+      {
+         ulRecLen = HB_GET_LE_UINT24( ptr );
+         if( ! ulRecLen || ptr + ulRecLen + 3 > ptrEnd )  /* malicious data */
+            break;
+         leto_RecCacheAdd( pTable, ptr );
+         ptr += ulRecLen + 3;
+      }
+   }
+   hb_xfree( szData );
+
+   return HB_SUCCESS;
+}
+
+/* szFields: comma separated field numbers to be send with records, NULL or empty for all */
+HB_ERRCODE LetoDbSetFields( LETOTABLE * pTable, const char * szFields )
+{
+   LETOCONNECTION * pConnection = letoGetConnPool( pTable->uiConnection );
+   HB_ULONG         ulLen = szFields ? strlen( szFields ) : 0;
+   char *           szData = ( char * ) hb_xgrab( ulLen + 42 );
+   HB_USHORT        uiCount;
+
+   eprintf( szData, "%c;%lu;%d;%s;", LETOCMD_dbi, pTable->hTable, DBI_LETOFIELDS, szFields ? szFields : "" );
+   if( ! leto_DataSendRecv( pConnection, szData, 0 ) || *pConnection->szBuffer != '+' )
+   {
+      hb_xfree( szData );
+      return HB_FAILURE;
+   }
+   hb_xfree( szData );
+
+   if( pTable->fRecPartial )  /* before pFieldSel changes */
+      LetoDbRecFull( pTable );
+   uiCount = ( HB_USHORT ) atoi( pConnection->szBuffer + 1 );
+   if( uiCount )
+   {
+      const char * ptr = szFields;
+      HB_USHORT    uiField;
+
+      if( ! pTable->pFieldSel )
+         pTable->pFieldSel = ( unsigned char * ) hb_xgrab( pTable->uiFieldExtent );
+      memset( pTable->pFieldSel, 0, pTable->uiFieldExtent );
+      while( *ptr )
+      {
+         uiField = ( HB_USHORT ) strtoul( ptr, ( char ** ) &ptr, 10 );
+         if( uiField && uiField <= pTable->uiFieldExtent )
+            pTable->pFieldSel[ uiField - 1 ] = 1;
+         if( *ptr == ',' )
+            ptr++;
+         else
+            break;
+      }
+   }
+   else if( pTable->pFieldSel )
+   {
+      hb_xfree( pTable->pFieldSel );
+      pTable->pFieldSel = NULL;
+   }
+   pTable->ptrBuf = NULL;  /* skip buffer records have old layout */
+   leto_RecCacheClear( pTable );
+
+   return HB_SUCCESS;
+}
+
+/* re-read active record with all fields, without touching skip buffer */
+HB_ERRCODE LetoDbRecFull( LETOTABLE * pTable )
+{
+   LETOCONNECTION * pConnection = letoGetConnPool( pTable->uiConnection );
+   char             szData[ 32 ];
+   HB_ULONG         ulLen;
+   HB_BOOL          fBof = pTable->fBof, fFound = pTable->fFound;
+
+   if( ! pTable->fRecPartial || ! pTable->ulRecNo )
+      return HB_SUCCESS;
+   if( pTable->uiUpdated )
+      LetoDbPutRecord( pTable );
+
+   ulLen = eprintf( szData, "%c;%lu;%lu;%c;", LETOCMD_goto, pTable->hTable, pTable->ulRecNo,
+                            ( char ) ( ( hb_setGetDeleted() ? 0x41 : 0x40 ) | 0x02 ) );
+   if( ! leto_SendRecv( pConnection, szData, ulLen, 1021 ) )
+      return HB_FAILURE;
+   leto_ParseRecord( pConnection, pTable, leto_firstchar( pConnection ) );
+   pTable->fBof = fBof;  /* GOTO result flags are not of interest */
+   pTable->fFound = fFound;
+
+   return HB_SUCCESS;
+}
+
 HB_ERRCODE LetoDbGoBottom( LETOTABLE * pTable )
 {
    LETOCONNECTION * pConnection = letoGetConnPool( pTable->uiConnection );
@@ -5155,16 +6263,71 @@ HB_ERRCODE LetoDbGoTop( LETOTABLE * pTable )
    return 0;
 }
 
+/* read-ahead: with more than half of skip buffer consumed, request the next one pipelined from last
+ * record of buffer, to be collected by LetoDbSkip(). Lost, if meanwhile another request collects it */
+static void leto_PrefetchSend( LETOCONNECTION * pConnection, LETOTABLE * pTable )
+{
+   unsigned char * ptrBuf = pTable->ptrBuf, * ptrLast;
+   char            sData[ 48 ];
+   unsigned long   ulLen;
+
+   if( pTable->ulPrefetchID || pTable->iBufRefreshTime < 0 || LetoAsyncPending( pConnection ) ||
+       ( unsigned long ) ( ptrBuf - pTable->Buffer.pBuffer ) < pTable->Buffer.ulBufDataLen / 2 )
+      return;
+
+   do
+   {
+      ptrLast = ptrBuf;
+      ptrBuf += HB_GET_LE_UINT24( ptrBuf ) + 3;
+   }
+   while( ! leto_OutBuffer( &pTable->Buffer, ( char * ) ptrBuf ) );
+   if( ptrLast[ 3 ] & ( LETO_FLG_BOF | LETO_FLG_EOF ) )  /* end of table already in buffer */
+      return;
+
+   ulLen = eprintf( sData, "%c;%lu;%d;%lu;%c;T;1;", LETOCMD_skip, pTable->hTable, ( int ) pTable->BufDirection,
+                    HB_GET_LE_UINT32( ptrLast + 4 ), ( char ) ( ( hb_setGetDeleted() ) ? 0x41 : 0x40 ) );
+   pTable->ulPrefetchID = LetoAsyncSend( pConnection, sData, ulLen );
+   if( pTable->ulPrefetchID )
+   {
+      pTable->ulPrefetchRec = HB_GET_LE_UINT32( ptrLast + 4 );
+      pTable->llPrefetchTime = leto_MilliSec();
+   }
+   else
+      pConnection->iError = 0;  /* retried as usual request */
+}
+
+/* answer of read-ahead in szBuffer, returns its length or 0 if gone or outdated */
+static unsigned long leto_PrefetchRecv( LETOCONNECTION * pConnection, LETOTABLE * pTable )
+{
+   unsigned long ulID = 0;
+   long          lRecv = 0;
+
+   /* still pending, not collected by any request in between */
+   if( pConnection->ulPipeSent - pTable->ulPrefetchID < LetoAsyncPending( pConnection ) )
+   {
+      while( ulID != pTable->ulPrefetchID && ( lRecv = LetoAsyncRecv( pConnection, &ulID ) ) > 0 )
+         ;
+      if( lRecv <= 0 || *pConnection->szBuffer != '+' )
+         lRecv = 0;
+      else if( pTable->iBufRefreshTime && ( int ) leto_MilliDiff( pTable->llPrefetchTime ) >= pTable->iBufRefreshTime )
+         lRecv = 0;
+   }
+
+   return ( unsigned long ) lRecv;
+}
+
 HB_ERRCODE LetoDbSkip( LETOTABLE * pTable, long lToSkip )
 {
    LETOCONNECTION * pConnection = letoGetConnPool( pTable->uiConnection );
-   HB_ULONG         ulDataLen;
+   HB_ULONG         ulDataLen = 0;
    const char *     ptr;
    char             sData[ 42 ];
+   HB_BOOL          fPrefetched = HB_FALSE;
 
    if( pTable->uiUpdated )
       LetoDbPutRecord( pTable );
    Leto_VarExprSync( pConnection, pTable->pFilterVar, HB_FALSE );
+   leto_NotifyApply( pConnection, pTable );
 
    if( pTable->ptrBuf && leto_HotBuffer( pTable ) )
    {
@@ -5217,16 +6380,28 @@ HB_ERRCODE LetoDbSkip( LETOTABLE * pTable, long lToSkip )
          {
             leto_ParseRecord( pConnection, pTable, ( char * ) pTable->ptrBuf );
             pTable->Buffer.ulShoots++;
+            if( pTable->fPrefetch && lToSkip == pTable->BufDirection )
+               leto_PrefetchSend( pConnection, pTable );
             return 0;
          }
       }
    }
 
-   /* if( lToSkip == 0 || pTable->iBufRefreshTime < 0 ) will fetch only one record */
-   ulDataLen = eprintf( sData, "%c;%lu;%ld;%lu;%c;%c;", LETOCMD_skip, pTable->hTable, lToSkip,
-                        pTable->ulRecNo, ( char ) ( ( hb_setGetDeleted() ) ? 0x41 : 0x40 ),
-                        pTable->iBufRefreshTime >= 0 ? 'T' : 'F'  );
-   ulDataLen = leto_SendRecv( pConnection, sData, ulDataLen, 1020 );
+   if( pTable->ulPrefetchID )
+   {
+      if( lToSkip == pTable->BufDirection && pTable->ulRecNo == pTable->ulPrefetchRec )
+         fPrefetched = ( ulDataLen = leto_PrefetchRecv( pConnection, pTable ) ) > 0;
+      pTable->ulPrefetchID = 0;
+   }
+   if( ! fPrefetched )
+   {
+      /* if( lToSkip == 0 || pTable->iBufRefreshTime < 0 ) will fetch only one record,
+       * trailing '1' accepts a window of records on other side of target */
+      ulDataLen = eprintf( sData, "%c;%lu;%ld;%lu;%c;%c;1;", LETOCMD_skip, pTable->hTable, lToSkip,
+                           pTable->ulRecNo, ( char ) ( ( hb_setGetDeleted() ) ? 0x41 : 0x40 ),
+                           pTable->iBufRefreshTime >= 0 ? 'T' : 'F'  );
+      ulDataLen = leto_SendRecv( pConnection, sData, ulDataLen, 1020 );
+   }
    if( ! ulDataLen-- )  /* first char is '+' */
       return 1;
 
@@ -5236,7 +6411,9 @@ HB_ERRCODE LetoDbSkip( LETOTABLE * pTable, long lToSkip )
    {
       leto_setSkipBuf( pTable, ptr, ulDataLen );
       pTable->BufDirection = ( lToSkip > 0 ? 1 : -1 );
-      pTable->uiRecInBuf = 0;
+      pTable->Buffer.ulFetches++;
+      if( fPrefetched )  /* age of data */
+         pTable->llCentiSec = pTable->llPrefetchTime;
    }
    else
    {
@@ -5269,6 +6446,8 @@ HB_ERRCODE LetoDbSeek( LETOTABLE * pTable, const char * szKey, HB_USHORT uiKeyLe
          return 1;
 
       leto_ParseRecord( pConnection, pTable, leto_firstchar( pConnection ) );
+      if( pTable->pRecCache )
+         leto_RecCacheAdd( pTable, leto_firstchar( pConnection ) );
       pTable->ptrBuf = NULL;
       if( pTable->fAutoRefresh )
          pTable->llCentiSec = leto_MilliSec();
@@ -5277,6 +6456,78 @@ HB_ERRCODE LetoDbSeek( LETOTABLE * pTable, const char * szKey, HB_USHORT uiKeyLe
    return 0;
 }
 
+/* seek ulCount keys of active order with one request per LETO_SEEKLIST_MAX, puiKeyLen NULL for strlen();
+ * pulRecNo receives RecNo or 0 if EOF, pfFound [ optional ] if key was found, with fRecords the records
+ * are fetched into record cache for following LetoDbGoTo(); active record and skip buffer are not touched */
+HB_ERRCODE LetoDbSeekList( LETOTABLE * pTable, const char ** pszKeys, const HB_USHORT * puiKeyLen, unsigned long ulCount,
+                           HB_BOOL fSoftSeek, HB_BOOL fRecords, unsigned long * pulRecNo, HB_BOOL * pfFound )
+{
+   LETOCONNECTION * pConnection = letoGetConnPool( pTable->uiConnection );
+   unsigned long    ul = 0, ulChunk, ulLen, ulNext;
+   char *           szData;
+
+   if( ! ulCount )
+      return HB_SUCCESS;
+   if( pTable->uiUpdated )
+      LetoDbPutRecord( pTable );
+   Leto_VarExprSync( pConnection, pTable->pFilterVar, HB_FALSE );
+   if( fRecords && ! pConnection->fBufKeyNo && ! pConnection->fBufKeyCount )
+      leto_RecCacheFor( pTable, ulCount );
+   else
+      fRecords = HB_FALSE;
+
+   szData = ( char * ) hb_xgrab( HB_MIN( ulCount, LETO_SEEKLIST_MAX ) * ( LETO_MAX_KEY + 1 ) + 42 );
+   while( ul < ulCount )
+   {
+      const char *  ptr, * ptrEnd;
+      unsigned long ulRecLen;
+
+      ulChunk = HB_MIN( ulCount - ul, LETO_SEEKLIST_MAX );
+      ulLen = eprintf( szData, "%c;%lu;%c;%lu;", LETOCMD_seeklist, pTable->hTable,
+                       ( char ) ( ( ( hb_setGetDeleted() ) ? 0x41 : 0x40 )
+                                  | ( fSoftSeek ? 0x10 : 0 )
+                                  | ( fRecords ? 0 : 0x02 ) ), ulChunk );
+      for( ulNext = ul; ulNext < ul + ulChunk; ulNext++ )
+         leto_AddKeyToBuf( szData, pszKeys[ ulNext ], HB_MIN( puiKeyLen ? puiKeyLen[ ulNext ] : strlen( pszKeys[ ulNext ] ), LETO_MAX_KEY ), &ulLen );
+
+      if( ! ( ulLen = leto_SendRecv( pConnection, szData, ulLen, 1021 ) ) )
+      {
+         hb_xfree( szData );
+         return HB_FAILURE;
+      }
+      ptr = leto_firstchar( pConnection );
+      ptrEnd = pConnection->szBuffer + ulLen;
+      for( ; ul < ulNext; ul++ )
+      {
+         ulRecLen = fRecords ? HB_GET_LE_UINT24( ptr ) + 3 : 5;
+         if( ptr + ulRecLen > ptrEnd || ulRecLen < 5 )  /* malicious data */
+            break;
+         if( fRecords )
+         {
+            pulRecNo[ ul ] = ( ptr[ 3 ] & LETO_FLG_EOF ) ? 0 : HB_GET_LE_UINT32( ptr + 4 );
+            if( pfFound )
+               pfFound[ ul ] = ( ptr[ 3 ] & LETO_FLG_FOUND ) ? HB_TRUE : HB_FALSE;
+            leto_RecCacheAdd( pTable, ptr );
+         }
+         else
+         {
+            pulRecNo[ ul ] = HB_GET_LE_UINT32( ptr + 1 );
+            if( pfFound )
+               pfFound[ ul ] = ( *ptr & LETO_FLG_FOUND ) ? HB_TRUE : HB_FALSE;
+         }
+         ptr += ulRecLen;
+      }
+      if( ul < ulNext )
+      {
+         hb_xfree( szData );
+         return HB_FAILURE;
+      }
+   }
+   hb_xfree( szData );
+
+   return HB_SUCCESS;
+}
+
 HB_ERRCODE LetoDbClearFilter( LETOTABLE * pTable )
 {
    LETOCONNECTION * pConnection = letoGetConnPool( pTable->uiConnection );
@@ -5414,11 +6665,15 @@ HB_ERRCODE LetoDbPutRecord( LETOTABLE * pTable )
    if( fAppend )
       cUnlockFlag = ( pTable->uiUpdated & LETO_FLAG_UPD_UNLOCK ) ? '1' : '0';
    else
+   {
       cUnlockFlag = ( pTable->uiUpdated & LETO_FLAG_UPD_UNLOCK ) ? '0' : ' ';
+      leto_RecCacheDel( pTable, pTable->ulRecNo );
+   }
 
    if( pTable->fReadonly )
       return HB_FAILURE;
 
+   leto_RecDecodeAll( pTable );
    for( ui = 0; ui < pTable->uiFieldExtent; ui++ )
    {
       if( ( pTable->uiUpdated & LETO_FLAG_UPD_ALL ) )  /* pTable->fHaveMemo */
@@ -5775,6 +7030,8 @@ HB_ERRCODE LetoDbEval( LETOTABLE * pTable, const char * szBlock, const char * sz
 
    if( pTable->ptrBuf && ( ulRecNo != pTable->ulRecNo || fNeedLock ) )
       pTable->ptrBuf = NULL;
+   if( fNeedLock || szBlock )  /* block may have changed records */
+      leto_RecCacheClear( pTable );
    if( pTable->fAutoRefresh )
       pTable->llCentiSec = leto_MilliSec();
 
@@ -6024,6 +7281,7 @@ HB_ERRCODE LetoDbRecLock( LETOTABLE * pTable, unsigned long ulRecNo )
    if( pTable->fFLocked )  /* release file lock beforehand */
       LetoDbFileUnLock( pTable );
 
+   leto_RecCacheDel( pTable, ulRecNo );
    ulLen = eprintf( szData, "%c;%lu;r;%lu;%d;", LETOCMD_lock, pTable->hTable, ulRecNo, pConnection->iLockTimeOut );
    if( ! leto_SendRecv( pConnection, szData, ulLen, 0 ) || leto_checkLockError( pConnection ) )
       return 1;
@@ -6064,6 +7322,7 @@ HB_ERRCODE LetoDbRecUnLock( LETOTABLE * pTable, unsigned long ulRecNo )
 
    if( pTable->uiUpdated )
       LetoDbPutRecord( pTable );
+   leto_RecCacheDel( pTable, ulRecNo );
    ulLen = eprintf( szData, "%c;%lu;r;%lu;", LETOCMD_unlock, pTable->hTable, ulRecNo );
    if( pTable->fModStamp )  /* server answer with record with updated values */
    {
@@ -6190,6 +7449,7 @@ HB_ERRCODE LetoDbPack( LETOTABLE * pTable )
    if( ! leto_SendRecv( pConnection, szData, ulLen, 1021 ) )
       return 1; /* 2; */
    pTable->ptrBuf = NULL;
+   leto_RecCacheClear( pTable );
 
    return 0;
 }
@@ -6212,6 +7472,7 @@ HB_ERRCODE LetoDbZap( LETOTABLE * pTable )
    if( ! leto_SendRecv( pConnection, szData, ulLen, 1021 ) )
       return 1;  /* 2; */
    pTable->ptrBuf = NULL;
+   leto_RecCacheClear( pTable );
 
    return 0;
 }
@@ -6812,6 +8073,65 @@ const char * LetoFileRead( LETOCONNECTION * pConnection, const char * szFile, un
    return NULL;
 }
 
+/* read [ part of ] file with one request: server answers with a stream of messages up to ulStep bytes, each
+ * passed to pFunc( cargo, data, len ). Return 1 == success, 0 == failed, -1 == server does not know this request */
+int LetoFileReadStream( LETOCONNECTION * pConnection, const char * szFile, unsigned long ulStart, unsigned long ulLen,
+                        unsigned long ulStep, LETO_FILESTREAM_FUNC pFunc, void * cargo )
+{
+   char *        pData;
+   unsigned long ulRes, ulTotal, ulRecv = 0;
+   long          lRecv;
+   HB_BOOL       fWriteOk = HB_TRUE;
+
+   pData = ( char * ) hb_xgrab( 48 + strlen( szFile ) );
+   ulRes = eprintf( pData, "%c;19;%s;%lu;%lu;%lu;", LETOCMD_file, szFile, ulStart, ulLen, ulStep );
+
+   ulRes = leto_DataSendRecv( pConnection, pData, ulRes );
+   hb_xfree( pData );
+   if( ulRes > 3 && ! memcmp( pConnection->szBuffer, "+F;", 3 ) )
+   {
+      pConnection->iError = atoi( pConnection->szBuffer + 3 );
+      return pConnection->iError == 1 ? -1 : 0;  /* 1 == also unknown request for older server */
+   }
+   else if( ulRes <= 3 || memcmp( pConnection->szBuffer, "+T;", 3 ) )
+   {
+      if( ! pConnection->iError )
+         pConnection->iError = -1;
+      return 0;
+   }
+
+   ulTotal = strtoul( pConnection->szBuffer + 3, NULL, 10 );
+   pConnection->iError = 0;
+   while( ulRecv < ulTotal )
+   {
+      lRecv = leto_Recv( pConnection );
+      if( lRecv <= 0 )
+      {
+#ifdef LETO_CLIENTLOG
+         leto_clientlog( NULL, 0, "LetoFileReadStream() read error %ld after %lu of %lu bytes", lRecv, ulRecv, ulTotal );
+#endif
+         pConnection->fMustResync = HB_TRUE;
+         pConnection->iError = 1000;
+         return 0;
+      }
+      else if( *pConnection->szBuffer != 'D' )  /* error message ends the stream */
+      {
+         if( lRecv > 3 && ! memcmp( pConnection->szBuffer, "+F;", 3 ) )
+            pConnection->iError = atoi( pConnection->szBuffer + 3 );
+         else
+            pConnection->iError = -1;
+         return 0;
+      }
+
+      ulRecv += lRecv - 1;
+      /* after failure still receive the rest of stream */
+      if( fWriteOk && ! pFunc( cargo, pConnection->szBuffer + 1, lRecv - 1 ) )
+         fWriteOk = HB_FALSE;
+   }
+
+   return fWriteOk ? 1 : 0;
+}
+
 HB_BOOL LetoFileWrite( LETOCONNECTION * pConnection, const char * szFile, const char * szValue, unsigned long ulStart, unsigned long ulLen )
 {
    char *        pData;
@@ -7104,7 +8424,12 @@ int LetoToggleZip( LETOCONNECTION * pConnection, int iZipRecord, const char * sz
       {
          int    iKeyLen = szPassword ? strlen( szPassword ) : 0;
          char * szPass = ( char * ) hb_xgrab( ( iKeyLen + 9 ) * 2 );
-         char   szData[ 96 ];
+         char   szData[ 96 + 2 * LETO_CRYPT_SALTLEN ];
+#ifdef USE_LZ4
+         char    szSalt[ 2 * LETO_CRYPT_SALTLEN ];
+         char    szSaltHex[ 2 * LETO_CRYPT_SALTLEN + 1 ];
+         HB_BOOL fChaCha;
+#endif
 
          if( iKeyLen > 0 && iZipRecord >= 0 )
          {
@@ -7123,7 +8448,19 @@ int LetoToggleZip( LETOCONNECTION * pConnection, int iZipRecord, const char * sz
          else
             szPass[ 0 ] = '\0';
 
+#ifdef USE_LZ4
+         /* offer streaming mode on demand, and the ChaCha20-Poly1305 cipher with the random
+          * client part of salt; older server ignore */
+         memset( szSalt, 0, sizeof( szSalt ) );
+         fChaCha = LETO_CRYPT_CHACHA && iKeyLen > 0 && iZipRecord >= 0 && hb_lz4netRandom( szSalt, LETO_CRYPT_SALTLEN );
+         if( fChaCha )
+            leto_byte2hexchar( szSalt, LETO_CRYPT_SALTLEN, szSaltHex );
+         szSaltHex[ fChaCha ? 2 * LETO_CRYPT_SALTLEN : 0 ] = '\0';
+         eprintf( szData, "%c;%d;%s;%c;%c;%s;", LETOCMD_zip, iZipRecord, szPass,
+                  pConnection->fZipStream && iZipRecord > 0 ? '1' : '0', fChaCha ? '1' : '0', szSaltHex );
+#else
          eprintf( szData, "%c;%d;%s;", LETOCMD_zip, iZipRecord, szPass );
+#endif
          hb_xfree( szPass );
          if( leto_DataSendRecv( pConnection, szData, 0 ) )
          {
@@ -7145,7 +8482,11 @@ int LetoToggleZip( LETOCONNECTION * pConnection, int iZipRecord, const char * sz
                pConnection->iZipRecord = iZipRecord;
 #ifdef USE_LZ4
                if( pConnection->iZipRecord >= 0 && ! pConnection->zstream )
+               {
                   pConnection->zstream = hb_lz4netOpen( pConnection->iZipRecord, HB_ZLIB_STRATEGY_DEFAULT );
+                  if( ptr[ 2 ] == 'S' )  /* server acknowledged streaming mode, older ones ignore it */
+                     hb_lz4netStreamMode( ( PHB_LZ4NET ) pConnection->zstream, HB_TRUE );
+               }
 #else
                if( pConnection->iZipRecord > 0 && ! pConnection->zstream )
                   pConnection->zstream = hb_znetOpen( pConnection->iZipRecord, HB_ZLIB_STRATEGY_DEFAULT );
@@ -7161,6 +8502,12 @@ int LetoToggleZip( LETOCONNECTION * pConnection, int iZipRecord, const char * sz
                      szPW[ i ] ^= pConnection->cDopcode[ i ];
                   }
 #ifdef USE_LZ4
+                  if( ptr[ 1 ] == 'C' )  /* server agreed to ChaCha20, its salt part follows */
+                  {  /* without it keys differ, first message fails authentication */
+                     if( ptr[ 3 ] == ';' && strlen( ptr + 4 ) > 2 * LETO_CRYPT_SALTLEN )
+                        leto_hexchar2byte( ptr + 4, 2 * LETO_CRYPT_SALTLEN, szSalt + LETO_CRYPT_SALTLEN );
+                     hb_lz4netCipher( ( PHB_LZ4NET ) pConnection->zstream, LETO_CIPHER_CHACHA20, szSalt, HB_FALSE );
+                  }
                   hb_lz4netEncryptKey( ( PHB_LZ4NET ) pConnection->zstream, szPW, iKeyLen );
 #else
                   hb_znetEncryptKey( pConnection->zstream, szPW, iKeyLen );
@@ -690,6 +690,13 @@ HB_FUNC( LETO_FCOPYTOSRV )  /* ( cFileLocal, cFileServer, nStepSize ) */
    hb_retl( fSuccess );
 }
 
+static HB_BOOL leto_FileWriteBlock( void * cargo, const char * pData, unsigned long ulLen )
+{
+   HB_SIZE nWrite = hb_fileWrite( ( PHB_FILE ) cargo, pData, ulLen, -1 );
+
+   return nWrite != ( HB_SIZE ) FS_ERROR && nWrite == ulLen;
+}
+
 HB_FUNC( LETO_FCOPYFROMSRV )  /* ( cFileLocal, cFileServer, nStepSize ) */
 {
    HB_BOOL fSuccess = HB_FALSE;
@@ -713,8 +720,12 @@ HB_FUNC( LETO_FCOPYFROMSRV )  /* ( cFileLocal, cFileServer, nStepSize ) */
             HB_ULONG     ulLen;
             HB_SIZE      nWrite = 0;
             const char * ptr;
+            /* whole file with one request, older server need a request for each step */
+            int          iRes = LetoFileReadStream( pConnection, szFile, 0, 0, ( unsigned long ) nStepSize, leto_FileWriteBlock, pFile );
 
-            fSuccess = HB_TRUE;
+            if( iRes == 0 && pConnection->iError )
+               hb_fsSetFError( 14 );
+            fSuccess = iRes < 0;
             while( fSuccess )
             {
                fSuccess = HB_FALSE;
@@ -732,6 +743,8 @@ HB_FUNC( LETO_FCOPYFROMSRV )  /* ( cFileLocal, cFileServer, nStepSize ) */
                   break;
                uStep++;
             }
+            if( iRes > 0 )
+               fSuccess = HB_TRUE;
             hb_fileClose( pFile );
             leto_BufferResize( pConnection );
          }
@@ -1210,8 +1223,8 @@ HB_FUNC( LETO_MGGETINFO )
             const char * ptr2;
             int          i;
 
-            aInfo = hb_itemArrayNew( 18 );
-            for( i = 1; i <= 18; i++ )
+            aInfo = hb_itemArrayNew( 30 );
+            for( i = 1; i <= 30; i++ )
             {
                if( ( ptr2 = LetoFindCmdItem( ptr ) ) == NULL )
                   break;
@@ -2053,6 +2066,7 @@ HB_FUNC( LETO_TOGGLEZIP )
 
    if( pConnection && HB_ISNUM( 1 ) )
    {
+      pConnection->fZipStream = hb_parl( 3 );
       hb_retni( LetoToggleZip( pConnection, hb_parni( 1 ), hb_parc( 2 ) ) );
 
 #ifndef __XHARBOUR__
@@ -2850,6 +2864,7 @@ HB_FUNC( LETO_FTS )
 
    if( pTable && ! pTable->fEof )
    {
+      leto_RecDecodeAll( pTable );
       uiRecordLen = ( HB_USHORT ) pTable->uiRecordLen;
       if( uiRecordLen && uiSearchLen )
       {
@@ -57,7 +57,14 @@
 #endif
 #include "hbatomic.h"
 #include "hbsocket.h"
+#include "hbapirdd.h"
 #include "rddleto.ch"
+#include "funcleto.h"
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+   #include <emmintrin.h>
+   #define LETO_USE_SSE2
+#endif
 
 #if defined( HB_OS_UNIX )
    #include <unistd.h>
@@ -410,6 +417,209 @@ HB_UCHAR leto_n2b( char * s, HB_U32 n )
    return ui;
 }
 
+/* length of string without trailing blanks, 16 bytes per step with SSE2, else 8 */
+HB_SIZE leto_RTrimLen( const char * ptr, HB_SIZE nLen )
+{
+#if defined( LETO_USE_SSE2 )
+   const __m128i vSpace = _mm_set1_epi8( ' ' );
+
+   while( nLen >= 16 )
+   {
+      int iMask = _mm_movemask_epi8( _mm_cmpeq_epi8( _mm_loadu_si128( ( const __m128i * ) ( ptr + nLen - 16 ) ), vSpace ) );
+
+      if( iMask != 0xFFFF )
+      {
+         int i = 15;
+
+         while( iMask & ( 1 << i ) )
+            i--;
+         return nLen - 15 + i;
+      }
+      nLen -= 16;
+   }
+#else
+   HB_U64 u64;
+
+   while( nLen >= 8 )
+   {
+      memcpy( &u64, ptr + nLen - 8, 8 );
+      if( u64 != HB_ULL( 0x2020202020202020 ) )
+         break;
+      nLen -= 8;
+   }
+#endif
+   while( nLen && ptr[ nLen - 1 ] == ' ' )
+      nLen--;
+
+   return nLen;
+}
+
+PLETORECPLAN leto_RecPlanNew( HB_USHORT uiFields )
+{
+   PLETORECPLAN pPlan = ( PLETORECPLAN ) hb_xgrabz( sizeof( LETORECPLAN ) );
+
+   pPlan->pOps = ( LETORECOP * ) hb_xgrab( ( uiFields + 1 ) * sizeof( LETORECOP ) );
+   pPlan->uiOffset = 1;  /* delete flag */
+
+   return pPlan;
+}
+
+void leto_RecPlanFree( PLETORECPLAN pPlan )
+{
+   hb_xfree( pPlan->pOps );
+   hb_xfree( pPlan );
+}
+
+/* add next field of record, HB_FALSE if it needs a workarea to encode */
+HB_BOOL leto_RecPlanAdd( PLETORECPLAN pPlan, HB_USHORT uiType, HB_USHORT uiLen, HB_USHORT uiFlags )
+{
+   HB_USHORT uiOp;
+
+   switch( uiType )
+   {
+      case HB_FT_STRING:
+         if( uiFlags )  /* binary, compressed, encrypted, ... */
+            uiOp = LETO_RECOP_STRBIN;
+         else
+            uiOp = uiLen < 256 ? LETO_RECOP_STR : LETO_RECOP_STRLONG;
+         break;
+
+      case HB_FT_LONG:
+      case HB_FT_FLOAT:
+         uiOp = LETO_RECOP_NUM;
+         break;
+
+      case HB_FT_DATE:
+         uiOp = uiLen == 8 ? LETO_RECOP_DATE : LETO_RECOP_COPY;
+         break;
+
+      case HB_FT_MEMO:
+      case HB_FT_BLOB:
+      case HB_FT_PICTURE:
+      case HB_FT_OLE:
+         uiOp = uiLen == 4 ? LETO_RECOP_COPY : LETO_RECOP_MEMO;
+         break;
+
+      case HB_FT_LOGICAL:
+      case HB_FT_INTEGER:
+      case HB_FT_CURRENCY:
+      case HB_FT_DOUBLE:
+      case HB_FT_CURDOUBLE:
+      case HB_FT_TIME:
+      case HB_FT_MODTIME:
+      case HB_FT_TIMESTAMP:
+      case HB_FT_AUTOINC:
+      case HB_FT_ROWVER:
+         uiOp = LETO_RECOP_COPY;
+         break;
+
+      case HB_FT_ANY:
+         if( uiLen != 3 && uiLen != 4 )
+            return HB_FALSE;
+         uiOp = LETO_RECOP_COPY;
+         break;
+
+      default:  /* not transmitted */
+         uiOp = 0;
+   }
+
+   if( uiOp == LETO_RECOP_COPY && pPlan->uiOps &&
+       pPlan->pOps[ pPlan->uiOps - 1 ].uiOp == LETO_RECOP_COPY &&
+       pPlan->pOps[ pPlan->uiOps - 1 ].uiOffset + pPlan->pOps[ pPlan->uiOps - 1 ].uiLen == pPlan->uiOffset )
+      pPlan->pOps[ pPlan->uiOps - 1 ].uiLen += uiLen;  /* extend run */
+   else if( uiOp )
+   {
+      pPlan->pOps[ pPlan->uiOps ].uiOp = uiOp;
+      pPlan->pOps[ pPlan->uiOps ].uiOffset = pPlan->uiOffset;
+      pPlan->pOps[ pPlan->uiOps ].uiLen = uiLen;
+      pPlan->uiOps++;
+   }
+   pPlan->uiOffset += uiLen;
+
+   return HB_TRUE;
+}
+
+/* encode fields of pRecord [ with leading delete flag ], returns end of encoded data */
+char * leto_RecPlanEncode( const LETORECPLAN * pPlan, const HB_BYTE * pRecord, char * pData )
+{
+   const LETORECOP * pOp = pPlan->pOps;
+   const LETORECOP * pEnd = pOp + pPlan->uiOps;
+   const char *      ptr, * ptrEnd;
+   HB_SIZE           nLen;
+
+   for( ; pOp < pEnd; pOp++ )
+   {
+      ptr = ( const char * ) pRecord + pOp->uiOffset;
+      switch( pOp->uiOp )
+      {
+         case LETO_RECOP_COPY:
+            memcpy( pData, ptr, pOp->uiLen );
+            pData += pOp->uiLen;
+            break;
+
+         case LETO_RECOP_STR:
+            nLen = leto_RTrimLen( ptr, pOp->uiLen );
+            *pData++ = ( char ) nLen;
+            memcpy( pData, ptr, nLen );
+            pData += nLen;
+            break;
+
+         case LETO_RECOP_STRLONG:
+            nLen = leto_RTrimLen( ptr, pOp->uiLen );
+            pData[ 0 ] = ( char ) leto_n2b( pData + 1, ( HB_U32 ) nLen );
+            pData += pData[ 0 ] + 1;
+            memcpy( pData, ptr, nLen );
+            pData += nLen;
+            break;
+
+         case LETO_RECOP_STRBIN:
+            if( pOp->uiLen < 256 )
+               *pData++ = ( char ) pOp->uiLen;
+            else
+            {
+               pData[ 0 ] = ( char ) leto_n2b( pData + 1, pOp->uiLen );
+               pData += pData[ 0 ] + 1;
+            }
+            memcpy( pData, ptr, pOp->uiLen );
+            pData += pOp->uiLen;
+            break;
+
+         case LETO_RECOP_NUM:
+            ptrEnd = ptr + pOp->uiLen - 1;
+            while( ptrEnd > ptr && *ptr == ' ' )
+               ptr++;
+            nLen = ptrEnd - ptr + 1;
+            while( ptrEnd > ptr && ( *ptrEnd == '0' || *ptrEnd == '.' ) )
+               ptrEnd--;
+            if( *ptrEnd == '0' || *ptrEnd == '.' )
+               *pData++ = '\0';
+            else
+            {
+               *pData++ = ( char ) nLen;
+               memcpy( pData, ptr, nLen );
+               pData += nLen;
+            }
+            break;
+
+         case LETO_RECOP_DATE:
+            if( *ptr <= ' ' )
+               *pData++ = '\0';
+            else
+            {
+               memcpy( pData, ptr, 8 );
+               pData += 8;
+            }
+            break;
+
+         case LETO_RECOP_MEMO:
+            *pData++ = ptr[ pOp->uiLen - 1 ] == ' ' ? '\0' : '1';
+            break;
+      }
+   }
+
+   return pData;
+}
+
 #ifdef USE_PMURHASH
 /* fast 'official' PD hashing logic, with possible collisions -- for NON !! security tasks */
 HB_U32 leto_hash( const char * key, int iLen )
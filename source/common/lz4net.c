@@ -49,6 +49,11 @@
  *    iStrategy unused; => pointer to struct
  * hb_lz4netEncryptKey( PHB_LZ4NET pStream, const unsigned char * pPassword, int iPasslen )
  *    activate optional blowfish encrytion, pBfKey is stored in struct
+ * void hb_lz4netCipher( PHB_LZ4NET pStream, int iCipher, const char * pSalt, HB_BOOL fServer )
+ *    select cipher before hb_lz4netEncryptKey(): LETO_CIPHER_BLOWFISH [default] or LETO_CIPHER_CHACHA20,
+ *    the latter needs 2 * LETO_CRYPT_SALTLEN bytes salt: random part of client, then of server
+ * HB_BOOL hb_lz4netRandom( char * pBuf, int iLen )
+ *    fill with bytes from random source of OS; => HB_FALSE if not available
  *
  * HB_ULONG lz4_bfEncrypt( const HB_BLOWFISH * pBfKey, const char * pSrc, HB_SIZE nLen, char * pDest, HB_ULONG * pulLen )
  *    compress [plus encrypt] data into pDest, highest bit of leading U32 length value indicates if compressed
@@ -58,11 +63,44 @@
  *
  * void hb_lz4netClose( PHB_LZ4NET pStream )
  *    free allocated memory in struct
+ *
+ * void hb_lz4netBandwidth( PHB_LZ4NET pStream, HB_ULONG ulBytes, HB_U64 ullMicroSec )
+ *    feed measured network throughput, enables auto-tune of LZ4 acceleration
+ *
+ * int hb_lz4netStat( PHB_LZ4NET pStream, HB_U64 * pullIn, HB_U64 * pullOut, HB_ULONG * pulPacked,
+ *                    HB_ULONG * pulRaw, HB_ULONG * pulSkipped, HB_BOOL fReset )
+ *    statistics of compression policy, returns current acceleration ( 0 = compression paused )
+ *
+ * int hb_lz4netDictAdd( PHB_LZ4NET pStream, int iID, const char * pDict, HB_ULONG ulLen )
+ *    register a dictionary, iID = 0 let choose a free ID; => ID or 0 if full
+ * int hb_lz4netDictFind( PHB_LZ4NET pStream, const char * pDict, HB_ULONG ulLen )
+ *    ID of an equal already registered dictionary, 0 = none
+ * void hb_lz4netDictUse( PHB_LZ4NET pStream, int iID )
+ *    dictionary used to compress the next messages, 0 = none
+ *
+ * HB_BOOL hb_lz4netStreamMode( PHB_LZ4NET pStream, HB_BOOL fStream )
+ *    [de-]activate streaming: messages are compressed against the history of previous ones,
+ *    must be done at same time at both sides; => HB_TRUE if active
+ * HB_BOOL hb_lz4netStreamFailed( PHB_LZ4NET pStream )
+ *    a streamed block could not be decoded, history is out of sync, or a received message failed
+ *    authentication -- connection must be dropped
  */
 
 #include "hbapi.h"
 #include "hbbfish.h"
 
+#if defined( HB_OS_WIN )
+   #include <windows.h>
+   #include <bcrypt.h>
+   #if defined( _MSC_VER )
+      #pragma comment( lib, "bcrypt.lib" )
+   #endif
+#elif defined( HB_OS_UNIX )
+   #include <errno.h>
+   #include <fcntl.h>
+   #include <unistd.h>
+#endif
+
 /* plus compile & link lz4.c, referenced revision: r131, in subdirectory: lib of*/
 /* https://github.com/Cyan4973/lz4 */
 #include <lz4.h>
@@ -73,7 +111,22 @@
 
 #define LZ4_COMPRESS_MINLENGTH  384    /* 5 is logical minimum: min. +1 LZ4 overhead, +4 for uncomp. length */
 #define LZ4_BUFFER_DEFSIZE      65536  /* min default buffer size, alloc + 1 */
+#define LZ4_SAMPLE_MINLENGTH    16384  /* bigger messages are first probed by compressing a sample */
+#define LZ4_SAMPLE_SIZE         4096   /* size of probe taken from middle of message */
+#define LZ4_TUNE_WINDOW         262144 /* raw bytes compressed before acceleration is re-considered */
+#define LZ4_ACCEL_MAX           64     /* max. LZ4 acceleration, above compression is paused */
+#define LZ4_PROBE_INTERVAL      16     /* while paused, each x-th message is compressed to measure */
+#define LZ4_DICT_MAX            16     /* max. count of dictionaries registered for a connection */
+#define LZ4_STREAM_MSGMAX       65536  /* max. message size compressed in streaming mode */
+#define LZ4_STREAM_RINGSIZE     ( 65536 + 8 + LZ4_STREAM_MSGMAX )  /* history ring buffer, same size both sides */
 #define LZ4_BF_CBC                     /* activate CBC mode for Blowfish */
+#define LZ4_CHACHA_NONCE        12     /* ChaCha20 nonce leading each encrypted message: direction + counter */
+#define LZ4_CHACHA_TAG          16     /* Poly1305 tag trailing each encrypted message */
+#define LZ4_KDF_SALTLEN         32     /* salt for ChaCha20 keys, == 2 * LETO_CRYPT_SALTLEN */
+#define LZ4_KDF_ROUNDS          10000  /* PBKDF2-HMAC-SHA256 iterations for ChaCha20 keys */
+
+#define LZ4_CIPHER_CHACHA20     1      /* == LETO_CIPHER_CHACHA20 */
+#define LZ4_ENCRYPTED( p )      ( ( p )->pBfKey || ( p )->pChaKey )
 
 #ifndef HB_BF_CIPHERBLOCK
    #define HB_BF_CIPHERBLOCK    8
@@ -88,19 +141,75 @@ typedef struct _HB_LZ4NET
    HB_BLOWFISH * pBfKey;     /* blowfish en-/de-encrypt key */
    void *        LZ4state;   /* internal used by LZ4 */
    char        * IV;         /* initialization vektor for CBC mode*/
+   HB_BOOL       fPaused;    /* compression costs more than it saves */
+   HB_ULONG      ulProbe;    /* counter of messages while paused */
+   HB_U64        ullBandwidth;  /* measured network throughput in bytes per second, 0 = unknown */
+   HB_U64        ullWinIn;   /* tuning window: raw bytes compressed */
+   HB_U64        ullWinOut;  /* tuning window: resulting bytes */
+   HB_U64        ullWinTime; /* tuning window: microseconds spent to compress */
+   HB_U64        ullStatIn;  /* statistics: raw bytes of compressed messages */
+   HB_U64        ullStatOut; /* statistics: bytes after compression */
+   HB_ULONG      ulPacked;   /* statistics: count of compressed messages */
+   HB_ULONG      ulRaw;      /* statistics: count of messages too small or compression paused/ off */
+   HB_ULONG      ulSkipped;  /* statistics: count of messages found incompressible */
+   char *        pDict[ LZ4_DICT_MAX ];   /* registered dictionaries, index + 1 = ID */
+   int           iDictLen[ LZ4_DICT_MAX ];
+   int           iDictUse;   /* ID of dictionary to use for compression, 0 = none */
+   LZ4_stream_t *       pStreamEnc;  /* streaming mode: history of sent messages */
+   LZ4_streamDecode_t * pStreamDec;  /* streaming mode: history of received messages */
+   char *        pRingEnc;   /* ring buffer keeping the sent messages */
+   char *        pRingDec;   /* ring buffer the received messages are decoded into */
+   HB_ULONG      ulRingEnc;  /* position for next message in ring buffers */
+   HB_ULONG      ulRingDec;
+   HB_USHORT     uiSeqEnc;   /* sequence number of streamed blocks, 15 bit */
+   HB_USHORT     uiSeqDec;
+   HB_BOOL       fStreamErr; /* streamed block not decodable, history lost */
+   int           iCipher;    /* cipher used by hb_lz4netEncryptKey() */
+   HB_U32 *      pChaKey;    /* ChaCha20 keys, 8 x U32 to send, 8 x U32 to receive */
+   char          szChaSalt[ LZ4_KDF_SALTLEN ];  /* salt of key derivation, from both sides */
+   HB_BOOL       fServer;    /* server side of connection, selects keys and nonce direction */
+   HB_U64        ullChaSend; /* counter of sent messages, part of nonce */
+   HB_U64        ullChaRecv; /* counter of last received message, must ever increase */
+   HB_BOOL       fAuthErr;   /* received message failed authentication */
 }
 HB_LZ4NET, * PHB_LZ4NET;
 
+extern HB_U64 leto_MicroSec( void );
+
+static void lz4_streamFree( PHB_LZ4NET pStream, HB_BOOL fEncoder, HB_BOOL fDecoder )
+{
+   if( fEncoder && pStream->pStreamEnc )
+   {
+      hb_xfree( pStream->pStreamEnc );
+      hb_xfree( pStream->pRingEnc );
+      pStream->pStreamEnc = NULL;
+      pStream->pRingEnc = NULL;
+   }
+   if( fDecoder && pStream->pStreamDec )
+   {
+      hb_xfree( pStream->pStreamDec );
+      hb_xfree( pStream->pRingDec );
+      pStream->pStreamDec = NULL;
+      pStream->pRingDec = NULL;
+   }
+}
 
 /* release stream structure */
 void hb_lz4netClose( PHB_LZ4NET pStream )
 {
    if( pStream )
    {
+      int i;
+
       if( pStream->ulBufLen && pStream->pBuffer )
          hb_xfree( pStream->pBuffer );
       if( pStream->pBfKey )
          hb_xfree( pStream->pBfKey );
+      if( pStream->pChaKey )
+      {
+         memset( pStream->pChaKey, 0, 16 * sizeof( HB_U32 ) );
+         hb_xfree( pStream->pChaKey );
+      }
       if( pStream->LZ4state )
          hb_xfree( pStream->LZ4state );
       if( pStream->IV )
@@ -108,6 +217,12 @@ void hb_lz4netClose( PHB_LZ4NET pStream )
          memset( pStream->IV, 0, HB_BF_CIPHERBLOCK );
          hb_xfree( pStream->IV );
       }
+      for( i = 0; i < LZ4_DICT_MAX; i++ )
+      {
+         if( pStream->pDict[ i ] )
+            hb_xfree( pStream->pDict[ i ] );
+      }
+      lz4_streamFree( pStream, HB_TRUE, HB_TRUE );
       hb_xfree( pStream );
    }
 }
@@ -136,10 +251,492 @@ PHB_LZ4NET hb_lz4netOpen( int iLevel, int iStrategy )
    return pStream;
 }
 
+/* ChaCha20 ( RFC 8439 ): 20 rounds over 16 x U32 state, 64 bytes keystream per block */
+#define LZ4_ROTL32( v, n )  ( ( ( v ) << ( n ) ) | ( ( v ) >> ( 32 - ( n ) ) ) )
+#define LZ4_QROUND( a, b, c, d ) \
+   a += b; d ^= a; d = LZ4_ROTL32( d, 16 ); \
+   c += d; b ^= c; b = LZ4_ROTL32( b, 12 ); \
+   a += b; d ^= a; d = LZ4_ROTL32( d, 8 ); \
+   c += d; b ^= c; b = LZ4_ROTL32( b, 7 );
+
+static void lz4_chachaBlock( const HB_U32 * pState, HB_U32 * x )
+{
+   int i;
+
+   memcpy( x, pState, 16 * sizeof( HB_U32 ) );
+   for( i = 0; i < 10; i++ )
+   {
+      LZ4_QROUND( x[ 0 ], x[ 4 ], x[  8 ], x[ 12 ] )
+      LZ4_QROUND( x[ 1 ], x[ 5 ], x[  9 ], x[ 13 ] )
+      LZ4_QROUND( x[ 2 ], x[ 6 ], x[ 10 ], x[ 14 ] )
+      LZ4_QROUND( x[ 3 ], x[ 7 ], x[ 11 ], x[ 15 ] )
+      LZ4_QROUND( x[ 0 ], x[ 5 ], x[ 10 ], x[ 15 ] )
+      LZ4_QROUND( x[ 1 ], x[ 6 ], x[ 11 ], x[ 12 ] )
+      LZ4_QROUND( x[ 2 ], x[ 7 ], x[  8 ], x[ 13 ] )
+      LZ4_QROUND( x[ 3 ], x[ 4 ], x[  9 ], x[ 14 ] )
+   }
+   for( i = 0; i < 16; i++ )
+      x[ i ] += pState[ i ];
+}
+
+/* XOR keystream starting at block ulCounter: pSrc and pDest may be the same, or pSrc ahead of pDest */
+static void lz4_chachaXor( const HB_U32 * pKey, const char * pNonce, HB_U32 ulCounter,
+                           const char * pSrc, char * pDest, HB_SIZE nLen )
+{
+   HB_U32 state[ 16 ], x[ 16 ];
+   int    i;
+
+   state[ 0 ] = 0x61707865;  /* "expand 32-byte k" */
+   state[ 1 ] = 0x3320646e;
+   state[ 2 ] = 0x79622d32;
+   state[ 3 ] = 0x6b206574;
+   memcpy( state + 4, pKey, 8 * sizeof( HB_U32 ) );
+   state[ 12 ] = ulCounter;
+   state[ 13 ] = HB_GET_LE_UINT32( pNonce );
+   state[ 14 ] = HB_GET_LE_UINT32( pNonce + 4 );
+   state[ 15 ] = HB_GET_LE_UINT32( pNonce + 8 );
+
+   while( nLen >= 64 )
+   {
+      lz4_chachaBlock( state, x );
+      for( i = 0; i < 16; i++ )
+         HB_PUT_LE_UINT32( pDest + ( i << 2 ), HB_GET_LE_UINT32( pSrc + ( i << 2 ) ) ^ x[ i ] );
+      state[ 12 ]++;
+      pSrc += 64;
+      pDest += 64;
+      nLen -= 64;
+   }
+   if( nLen )
+   {
+      unsigned char ks[ 64 ];
+
+      lz4_chachaBlock( state, x );
+      for( i = 0; i < 16; i++ )
+         HB_PUT_LE_UINT32( ks + ( i << 2 ), x[ i ] );
+      for( i = 0; i < ( int ) nLen; i++ )
+         pDest[ i ] = pSrc[ i ] ^ ks[ i ];
+      memset( ks, 0, 64 );
+   }
+   memset( x, 0, sizeof( x ) );
+   memset( state + 4, 0, 8 * sizeof( HB_U32 ) );
+}
+
+/* Poly1305 ( RFC 8439 ) with 26 bit limbs, after poly1305-donna ( public domain );
+ * AEAD input is ever padded to full 16 byte blocks */
+typedef struct
+{
+   HB_U32 r[ 5 ];
+   HB_U32 h[ 5 ];
+   HB_U32 pad[ 4 ];
+} LZ4_POLY1305;
+
+static void lz4_polyInit( LZ4_POLY1305 * pPoly, const unsigned char * pKey )
+{
+   pPoly->r[ 0 ] = ( HB_GET_LE_UINT32( pKey ) ) & 0x3ffffff;
+   pPoly->r[ 1 ] = ( HB_GET_LE_UINT32( pKey + 3 ) >> 2 ) & 0x3ffff03;
+   pPoly->r[ 2 ] = ( HB_GET_LE_UINT32( pKey + 6 ) >> 4 ) & 0x3ffc0ff;
+   pPoly->r[ 3 ] = ( HB_GET_LE_UINT32( pKey + 9 ) >> 6 ) & 0x3f03fff;
+   pPoly->r[ 4 ] = ( HB_GET_LE_UINT32( pKey + 12 ) >> 8 ) & 0x00fffff;
+   memset( pPoly->h, 0, sizeof( pPoly->h ) );
+   pPoly->pad[ 0 ] = HB_GET_LE_UINT32( pKey + 16 );
+   pPoly->pad[ 1 ] = HB_GET_LE_UINT32( pKey + 20 );
+   pPoly->pad[ 2 ] = HB_GET_LE_UINT32( pKey + 24 );
+   pPoly->pad[ 3 ] = HB_GET_LE_UINT32( pKey + 28 );
+}
+
+/* nLen bytes, a last partial block is zero padded */
+static void lz4_polyUpdate( LZ4_POLY1305 * pPoly, const unsigned char * pMsg, HB_SIZE nLen )
+{
+   const HB_U32  r0 = pPoly->r[ 0 ], r1 = pPoly->r[ 1 ], r2 = pPoly->r[ 2 ], r3 = pPoly->r[ 3 ], r4 = pPoly->r[ 4 ];
+   const HB_U32  s1 = r1 * 5, s2 = r2 * 5, s3 = r3 * 5, s4 = r4 * 5;
+   HB_U32        h0 = pPoly->h[ 0 ], h1 = pPoly->h[ 1 ], h2 = pPoly->h[ 2 ], h3 = pPoly->h[ 3 ], h4 = pPoly->h[ 4 ];
+   HB_U64        d0, d1, d2, d3, d4;
+   HB_U32        c;
+   unsigned char block[ 16 ];
+
+   while( nLen )
+   {
+      if( nLen < 16 )
+      {
+         memset( block, 0, 16 );
+         memcpy( block, pMsg, nLen );
+         pMsg = block;
+         nLen = 16;
+      }
+      h0 += ( HB_GET_LE_UINT32( pMsg ) ) & 0x3ffffff;
+      h1 += ( HB_GET_LE_UINT32( pMsg + 3 ) >> 2 ) & 0x3ffffff;
+      h2 += ( HB_GET_LE_UINT32( pMsg + 6 ) >> 4 ) & 0x3ffffff;
+      h3 += ( HB_GET_LE_UINT32( pMsg + 9 ) >> 6 ) & 0x3ffffff;
+      h4 += ( HB_GET_LE_UINT32( pMsg + 12 ) >> 8 ) | ( 1 << 24 );
+
+      d0 = ( HB_U64 ) h0 * r0 + ( HB_U64 ) h1 * s4 + ( HB_U64 ) h2 * s3 + ( HB_U64 ) h3 * s2 + ( HB_U64 ) h4 * s1;
+      d1 = ( HB_U64 ) h0 * r1 + ( HB_U64 ) h1 * r0 + ( HB_U64 ) h2 * s4 + ( HB_U64 ) h3 * s3 + ( HB_U64 ) h4 * s2;
+      d2 = ( HB_U64 ) h0 * r2 + ( HB_U64 ) h1 * r1 + ( HB_U64 ) h2 * r0 + ( HB_U64 ) h3 * s4 + ( HB_U64 ) h4 * s3;
+      d3 = ( HB_U64 ) h0 * r3 + ( HB_U64 ) h1 * r2 + ( HB_U64 ) h2 * r1 + ( HB_U64 ) h3 * r0 + ( HB_U64 ) h4 * s4;
+      d4 = ( HB_U64 ) h0 * r4 + ( HB_U64 ) h1 * r3 + ( HB_U64 ) h2 * r2 + ( HB_U64 ) h3 * r1 + ( HB_U64 ) h4 * r0;
+
+      c = ( HB_U32 ) ( d0 >> 26 ); h0 = ( HB_U32 ) d0 & 0x3ffffff;
+      d1 += c; c = ( HB_U32 ) ( d1 >> 26 ); h1 = ( HB_U32 ) d1 & 0x3ffffff;
+      d2 += c; c = ( HB_U32 ) ( d2 >> 26 ); h2 = ( HB_U32 ) d2 & 0x3ffffff;
+      d3 += c; c = ( HB_U32 ) ( d3 >> 26 ); h3 = ( HB_U32 ) d3 & 0x3ffffff;
+      d4 += c; c = ( HB_U32 ) ( d4 >> 26 ); h4 = ( HB_U32 ) d4 & 0x3ffffff;
+      h0 += c * 5; c = h0 >> 26; h0 &= 0x3ffffff;
+      h1 += c;
+
+      pMsg += 16;
+      nLen -= 16;
+   }
+
+   pPoly->h[ 0 ] = h0;
+   pPoly->h[ 1 ] = h1;
+   pPoly->h[ 2 ] = h2;
+   pPoly->h[ 3 ] = h3;
+   pPoly->h[ 4 ] = h4;
+}
+
+static void lz4_polyFinish( LZ4_POLY1305 * pPoly, unsigned char * pTag )
+{
+   HB_U32 h0 = pPoly->h[ 0 ], h1 = pPoly->h[ 1 ], h2 = pPoly->h[ 2 ], h3 = pPoly->h[ 3 ], h4 = pPoly->h[ 4 ];
+   HB_U32 g0, g1, g2, g3, g4, c, mask;
+   HB_U64 f;
+
+   c = h1 >> 26; h1 &= 0x3ffffff;
+   h2 += c; c = h2 >> 26; h2 &= 0x3ffffff;
+   h3 += c; c = h3 >> 26; h3 &= 0x3ffffff;
+   h4 += c; c = h4 >> 26; h4 &= 0x3ffffff;
+   h0 += c * 5; c = h0 >> 26; h0 &= 0x3ffffff;
+   h1 += c;
+
+   /* h - p, taken if not negative */
+   g0 = h0 + 5; c = g0 >> 26; g0 &= 0x3ffffff;
+   g1 = h1 + c; c = g1 >> 26; g1 &= 0x3ffffff;
+   g2 = h2 + c; c = g2 >> 26; g2 &= 0x3ffffff;
+   g3 = h3 + c; c = g3 >> 26; g3 &= 0x3ffffff;
+   g4 = h4 + c - ( 1 << 26 );
+
+   mask = ( g4 >> 31 ) - 1;
+   h0 = ( h0 & ~mask ) | ( g0 & mask );
+   h1 = ( h1 & ~mask ) | ( g1 & mask );
+   h2 = ( h2 & ~mask ) | ( g2 & mask );
+   h3 = ( h3 & ~mask ) | ( g3 & mask );
+   h4 = ( h4 & ~mask ) | ( g4 & mask );
+
+   h0 = h0 | ( h1 << 26 );
+   h1 = ( h1 >> 6 ) | ( h2 << 20 );
+   h2 = ( h2 >> 12 ) | ( h3 << 14 );
+   h3 = ( h3 >> 18 ) | ( h4 << 8 );
+
+   f = ( HB_U64 ) h0 + pPoly->pad[ 0 ];
+   HB_PUT_LE_UINT32( pTag, ( HB_U32 ) f );
+   f = ( HB_U64 ) h1 + pPoly->pad[ 1 ] + ( f >> 32 );
+   HB_PUT_LE_UINT32( pTag + 4, ( HB_U32 ) f );
+   f = ( HB_U64 ) h2 + pPoly->pad[ 2 ] + ( f >> 32 );
+   HB_PUT_LE_UINT32( pTag + 8, ( HB_U32 ) f );
+   f = ( HB_U64 ) h3 + pPoly->pad[ 3 ] + ( f >> 32 );
+   HB_PUT_LE_UINT32( pTag + 12, ( HB_U32 ) f );
+
+   memset( pPoly, 0, sizeof( LZ4_POLY1305 ) );
+}
+
+/* AEAD tag over ciphertext without additional data: one-time key is keystream block 0 */
+static void lz4_chachaTag( const HB_U32 * pKey, const char * pNonce, const char * pCipher, HB_SIZE nLen,
+                           unsigned char * pTag )
+{
+   LZ4_POLY1305  poly;
+   unsigned char polyKey[ 32 ];
+   unsigned char lens[ 16 ];
+
+   memset( polyKey, 0, 32 );
+   lz4_chachaXor( pKey, pNonce, 0, ( const char * ) polyKey, ( char * ) polyKey, 32 );
+   lz4_polyInit( &poly, polyKey );
+   memset( polyKey, 0, 32 );
+   lz4_polyUpdate( &poly, ( const unsigned char * ) pCipher, nLen );
+   HB_PUT_LE_UINT64( lens, 0 );
+   HB_PUT_LE_UINT64( lens + 8, ( HB_U64 ) nLen );
+   lz4_polyUpdate( &poly, lens, 16 );
+   lz4_polyFinish( &poly, pTag );
+}
+
+/* SHA-256 ( FIPS 180-4 ), only used for key derivation */
+typedef struct
+{
+   HB_U32        state[ 8 ];
+   HB_U64        ullLen;
+   unsigned char buf[ 64 ];
+} LZ4_SHA256;
+
+static const HB_U32 s_sha256K[ 64 ] = {
+   0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+   0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+   0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+   0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+   0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+   0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+   0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+   0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2 };
+
+#define LZ4_ROTR32( v, n )  ( ( ( v ) >> ( n ) ) | ( ( v ) << ( 32 - ( n ) ) ) )
+
+static void lz4_sha256Block( HB_U32 * pState, const unsigned char * pBlock )
+{
+   HB_U32 w[ 64 ], a, b, c, d, e, f, g, h, t1, t2;
+   int    i;
+
+   for( i = 0; i < 16; i++ )
+      w[ i ] = HB_GET_BE_UINT32( pBlock + ( i << 2 ) );
+   for( ; i < 64; i++ )
+      w[ i ] = ( LZ4_ROTR32( w[ i - 2 ], 17 ) ^ LZ4_ROTR32( w[ i - 2 ], 19 ) ^ ( w[ i - 2 ] >> 10 ) ) + w[ i - 7 ] +
+               ( LZ4_ROTR32( w[ i - 15 ], 7 ) ^ LZ4_ROTR32( w[ i - 15 ], 18 ) ^ ( w[ i - 15 ] >> 3 ) ) + w[ i - 16 ];
+
+   a = pState[ 0 ]; b = pState[ 1 ]; c = pState[ 2 ]; d = pState[ 3 ];
+   e = pState[ 4 ]; f = pState[ 5 ]; g = pState[ 6 ]; h = pState[ 7 ];
+   for( i = 0; i < 64; i++ )
+   {
+      t1 = h + ( LZ4_ROTR32( e, 6 ) ^ LZ4_ROTR32( e, 11 ) ^ LZ4_ROTR32( e, 25 ) ) + ( ( e & f ) ^ ( ~e & g ) ) +
+           s_sha256K[ i ] + w[ i ];
+      t2 = ( LZ4_ROTR32( a, 2 ) ^ LZ4_ROTR32( a, 13 ) ^ LZ4_ROTR32( a, 22 ) ) + ( ( a & b ) ^ ( a & c ) ^ ( b & c ) );
+      h = g; g = f; f = e; e = d + t1;
+      d = c; c = b; b = a; a = t1 + t2;
+   }
+   pState[ 0 ] += a; pState[ 1 ] += b; pState[ 2 ] += c; pState[ 3 ] += d;
+   pState[ 4 ] += e; pState[ 5 ] += f; pState[ 6 ] += g; pState[ 7 ] += h;
+}
+
+static void lz4_sha256Init( LZ4_SHA256 * pCtx )
+{
+   pCtx->state[ 0 ] = 0x6a09e667; pCtx->state[ 1 ] = 0xbb67ae85;
+   pCtx->state[ 2 ] = 0x3c6ef372; pCtx->state[ 3 ] = 0xa54ff53a;
+   pCtx->state[ 4 ] = 0x510e527f; pCtx->state[ 5 ] = 0x9b05688c;
+   pCtx->state[ 6 ] = 0x1f83d9ab; pCtx->state[ 7 ] = 0x5be0cd19;
+   pCtx->ullLen = 0;
+}
+
+static void lz4_sha256Update( LZ4_SHA256 * pCtx, const unsigned char * pData, HB_SIZE nLen )
+{
+   HB_SIZE nFill = ( HB_SIZE ) ( pCtx->ullLen & 63 );
+
+   pCtx->ullLen += nLen;
+   if( nFill )
+   {
+      HB_SIZE nPart = HB_MIN( nLen, 64 - nFill );
+
+      memcpy( pCtx->buf + nFill, pData, nPart );
+      pData += nPart;
+      nLen -= nPart;
+      if( nFill + nPart < 64 )
+         return;
+      lz4_sha256Block( pCtx->state, pCtx->buf );
+   }
+   while( nLen >= 64 )
+   {
+      lz4_sha256Block( pCtx->state, pData );
+      pData += 64;
+      nLen -= 64;
+   }
+   if( nLen )
+      memcpy( pCtx->buf, pData, nLen );
+}
+
+static void lz4_sha256Final( LZ4_SHA256 * pCtx, unsigned char * pDigest )
+{
+   HB_U64        ullBits = pCtx->ullLen << 3;
+   unsigned char pad[ 72 ];
+   HB_SIZE       nPad = 64 - ( HB_SIZE ) ( ( pCtx->ullLen + 8 ) & 63 );
+   int           i;
+
+   memset( pad, 0, sizeof( pad ) );
+   pad[ 0 ] = 0x80;
+   HB_PUT_BE_UINT64( pad + nPad, ullBits );
+   lz4_sha256Update( pCtx, pad, nPad + 8 );
+   for( i = 0; i < 8; i++ )
+      HB_PUT_BE_UINT32( pDigest + ( i << 2 ), pCtx->state[ i ] );
+   memset( pCtx, 0, sizeof( LZ4_SHA256 ) );
+}
+
+/* PBKDF2-HMAC-SHA256 ( RFC 8018 ), HMAC pads hashed once and re-used for all rounds */
+static void lz4_pbkdf2( const char * pPassword, int iPasslen, const char * pSalt, int iSaltLen,
+                        int iRounds, unsigned char * pKey, int iKeyLen )
+{
+   LZ4_SHA256    ctxInner, ctxOuter, ctx;
+   unsigned char pad[ 64 ], u[ 32 ], t[ 32 ], cnt[ 4 ];
+   HB_U32        ulBlock;
+   int           i, j;
+
+   memset( pad, 0, 64 );
+   if( iPasslen > 64 )
+   {
+      lz4_sha256Init( &ctx );
+      lz4_sha256Update( &ctx, ( const unsigned char * ) pPassword, iPasslen );
+      lz4_sha256Final( &ctx, pad );
+   }
+   else
+      memcpy( pad, pPassword, iPasslen );
+   for( i = 0; i < 64; i++ )
+      pad[ i ] ^= 0x36;
+   lz4_sha256Init( &ctxInner );
+   lz4_sha256Update( &ctxInner, pad, 64 );
+   for( i = 0; i < 64; i++ )
+      pad[ i ] ^= 0x36 ^ 0x5c;
+   lz4_sha256Init( &ctxOuter );
+   lz4_sha256Update( &ctxOuter, pad, 64 );
+   memset( pad, 0, 64 );
+
+   for( ulBlock = 1; iKeyLen > 0; ulBlock++ )
+   {
+      HB_PUT_BE_UINT32( cnt, ulBlock );
+      memcpy( &ctx, &ctxInner, sizeof( LZ4_SHA256 ) );
+      lz4_sha256Update( &ctx, ( const unsigned char * ) pSalt, iSaltLen );
+      lz4_sha256Update( &ctx, cnt, 4 );
+      lz4_sha256Final( &ctx, u );
+      memcpy( &ctx, &ctxOuter, sizeof( LZ4_SHA256 ) );
+      lz4_sha256Update( &ctx, u, 32 );
+      lz4_sha256Final( &ctx, u );
+      memcpy( t, u, 32 );
+      for( i = 1; i < iRounds; i++ )
+      {
+         memcpy( &ctx, &ctxInner, sizeof( LZ4_SHA256 ) );
+         lz4_sha256Update( &ctx, u, 32 );
+         lz4_sha256Final( &ctx, u );
+         memcpy( &ctx, &ctxOuter, sizeof( LZ4_SHA256 ) );
+         lz4_sha256Update( &ctx, u, 32 );
+         lz4_sha256Final( &ctx, u );
+         for( j = 0; j < 32; j++ )
+            t[ j ] ^= u[ j ];
+      }
+      memcpy( pKey, t, HB_MIN( iKeyLen, 32 ) );
+      pKey += 32;
+      iKeyLen -= 32;
+   }
+   memset( u, 0, 32 );
+   memset( t, 0, 32 );
+   memset( &ctxInner, 0, sizeof( LZ4_SHA256 ) );
+   memset( &ctxOuter, 0, sizeof( LZ4_SHA256 ) );
+}
+
+static HB_BOOL lz4_tagEqual( const unsigned char * pTag, const char * pRecv )
+{
+   unsigned char c = 0;
+   int           i;
+
+   for( i = 0; i < LZ4_CHACHA_TAG; i++ )  /* ever all bytes, no early exit */
+      c |= pTag[ i ] ^ ( unsigned char ) pRecv[ i ];
+
+   return c == 0;
+}
+
+/* result is nonce plus encrypted data plus tag, without padding; can be done 'in place' */
+static void lz4_chachaEncrypt( PHB_LZ4NET pStream, const char * pSrc, HB_SIZE nLen, char * pDest, HB_ULONG * pulLen )
+{
+   if( pSrc == pDest )
+   {
+      memmove( pDest + LZ4_CHACHA_NONCE, pSrc, nLen );
+      pSrc = pDest + LZ4_CHACHA_NONCE;
+   }
+   /* own key per direction, counter never repeats as keys are fresh for each connection */
+   pStream->ullChaSend++;
+   HB_PUT_LE_UINT32( pDest, pStream->fServer ? 1 : 0 );
+   HB_PUT_LE_UINT64( pDest + 4, pStream->ullChaSend );
+   lz4_chachaXor( pStream->pChaKey, pDest, 1, pSrc, pDest + LZ4_CHACHA_NONCE, nLen );
+   lz4_chachaTag( pStream->pChaKey, pDest, pDest + LZ4_CHACHA_NONCE, nLen,
+                  ( unsigned char * ) pDest + LZ4_CHACHA_NONCE + nLen );
+   *pulLen = ( HB_ULONG ) nLen + LZ4_CHACHA_NONCE + LZ4_CHACHA_TAG;
+}
+
+/* a forged, modified, replayed or reflected message sets fAuthErr, the connection is then dropped */
+static void lz4_chachaDecrypt( PHB_LZ4NET pStream, const char * pSrc, HB_SIZE nSize, char * pszData, HB_ULONG * pulLen )
+{
+   *pulLen = 0;
+   if( nSize >= LZ4_CHACHA_NONCE + LZ4_CHACHA_TAG && ! pStream->fAuthErr )
+   {
+      const HB_U32 * pKey = pStream->pChaKey + 8;
+      char           szNonce[ LZ4_CHACHA_NONCE ];
+      unsigned char  tag[ LZ4_CHACHA_TAG ];
+      HB_U64         ullCount = HB_GET_LE_UINT64( pSrc + 4 );
+
+      memcpy( szNonce, pSrc, LZ4_CHACHA_NONCE );  /* may be overwritten by in place decrypt */
+      nSize -= LZ4_CHACHA_NONCE + LZ4_CHACHA_TAG;
+      lz4_chachaTag( pKey, szNonce, pSrc + LZ4_CHACHA_NONCE, nSize, tag );
+      if( lz4_tagEqual( tag, pSrc + LZ4_CHACHA_NONCE + nSize ) && ullCount > pStream->ullChaRecv &&
+          HB_GET_LE_UINT32( szNonce ) == ( HB_U32 ) ( pStream->fServer ? 0 : 1 ) )
+      {
+         lz4_chachaXor( pKey, szNonce, 1, pSrc + LZ4_CHACHA_NONCE, pszData, nSize );
+         pStream->ullChaRecv = ullCount;
+         *pulLen = ( HB_ULONG ) nSize;
+      }
+      else
+         pStream->fAuthErr = HB_TRUE;
+   }
+   else
+      pStream->fAuthErr = HB_TRUE;
+   pszData[ *pulLen ] = '\0';
+}
+
+/* random source of the OS, used for the salt of key derivation */
+HB_BOOL hb_lz4netRandom( char * pBuf, int iLen )
+{
+#if defined( HB_OS_WIN )
+   return BCryptGenRandom( NULL, ( PUCHAR ) pBuf, ( ULONG ) iLen, BCRYPT_USE_SYSTEM_PREFERRED_RNG ) >= 0;
+#elif defined( HB_OS_UNIX )
+   int iRead = 0;
+   int fd = open( "/dev/urandom", O_RDONLY );
+
+   if( fd >= 0 )
+   {
+      while( iRead < iLen )
+      {
+         long lRead = ( long ) read( fd, pBuf + iRead, iLen - iRead );
+
+         if( lRead > 0 )
+            iRead += ( int ) lRead;
+         else if( lRead < 0 && errno == EINTR )
+            continue;
+         else
+            break;
+      }
+      close( fd );
+   }
+
+   return iRead == iLen;
+#else
+   HB_SYMBOL_UNUSED( pBuf );
+   HB_SYMBOL_UNUSED( iLen );
+
+   return HB_FALSE;
+#endif
+}
+
+void hb_lz4netCipher( PHB_LZ4NET pStream, int iCipher, const char * pSalt, HB_BOOL fServer )
+{
+   if( pStream && ! LZ4_ENCRYPTED( pStream ) )
+   {
+      pStream->iCipher = iCipher;
+      pStream->fServer = fServer;
+      if( pSalt )
+         memcpy( pStream->szChaSalt, pSalt, LZ4_KDF_SALTLEN );
+   }
+}
+
 /* create blowfish encryption key */
 void hb_lz4netEncryptKey( PHB_LZ4NET pStream, const char * pPassword, int iPasslen )
 {
-   if( ! pStream->pBfKey && pPassword && iPasslen )
+   if( pStream->iCipher == LZ4_CIPHER_CHACHA20 && ! LZ4_ENCRYPTED( pStream ) && pPassword && iPasslen )
+   {  /* PBKDF2 over password and salt from both sides: first key client to server, second back */
+      unsigned char key[ 64 ];
+      int           iSend = pStream->fServer ? 32 : 0;
+      int           i;
+
+      lz4_pbkdf2( pPassword, iPasslen, pStream->szChaSalt, LZ4_KDF_SALTLEN, LZ4_KDF_ROUNDS, key, 64 );
+      pStream->pChaKey = ( HB_U32 * ) hb_xgrab( 16 * sizeof( HB_U32 ) );
+      for( i = 0; i < 8; i++ )
+      {
+         pStream->pChaKey[ i ] = HB_GET_LE_UINT32( key + iSend + ( i << 2 ) );
+         pStream->pChaKey[ i + 8 ] = HB_GET_LE_UINT32( key + ( 32 - iSend ) + ( i << 2 ) );
+      }
+      memset( key, 0, 64 );
+      pStream->ullChaSend = pStream->ullChaRecv = 0;
+      pStream->fAuthErr = HB_FALSE;
+   }
+   else if( ! LZ4_ENCRYPTED( pStream ) && pPassword && iPasslen )
    {
 #ifdef LZ4_BF_CBC
       HB_U32 xl, xr;
@@ -318,11 +915,213 @@ static void lz4_bfDecrypt( const HB_BLOWFISH * pBfKey, const char * pSrc, const
       *pulLen = 0;
 }
 
+/* dispatch to the cipher in use, pDest needs up to +28 bytes more than nLen */
+static void lz4_encrypt( PHB_LZ4NET pStream, const char * pSrc, HB_SIZE nLen, char * pDest, HB_ULONG * pulLen )
+{
+   if( pStream->pChaKey )
+   {
+      if( pSrc && pDest )
+         lz4_chachaEncrypt( pStream, pSrc, nLen, pDest, pulLen );
+      else
+         *pulLen = 0;
+   }
+   else
+      lz4_bfEncrypt( pStream->pBfKey, pSrc, nLen, pDest, pulLen, &pStream->IV );
+}
+
+static void lz4_decrypt( PHB_LZ4NET pStream, const char * pSrc, HB_SIZE nSize, char * pszData, HB_ULONG * pulLen )
+{
+   if( pStream->pChaKey )
+      lz4_chachaDecrypt( pStream, pSrc, nSize, pszData, pulLen );
+   else
+      lz4_bfDecrypt( pStream->pBfKey, pSrc, nSize, pszData, pulLen, &pStream->IV );
+}
+
+/* compression policy: off, too small or paused by auto-tune ( then each x-th message is a probe ) */
+static HB_BOOL lz4_wantCompress( PHB_LZ4NET pStream, HB_ULONG ulLen )
+{
+   if( pStream->iLevel > 0 && ulLen > LZ4_COMPRESS_MINLENGTH )
+   {
+      if( ! pStream->fPaused || ( ++pStream->ulProbe % LZ4_PROBE_INTERVAL ) == 0 )
+         return HB_TRUE;
+   }
+   pStream->ulRaw++;
+   return HB_FALSE;
+}
+
+/* compress a sample from middle of data, gain below 1/16 means e.g. already compressed content */
+static HB_BOOL lz4_incompressible( PHB_LZ4NET pStream, const char * szData, HB_ULONG ulLen )
+{
+   int iBound = LZ4_COMPRESSBOUND( LZ4_SAMPLE_SIZE );
+   int iDest;
+
+   if( ( HB_ULONG ) iBound > pStream->ulBufLen )
+      lz4_bufSizer( pStream, iBound );
+   iDest = LZ4_compress_fast_extState( pStream->LZ4state, szData + ( ( ulLen - LZ4_SAMPLE_SIZE ) >> 1 ),
+                                       pStream->pBuffer, LZ4_SAMPLE_SIZE, iBound, pStream->iLevel );
+
+   return iDest <= 0 || iDest > LZ4_SAMPLE_SIZE - ( LZ4_SAMPLE_SIZE >> 4 );
+}
+
+/* compare time spent for compression with time the saved bytes would need at network,
+ * step acceleration up if more expensive, down if much cheaper; pause if even fastest one not pays */
+static void lz4_tune( PHB_LZ4NET pStream )
+{
+   if( pStream->ullBandwidth && pStream->ullWinTime )
+   {
+      HB_U64 ullSaved = pStream->ullWinIn > pStream->ullWinOut ? pStream->ullWinIn - pStream->ullWinOut : 0;
+      HB_U64 ullWire = ullSaved * 1000000 / pStream->ullBandwidth;
+
+      if( pStream->ullWinTime > ullWire )
+      {
+         if( pStream->iLevel < LZ4_ACCEL_MAX )
+            pStream->iLevel = HB_MIN( pStream->iLevel << 1, LZ4_ACCEL_MAX );
+         else
+            pStream->fPaused = HB_TRUE;
+      }
+      else if( ( pStream->ullWinTime << 2 ) < ullWire )
+      {
+         if( pStream->fPaused )
+            pStream->fPaused = HB_FALSE;
+         else if( pStream->iLevel > 1 )
+            pStream->iLevel >>= 1;
+      }
+   }
+   pStream->ullWinIn = pStream->ullWinOut = pStream->ullWinTime = 0;
+}
+
+/* measured throughput of a network send, smoothed; at least one value needed for auto-tune */
+void hb_lz4netBandwidth( PHB_LZ4NET pStream, HB_ULONG ulBytes, HB_U64 ullMicroSec )
+{
+   if( pStream && ulBytes && ullMicroSec )
+   {
+      HB_U64 ullBandwidth = ( HB_U64 ) ulBytes * 1000000 / ullMicroSec;
+
+      if( pStream->ullBandwidth )
+         pStream->ullBandwidth = ( pStream->ullBandwidth * 3 + ullBandwidth ) >> 2;
+      else
+         pStream->ullBandwidth = ullBandwidth;
+   }
+}
+
+/* returns current acceleration, 0 = no compression; counters are added to given values */
+int hb_lz4netStat( PHB_LZ4NET pStream, HB_U64 * pullIn, HB_U64 * pullOut, HB_ULONG * pulPacked,
+                   HB_ULONG * pulRaw, HB_ULONG * pulSkipped, HB_BOOL fReset )
+{
+   if( ! pStream )
+      return 0;
+
+   *pullIn += pStream->ullStatIn;
+   *pullOut += pStream->ullStatOut;
+   *pulPacked += pStream->ulPacked;
+   *pulRaw += pStream->ulRaw;
+   *pulSkipped += pStream->ulSkipped;
+   if( fReset )
+   {
+      pStream->ullStatIn = pStream->ullStatOut = 0;
+      pStream->ulPacked = pStream->ulRaw = pStream->ulSkipped = 0;
+   }
+
+   return pStream->fPaused ? 0 : HB_MAX( pStream->iLevel, 0 );
+}
+
+int hb_lz4netDictFind( PHB_LZ4NET pStream, const char * pDict, HB_ULONG ulLen )
+{
+   int i;
+
+   if( pStream && pDict && ulLen )
+   {
+      for( i = 0; i < LZ4_DICT_MAX; i++ )
+      {
+         if( pStream->pDict[ i ] && pStream->iDictLen[ i ] == ( int ) ulLen &&
+             ! memcmp( pStream->pDict[ i ], pDict, ulLen ) )
+            return i + 1;
+      }
+   }
+
+   return 0;
+}
+
+/* dictionaries are only added, never removed: both sides must have the same for an ID,
+ * an already registered equal one is re-used */
+int hb_lz4netDictAdd( PHB_LZ4NET pStream, int iID, const char * pDict, HB_ULONG ulLen )
+{
+   int i;
+
+   if( ! pStream || ! pDict || ! ulLen || ulLen > LZ4_BUFFER_DEFSIZE || iID < 0 || iID > LZ4_DICT_MAX )
+      return 0;
+
+   if( ! iID )
+   {
+      if( ( iID = hb_lz4netDictFind( pStream, pDict, ulLen ) ) != 0 )
+         return iID;
+      for( i = 0; i < LZ4_DICT_MAX && ! iID; i++ )
+      {
+         if( ! pStream->pDict[ i ] )
+            iID = i + 1;
+      }
+      if( ! iID )
+         return 0;
+   }
+   else if( pStream->pDict[ iID - 1 ] )
+      hb_xfree( pStream->pDict[ iID - 1 ] );
+
+   pStream->pDict[ iID - 1 ] = ( char * ) hb_xgrab( ulLen );
+   memcpy( pStream->pDict[ iID - 1 ], pDict, ulLen );
+   pStream->iDictLen[ iID - 1 ] = ( int ) ulLen;
+
+   return iID;
+}
+
+void hb_lz4netDictUse( PHB_LZ4NET pStream, int iID )
+{
+   if( pStream )
+      pStream->iDictUse = ( iID > 0 && iID <= LZ4_DICT_MAX && pStream->pDict[ iID - 1 ] ) ? iID : 0;
+}
+
+/* both directions get an own history, a ring buffer with same size and same update rule at both sides;
+ * a fresh stream ( e.g. after reconnect ) starts again without history */
+HB_BOOL hb_lz4netStreamMode( PHB_LZ4NET pStream, HB_BOOL fStream )
+{
+   if( ! pStream )
+      return HB_FALSE;
+
+   lz4_streamFree( pStream, HB_TRUE, HB_TRUE );
+   pStream->ulRingEnc = pStream->ulRingDec = 0;
+   pStream->uiSeqEnc = pStream->uiSeqDec = 0;
+   pStream->fStreamErr = HB_FALSE;
+   if( fStream && pStream->iLevel > 0 )
+   {
+      pStream->pStreamEnc = ( LZ4_stream_t * ) hb_xgrab( sizeof( LZ4_stream_t ) );
+      LZ4_resetStream( pStream->pStreamEnc );
+      pStream->pRingEnc = ( char * ) hb_xgrab( LZ4_STREAM_RINGSIZE );
+      pStream->pStreamDec = ( LZ4_streamDecode_t * ) hb_xgrab( sizeof( LZ4_streamDecode_t ) );
+      LZ4_setStreamDecode( pStream->pStreamDec, NULL, 0 );
+      pStream->pRingDec = ( char * ) hb_xgrab( LZ4_STREAM_RINGSIZE );
+   }
+
+   return pStream->pStreamEnc != NULL;
+}
+
+HB_BOOL hb_lz4netStreamFailed( PHB_LZ4NET pStream )
+{
+   return pStream && ( pStream->fStreamErr || pStream->fAuthErr );
+}
+
 /* hb_lz4netEncryptTest: will a datablock be modified by compression and/or encryption ?
- * if not, and socket flag <MSG_MORE> is available, datablock can be send directly without memcpy() */
+ * without side effect, compression paused by auto-tune counts as not modified */
 HB_BOOL hb_lz4netEncryptTest( const PHB_LZ4NET pStream, const HB_ULONG ulLen )
 {
-   return ( pStream && ( ( ulLen > LZ4_COMPRESS_MINLENGTH && pStream->iLevel > 0 ) || pStream->pBfKey ) );
+   return ( pStream && ( LZ4_ENCRYPTED( pStream ) ||
+            ( pStream->iLevel > 0 && ulLen > LZ4_COMPRESS_MINLENGTH && ! pStream->fPaused ) ) );
+}
+
+/* hb_lz4netMsgBuffered: decision for one message, counted by the compression policy [ probes while paused ],
+ * so call it exactly once per message. If not, and socket flag <MSG_MORE> is available,
+ * datablock can be send directly without memcpy(), else it goes through hb_lz4netEncrypt() */
+HB_BOOL hb_lz4netMsgBuffered( PHB_LZ4NET pStream, const HB_ULONG ulLen )
+{
+   return ( pStream && ( LZ4_ENCRYPTED( pStream ) || lz4_wantCompress( pStream, ulLen ) ) );
 }
 
 /* for hb_lz4net[En|De]crypt() the caller is responsible to free 'too' big result blocks after send/ receive,
@@ -331,21 +1130,35 @@ HB_BOOL hb_lz4netEncryptTest( const PHB_LZ4NET pStream, const HB_ULONG ulLen )
 
 /* target pData ever start with 4 bytes HB_U32 [compressed] data length [ highest BIT = [un]compressed flag ]
  * source szData start at offset 0 with length ulLen
- * pulDataLen is already allocated size of target buffer pData */
+ * pulDataLen is already allocated size of target buffer pData
+ * without encryption the caller must have asked hb_lz4netMsgBuffered() before */
 HB_ULONG hb_lz4netEncrypt( PHB_LZ4NET pStream, char ** pData, HB_ULONG ulLen, HB_ULONG * pulDataLen, const char * szData )
 {
    HB_ULONG  ulBufLen;
    HB_SIZE   nDest;
-   HB_BOOL   fCompress = ( pStream->iLevel > 0 && ulLen > LZ4_COMPRESS_MINLENGTH );
+   HB_BOOL   fCompress, fStream;
 
    if( ! ulLen )
       return 0;
-   else if( fCompress )
+
+   if( LZ4_ENCRYPTED( pStream ) )
+      fCompress = lz4_wantCompress( pStream, ulLen );
+   else
+      fCompress = ( pStream->iLevel > 0 && ulLen > LZ4_COMPRESS_MINLENGTH );
+   if( fCompress && szData && ulLen >= LZ4_SAMPLE_MINLENGTH && lz4_incompressible( pStream, szData, ulLen ) )
+   {
+      pStream->ulSkipped++;
+      fCompress = HB_FALSE;
+   }
+   /* only compressed messages enter the history, so a raw one in between does not disturb */
+   fStream = fCompress && pStream->pStreamEnc && ulLen <= LZ4_STREAM_MSGMAX;
+
+   if( fCompress )
    {
       nDest = ( HB_SIZE ) LZ4_COMPRESSBOUND( ulLen ); /* value needed for compressing below */
-      ulBufLen = nDest + 16;  /* add overhead: encrypt +8, uncomp-length +4, length +4 [, termination +1 ]  */
+      ulBufLen = nDest + 40;  /* add overhead: encrypt +8 [ +28 ], ID +2, uncomp-length +4, length +4 [, termination +1 ] */
    }
-   else if( ! pStream->pBfKey )  /* use raw uncompressed data, just copy and add length */
+   else if( ! LZ4_ENCRYPTED( pStream ) )  /* use raw uncompressed data, just copy and add length */
    {
       if( ulLen > *pulDataLen )  /* [re]alloc target */
       {
@@ -364,7 +1177,7 @@ HB_ULONG hb_lz4netEncrypt( PHB_LZ4NET pStream, char ** pData, HB_ULONG ulLen, HB
    else  /* only crypt, no compress */
    {
       nDest = 0;
-      ulBufLen = ulLen + 8;
+      ulBufLen = ulLen + 36;  /* encrypt +8 [ +28 ], length +4 */
    }
 
    if( ulBufLen > *pulDataLen )  /* [re]alloc target */
@@ -375,23 +1188,86 @@ HB_ULONG hb_lz4netEncrypt( PHB_LZ4NET pStream, char ** pData, HB_ULONG ulLen, HB
 
    if( fCompress )
    {
+      HB_U64 ullStart = leto_MicroSec();
+      int    iDict = fStream ? 0 : pStream->iDictUse;
+
 #if 0  /* testing purpose only */
       // nDest = LZ4_compress_fast( szData, *pData + 4, ulLen, nDest, pStream->iLevel );
       /* HighCompression algo - much! slower; need different LZ4_sizeofStateHC LZ4state */
       nDest = LZ4_compress_HC_extStateHC( pStream->LZ4state, szData, *pData + 4, ulLen, nDest, pStream->iLevel );
 #else  /* newer version with external ( aka Harbour hb_xgrab ) allocated LZ4state */
-      nDest = LZ4_compress_fast_extState( pStream->LZ4state, szData, *pData + 4, ulLen, nDest, pStream->iLevel );
+      if( fStream )  /* previous messages are the history, copied into ring buffer to keep them in place */
+      {
+         char * pRing;
+
+         if( pStream->ulRingEnc + ulLen > LZ4_STREAM_RINGSIZE )
+            pStream->ulRingEnc = 0;
+         pRing = pStream->pRingEnc + pStream->ulRingEnc;
+         memcpy( pRing, szData, ulLen );
+         nDest = LZ4_compress_fast_continue( pStream->pStreamEnc, pRing, *pData + 4, ulLen, nDest, pStream->iLevel );
+         pStream->ulRingEnc += ulLen;
+         if( ( int ) nDest <= 0 )  /* encoder history unusable, stop streaming; receiver needs no notice */
+         {
+            lz4_streamFree( pStream, HB_TRUE, HB_FALSE );
+            fStream = HB_FALSE;
+         }
+      }
+      else if( iDict )  /* dictionary is the 'history' preceding the message */
+      {
+         LZ4_resetStream( ( LZ4_stream_t * ) pStream->LZ4state );
+         LZ4_loadDict( ( LZ4_stream_t * ) pStream->LZ4state, pStream->pDict[ iDict - 1 ], pStream->iDictLen[ iDict - 1 ] );
+         nDest = LZ4_compress_fast_continue( ( LZ4_stream_t * ) pStream->LZ4state, szData, *pData + 4, ulLen, nDest, pStream->iLevel );
+      }
+      else
+         nDest = LZ4_compress_fast_extState( pStream->LZ4state, szData, *pData + 4, ulLen, nDest, pStream->iLevel );
 #endif
-      HB_PUT_LE_UINT32( *pData + 4 + nDest, ulLen );  /* trailing expanded data size */
-      ulLen = nDest + 4;
-      if( pStream->pBfKey )
-         lz4_bfEncrypt( pStream->pBfKey, *pData + 4, ulLen, *pData + 4, &ulLen, &pStream->IV );
-      HB_PUT_LE_UINT32( *pData, ulLen | 0x80000000 );  /* highest BIT: flag for compressed content */
-      ulLen += 4;
+      pStream->ullWinTime += leto_MicroSec() - ullStart;
+      pStream->ullWinIn += ulLen;
+
+      /* no gain: send raw, flag bit not set -- not for a streamed block, it is already part of history */
+      if( ( int ) nDest <= 0 || ( ! fStream && nDest + ( iDict ? 6 : 4 ) >= ulLen ) )
+      {
+         pStream->ullWinOut += ulLen;
+         pStream->ulSkipped++;
+         fCompress = HB_FALSE;
+      }
+      else
+      {
+         pStream->ullWinOut += nDest + 4;
+         pStream->ullStatIn += ulLen;
+         pStream->ullStatOut += nDest + 4;
+         pStream->ulPacked++;
+
+         if( fStream )  /* sequence number with highest bit instead of dictionary ID */
+         {
+            HB_PUT_LE_UINT16( *pData + 4 + nDest, 0x8000 | ( pStream->uiSeqEnc & 0x7FFF ) );
+            pStream->uiSeqEnc++;  /* not inside the macro, it may evaluate its param twice */
+            nDest += 2;
+            ulLen |= 0x80000000;
+         }
+         else if( iDict )  /* ID before trailing size, marked by its highest bit */
+         {
+            HB_PUT_LE_UINT16( *pData + 4 + nDest, iDict );
+            nDest += 2;
+            ulLen |= 0x80000000;
+         }
+         HB_PUT_LE_UINT32( *pData + 4 + nDest, ulLen );  /* trailing expanded data size */
+         ulLen = nDest + 4;
+         if( LZ4_ENCRYPTED( pStream ) )
+            lz4_encrypt( pStream, *pData + 4, ulLen, *pData + 4, &ulLen );
+         HB_PUT_LE_UINT32( *pData, ulLen | 0x80000000 );  /* highest BIT: flag for compressed content */
+         ulLen += 4;
+      }
+      if( pStream->ullWinIn >= LZ4_TUNE_WINDOW )
+         lz4_tune( pStream );
    }
-   else if( pStream->pBfKey )
+
+   if( ! fCompress )
    {
-      lz4_bfEncrypt( pStream->pBfKey, szData, ulLen, *pData + 4, &ulLen, &pStream->IV );
+      if( LZ4_ENCRYPTED( pStream ) )
+         lz4_encrypt( pStream, szData, ulLen, *pData + 4, &ulLen );
+      else  /* compression without gain */
+         memcpy( *pData + 4, szData, ulLen );
       HB_PUT_LE_UINT32( *pData, ulLen );
       ulLen += 4;
    }
@@ -405,16 +1281,16 @@ HB_ULONG hb_lz4netEncrypt( PHB_LZ4NET pStream, char ** pData, HB_ULONG ulLen, HB
  * pulDataLen is already allocated size of source & target buffer: pData */
 HB_ULONG hb_lz4netDecrypt( PHB_LZ4NET pStream, char ** pData, HB_ULONG ulLen, HB_ULONG * pulDataLen, HB_BOOL fCompressed )
 {
-   if( pStream->pBfKey )
+   if( LZ4_ENCRYPTED( pStream ) )
    {
       if( fCompressed )  /* decrypt into tmp buffer */
       {
          if( ulLen > pStream->ulBufLen )
             lz4_bufSizer( pStream, ulLen );
-         lz4_bfDecrypt( pStream->pBfKey, *pData, ulLen, pStream->pBuffer, &ulLen, &pStream->IV );
+         lz4_decrypt( pStream, *pData, ulLen, pStream->pBuffer, &ulLen );
       }
       else  /* decrypt in place */
-         lz4_bfDecrypt( pStream->pBfKey, *pData, ulLen, *pData, &ulLen, &pStream->IV );
+         lz4_decrypt( pStream, *pData, ulLen, *pData, &ulLen );
    }
    else if( fCompressed )  /* need tmp buffer */
    {
@@ -423,12 +1299,44 @@ HB_ULONG hb_lz4netDecrypt( PHB_LZ4NET pStream, char ** pData, HB_ULONG ulLen, HB
       memcpy( pStream->pBuffer, *pData, ulLen );
    }
 
-   if( fCompressed )
+   if( fCompressed && ulLen <= 4 )  /* failed decryption or too short for trailing size */
+   {
+      **pData = '\0';
+      return 0;
+   }
+   else if( fCompressed )
    {
       HB_SIZE nSize = ulLen - 4;  /* raw compressed size, without trailing U32 */
-      int     iCompressed;
+      int     iCompressed, iDict = 0;
+      char *  pRing = NULL;
+      HB_BOOL fStreamed = HB_FALSE;
 
       ulLen = HB_GET_LE_UINT32( pStream->pBuffer + nSize );  /* expanded size */
+      if( ulLen & 0x80000000 )  /* compressed with dictionary, its ID before trailing size */
+      {
+         ulLen &= 0x7FFFFFFF;
+         if( nSize >= 2 )
+         {
+            nSize -= 2;
+            iDict = HB_GET_LE_UINT16( pStream->pBuffer + nSize );
+         }
+         if( iDict & 0x8000 )  /* streamed block, must be the next expected one */
+         {
+            fStreamed = HB_TRUE;
+            if( pStream->pStreamDec && ! pStream->fStreamErr && ulLen <= LZ4_STREAM_MSGMAX &&
+                ( iDict & 0x7FFF ) == ( pStream->uiSeqDec & 0x7FFF ) )
+            {
+               if( pStream->ulRingDec + ulLen > LZ4_STREAM_RINGSIZE )
+                  pStream->ulRingDec = 0;
+               pRing = pStream->pRingDec + pStream->ulRingDec;
+               iDict = 0;
+            }
+            else
+               iDict = -1;
+         }
+         else if( iDict < 1 || iDict > LZ4_DICT_MAX || ! pStream->pDict[ iDict - 1 ] )
+            iDict = -1;
+      }
       if( ulLen > *pulDataLen )  /* [re]alloc target */
       {
          *pulDataLen = ulLen;
@@ -439,11 +1347,29 @@ HB_ULONG hb_lz4netDecrypt( PHB_LZ4NET pStream, char ** pData, HB_ULONG ulLen, HB
       iCompressed = LZ4_decompress_fast( pStream->pBuffer, *pData, ulLen );
       if( ( HB_ULONG ) iCompressed != nSize )
 #else  /* the safe version */
-      iCompressed = LZ4_decompress_safe( pStream->pBuffer, *pData, nSize, ulLen );
+      if( iDict < 0 )  /* unknown dictionary or stream out of sync */
+         iCompressed = -1;
+      else if( pRing )  /* decode into history, then copy out */
+      {
+         iCompressed = LZ4_decompress_safe_continue( pStream->pStreamDec, pStream->pBuffer, pRing, nSize, ulLen );
+         if( ( HB_ULONG ) iCompressed == ulLen )
+         {
+            memcpy( *pData, pRing, ulLen );
+            pStream->ulRingDec += ulLen;
+            pStream->uiSeqDec++;
+         }
+      }
+      else if( iDict )
+         iCompressed = LZ4_decompress_safe_usingDict( pStream->pBuffer, *pData, nSize, ulLen,
+                                                      pStream->pDict[ iDict - 1 ], pStream->iDictLen[ iDict - 1 ] );
+      else
+         iCompressed = LZ4_decompress_safe( pStream->pBuffer, *pData, nSize, ulLen );
       if( ( HB_ULONG ) iCompressed != ulLen )
 #endif
       {
          pStream->iErr = iCompressed;
+         if( fStreamed )  /* history is broken, following streamed blocks can't be decoded */
+            pStream->fStreamErr = HB_TRUE;
          ulLen = 0;
       }
 
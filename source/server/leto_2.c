@@ -57,6 +57,31 @@
 #endif
 
 #include "srvleto.h"
+#include "hbstack.h"
+
+#if defined( LETO_LOCAL_SOCKET )
+   #include <sys/stat.h>
+#endif
+
+#if defined( LETO_LOCAL_SOCKET )
+/* directory of local socket: created with mode 0711, or an existing one must be owned by us and
+ * not writable by others, else anybody could place a socket there and intercept the logins */
+static HB_BOOL leto_localDir( char * szPath )
+{
+   struct stat st;
+
+   hb_snprintf( szPath, HB_PATH_MAX, LETO_LOCAL_SOCKETDIR, ( unsigned ) geteuid() );
+   if( mkdir( szPath, 0711 ) != 0 && errno != EEXIST )
+      return HB_FALSE;
+   if( lstat( szPath, &st ) != 0 || ! S_ISDIR( st.st_mode ) || st.st_uid != geteuid() ||
+       ( st.st_mode & ( S_IWGRP | S_IWOTH ) ) )
+   {
+      errno = EPERM;
+      return HB_FALSE;
+   }
+   return HB_TRUE;
+}
+#endif
 
 /* for counting statistic */
 #if defined( HB_SPINLOCK_INIT ) && ! defined( HB_HELGRIND_FRIENDLY )
@@ -121,10 +146,20 @@ static HB_U64 s_ullUDFOps = 0;
 static HB_U64 s_ullBytesRead = 0;
 static HB_U64 s_ullBytesSend = 0;
 static HB_U64 s_ullCPULoad = 0;          /* sum in us of CPU load for requests */
+static HB_U64 s_ullSysCalls = 0;         /* network syscalls for requests, with io_uring one per submit */
+#ifdef USE_LZ4
+static HB_U64 s_ullZipIn = 0;            /* raw bytes of compressed answers */
+static HB_U64 s_ullZipOut = 0;           /* .. and after compression */
+static HB_U64 s_ullZipPacked = 0;        /* count of compressed answers */
+static HB_U64 s_ullZipRaw = 0;           /* answers too small or compression paused */
+static HB_U64 s_ullZipSkipped = 0;       /* answers found incompressible */
+static HB_U64 s_ullZipLevels = 0;        /* sum of LZ4 acceleration of compressed answers */
+#endif
 
 
 extern HB_USHORT leto_ActiveUser( void );
 extern HB_USHORT leto_MaxUsers( void );
+extern HB_BOOL leto_NoSaveWA( void );
 extern int iDebugMode( void );
 extern const char * leto_sDirBase( void );
 extern HB_BOOL leto_ConnectIsLock( int iLock );
@@ -171,6 +206,22 @@ HB_U64 leto_Statistics( int iEntry )
       ullRet = s_ullBytesSend;
    else if( iEntry == 4 )
       ullRet = s_ullCPULoad / 1000000;
+   else if( iEntry == 5 )
+      ullRet = s_ullSysCalls;
+#ifdef USE_LZ4
+   else if( iEntry == 6 )
+      ullRet = s_ullZipIn;
+   else if( iEntry == 7 )
+      ullRet = s_ullZipOut;
+   else if( iEntry == 8 )
+      ullRet = s_ullZipPacked;
+   else if( iEntry == 9 )
+      ullRet = s_ullZipRaw;
+   else if( iEntry == 10 )
+      ullRet = s_ullZipSkipped;
+   else if( iEntry == 11 )
+      ullRet = s_ullZipLevels;
+#endif
    else
       ullRet = 0;
    HB_GC_UNLOCKS();
@@ -214,6 +265,7 @@ static void leto_CommandDescInit( void )
    s_szCmdSetDesc[ LETOCMD_dbeval  - LETOCMD_OFFSET ] = "dbeval";
    s_szCmdSetDesc[ LETOCMD_flush   - LETOCMD_OFFSET ] = "flush";
    s_szCmdSetDesc[ LETOCMD_goto    - LETOCMD_OFFSET ] = "goto";
+   s_szCmdSetDesc[ LETOCMD_golist  - LETOCMD_OFFSET ] = "gotolist";
    s_szCmdSetDesc[ LETOCMD_group   - LETOCMD_OFFSET ] = "group";
    s_szCmdSetDesc[ LETOCMD_islock  - LETOCMD_OFFSET ] = "islocked";
    s_szCmdSetDesc[ LETOCMD_lock    - LETOCMD_OFFSET ] = "lock";
@@ -227,6 +279,7 @@ static void leto_CommandDescInit( void )
    s_szCmdSetDesc[ LETOCMD_skip    - LETOCMD_OFFSET ] = "skip";
    s_szCmdSetDesc[ LETOCMD_sort    - LETOCMD_OFFSET ] = "sort";
    s_szCmdSetDesc[ LETOCMD_seek    - LETOCMD_OFFSET ] = "seek";
+   s_szCmdSetDesc[ LETOCMD_seeklist - LETOCMD_OFFSET ] = "seeklist";
    s_szCmdSetDesc[ LETOCMD_sum     - LETOCMD_OFFSET ] = "sum";
    s_szCmdSetDesc[ LETOCMD_trans   - LETOCMD_OFFSET ] = "transition";
    s_szCmdSetDesc[ LETOCMD_unlock  - LETOCMD_OFFSET ] = "unlock";
@@ -341,6 +394,275 @@ void leto_SrvShutDown( unsigned int uiWait )
 #  define LETO_SOCK_IS_EAGAIN( err ) ( ( err ) == EAGAIN )
 #endif
 
+/* thread local socket helpers: syscall counter for statistics, optional io_uring */
+#define LETO_URING_DEPTH     8
+#define LETO_URING_SEND      1
+#define LETO_URING_RECV      2
+
+typedef struct
+{
+   HB_ULONG          ulSysCalls;              /* network syscalls since last request */
+#if defined( LETO_HAS_URING )
+   int               iRingState;              /* 0 = not initialized, 1 = ready, -1 = not supported */
+   struct io_uring   ring;
+#endif
+} LETO_SOCKTSD, * PLETO_SOCKTSD;
+
+static void leto_sockTSDRelease( void * cargo )
+{
+#if defined( LETO_HAS_URING )
+   PLETO_SOCKTSD pSockTSD = ( PLETO_SOCKTSD ) cargo;
+
+   if( pSockTSD->iRingState > 0 )
+      io_uring_queue_exit( &pSockTSD->ring );
+   pSockTSD->iRingState = 0;
+#else
+   HB_SYMBOL_UNUSED( cargo );
+#endif
+}
+
+static HB_TSD_NEW( s_TSDsock, sizeof( LETO_SOCKTSD ), NULL, leto_sockTSDRelease );
+
+static _HB_INLINE_ PLETO_SOCKTSD leto_sockTSD( void )
+{
+   return ( PLETO_SOCKTSD ) hb_stackGetTSD( &s_TSDsock );
+}
+
+/* returns number of syscalls done by this thread, and resets the counter */
+static HB_ULONG leto_sockSysCalls( void )
+{
+   PLETO_SOCKTSD pSockTSD = leto_sockTSD();
+   HB_ULONG      ulSysCalls = pSockTSD->ulSysCalls;
+
+   pSockTSD->ulSysCalls = 0;
+   return ulSysCalls;
+}
+
+#if defined( LETO_HAS_URING )
+static struct io_uring * leto_uringGet( PLETO_SOCKTSD pSockTSD )
+{
+   if( ! pSockTSD->iRingState )
+   {
+      if( io_uring_queue_init( LETO_URING_DEPTH, &pSockTSD->ring, 0 ) == 0 )
+         pSockTSD->iRingState = 1;
+      else
+      {
+         pSockTSD->iRingState = -1;  /* e.g. kernel < 5.6: use ordinary send()/ recv() */
+         leto_writelog( NULL, 0, "DEBUG io_uring not supported, using send()/ recv()" );
+      }
+   }
+
+   return pSockTSD->iRingState > 0 ? &pSockTSD->ring : NULL;
+}
+
+/* submit up to two linked SEND and wait for all; plSend[] receive the results,
+ * negative values are -errno. One syscall for all */
+static int leto_uringSend( struct io_uring * ring, HB_SOCKET hSocket, const char ** pBufs, HB_ULONG * pulLens, int iCount, int flags, long * plSend )
+{
+   struct io_uring_cqe * cqe;
+   int i;
+
+   for( i = 0; i < iCount; i++ )
+   {
+      struct io_uring_sqe * sqe = io_uring_get_sqe( ring );
+
+      io_uring_prep_send( sqe, hSocket, pBufs[ i ], pulLens[ i ], flags | ( i < iCount - 1 ? MSG_MORE : 0 ) );
+      io_uring_sqe_set_data( sqe, ( void * ) ( HB_PTRUINT ) ( i + 1 ) );
+      if( i < iCount - 1 )
+         sqe->flags |= IOSQE_IO_LINK;
+      plSend[ i ] = -ECANCELED;
+   }
+
+   if( io_uring_submit_and_wait( ring, iCount ) < 0 )
+      return 0;
+
+   for( i = 0; i < iCount; i++ )
+   {
+      if( io_uring_peek_cqe( ring, &cqe ) != 0 )
+         break;
+      if( cqe->user_data > 0 && cqe->user_data <= ( HB_U64 ) iCount )
+         plSend[ cqe->user_data - 1 ] = cqe->res;
+      io_uring_cqe_seen( ring, cqe );
+   }
+
+   return iCount;
+}
+
+static long leto_uringRecv( struct io_uring * ring, HB_SOCKET hSocket, char * pBuf, HB_ULONG ulLen )
+{
+   struct io_uring_sqe * sqe = io_uring_get_sqe( ring );
+   struct io_uring_cqe * cqe;
+   long                  lRecv;
+
+   io_uring_prep_recv( sqe, hSocket, pBuf, ulLen, 0 );
+   if( io_uring_submit_and_wait( ring, 1 ) < 0 || io_uring_peek_cqe( ring, &cqe ) != 0 )
+      return -EIO;
+   lRecv = cqe->res;
+   io_uring_cqe_seen( ring, cqe );
+
+   return lRecv;
+}
+#endif  /* LETO_HAS_URING */
+
+/* one send() or recv() with syscall counting, returns like them and sets errno */
+static _HB_INLINE_ long leto_sockOp( int iOp, HB_SOCKET hSocket, char * pBuf, HB_ULONG ulLen, int flags )
+{
+   PLETO_SOCKTSD pSockTSD = leto_sockTSD();
+   long          lRes;
+
+   pSockTSD->ulSysCalls++;
+#if defined( LETO_HAS_URING )
+   {
+      struct io_uring * ring = leto_uringGet( pSockTSD );
+
+      if( ring )
+      {
+         if( iOp == LETO_URING_SEND )
+         {
+            const char * pBufs[ 1 ];
+            HB_ULONG     ulLens[ 1 ];
+
+            pBufs[ 0 ] = pBuf;
+            ulLens[ 0 ] = ulLen;
+            leto_uringSend( ring, hSocket, pBufs, ulLens, 1, flags, &lRes );
+         }
+         else
+            lRes = leto_uringRecv( ring, hSocket, pBuf, ulLen );
+
+         if( lRes < 0 )
+         {
+            errno = ( int ) -lRes;
+            lRes = -1;
+         }
+         else
+            errno = 0;
+         return lRes;
+      }
+   }
+#endif
+
+   if( iOp == LETO_URING_SEND )
+      lRes = send( hSocket, ( const char * ) pBuf, ulLen, flags );
+   else
+      lRes = recv( hSocket, pBuf, ulLen, flags );
+
+   return lRes;
+}
+
+
+/* gather send: all segments with one syscall, no need to memcpy() them into one buffer */
+#if defined( HB_OS_WIN )
+   typedef WSABUF        LETO_IOVEC;
+   #define LETO_IOV_BASE( v )  ( ( v ).buf )
+   #define LETO_IOV_LEN( v )   ( ( v ).len )
+#else
+   typedef struct iovec  LETO_IOVEC;
+   #define LETO_IOV_BASE( v )  ( ( v ).iov_base )
+   #define LETO_IOV_LEN( v )   ( ( v ).iov_len )
+#endif
+
+static HB_ULONG leto_SockSendV( HB_SOCKET hSocket, LETO_IOVEC * pVec, int iCount )
+{
+   HB_ULONG ulSend = 0;
+   long     lTmp;
+#if defined( HB_OS_WIN )
+   DWORD    dwSend;
+#else
+   struct msghdr msg;
+   int      flags = 0;
+
+#if defined( MSG_NOSIGNAL )
+   flags |= MSG_NOSIGNAL;
+#endif
+#endif
+
+   while( iCount > 0 )
+   {
+      leto_sockTSD()->ulSysCalls++;
+#if defined( HB_OS_WIN )
+      if( WSASend( hSocket, pVec, ( DWORD ) iCount, &dwSend, 0, NULL, NULL ) == 0 )
+         lTmp = ( long ) dwSend;
+      else
+         lTmp = -1;
+#else
+      memset( &msg, 0, sizeof( msg ) );
+      msg.msg_iov = pVec;
+      msg.msg_iovlen = iCount;
+      lTmp = sendmsg( hSocket, &msg, flags );
+#endif
+      if( lTmp < 1 )
+      {
+         if( LETO_SOCK_IS_EINTR( LETO_SOCK_GETERROR() ) )
+            continue;
+         break;
+      }
+
+      ulSend += lTmp;
+      /* skip the completely sent segments, adjust a partial sent one */
+      while( iCount > 0 && ( HB_ULONG ) lTmp >= ( HB_ULONG ) LETO_IOV_LEN( *pVec ) )
+      {
+         lTmp -= ( long ) LETO_IOV_LEN( *pVec );
+         pVec++;
+         iCount--;
+      }
+      if( iCount > 0 && lTmp > 0 )
+      {
+         LETO_IOV_BASE( *pVec ) = ( char * ) LETO_IOV_BASE( *pVec ) + lTmp;
+         LETO_IOV_LEN( *pVec ) -= lTmp;
+      }
+   }
+
+   return ulSend;
+}
+
+/* send message length header plus data, without copy into a send buffer */
+static HB_ULONG leto_SockSendMsg( HB_SOCKET hSocket, const char * pHead, HB_ULONG ulHead, const char * pBuf, HB_ULONG ulLen )
+{
+   LETO_IOVEC pVec[ 2 ];
+   HB_ULONG   ulSend = 0;
+
+#if defined( LETO_HAS_URING )
+   PLETO_SOCKTSD     pSockTSD = leto_sockTSD();
+   struct io_uring * ring = leto_uringGet( pSockTSD );
+
+   /* two linked sends with one syscall */
+   if( ring )
+   {
+      const char * pBufs[ 2 ];
+      HB_ULONG     ulLens[ 2 ];
+      long         lSend[ 2 ];
+
+      pBufs[ 0 ] = pHead;
+      ulLens[ 0 ] = ulHead;
+      pBufs[ 1 ] = pBuf;
+      ulLens[ 1 ] = ulLen;
+      pSockTSD->ulSysCalls++;
+      leto_uringSend( ring, hSocket, pBufs, ulLens, 2, MSG_NOSIGNAL, lSend );
+
+      if( lSend[ 0 ] > 0 )
+         ulSend = ( HB_ULONG ) lSend[ 0 ];
+      if( ulSend == ulHead && lSend[ 1 ] > 0 )
+         ulSend += ( HB_ULONG ) lSend[ 1 ];
+      if( ulSend == ulHead + ulLen )
+         return ulSend;
+      /* partial send breaks the chain: continue below with the rest */
+   }
+#endif
+
+   if( ulSend >= ulHead )
+   {
+      LETO_IOV_BASE( pVec[ 0 ] ) = ( char * ) pBuf + ( ulSend - ulHead );
+      LETO_IOV_LEN( pVec[ 0 ] ) = ulLen - ( ulSend - ulHead );
+      return ulSend + leto_SockSendV( hSocket, pVec, 1 );
+   }
+
+   LETO_IOV_BASE( pVec[ 0 ] ) = ( char * ) pHead + ulSend;
+   LETO_IOV_LEN( pVec[ 0 ] ) = ulHead - ulSend;
+   LETO_IOV_BASE( pVec[ 1 ] ) = ( char * ) pBuf;
+   LETO_IOV_LEN( pVec[ 1 ] ) = ulLen;
+
+   return ulSend + leto_SockSendV( hSocket, pVec, 2 );
+}
 
 #ifdef USE_LZ4
 static HB_ULONG leto_SockSend( HB_SOCKET hSocket, const char * pBuf, HB_ULONG ulLen, int flags )
@@ -354,7 +676,7 @@ static HB_ULONG leto_SockSend( HB_SOCKET hSocket, const char * pBuf, HB_ULONG ul
 
    do
    {
-      lTmp = send( hSocket, ( const char * ) ( pBuf + ulSend ), ulLen - ulSend, flags );
+      lTmp = leto_sockOp( LETO_URING_SEND, hSocket, ( char * ) ( pBuf + ulSend ), ulLen - ulSend, flags );
       if( lTmp < 1 )
       {
          if( LETO_SOCK_IS_EINTR( LETO_SOCK_GETERROR() ) )
@@ -372,6 +694,7 @@ static HB_ULONG leto_SockSend( HB_SOCKET hSocket, const char * pBuf, HB_ULONG ul
    return ulSend;
 }
 
+
 #else  /* ! USE_LZ4 */
 static HB_ULONG leto_SockSend( HB_SOCKET hSocket, const char * pBuf, HB_ULONG ulLen, PHB_ZNETSTREAM zstream, int flags )
 {
@@ -389,7 +712,7 @@ static HB_ULONG leto_SockSend( HB_SOCKET hSocket, const char * pBuf, HB_ULONG ul
          lTmp = hb_znetWrite( zstream, hSocket, pBuf + ulSend, ulLen - ulSend, s_iTimeOut, &lLast );
       else
       {
-         lTmp = send( hSocket, ( const char * ) ( pBuf + ulSend ), ulLen - ulSend, flags );
+         lTmp = leto_sockOp( LETO_URING_SEND, hSocket, ( char * ) ( pBuf + ulSend ), ulLen - ulSend, flags );
          if( lTmp < 1 )
          {
             if( LETO_SOCK_IS_EINTR( LETO_SOCK_GETERROR() ) )
@@ -443,7 +766,7 @@ static HB_ULONG leto_SockRecv( HB_SOCKET hSocket, char * pBuf, HB_ULONG ulLen, P
       else
 #endif
       {
-         lTmp = recv( hSocket, pBuf + ulRead, ulLen - ulRead, 0 );
+         lTmp = leto_sockOp( LETO_URING_RECV, hSocket, pBuf + ulRead, ulLen - ulRead, 0 );
          if( lTmp < 1 )
          {
             if( LETO_SOCK_IS_EINTR( LETO_SOCK_GETERROR() ) )
@@ -471,6 +794,7 @@ static HB_ULONG leto_SockRecv( HB_SOCKET hSocket, char * pBuf, HB_ULONG ulLen, P
             bDoNotWait = HB_TRUE;
             do
             {
+               leto_sockTSD()->ulSysCalls++;
                iChange = poll( pPoll, 1, 500 );
                if( iChange < 0 && LETO_SOCK_IS_EINTR( LETO_SOCK_GETERROR() ) )
                   continue;
@@ -522,11 +846,250 @@ static HB_ULONG leto_SockRecv( HB_SOCKET hSocket, char * pBuf, HB_ULONG ulLen, P
    return ulRead;
 }
 
-/* connection health check */
-HB_BOOL leto_AskAnswer( HB_SOCKET hSocket )
+/* ### second socket: all writes are queued as complete frames and send by one thread, so frames of   ###
+ * ### different threads never interleave and a slow client doesn't block the thread which queues    ### */
+
+#define LETO_ERRSOCK_MAX     65536            /* max. queued bytes of a connection, more gives up the socket */
+#define LETO_ERRSOCK_STALL   1000             /* ms without progress until the second socket is given up */
+
+static HB_CRITICAL_NEW( s_ErrSockMtx );
+static HB_COND_NEW( s_ErrSockCond );
+static PUSERSTRU * s_pErrSockPending = NULL;  /* connections with queued frames */
+static int         s_iErrSockPending = 0;
+static int         s_iErrSockAlloc = 0;
+static HB_BOOL     s_bErrSockThread = HB_FALSE;
+
+/* need s_ErrSockMtx */
+static void leto_errSockUnpend( PUSERSTRU pUStru )
 {
-   HB_BOOL bIsAlive = HB_FALSE;
-   char szData[ 8 ];
+   int i;
+
+   for( i = 0; i < s_iErrSockPending; i++ )
+   {
+      if( s_pErrSockPending[ i ] == pUStru )
+      {
+         s_pErrSockPending[ i ] = s_pErrSockPending[ --s_iErrSockPending ];
+         break;
+      }
+   }
+   if( pUStru->pErrSockBuf )
+   {
+      hb_xfree( pUStru->pErrSockBuf );
+      pUStru->pErrSockBuf = NULL;
+   }
+   pUStru->ulErrSockLen = pUStru->ulErrSockAlloc = 0;
+}
+
+/* need s_ErrSockMtx: a torn or stuck frame can't be repaired, so the client will notice the closed
+ * second socket, end its change notes and use the hotbuffer timeout again */
+static void leto_errSockDrop( PUSERSTRU pUStru )
+{
+   pUStru->bErrSockDrop = HB_TRUE;
+   leto_errSockUnpend( pUStru );
+   if( pUStru->hSocketErr != HB_NO_SOCKET )
+      hb_socketShutdown( pUStru->hSocketErr, HB_SOCKET_SHUT_RDWR );
+}
+
+/* queue a complete frame including size head for the second socket of pUStru */
+HB_BOOL leto_ErrSockQueue( PUSERSTRU pUStru, const char * pData, HB_ULONG ulLen )
+{
+   HB_BOOL bQueued = HB_FALSE;
+
+   hb_threadEnterCriticalSection( &s_ErrSockMtx );
+   if( s_bErrSockThread && ! pUStru->bErrSockDrop && pUStru->hSocketErr != HB_NO_SOCKET )
+   {
+      if( pUStru->ulErrSockLen + ulLen > LETO_ERRSOCK_MAX )
+         leto_errSockDrop( pUStru );
+      else
+      {
+         if( ! pUStru->pErrSockBuf && ! pUStru->bErrSockBusy )
+         {
+            if( s_iErrSockPending == s_iErrSockAlloc )
+            {
+               s_iErrSockAlloc += 16;
+               s_pErrSockPending = ( PUSERSTRU * ) hb_xrealloc( s_pErrSockPending, sizeof( PUSERSTRU ) * s_iErrSockAlloc );
+            }
+            s_pErrSockPending[ s_iErrSockPending++ ] = pUStru;
+         }
+         if( pUStru->ulErrSockLen + ulLen > pUStru->ulErrSockAlloc )
+         {
+            pUStru->ulErrSockAlloc = pUStru->ulErrSockLen + ulLen + 256;
+            pUStru->pErrSockBuf = ( HB_BYTE * ) hb_xrealloc( pUStru->pErrSockBuf, pUStru->ulErrSockAlloc );
+         }
+         memcpy( pUStru->pErrSockBuf + pUStru->ulErrSockLen, pData, ulLen );
+         pUStru->ulErrSockLen += ulLen;
+         bQueued = HB_TRUE;
+         hb_threadCondBroadcast( &s_ErrSockCond );
+      }
+   }
+   hb_threadLeaveCriticalSection( &s_ErrSockMtx );
+
+   return bQueued;
+}
+
+/* called by leto_CloseUS() before the second socket is closed, no more frames are accepted */
+void leto_ErrSockClose( PUSERSTRU pUStru )
+{
+   hb_vmUnlock();
+   hb_threadEnterCriticalSection( &s_ErrSockMtx );
+   while( pUStru->bErrSockBusy )
+      hb_threadCondTimedWait( &s_ErrSockCond, &s_ErrSockMtx, 100 );
+   pUStru->bErrSockDrop = HB_TRUE;
+   leto_errSockUnpend( pUStru );
+   hb_threadLeaveCriticalSection( &s_ErrSockMtx );
+   hb_vmLock();
+}
+
+/* send what the socket takes without waiting, an unsent rest stays ahead of meanwhile queued frames;
+ * returns HB_FALSE if the socket is to be given up */
+static HB_BOOL leto_errSockSend( PUSERSTRU pUStru )
+{
+   HB_BYTE * pBuf = pUStru->pErrSockBuf;
+   HB_ULONG  ulLen = pUStru->ulErrSockLen, ulSend = 0;
+   HB_SOCKET hSocket = pUStru->hSocketErr;
+   long      lTmp;
+
+   pUStru->pErrSockBuf = NULL;
+   pUStru->ulErrSockLen = pUStru->ulErrSockAlloc = 0;
+   pUStru->bErrSockBusy = HB_TRUE;
+   hb_threadLeaveCriticalSection( &s_ErrSockMtx );
+
+   do
+   {
+      lTmp = hb_socketSend( hSocket, pBuf + ulSend, HB_MIN( ulLen - ulSend, 4096 ), 0, 0 );
+      if( lTmp > 0 )
+         ulSend += ( HB_ULONG ) lTmp;
+   }
+   while( lTmp > 0 && ulSend < ulLen );
+
+   hb_threadEnterCriticalSection( &s_ErrSockMtx );
+   pUStru->bErrSockBusy = HB_FALSE;
+   hb_threadCondBroadcast( &s_ErrSockCond );
+
+   if( ulSend < ulLen && ! pUStru->bErrSockDrop )
+   {
+      HB_BOOL bGiveUp = HB_FALSE;
+
+      if( lTmp < 0 && hb_socketGetError() != HB_SOCKET_ERR_TIMEOUT )
+         bGiveUp = HB_TRUE;
+      else if( ulSend )
+         pUStru->llErrSockStall = 0;
+      else if( ! pUStru->llErrSockStall )
+         pUStru->llErrSockStall = leto_MilliSec();
+      else if( leto_MilliDiff( pUStru->llErrSockStall ) > LETO_ERRSOCK_STALL )
+         bGiveUp = HB_TRUE;
+
+      if( bGiveUp )
+      {
+         hb_xfree( pBuf );
+         return HB_FALSE;
+      }
+
+      /* rest in front of the frames queued meanwhile */
+      memmove( pBuf, pBuf + ulSend, ulLen - ulSend );
+      ulLen -= ulSend;
+      if( pUStru->pErrSockBuf )
+      {
+         pBuf = ( HB_BYTE * ) hb_xrealloc( pBuf, ulLen + pUStru->ulErrSockLen );
+         memcpy( pBuf + ulLen, pUStru->pErrSockBuf, pUStru->ulErrSockLen );
+         hb_xfree( pUStru->pErrSockBuf );
+         ulLen += pUStru->ulErrSockLen;
+      }
+      pUStru->pErrSockBuf = pBuf;
+      pUStru->ulErrSockLen = pUStru->ulErrSockAlloc = ulLen;
+   }
+   else
+   {
+      hb_xfree( pBuf );
+      pUStru->llErrSockStall = 0;
+   }
+
+   return HB_TRUE;
+}
+
+static HB_THREAD_STARTFUNC( leto_errSockThread )
+{
+   PUSERSTRU * pUsers = NULL;
+   int         iUsers, iAlloc = 0, i, iFinal = 0;
+   HB_BOOL     bRest = HB_FALSE;
+
+   HB_SYMBOL_UNUSED( Cargo );
+   hb_vmThreadInit( NULL );
+   hb_vmUnlock();
+
+   hb_threadEnterCriticalSection( &s_ErrSockMtx );
+   /* at shutdown some rounds more for the shut off notes */
+   while( ! leto_ExitGlobal( HB_FALSE ) || ( s_iErrSockPending && iFinal++ < 100 ) )
+   {
+      if( ! s_iErrSockPending || bRest )
+         hb_threadCondTimedWait( &s_ErrSockCond, &s_ErrSockMtx, s_iErrSockPending ? 10 : 1000 );
+
+      /* snapshot, as the list changes while the mutex is released for sending */
+      iUsers = s_iErrSockPending;
+      if( iUsers > iAlloc )
+      {
+         iAlloc = iUsers + 16;
+         pUsers = ( PUSERSTRU * ) hb_xrealloc( pUsers, sizeof( PUSERSTRU ) * iAlloc );
+      }
+      if( iUsers )
+         memcpy( pUsers, s_pErrSockPending, sizeof( PUSERSTRU ) * iUsers );
+
+      bRest = HB_FALSE;
+      for( i = 0; i < iUsers; i++ )
+      {
+         PUSERSTRU pUStru = pUsers[ i ];
+
+         if( ! pUStru->pErrSockBuf || pUStru->bErrSockDrop )  /* meanwhile closed */
+            continue;
+         if( ! leto_errSockSend( pUStru ) )
+         {
+            int iUserStru = pUStru->iUserStru;
+
+            leto_errSockDrop( pUStru );
+            hb_threadLeaveCriticalSection( &s_ErrSockMtx );
+            hb_vmLock();
+            leto_writelog( NULL, -1, "ERROR second socket of user %d given up: send timeout", iUserStru );
+            hb_vmUnlock();
+            hb_threadEnterCriticalSection( &s_ErrSockMtx );
+         }
+         else if( pUStru->pErrSockBuf )
+            bRest = HB_TRUE;
+         else
+            leto_errSockUnpend( pUStru );
+      }
+   }
+   s_bErrSockThread = HB_FALSE;
+   hb_threadLeaveCriticalSection( &s_ErrSockMtx );
+
+   if( pUsers )
+      hb_xfree( pUsers );
+   hb_vmLock();
+   hb_vmThreadQuit();
+   HB_THREAD_END
+}
+
+static void leto_errSockStart( void )
+{
+   HB_THREAD_ID     th_id;
+   HB_THREAD_HANDLE th_h;
+
+   s_bErrSockThread = HB_TRUE;
+   th_h = hb_threadCreate( &th_id, leto_errSockThread, NULL );
+   if( th_h )
+      hb_threadDetach( th_h );
+   else
+   {
+      s_bErrSockThread = HB_FALSE;
+      leto_writelog( NULL, 0, "ERROR thread for second socket not started, no change notes and delayed errors" );
+   }
+}
+
+/* connection health check at second socket */
+HB_BOOL leto_AskAnswer( PUSERSTRU pUStru )
+{
+   HB_SOCKET hSocket = pUStru->hSocketErr;
+   HB_BOOL   bIsAlive = HB_FALSE;
+   char      szData[ 8 ];
 
    szData[ 4 ] = '+';
    szData[ 5 ] = LETOCMD_ping;
@@ -536,11 +1099,7 @@ HB_BOOL leto_AskAnswer( HB_SOCKET hSocket )
 
    hb_vmUnlock();
 
-#ifdef USE_LZ4
-   if( leto_SockSend( hSocket, szData, 7, 0 ) == 7 )
-#else
-   if( leto_SockSend( hSocket, szData, 7, NULL, 0 ) == 7 )
-#endif
+   if( leto_ErrSockQueue( pUStru, szData, 7 ) )
    {
       char *   pBuffer;
       HB_ULONG ulRecvLen;
@@ -608,8 +1167,13 @@ void leto_SendAnswer2( PUSERSTRU pUStru, const char * szData, HB_ULONG ulLen, HB
 
    if( ! pUStru->bNoAnswer )
    {
+#ifdef USE_LZ4
+      HB_BOOL bUseBuffer = bDelayedError;
+#else
+      HB_BOOL bUseBuffer = bDelayedError || pUStru->zstream;
+#endif
 
-      if( pUStru->ulSndBufLen < ulLen + LETO_MSGSIZE_LEN )
+      if( bUseBuffer && pUStru->ulSndBufLen < ulLen + LETO_MSGSIZE_LEN )
       {
          pUStru->ulSndBufLen = ulLen + LETO_MSGSIZE_LEN;
          pUStru->pSendBuffer = ( HB_BYTE * ) hb_xrealloc( pUStru->pSendBuffer, pUStru->ulSndBufLen + 1 );
@@ -676,7 +1240,7 @@ void leto_SendAnswer2( PUSERSTRU pUStru, const char * szData, HB_ULONG ulLen, HB
          ulLen += LETO_MSGSIZE_LEN;
          pUStru->pSendBuffer[ ulLen ] = '\0';
       }
-      else
+      else if( bUseBuffer )
       {
          HB_PUT_LE_UINT32( ( char * ) pUStru->pSendBuffer, ulLen );
          memcpy( ( char * ) pUStru->pSendBuffer + LETO_MSGSIZE_LEN, szData, ulLen );
@@ -685,10 +1249,21 @@ void leto_SendAnswer2( PUSERSTRU pUStru, const char * szData, HB_ULONG ulLen, HB
       }
 
       hb_vmUnlock();
+      if( bDelayedError )  /* send by leto_errSockThread() */
+         pUStru->ulBytesSend = leto_ErrSockQueue( pUStru, ( char * ) pUStru->pSendBuffer, ulLen ) ? ulLen : 0;
+      else if( ! bUseBuffer )
+      {
+         char szMsgSize[ LETO_MSGSIZE_LEN ];
+
+         HB_PUT_LE_UINT32( szMsgSize, ulLen );
+         pUStru->ulBytesSend = leto_SockSendMsg( hSocket, szMsgSize, LETO_MSGSIZE_LEN, szData, ulLen );
+         ulLen += LETO_MSGSIZE_LEN;
+      }
+      else
 #ifdef USE_LZ4
-      pUStru->ulBytesSend = leto_SockSend( hSocket, ( char * ) pUStru->pSendBuffer, ulLen, 0 );
+         pUStru->ulBytesSend = leto_SockSend( hSocket, ( char * ) pUStru->pSendBuffer, ulLen, 0 );
 #else
-      pUStru->ulBytesSend = leto_SockSend( hSocket, ( char * ) pUStru->pSendBuffer, ulLen, pUStru->zstream, 0 );
+         pUStru->ulBytesSend = leto_SockSend( hSocket, ( char * ) pUStru->pSendBuffer, ulLen, pUStru->zstream, 0 );
 #endif
       hb_vmLock();
 
@@ -707,22 +1282,21 @@ void leto_SendAnswer2( PUSERSTRU pUStru, const char * szData, HB_ULONG ulLen, HB
       {
          if( iDebugMode() <= 20 )
             leto_wUsLog( pUStru, -1, "DEBUG leto_SendAnswer2() %lu bytes", ulLen );
-         else
+         else if( bUseBuffer )
             leto_wUsLog( pUStru, ( ( ulLen > 2048 ) ? 1024 : ulLen ), ( char * ) pUStru->pSendBuffer );
+         else
+            leto_wUsLog( pUStru, ( ( ulLen > 2048 ) ? 1024 : ulLen - LETO_MSGSIZE_LEN ), szData );
       }
    }
 }
 
 void leto_SendAnswer( PUSERSTRU pUStru, const char * szData, HB_ULONG ulLen )
 {
-#if ! defined( MSG_MORE )
-   HB_BOOL bUseBuffer = HB_TRUE;
+   /* send buffer only needed as target for compression/ encryption, else header and szData are send directly */
+#ifdef USE_LZ4
+   HB_BOOL bUseBuffer = hb_lz4netMsgBuffered( ( PHB_LZ4NET ) pUStru->zstream, ulLen );
 #else
-   #ifdef USE_LZ4
-      HB_BOOL bUseBuffer = hb_lz4netEncryptTest( ( PHB_LZ4NET ) pUStru->zstream, ulLen );
-   #else
-      HB_BOOL bUseBuffer = pUStru->zstream ? HB_TRUE : HB_FALSE;
-   #endif
+   HB_BOOL bUseBuffer = pUStru->zstream ? HB_TRUE : HB_FALSE;
 #endif
 
    /* free the area before sending the answer */
@@ -757,8 +1331,20 @@ void leto_SendAnswer( PUSERSTRU pUStru, const char * szData, HB_ULONG ulLen )
    if( bUseBuffer && pUStru->zstream )
    {
 #ifdef USE_LZ4
+      /* record data of an area compresses better with dictionary of its table */
+      hb_lz4netDictUse( ( PHB_LZ4NET ) pUStru->zstream, pUStru->pCurAStru ? pUStru->pCurAStru->iLZ4Dict : 0 );
       ulLen = hb_lz4netEncrypt( ( PHB_LZ4NET ) pUStru->zstream, ( char ** ) &pUStru->pSendBuffer, ulLen, &pUStru->ulSndBufLen, szData );
-      pUStru->ulBytesSend = leto_SockSend( pUStru->hSocket, ( const char * ) pUStru->pSendBuffer, ulLen, 0 );
+      if( ulLen > LETO_SENDRECV_BUFFSIZE * 2 )
+      {
+         /* socket buffer is filled after first 64KB, rest of time is needed by network: feed LZ4 auto-tune */
+         HB_U64 ullStart = leto_MicroSec();
+
+         pUStru->ulBytesSend = leto_SockSend( pUStru->hSocket, ( const char * ) pUStru->pSendBuffer, ulLen, 0 );
+         if( pUStru->ulBytesSend == ulLen )
+            hb_lz4netBandwidth( ( PHB_LZ4NET ) pUStru->zstream, ulLen - LETO_SENDRECV_BUFFSIZE, leto_MicroSec() - ullStart );
+      }
+      else
+         pUStru->ulBytesSend = leto_SockSend( pUStru->hSocket, ( const char * ) pUStru->pSendBuffer, ulLen, 0 );
 #else
       HB_PUT_LE_UINT32( pUStru->pSendBuffer, ulLen );
       memcpy( pUStru->pSendBuffer + LETO_MSGSIZE_LEN, szData, ulLen );
@@ -768,33 +1354,11 @@ void leto_SendAnswer( PUSERSTRU pUStru, const char * szData, HB_ULONG ulLen )
    }
    else
    {
-#if defined( MSG_MORE )
       char szMsgSize[ LETO_MSGSIZE_LEN ];
 
       HB_PUT_LE_UINT32( szMsgSize, ulLen );
-   #ifdef USE_LZ4
-      if( leto_SockSend( pUStru->hSocket, szMsgSize, LETO_MSGSIZE_LEN, MSG_MORE ) == LETO_MSGSIZE_LEN )
-      {
-         pUStru->ulBytesSend = leto_SockSend( pUStru->hSocket, szData, ulLen, 0 ) + LETO_MSGSIZE_LEN;
-         ulLen += LETO_MSGSIZE_LEN;
-      }
-   #else
-      if( leto_SockSend( pUStru->hSocket, szMsgSize, LETO_MSGSIZE_LEN, NULL, MSG_MORE ) == LETO_MSGSIZE_LEN )
-      {
-         pUStru->ulBytesSend = leto_SockSend( pUStru->hSocket, szData, ulLen, NULL, 0 ) + LETO_MSGSIZE_LEN;
-         ulLen += LETO_MSGSIZE_LEN;
-      }
-   #endif
-#else
-      HB_PUT_LE_UINT32( pUStru->pSendBuffer, ulLen );
-      memcpy( pUStru->pSendBuffer + LETO_MSGSIZE_LEN, szData, ulLen );
+      pUStru->ulBytesSend = leto_SockSendMsg( pUStru->hSocket, szMsgSize, LETO_MSGSIZE_LEN, szData, ulLen );
       ulLen += LETO_MSGSIZE_LEN;
-   #ifdef USE_LZ4
-      pUStru->ulBytesSend = leto_SockSend( pUStru->hSocket, ( const char * ) pUStru->pSendBuffer, ulLen, 0 );
-   #else
-      pUStru->ulBytesSend = leto_SockSend( pUStru->hSocket, ( const char * ) pUStru->pSendBuffer, ulLen, NULL, 0 );
-   #endif
-#endif
    }
 
    hb_vmLock();
@@ -811,6 +1375,67 @@ void leto_SendAnswer( PUSERSTRU pUStru, const char * szData, HB_ULONG ulLen )
    }
 }
 
+/* can file chunks of ulLen be send by leto_SendFileChunk(): needs uncompressed and unencrypted traffic,
+ * asked once for a whole transfer */
+HB_BOOL leto_SendFileAble( PUSERSTRU pUStru, HB_ULONG ulLen )
+{
+#if defined( LETO_HAS_SENDFILE )
+   return ! hb_lz4netEncryptTest( ( PHB_LZ4NET ) pUStru->zstream, ulLen + 1 );
+#else
+   HB_SYMBOL_UNUSED( pUStru );
+   HB_SYMBOL_UNUSED( ulLen );
+   return HB_FALSE;
+#endif
+}
+
+/* file segment as one message with leading 'D', send with sendfile() from page cache without copy.
+ * The size head already promised ulLen bytes, so after a short send the connection is closed */
+HB_BOOL leto_SendFileChunk( PUSERSTRU pUStru, HB_FHANDLE hFile, HB_FOFFSET nOffset, HB_ULONG ulLen )
+{
+#if defined( LETO_HAS_SENDFILE )
+   char     szHead[ LETO_MSGSIZE_LEN + 1 ];
+   off_t    nOff = ( off_t ) nOffset;
+   HB_ULONG ulSend = 0;
+   long     lTmp;
+
+   HB_PUT_LE_UINT32( szHead, ulLen + 1 );
+   szHead[ LETO_MSGSIZE_LEN ] = 'D';
+
+   hb_vmUnlock();
+   if( leto_SockSend( pUStru->hSocket, szHead, LETO_MSGSIZE_LEN + 1, MSG_MORE ) == LETO_MSGSIZE_LEN + 1 )
+   {
+      while( ulSend < ulLen )
+      {
+         leto_sockTSD()->ulSysCalls++;
+         lTmp = ( long ) sendfile( pUStru->hSocket, ( int ) hFile, &nOff, ulLen - ulSend );
+         if( lTmp > 0 )
+            ulSend += lTmp;
+         else if( lTmp < 0 && LETO_SOCK_IS_EINTR( LETO_SOCK_GETERROR() ) )
+            continue;
+         else  /* error or file shrinked */
+            break;
+      }
+   }
+   hb_vmLock();
+
+   pUStru->ulBytesSend = ulSend ? ulSend + LETO_MSGSIZE_LEN + 1 : 0;
+   if( ulSend != ulLen )
+   {
+      leto_writelog( NULL, -1, "ERROR leto_SendFileChunk() send %lu of %lu bytes (%d), client %s :%d %s",
+                     ulSend, ulLen, LETO_SOCK_GETERROR(), pUStru->szAddr, pUStru->iPort, pUStru->szExename );
+      pUStru->bCloseConnection = HB_TRUE;
+      return HB_FALSE;
+   }
+   return HB_TRUE;
+#else
+   HB_SYMBOL_UNUSED( pUStru );
+   HB_SYMBOL_UNUSED( hFile );
+   HB_SYMBOL_UNUSED( nOffset );
+   HB_SYMBOL_UNUSED( ulLen );
+   return HB_FALSE;
+#endif
+}
+
 void leto_SendError( PUSERSTRU pUStru, const char * szData, HB_ULONG ulLen )
 {
    HB_ULONG ulLenAll = pUStru->szHbError ? strlen( pUStru->szHbError ) : 0;
@@ -1469,47 +2094,224 @@ static HB_BOOL leto_idleSleep( double dSeconds )
          }
       }
    }
-   return fNoQuit;
-}
-
-HB_FUNC( LETO_IDLESLEEP )
-{
-   double dSeconds = hb_parnd( 1 );
+   return fNoQuit;
+}
+
+HB_FUNC( LETO_IDLESLEEP )
+{
+   double dSeconds = hb_parnd( 1 );
+
+   if( dSeconds > 0 )
+      hb_retl( leto_idleSleep( dSeconds ) );
+}
+
+/* healthy: an extra server thread for periodically testing for dead connections */
+static HB_THREAD_STARTFUNC( healthy )
+{
+   long lTimeNextCheck = s_iZombieCheck / 3;
+   HB_SYMBOL_UNUSED( Cargo );
+   /* we check 3 times per interval, to more early detect if a zombie outreached it's time */
+
+   hb_vmThreadInit( NULL );
+
+   if( iDebugMode() > 0 )
+      leto_writelog( NULL, -1, "DEBUG zombie watch thread active with %d sec interval", s_iZombieCheck );
+
+   while( ! leto_ExitGlobal( HB_FALSE ) && hb_vmRequestQuery() == 0 )
+   {
+      int iZombies;
+
+      /* special idleSleep */
+      if( ! leto_idleSleep( lTimeNextCheck ) )
+         break;
+      iZombies = leto_PingForZombies( s_iZombieCheck );
+
+      if( iZombies > 0 && iDebugMode() > 0 )
+         leto_writelog( NULL, -1, "DEBUG %d zombies send home", iZombies );
+   }
+
+   if( iDebugMode() > 0 )
+      leto_writelog( NULL, 0, "DEBUG zombie watch thread ends " );
+
+   hb_vmThreadQuit();
+   HB_THREAD_END
+}
+
+/* prepare and send initial answer for fresh connect */
+static void leto_SendGreeting( PUSERSTRU pUStru )
+{
+   char     szBuffer[ 128 ];
+   char     szTmp[ 64 ];
+   HB_ULONG ulLen, ulTmp;
+
+   ulTmp = sprintf( szBuffer, "%s %s", LETO_RELEASE_STRING, LETO_VERSION_STRING );
+   szBuffer[ ulTmp++ ] = ';';
+   szBuffer[ ulTmp++ ] = s_bCryptTraf ? 'Y' : 'N';
+
+   leto_random_block( pUStru->cDopcode, LETO_DOPCODE_LEN, 42 );
+   leto_encrypt( pUStru->cDopcode, LETO_DOPCODE_LEN, szTmp, &ulLen, LETO_PASSWORD, HB_TRUE );
+   leto_byte2hexchar( szTmp, ( int ) ulLen, szBuffer + ulTmp );
+   ulLen *= 2;
+   *( szBuffer + ulTmp + ulLen ) = '\0';
+   leto_SendAnswer( pUStru, szBuffer, ulTmp + ulLen );
+
+   HB_GC_LOCKS();
+   s_ullBytesSend += pUStru->ulBytesSend;
+   HB_GC_UNLOCKS();
+}
+
+/* execute a complete received request, returns HB_FALSE if the connection is to be closed */
+#ifdef USE_LZ4
+static HB_BOOL leto_ExecRequest( PUSERSTRU pUStru, HB_ULONG ulRecvLen, HB_BOOL bCompressed )
+#else
+static HB_BOOL leto_ExecRequest( PUSERSTRU pUStru, HB_ULONG ulRecvLen, HB_BOOL * pbCheckForNext )
+#endif
+{
+   HB_ULONG ulSysCalls;
+#ifdef USE_LZ4
+   HB_U64   ullZipIn = 0, ullZipOut = 0;
+   HB_ULONG ulZipPacked = 0, ulZipRaw = 0, ulZipSkipped = 0;
+   int      iZipLevel = 0;
+#endif
+#ifdef LETO_CPU_STATISTIC
+   HB_U64   llTimePoint = leto_MicroSec();
+   HB_U64   ullTimeElapse;
+#endif
+
+#ifdef USE_LZ4
+   if( bCompressed || pUStru->bZipCrypt )  /* means compressed and/or encrypted */
+   {
+      ulRecvLen = hb_lz4netDecrypt( ( PHB_LZ4NET ) pUStru->zstream, ( char ** ) &pUStru->pBuffer, ulRecvLen, &pUStru->ulBufferLen, bCompressed );
+      if( ! ulRecvLen && hb_lz4netStreamFailed( ( PHB_LZ4NET ) pUStru->zstream ) )
+      {  /* lost LZ4 history or a not authentic message: connection is closed, client gets a receive error */
+         leto_writelog( NULL, -1, "ERROR leto_ExecRequest() LZ4 stream out of sync or not authentic [%s:%s]",
+                        pUStru->szAddr, pUStru->szExename );
+         return HB_FALSE;
+      }
+   }
+#endif
+
+   if( ulRecvLen < 2 )  /* must be at least command char + ';' */
+   {
+      if( *pUStru->szExename )
+      {
+         leto_SendAnswer( pUStru, szErr1, 4 );
+         leto_writelog( NULL, -1, "ERROR leto_ExecRequest() command format: %lu too short [%s:%s (%d)]",
+                        ulRecvLen, pUStru->szAddr, pUStru->szExename, LETO_SOCK_GETERROR() );
+         if( ulRecvLen )
+            leto_writelog( NULL, ulRecvLen, ( char * ) pUStru->pBuffer );
+         return HB_TRUE;
+      }
+      else
+      {
+         leto_writelog( NULL, -1, "DEBUG leto_ExecRequest() no LetoDBf client at %s:%d ! wrong command",
+                        pUStru->szAddr, pUStru->iPort );
+         return HB_FALSE;
+      }
+   }
 
-   if( dSeconds > 0 )
-      hb_retl( leto_idleSleep( dSeconds ) );
-}
+   pUStru->ulDataLen = ulRecvLen;
 
-/* healthy: an extra server thread for periodically testing for dead connections */
-static HB_THREAD_STARTFUNC( healthy )
-{
-   long lTimeNextCheck = s_iZombieCheck / 3;
-   HB_SYMBOL_UNUSED( Cargo );
-   /* we check 3 times per interval, to more early detect if a zombie outreached it's time */
+   if( iDebugMode() >= 15 )
+   {
+      leto_wUsLog( pUStru, -1, "<< %s: (len %lu)",
+                               leto_CmdToHuman( *pUStru->pBuffer ),
+                               pUStru->ulDataLen );
+      if( iDebugMode() >= 20 )  /* log complete communication data */
+         leto_wUsLog( pUStru, pUStru->ulDataLen, ( char * ) pUStru->pBuffer );
+   }
 
-   hb_vmThreadInit( NULL );
+   if( s_bCryptTraf && ! pUStru->bZipCrypt )
+   {
+      const char cCmd = *pUStru->pBuffer;
 
-   if( iDebugMode() > 0 )
-      leto_writelog( NULL, -1, "DEBUG zombie watch thread active with %d sec interval", s_iZombieCheck );
+      /* allowed unencrypted requests if encrytion is demanded to use */
+      if( cCmd != LETOCMD_zip && cCmd != LETOCMD_stop && cCmd != LETOCMD_udf_rel )
+      {
+         if( iDebugMode() > 0 )
+            leto_writelog( NULL, -1, "DEBUG leto_ExecRequest() LetoDBf client at %s:%d ! not using encryption",
+                           pUStru->szAddr, pUStru->iPort );
+         return HB_FALSE;
+      }
+   }
 
-   while( ! leto_ExitGlobal( HB_FALSE ) && hb_vmRequestQuery() == 0 )
+   if( ! leto_ParseCommand( pUStru ) )
    {
-      int iZombies;
-
-      /* special idleSleep */
-      if( ! leto_idleSleep( lTimeNextCheck ) )
-         break;
-      iZombies = leto_PingForZombies( s_iZombieCheck );
+      leto_writelog( NULL, 0, "ERROR leto_ParseCommand()" );
+      leto_writelog( NULL, pUStru->ulDataLen, ( char * ) pUStru->pBuffer );
+      if( ! pUStru->ulBytesSend && ! pUStru->bNoAnswer )  /* else client won't expect something after given answer */
+         leto_SendAnswer( pUStru, szErr1, 4 );
+      /* ToDo then a leto_SendAnswer2() ? -- client shell throw RTE */
+   }
+   if( pUStru->bNoAnswer )
+   {
+#ifndef USE_LZ4
+      /* in ZLIB zstream mode, maybe all data from socket is read, but next request already in buffer
+       * then select()/ poll() will sleep and we have to check before ... */
+      if( pUStru->iZipRecord > 0 )
+         *pbCheckForNext = HB_TRUE;
+#endif
+      pUStru->bNoAnswer = HB_FALSE;
+   }
+   if( pUStru->bCloseConnection )  /* commonly together with bNoAnswer, exception wrong Pass leto_Intro */
+      return HB_FALSE;
+
+   /* Note: LetoDB monitor <read> these two values, maybe in a race condition with wrong content,
+    *       but leto_Mgmt() ever ensures a zero terminated copy of this buffer;
+    *       further these values are just used for 'fancy info' */
+   pUStru->llLastAct = leto_MilliSec();
+   memcpy( pUStru->szLastRequest, pUStru->pBuffer, ulRecvLen > 63 ? 63 : ulRecvLen );
+   pUStru->szLastRequest[ ulRecvLen > 63 ? 63 : ulRecvLen ] = '\0';
+   pUStru->iHbError = 0;  /* leave the pUStru->szHbError description for e.g. console monitor */
+   /* resize to default size if last request needed big buffer */
+   if( pUStru->ulBufferLen > LETO_SENDRECV_BUFFSIZE )
+      leto_ReallocUSbuff( pUStru, 0 );  /* '0' means default size */
+#ifdef LETO_CPU_STATISTIC
+   ullTimeElapse = ( HB_U64 ) ( leto_MicroSec() - llTimePoint );
+   pUStru->ullCPULoad += ullTimeElapse;
+#endif
+   ulSysCalls = leto_sockSysCalls();
+#ifdef USE_LZ4
+   if( pUStru->zstream )
+      iZipLevel = hb_lz4netStat( ( PHB_LZ4NET ) pUStru->zstream, &ullZipIn, &ullZipOut,
+                                 &ulZipPacked, &ulZipRaw, &ulZipSkipped, HB_TRUE );
+#endif
 
-      if( iZombies > 0 && iDebugMode() > 0 )
-         leto_writelog( NULL, -1, "DEBUG %d zombies send home", iZombies );
+   HB_GC_LOCKS();
+   s_ullOperations++;
+   s_ullSysCalls += ulSysCalls;
+#ifdef USE_LZ4
+   if( pUStru->zstream )
+   {
+      s_ullZipIn += ullZipIn;
+      s_ullZipOut += ullZipOut;
+      s_ullZipPacked += ulZipPacked;
+      s_ullZipRaw += ulZipRaw;
+      s_ullZipSkipped += ulZipSkipped;
+      s_ullZipLevels += ( HB_U64 ) ulZipPacked * iZipLevel;
    }
+#endif
+   if( pUStru->bBeQuiet )  /* UDF executed, HVM called */
+   {
+      pUStru->bBeQuiet = HB_FALSE;
+      if( ( ++s_ullUDFOps & 0xFF ) == 0 )  /* ToDo verify 256 */
+         pUStru->bGCCollect = HB_TRUE;
+   }
+   s_ullBytesRead += ulRecvLen + LETO_MSGSIZE_LEN;
+   s_ullBytesSend += pUStru->ulBytesSend;
+#ifdef LETO_CPU_STATISTIC
+   s_ullCPULoad += ullTimeElapse;  /* result in us */
+#endif
+   HB_GC_UNLOCKS();
 
-   if( iDebugMode() > 0 )
-      leto_writelog( NULL, 0, "DEBUG zombie watch thread ends " );
+   pUStru->ulBytesSend = 0;
+   if( pUStru->bGCCollect )
+   {
+      hb_gcCollectAll( HB_FALSE );
+      pUStru->bGCCollect = HB_FALSE;
+   }
 
-   hb_vmThreadQuit();
-   HB_THREAD_END
+   return HB_TRUE;
 }
 
 /* ### connection specific thread, one for each connection, this is their main loop ### */
@@ -1517,10 +2319,6 @@ static HB_THREAD_STARTFUNC( thread2 )
 {
    PUSERSTRU pUStru = ( PUSERSTRU ) Cargo;
    HB_ULONG  ulTmp, ulRecvLen = 0;
-#ifdef LETO_CPU_STATISTIC
-   HB_U64    llTimePoint;
-   HB_U64    ullTimeElapse;
-#endif
    int       iChange;
 #ifdef USE_LZ4
    HB_BOOL   bCompressed = HB_FALSE;
@@ -1555,27 +2353,7 @@ static HB_THREAD_STARTFUNC( thread2 )
    leto_initSet();
    leto_wUsLogDelete( pUStru->iUserStru );
 
-   /* prepare and send initial answer for fresh connect */
-   {
-      char     szBuffer[ 128 ];
-      char     szTmp[ 64 ];
-      HB_ULONG ulLen;
-
-      ulTmp = sprintf( szBuffer, "%s %s", LETO_RELEASE_STRING, LETO_VERSION_STRING );
-      szBuffer[ ulTmp++ ] = ';';
-      szBuffer[ ulTmp++ ] = s_bCryptTraf ? 'Y' : 'N';
-
-      leto_random_block( pUStru->cDopcode, LETO_DOPCODE_LEN, 42 );
-      leto_encrypt( pUStru->cDopcode, LETO_DOPCODE_LEN, szTmp, &ulLen, LETO_PASSWORD, HB_TRUE );
-      leto_byte2hexchar( szTmp, ( int ) ulLen, szBuffer + ulTmp );
-      ulLen *= 2;
-      *( szBuffer + ulTmp + ulLen ) = '\0';
-      leto_SendAnswer( pUStru, szBuffer, ulTmp + ulLen );
-
-      HB_GC_LOCKS();
-      s_ullBytesSend += pUStru->ulBytesSend;
-      HB_GC_UNLOCKS();
-   }
+   leto_SendGreeting( pUStru );
 
    while( ! leto_ExitGlobal( HB_FALSE ) && pUStru->hSocket != HB_NO_SOCKET )
    {
@@ -1588,6 +2366,7 @@ static HB_THREAD_STARTFUNC( thread2 )
 
          hb_vmUnlock();
 
+         leto_sockTSD()->ulSysCalls++;
          iChange = poll( pPoll, 1, -1 );
          if( iChange <= 0 )
          {
@@ -1739,10 +2518,6 @@ static HB_THREAD_STARTFUNC( thread2 )
          break;
       }
 
-#ifdef LETO_CPU_STATISTIC
-      llTimePoint = leto_MicroSec();
-#endif
-
       ulRecvLen = HB_GET_LE_UINT32( pUStru->pBuffer );
 #ifdef USE_LZ4
       if( pUStru->zstream )
@@ -1807,120 +2582,330 @@ static HB_THREAD_STARTFUNC( thread2 )
          hb_vmLock();
 
 #ifdef USE_LZ4
-      if( bCompressed || pUStru->bZipCrypt )  /* means compressed and/or encrypted */
-         ulRecvLen = hb_lz4netDecrypt( ( PHB_LZ4NET ) pUStru->zstream, ( char ** ) &pUStru->pBuffer, ulRecvLen, &pUStru->ulBufferLen, bCompressed );
+      if( ! leto_ExecRequest( pUStru, ulRecvLen, bCompressed ) )
+#else
+      if( ! leto_ExecRequest( pUStru, ulRecvLen, &bCheckForNext ) )
 #endif
+         break;
+   }
+
+   leto_CloseUS( pUStru );
+   hb_vmThreadQuit();
+   if( ! *s_UDPServer )  /* HVM thread */
+      hb_gcCollectAll( HB_FALSE );
+   HB_THREAD_END
+}
+
+#if defined( LETO_HAS_EPOLL )
+
+/* ### event driven engine: one epoll() reactor thread watches all idle connections, ###
+ * ### a fixed pool of HVM worker threads executes the requests                     ### */
+
+#define LETO_EV_MAXEVENTS    64
+
+/* pUStru->iEvState of a connection in event mode */
+#define LETO_EV_GREET        1                /* fresh connection, greeting to be send by a worker */
+#define LETO_EV_RECV         2                /* watched by the reactor, request not yet complete */
+#define LETO_EV_EXEC         3                /* complete request queued for any free worker */
+#define LETO_EV_CLOSE        4                /* hangup or error, queued for a worker to close it */
+
+static int            s_iEvFd = -1;           /* epoll() descriptor, -1 means thread2() mode */
+static int            s_iEvWorkers = 0;
+static int            s_iEvConnections = 0;   /* connections served in event mode */
+static PUSERSTRU *    s_pEvQueue = NULL;      /* ring of connections with a job for any worker */
+static int            s_iEvQueueSize = 0;
+static int            s_iEvHead = 0;
+static int            s_iEvCount = 0;
+static HB_CRITICAL_NEW( s_EvMtx );
+static HB_COND_NEW( s_EvCond );
+
+extern void * leto_SetsClone( void );
+extern void leto_SetsRelease( void * pSet );
+extern void leto_ParkUS( PUSERSTRU pUStru );
+extern void leto_UnparkUS( PUSERSTRU pUStru, void * pSetInit, PHB_CODEPAGE cdpInit );
+
+/* a connection is at most once in the queue, so its size of max users can't overflow */
+static void leto_evQueue( PUSERSTRU pUStru, int iEvState )
+{
+   pUStru->iEvState = iEvState;
+   hb_threadEnterCriticalSection( &s_EvMtx );
+   if( s_iEvCount < s_iEvQueueSize )
+   {
+      s_pEvQueue[ ( s_iEvHead + s_iEvCount ) % s_iEvQueueSize ] = pUStru;
+      s_iEvCount++;
+   }
+   hb_threadCondSignal( &s_EvCond );
+   hb_threadLeaveCriticalSection( &s_EvMtx );
+}
 
-      if( ulRecvLen < 2 )  /* must be at least command char + ';' */
+/* EPOLLONESHOT: either the reactor or one worker sees a connection, re-armed after each request */
+static HB_BOOL leto_evArm( PUSERSTRU pUStru, int iOp )
+{
+   struct epoll_event ev;
+
+   ev.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+   ev.data.ptr = ( void * ) pUStru;
+
+   leto_sockTSD()->ulSysCalls++;
+   return epoll_ctl( s_iEvFd, iOp, pUStru->hSocket, &ev ) == 0;
+}
+
+/* reactor: read without waiting what is available of the request into pUStru->pBuffer,
+ * pUStru->ulEvRecv counts the received bytes including the size head, returns new LETO_EV_* state */
+static int leto_evRecv( PUSERSTRU pUStru )
+{
+   for( ;; )
+   {
+      char *   pBuf;
+      HB_ULONG ulWant;
+      long     lTmp;
+
+      if( pUStru->ulEvRecv < LETO_MSGSIZE_LEN )
       {
+         pBuf = ( char * ) pUStru->pBuffer + pUStru->ulEvRecv;
+         ulWant = LETO_MSGSIZE_LEN - pUStru->ulEvRecv;
+      }
+      else
+      {
+         pBuf = ( char * ) pUStru->pBuffer + pUStru->ulEvRecv - LETO_MSGSIZE_LEN;
+         ulWant = ( pUStru->ulEvSize & 0x7FFFFFFF ) - ( pUStru->ulEvRecv - LETO_MSGSIZE_LEN );
+      }
+
+      lTmp = recv( pUStru->hSocket, pBuf, ulWant, MSG_DONTWAIT );
+      if( lTmp < 0 )
+      {
+         if( LETO_SOCK_IS_EINTR( LETO_SOCK_GETERROR() ) )
+            continue;
+         if( LETO_SOCK_IS_EAGAIN( LETO_SOCK_GETERROR() ) )
+            return LETO_EV_RECV;
          if( *pUStru->szExename )
+            leto_writelog( NULL, -1, "ERROR leto_evRecv() recv() %lu of %lu [%s:%s (%d)]",
+                           pUStru->ulEvRecv, ( pUStru->ulEvSize & 0x7FFFFFFF ) + LETO_MSGSIZE_LEN,
+                           pUStru->szAddr, pUStru->szExename, LETO_SOCK_GETERROR() );
+         return LETO_EV_CLOSE;
+      }
+      else if( lTmp == 0 )
+      {
+         if( pUStru->ulEvRecv && *pUStru->szExename )
+            leto_writelog( NULL, -1, "ERROR leto_evRecv() connection closed with %lu bytes of request [%s:%s]",
+                           pUStru->ulEvRecv, pUStru->szAddr, pUStru->szExename );
+         else if( iDebugMode() > 0 && pUStru->bCloseConnection )
+            leto_writelog( NULL, -1, "DEBUG leto_evRecv() %s:%d (%s) terminated by management",
+                           pUStru->szAddr, pUStru->iPort, pUStru->szExename );
+         return LETO_EV_CLOSE;
+      }
+
+      pUStru->ulEvRecv += ( HB_ULONG ) lTmp;
+      if( pUStru->ulEvRecv == LETO_MSGSIZE_LEN )  /* size head complete */
+      {
+         HB_ULONG ulRecvLen;
+
+         /* high bit is the compressed flag of LZ4 traffic */
+         pUStru->ulEvSize = HB_GET_LE_UINT32( pUStru->pBuffer );
+         ulRecvLen = pUStru->zstream ? pUStru->ulEvSize & 0x7FFFFFFF : pUStru->ulEvSize;
+         if( ! ulRecvLen || ulRecvLen > LETO_MAX_RECV_BLOCK )
          {
-            leto_SendAnswer( pUStru, szErr1, 4 );
-            leto_writelog( NULL, -1, "ERROR thread2() command format: %lu too short [%s:%s (%d)]",
-                           ulRecvLen, pUStru->szAddr, pUStru->szExename, LETO_SOCK_GETERROR() );
             if( ulRecvLen )
-               leto_writelog( NULL, ulRecvLen, ( char * ) pUStru->pBuffer );
-            continue;
-         }
-         else
-         {
-            leto_writelog( NULL, -1, "DEBUG thread2() no LetoDBf client at %s:%d ! wrong command",
-                           pUStru->szAddr, pUStru->iPort );
-            break;
+               leto_writelog( NULL, -1, "ERROR leto_evRecv() %s:%d too big packet size %lu",
+                              pUStru->szAddr, pUStru->iPort, ulRecvLen );
+            return LETO_EV_CLOSE;
          }
+         else if( pUStru->ulBufferLen <= ulRecvLen )
+            leto_ReallocUSbuff( pUStru, ulRecvLen );
+      }
+      else if( pUStru->ulEvRecv == ( pUStru->ulEvSize & 0x7FFFFFFF ) + LETO_MSGSIZE_LEN )
+      {
+         pUStru->pBuffer[ pUStru->ulEvRecv - LETO_MSGSIZE_LEN ] = '\0';
+         return LETO_EV_EXEC;
       }
+   }
+}
+
+static HB_THREAD_STARTFUNC( leto_evWorker )
+{
+   PHB_CODEPAGE cdpInit;
+   void *       pSetInit;
+
+   HB_SYMBOL_UNUSED( Cargo );
+   hb_vmThreadInit( NULL );
+   leto_initSet();
+   pSetInit = leto_SetsClone();
+   cdpInit = hb_vmCDP();
 
-      pUStru->ulDataLen = ulRecvLen;
+   /* at shutdown continue until the reactor has passed all connections to be closed */
+   while( ( ! leto_ExitGlobal( HB_FALSE ) || s_iEvConnections > 0 ) && hb_vmRequestQuery() == 0 )
+   {
+      PUSERSTRU pUStru = NULL;
+      HB_BOOL   bKeep;
+      int       iOp = EPOLL_CTL_MOD;
 
-      if( iDebugMode() >= 15 )
+      hb_vmUnlock();
+      hb_threadEnterCriticalSection( &s_EvMtx );
+      if( ! s_iEvCount )
+         hb_threadCondTimedWait( &s_EvCond, &s_EvMtx, 1000 );
+      if( s_iEvCount )
       {
-         leto_wUsLog( pUStru, -1, "<< %s: (len %lu)",
-                                  leto_CmdToHuman( *pUStru->pBuffer ),
-                                  pUStru->ulDataLen );
-         if( iDebugMode() >= 20 )  /* log complete communication data */
-            leto_wUsLog( pUStru, pUStru->ulDataLen, ( char * ) pUStru->pBuffer );
+         pUStru = s_pEvQueue[ s_iEvHead ];
+         s_iEvHead = ( s_iEvHead + 1 ) % s_iEvQueueSize;
+         s_iEvCount--;
       }
+      hb_threadLeaveCriticalSection( &s_EvMtx );
+      hb_vmLock();
+
+      if( ! pUStru )
+         continue;
 
-      if( s_bCryptTraf && ! pUStru->bZipCrypt )
+      leto_UnparkUS( pUStru, pSetInit, cdpInit );
+
+      if( leto_ExitGlobal( HB_FALSE ) || pUStru->hSocket == HB_NO_SOCKET || pUStru->iEvState == LETO_EV_CLOSE )
+         bKeep = HB_FALSE;
+      else if( pUStru->iEvState == LETO_EV_GREET )
       {
-         const char cCmd = *pUStru->pBuffer;
+         leto_wUsLogDelete( pUStru->iUserStru );
+         leto_SendGreeting( pUStru );
+         bKeep = HB_TRUE;
+         iOp = EPOLL_CTL_ADD;
+      }
+      else
+         bKeep = leto_ExecRequest( pUStru, pUStru->ulEvRecv - LETO_MSGSIZE_LEN,
+                                   ( pUStru->ulEvSize & 0x80000000 ) != 0 );
 
-         /* allowed unencrypted requests if encrytion is demanded to use */
-         if( cCmd != LETOCMD_zip && cCmd != LETOCMD_stop && cCmd != LETOCMD_udf_rel )
+      if( bKeep )
+      {
+         /* any worker may take the next request, so the environment is parked before re-arming */
+         leto_ParkUS( pUStru );
+         pUStru->iEvState = LETO_EV_RECV;
+         pUStru->ulEvRecv = 0;
+         pUStru->ulEvSize = 0;
+         if( ! leto_evArm( pUStru, iOp ) )
          {
-            if( iDebugMode() > 0 )
-               leto_writelog( NULL, -1, "DEBUG thread2() LetoDBf client at %s:%d ! not using encryption",
-                              pUStru->szAddr, pUStru->iPort );
-            break;
+            leto_UnparkUS( pUStru, pSetInit, cdpInit );
+            bKeep = HB_FALSE;
          }
       }
 
-      if( ! leto_ParseCommand( pUStru ) )
-      {
-         leto_writelog( NULL, 0, "ERROR leto_ParseCommand()" );
-         leto_writelog( NULL, pUStru->ulDataLen, ( char * ) pUStru->pBuffer );
-         if( ! pUStru->ulBytesSend && ! pUStru->bNoAnswer )  /* else client won't expect something after given answer */
-            leto_SendAnswer( pUStru, szErr1, 4 );
-         /* ToDo then a leto_SendAnswer2() ? -- client shell throw RTE */
-      }
-      if( pUStru->bNoAnswer )
+      if( ! bKeep )
       {
-#ifndef USE_LZ4
-         /* in ZLIB zstream mode, maybe all data from socket is read, but next request already in buffer
-          * then select()/ poll() will sleep and we have to check before ... */
-         if( pUStru->iZipRecord > 0 )
-            bCheckForNext = HB_TRUE;
-#endif
-         pUStru->bNoAnswer = HB_FALSE;
+         if( pUStru->hSocket != HB_NO_SOCKET )
+            epoll_ctl( s_iEvFd, EPOLL_CTL_DEL, pUStru->hSocket, NULL );
+         leto_CloseUS( pUStru );
+         hb_threadEnterCriticalSection( &s_EvMtx );
+         s_iEvConnections--;
+         hb_threadLeaveCriticalSection( &s_EvMtx );
       }
-      if( pUStru->bCloseConnection )  /* commonly together with bNoAnswer, exception wrong Pass leto_Intro */
-         break;
+   }
 
-      /* Note: LetoDB monitor <read> these two values, maybe in a race condition with wrong content,
-       *       but leto_Mgmt() ever ensures a zero terminated copy of this buffer;
-       *       further these values are just used for 'fancy info' */
-      pUStru->llLastAct = leto_MilliSec();
-      memcpy( pUStru->szLastRequest, pUStru->pBuffer, ulRecvLen > 63 ? 63 : ulRecvLen );
-      pUStru->szLastRequest[ ulRecvLen > 63 ? 63 : ulRecvLen ] = '\0';
-      pUStru->iHbError = 0;  /* leave the pUStru->szHbError description for e.g. console monitor */
-      /* resize to default size if last request needed big buffer */
-      if( pUStru->ulBufferLen > LETO_SENDRECV_BUFFSIZE )
-         leto_ReallocUSbuff( pUStru, 0 );  /* '0' means default size */
-#ifdef LETO_CPU_STATISTIC
-      ullTimeElapse = ( HB_U64 ) ( leto_MicroSec() - llTimePoint );
-      pUStru->ullCPULoad += ullTimeElapse;
-#endif
+   leto_SetsRelease( pSetInit );
+   hb_vmThreadQuit();
+   HB_THREAD_END
+}
+
+/* the reactor assembles requests without blocking and passes only complete ones to the workers,
+ * so a slow client occupies no worker and a long request of one connection delays no other */
+static HB_THREAD_STARTFUNC( leto_evReactor )
+{
+   struct epoll_event pEvents[ LETO_EV_MAXEVENTS ];
+   int                iEvents, i;
 
-      HB_GC_LOCKS();
-      s_ullOperations++;
-      if( pUStru->bBeQuiet )  /* UDF executed, HVM called */
+   HB_SYMBOL_UNUSED( Cargo );
+   hb_vmThreadInit( NULL );
+
+   if( iDebugMode() > 0 )
+      leto_writelog( NULL, -1, "DEBUG epoll() reactor active with %d worker threads", s_iEvWorkers );
+
+   while( ! leto_ExitGlobal( HB_FALSE ) || leto_ActiveUser() )
+   {
+      hb_vmUnlock();
+      iEvents = epoll_wait( s_iEvFd, pEvents, LETO_EV_MAXEVENTS, 1000 );
+      hb_vmLock();
+
+      if( iEvents < 0 )
       {
-         pUStru->bBeQuiet = HB_FALSE;
-         if( ( ++s_ullUDFOps & 0xFF ) == 0 )  /* ToDo verify 256 */
-            pUStru->bGCCollect = HB_TRUE;
+         if( LETO_SOCK_IS_EINTR( LETO_SOCK_GETERROR() ) )
+            continue;
+         leto_writelog( NULL, -1, "ERROR leto_evReactor() epoll_wait error: %d", LETO_SOCK_GETERROR() );
+         break;
       }
-      s_ullBytesRead += ulRecvLen + LETO_MSGSIZE_LEN;
-      s_ullBytesSend += pUStru->ulBytesSend;
-#ifdef LETO_CPU_STATISTIC
-      s_ullCPULoad += ullTimeElapse;  /* result in us */
-#endif
-      HB_GC_UNLOCKS();
 
-      pUStru->ulBytesSend = 0;
-      if( pUStru->bGCCollect )
+      /* hangup and errors are detected by recv() */
+      for( i = 0; i < iEvents; i++ )
       {
-         hb_gcCollectAll( HB_FALSE );
-         pUStru->bGCCollect = HB_FALSE;
+         PUSERSTRU pUStru = ( PUSERSTRU ) pEvents[ i ].data.ptr;
+         int       iEvState = leto_evRecv( pUStru );
+
+         if( iEvState != LETO_EV_RECV )
+            leto_evQueue( pUStru, iEvState );
+         else if( ! leto_evArm( pUStru, EPOLL_CTL_MOD ) )
+            leto_evQueue( pUStru, LETO_EV_CLOSE );
       }
    }
 
-   leto_CloseUS( pUStru );
+   if( iDebugMode() > 0 )
+      leto_writelog( NULL, 0, "DEBUG epoll() reactor ends " );
+
    hb_vmThreadQuit();
-   if( ! *s_UDPServer )  /* HVM thread */
-      hb_gcCollectAll( HB_FALSE );
    HB_THREAD_END
 }
 
+/* start reactor and iWorkers threads, HB_FALSE lets fall back to thread2() mode */
+static HB_BOOL leto_evStart( int iWorkers )
+{
+   HB_THREAD_ID     th_id;
+   HB_THREAD_HANDLE th_h;
+   int              i;
+
+   if( leto_NoSaveWA() )
+   {
+      leto_writelog( NULL, 0, "INFO  Event_Workers needs No_Save_WA = 0, using a thread for each connection" );
+      return HB_FALSE;
+   }
+   if( ( s_iEvFd = epoll_create1( EPOLL_CLOEXEC ) ) < 0 )
+   {
+      leto_writelog( NULL, -1, "ERROR epoll_create1() failed: %d, using a thread for each connection", errno );
+      return HB_FALSE;
+   }
+
+   s_iEvQueueSize = leto_MaxUsers();
+   s_pEvQueue = ( PUSERSTRU * ) hb_xgrabz( sizeof( PUSERSTRU ) * s_iEvQueueSize );
+   for( i = 0; i < iWorkers; i++ )
+   {
+      th_h = hb_threadCreate( &th_id, leto_evWorker, NULL );
+      if( th_h )
+         hb_threadDetach( th_h );
+      else
+      {
+         leto_writelog( NULL, -1, "ERROR could only create %d of %d worker threads", i, iWorkers );
+         break;
+      }
+   }
+   s_iEvWorkers = i;
+
+   th_h = s_iEvWorkers ? hb_threadCreate( &th_id, leto_evReactor, NULL ) : NULL;
+   if( th_h )
+      hb_threadDetach( th_h );
+   else
+   {
+      /* started workers will quit with leto_ExitGlobal(), no connections are queued */
+      close( s_iEvFd );
+      s_iEvFd = -1;
+      leto_writelog( NULL, 0, "ERROR epoll() reactor not started, using a thread for each connection" );
+      return HB_FALSE;
+   }
+
+   return HB_TRUE;
+}
+
+/* a new connection is queued for any worker, which will send the greeting */
+static void leto_evAddConnection( PUSERSTRU pUStru )
+{
+   hb_threadEnterCriticalSection( &s_EvMtx );
+   s_iEvConnections++;
+   hb_threadLeaveCriticalSection( &s_EvMtx );
+   leto_evQueue( pUStru, LETO_EV_GREET );
+}
+
+#endif  /* LETO_HAS_EPOLL */
+
 /* ### MASTER MAIN THREAD handling incoming connections, create and dispatch them to threads ### */
 HB_FUNC( LETO_SERVER )
 {
@@ -1937,10 +2922,18 @@ HB_FUNC( LETO_SERVER )
    const char *     szServerAddr = ( hb_parclen( 2 ) > 6 ) ? hb_parc( 2 ) : NULL;
    HB_SOCKET        hSocketMain;               /* main server socket */
    HB_SOCKET        hSocketErr = HB_NO_SOCKET; /* server second socket */
+   HB_SOCKET        hSocketLocal = HB_NO_SOCKET;  /* Unix domain socket for local clients */
+   HB_BOOL          bLocal = HB_FALSE;
    HB_FHANDLE       hThreadPipe[ 2 ] = { FS_ERROR, FS_ERROR };
+#if defined( LETO_LOCAL_SOCKET )
+   char             szLocalPath[ HB_PATH_MAX ];
+#endif
+#if defined( LETO_HAS_EPOLL )
+   int              iEvWorkers = 0;
+#endif
 
 #if 1 && defined( HB_HAS_POLL )
-   struct pollfd pPoll[ 2 ];
+   struct pollfd pPoll[ 3 ];
 #else
    struct timeval MicroWait;
    fd_set readfds;
@@ -1960,6 +2953,10 @@ HB_FUNC( LETO_SERVER )
    }
    if( HB_ISNUM( 4 ) )
       s_iZombieCheck = HB_MAX( hb_parni( 4 ), 0 );
+#if defined( LETO_HAS_EPOLL )
+   if( HB_ISNUM( 8 ) )
+      iEvWorkers = HB_MAX( hb_parni( 8 ), 0 );
+#endif
 
    hb_socketInit();
    if( ( hSocketMain = hb_socketOpen( HB_SOCKET_AF_INET, HB_SOCKET_PT_STREAM, 0 ) ) != HB_NO_SOCKET )
@@ -2010,8 +3007,12 @@ HB_FUNC( LETO_SERVER )
             leto_writelog( NULL, -1, "ERROR to establish second socket port %d: %s",
                            iServerPort + 1, hb_socketErrorStr( hb_socketGetError() ) );
          }
-         else if( iDebugMode() > 0 )
-            leto_writelog( NULL, -1, "DEBUG second socket: %d for errors established", hSocketErr );
+         else
+         {
+            leto_errSockStart();
+            if( iDebugMode() > 0 )
+               leto_writelog( NULL, -1, "DEBUG second socket: %d for errors established", hSocketErr );
+         }
 
          if( pSockAddr )
          {
@@ -2036,6 +3037,48 @@ HB_FUNC( LETO_SERVER )
    }
    s_hSocketMain = hSocketMain;
 
+#if defined( LETO_LOCAL_SOCKET )
+   /* additional listener for clients at same machine, saves the TCP/IP stack */
+   if( hb_parl( 9 ) &&
+       ( hSocketLocal = hb_socketOpen( HB_SOCKET_AF_LOCAL, HB_SOCKET_PT_STREAM, 0 ) ) != HB_NO_SOCKET )
+   {
+      HB_BOOL bFail = HB_TRUE;
+      HB_BOOL bDir = leto_localDir( szLocalPath );
+
+      if( bDir )
+      {
+         hb_snprintf( szLocalPath, HB_PATH_MAX, LETO_LOCAL_SOCKET, ( unsigned ) geteuid(), iServerPort );
+         unlink( szLocalPath );  /* leftover of a crashed server */
+         if( hb_socketLocalAddr( &pSockAddr, &uiLen, szLocalPath ) )
+         {
+            /* any local user may connect, access is checked by login as for TCP */
+            if( hb_socketBind( hSocketLocal, pSockAddr, uiLen ) == 0 && chmod( szLocalPath, 0666 ) == 0 &&
+                hb_socketListen( hSocketLocal, 10 ) == 0 )
+               bFail = HB_FALSE;
+         }
+      }
+      if( pSockAddr )
+      {
+         hb_xfree( pSockAddr );
+         pSockAddr = NULL;
+      }
+
+      if( bFail )
+      {
+         if( ! bDir )
+            leto_writelog( NULL, -1, "ERROR local socket directory %s not created or not private: %s",
+                           szLocalPath, strerror( errno ) );
+         else
+            leto_writelog( NULL, -1, "ERROR to establish local socket %s: %s",
+                           szLocalPath, hb_socketErrorStr( hb_socketGetError() ) );
+         hb_socketClose( hSocketLocal );
+         hSocketLocal = HB_NO_SOCKET;
+      }
+      else if( iDebugMode() > 0 )
+         leto_writelog( NULL, -1, "DEBUG local socket %s established", szLocalPath );
+   }
+#endif
+
    /* the zombie watch thread -- socket not created if not wanted */
    if( s_iZombieCheck && hSocketErr != HB_NO_SOCKET )
    {
@@ -2114,10 +3157,17 @@ HB_FUNC( LETO_SERVER )
    pPoll[ 1 ].fd = hSocketErr;
    pPoll[ 1 ].events = POLLIN | POLLRDNORM;
    pPoll[ 1 ].revents = 0;
+   pPoll[ 2 ].fd = hSocketLocal;
+   pPoll[ 2 ].events = POLLIN | POLLRDNORM;
+   pPoll[ 2 ].revents = 0;
 #endif
 
    leto_CommandSetInit();
    leto_CommandDescInit();
+#if defined( LETO_HAS_EPOLL )
+   if( iEvWorkers > 0 )
+      leto_evStart( iEvWorkers );
+#endif
 
    while( ! leto_ExitGlobal( HB_FALSE ) )
    {
@@ -2132,11 +3182,12 @@ HB_FUNC( LETO_SERVER )
          pSockAddr = NULL;
       }
       incoming = HB_NO_SOCKET;
+      bLocal = HB_FALSE;
 
 #if 1 && defined( HB_HAS_POLL )
 
       hb_vmUnlock();
-      iChange = poll( pPoll, hSocketErr != HB_NO_SOCKET ? 2 : 1, -1 );
+      iChange = poll( pPoll, hSocketLocal != HB_NO_SOCKET ? 3 : ( hSocketErr != HB_NO_SOCKET ? 2 : 1 ), -1 );
       hb_vmLock();
 
       if( iChange <= 0 )
@@ -2171,6 +3222,14 @@ HB_FUNC( LETO_SERVER )
             incoming = hb_socketAccept( hSocketErr, &pSockAddr, &uiLen, 3000 );
             bSocketErr = HB_TRUE;
          }
+         else if( hSocketLocal != HB_NO_SOCKET && pPoll[ 2 ].revents & ( POLLIN | POLLRDNORM ) )
+         {
+            if( iDebugMode() > 21 )
+               leto_writelog( NULL, 0, "DEBUG Server saw activity at local socket ..." );
+            incoming = hb_socketAccept( hSocketLocal, &pSockAddr, &uiLen, 3000 );
+            bSocketErr = HB_FALSE;
+            bLocal = HB_TRUE;
+         }
       }
 #else
       MicroWait.tv_sec = 1;
@@ -2179,9 +3238,13 @@ HB_FUNC( LETO_SERVER )
       FD_SET( hSocketMain, &readfds );
       if( hSocketErr != HB_NO_SOCKET )
          FD_SET( hSocketErr, &readfds );
+      if( hSocketLocal != HB_NO_SOCKET )
+         FD_SET( hSocketLocal, &readfds );
 
       hb_vmUnlock();
-      if( hSocketErr != HB_NO_SOCKET )
+      if( hSocketLocal != HB_NO_SOCKET )
+         iChange = select( ( int ) HB_MAX( hSocketErr, hSocketLocal ) + 1, &readfds, NULL, NULL, &MicroWait );
+      else if( hSocketErr != HB_NO_SOCKET )
          iChange = select( ( int ) hSocketErr + 1, &readfds, NULL, NULL, &MicroWait );
       else
          iChange = select( ( int ) hSocketMain + 1, &readfds, NULL, NULL, &MicroWait );
@@ -2202,6 +3265,14 @@ HB_FUNC( LETO_SERVER )
             bSocketErr = HB_TRUE;
             incoming = hb_socketAccept( hSocketErr, &pSockAddr, &uiLen, 3000 );
          }
+         else if( hSocketLocal != HB_NO_SOCKET && FD_ISSET( hSocketLocal, &readfds )  )
+         {
+            if( iDebugMode() > 21 )
+               leto_writelog( NULL, 0, "DEBUG Server saw activity at local socket ..." );
+            bSocketErr = HB_FALSE;
+            bLocal = HB_TRUE;
+            incoming = hb_socketAccept( hSocketLocal, &pSockAddr, &uiLen, 3000 );
+         }
       }
       else if( iChange == 0 )
          continue;
@@ -2212,7 +3283,13 @@ HB_FUNC( LETO_SERVER )
       }
 #endif
 
-      if( pSockAddr )
+      if( bLocal && incoming != HB_NO_SOCKET )
+      {
+         /* Unix domain peer has no IP, it's per definition a local one */
+         szAddr = hb_strdup( "127.0.0.1" );
+         bExtraWait = HB_TRUE;
+      }
+      else if( pSockAddr )
       {
          szAddr = hb_socketAddrGetName( pSockAddr, uiLen );
          if( szServerAddr )
@@ -2300,9 +3377,11 @@ HB_FUNC( LETO_SERVER )
          }
          else
 #else
-         hb_socketSetKeepAlive( incoming, HB_TRUE );
+         if( ! bLocal )  /* no TCP options for Unix domain socket */
+            hb_socketSetKeepAlive( incoming, HB_TRUE );
 #endif
-         hb_socketSetNoDelay( incoming, HB_TRUE );
+         if( ! bLocal )
+            hb_socketSetNoDelay( incoming, HB_TRUE );
          /* set 64KB send and receive buffer */
          hb_socketSetSndBufSize( incoming, 0xFFFF );
          hb_socketSetRcvBufSize( incoming, 0xFFFF );
@@ -2343,17 +3422,25 @@ HB_FUNC( LETO_SERVER )
          pUStru->ulSndBufLen = LETO_SENDRECV_BUFFSIZE;
          pUStru->pSendBuffer = ( HB_BYTE * ) hb_xgrab( LETO_SENDRECV_BUFFSIZE + 1 );
          pUStru->szAddr = ( HB_BYTE * ) hb_strdup( szAddr );
-         pUStru->iPort = hb_socketAddrGetPort( pSockAddr, uiLen );
+         /* Unix domain peer has no port, but thread3() needs an unique ID to assign the second socket */
+         pUStru->iPort = bLocal ? 0x10000 + ( int ) incoming : hb_socketAddrGetPort( pSockAddr, uiLen );
 
-         pUStru->hThread = hb_threadCreate( &pUStru->hThreadID, thread2, ( void * ) pUStru );
-         if( ! pUStru->hThread )
+#if defined( LETO_HAS_EPOLL )
+         if( s_iEvFd >= 0 )
+            leto_evAddConnection( pUStru );
+         else
+#endif
          {
-            leto_writelog( NULL, 0, "ERROR thread create error !" );
-            leto_SendAnswer( pUStru, "-ERR:MAX_THREADS", 16 );
-            leto_CloseUS( pUStru );
+            pUStru->hThread = hb_threadCreate( &pUStru->hThreadID, thread2, ( void * ) pUStru );
+            if( ! pUStru->hThread )
+            {
+               leto_writelog( NULL, 0, "ERROR thread create error !" );
+               leto_SendAnswer( pUStru, "-ERR:MAX_THREADS", 16 );
+               leto_CloseUS( pUStru );
+            }
+            else
+               hb_threadDetach( pUStru->hThread );
          }
-         else
-            hb_threadDetach( pUStru->hThread );
       }
       else if( hb_socketGetError() & HB_SOCKET_ERR_TIMEOUT )
       {
@@ -2398,6 +3485,13 @@ HB_FUNC( LETO_SERVER )
       hb_socketShutdown( hSocketMain, HB_SOCKET_SHUT_RDWR );
       hb_socketClose( hSocketMain );
    }
+#if defined( LETO_LOCAL_SOCKET )
+   if( hSocketLocal != HB_NO_SOCKET )
+   {
+      hb_socketClose( hSocketLocal );
+      unlink( szLocalPath );
+   }
+#endif
 
    leto_CloseAllSocket();
    hb_idleSleep( 0.5 );  /* give possible many threads a second to finalize their quit */
@@ -995,9 +995,15 @@ void leto_ToggleZip( PUSERSTRU pUStru, char * szData )
 {
    int      iZipRecord = atoi( szData );
    HB_ULONG ulLen;
-   char *   pp1;
+   char *   pp1, * pp2 = NULL, * pp3 = NULL, * pp4 = NULL;
+#ifdef USE_LZ4
+   HB_BOOL  fStream, fChaCha;
+   char     szAnswer[ 8 + 2 * LETO_CRYPT_SALTLEN ];
+   char     szSalt[ 2 * LETO_CRYPT_SALTLEN ];
+   HB_ULONG ulAnswer = 4;
+#endif
 
-   leto_GetParam( szData, &pp1, NULL );
+   leto_GetParam( szData, &pp1, &pp2, &pp3, &pp4, NULL );
 
 #ifdef USE_LZ4
    if( iZipRecord >= -1 && iZipRecord <= 15 )
@@ -1006,7 +1012,30 @@ void leto_ToggleZip( PUSERSTRU pUStru, char * szData )
 #endif
    {
       /* must send answer with *old* setting !! */
+#ifdef USE_LZ4
+      /* optional LZ4 streaming mode acknowledged to client by 'S', ChaCha20-Poly1305 cipher by 'C'
+       * plus the random salt part of server, key derivation salt is client part + server part */
+      fStream = iZipRecord > 0 && pp2 && *pp2 == '1';
+      fChaCha = iZipRecord >= 0 && pp1 && *pp1 && pp3 && *pp3 == '1' &&
+                pp4 && strlen( pp4 ) == 2 * LETO_CRYPT_SALTLEN &&
+                hb_lz4netRandom( szSalt + LETO_CRYPT_SALTLEN, LETO_CRYPT_SALTLEN );
+      memcpy( szAnswer, szOk, 5 );
+      if( fChaCha )
+      {
+         leto_hexchar2byte( pp4, 2 * LETO_CRYPT_SALTLEN, szSalt );
+         szAnswer[ 2 ] = 'C';
+         szAnswer[ 4 ] = ';';
+         leto_byte2hexchar( szSalt + LETO_CRYPT_SALTLEN, LETO_CRYPT_SALTLEN, szAnswer + 5 );
+         ulAnswer = 5 + 2 * LETO_CRYPT_SALTLEN;
+         szAnswer[ ulAnswer++ ] = ';';
+         szAnswer[ ulAnswer ] = '\0';
+      }
+      if( fStream )
+         szAnswer[ 3 ] = 'S';
+      leto_SendAnswer( pUStru, szAnswer, ulAnswer );
+#else
       leto_SendAnswer( pUStru, szOk, 4 );
+#endif
       if( pUStru->zstream )
       {
 #ifdef USE_LZ4
@@ -1021,7 +1050,11 @@ void leto_ToggleZip( PUSERSTRU pUStru, char * szData )
       pUStru->iZipRecord = iZipRecord;
 #ifdef USE_LZ4
       if( pUStru->iZipRecord >= 0 && ! pUStru->zstream )
+      {
          pUStru->zstream = hb_lz4netOpen( pUStru->iZipRecord, HB_ZLIB_STRATEGY_DEFAULT );
+         if( fStream )
+            hb_lz4netStreamMode( ( PHB_LZ4NET ) pUStru->zstream, HB_TRUE );
+      }
 #else
       if( pUStru->iZipRecord > 0 && ! pUStru->zstream )
          pUStru->zstream = hb_znetOpen( pUStru->iZipRecord, HB_ZLIB_STRATEGY_DEFAULT );
@@ -1042,6 +1075,8 @@ void leto_ToggleZip( PUSERSTRU pUStru, char * szData )
          }
 
 #ifdef USE_LZ4
+         if( fChaCha )
+            hb_lz4netCipher( ( PHB_LZ4NET ) pUStru->zstream, LETO_CIPHER_CHACHA20, szSalt, HB_TRUE );
          hb_lz4netEncryptKey( ( PHB_LZ4NET ) pUStru->zstream, szPass, ( int ) ulLen );
 #else
          hb_znetEncryptKey( pUStru->zstream, szPass, ulLen );
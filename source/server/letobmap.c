@@ -0,0 +1,771 @@
+/*
+ * Leto db server compressed record number bitmaps
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307 USA (or visit the web site http://www.gnu.org/).
+ *
+ * As a special exception, the Harbour Project gives permission for
+ * additional uses of the text contained in its release of Harbour.
+ *
+ * The exception is that, if you link the Harbour libraries with other
+ * files to produce an executable, this does not by itself cause the
+ * resulting executable to be covered by the GNU General Public License.
+ * Your use of that executable is in no way restricted on account of
+ * linking the Harbour library code into it.
+ *
+ * This exception does not however invalidate any other reasons why
+ * the executable file might be covered by the GNU General Public License.
+ *
+ * This exception applies only to the code released by the Harbour
+ * Project under the name Harbour.  If you copy code from other
+ * Harbour Project or Free Software Foundation releases into a copy of
+ * Harbour, as the General Public License permits, the exception does
+ * not apply to the code that you add in this way.  To avoid misleading
+ * anyone as to the status of such modified files, you must delete
+ * this exception notice from them.
+ *
+ * If you write modifications of your own for Harbour, it is your choice
+ * whether to permit this exception to apply to your modifications.
+ * If you do not wish that, delete this exception notice.
+ *
+ */
+
+/*
+ * Compressed bitmap of record numbers ( 'roaring' scheme ), used by the LBM_*() bitmap filters.
+ * Values are split into containers by their high 16 bit, each container holds the low 16 bit
+ * either as sorted HB_U16 array ( up to LETOBM_ARRAYMAX values ), or as bitmap of 1024 HB_U64.
+ * So memory is proportional to the count of set record numbers, not to the table size.
+ * Containers are kept sorted by key, set operations are done in place on the first bitmap.
+ */
+
+#include "srvleto.h"
+
+#define LETOBM_ARRAYMAX    4096    /* max. values of array container, above is a bitmap */
+#define LETOBM_WORDS       1024    /* HB_U64 of a bitmap container */
+
+typedef struct
+{
+   HB_U32         uiKey;               /* high 16 bit of values */
+   HB_U32         uiCard;              /* count of values in container */
+   HB_U32         uiAlloc;             /* allocated HB_U16 of array, 0 = bitmap container */
+   void *         pData;               /* HB_U16 * sorted array or HB_U64 * bitmap */
+} LETOBMCONT;
+
+typedef struct
+{
+   LETOBMCONT *   pCont;               /* sorted by uiKey */
+   HB_U32         uiConts;
+   HB_U32         uiAlloc;
+   HB_ULONG       ulCount;             /* count of all values */
+} LETOBMAP;
+
+#define LETOBM_ISBITS( c )    ( ( c )->uiAlloc == 0 )
+
+#if defined( __GNUC__ ) && ( __GNUC__ >= 4 )
+   #define leto_bmPopCount( w )    ( ( HB_U32 ) __builtin_popcountll( w ) )
+   #define leto_bmLowBit( w )      ( ( HB_U32 ) __builtin_ctzll( w ) )
+   #define leto_bmHighBit( w )     ( ( HB_U32 ) ( 63 - __builtin_clzll( w ) ) )
+#else
+static HB_U32 leto_bmPopCount( HB_U64 w )
+{
+   w = w - ( ( w >> 1 ) & HB_ULL( 0x5555555555555555 ) );
+   w = ( w & HB_ULL( 0x3333333333333333 ) ) + ( ( w >> 2 ) & HB_ULL( 0x3333333333333333 ) );
+   w = ( w + ( w >> 4 ) ) & HB_ULL( 0x0F0F0F0F0F0F0F0F );
+   return ( HB_U32 ) ( ( w * HB_ULL( 0x0101010101010101 ) ) >> 56 );
+}
+
+static HB_U32 leto_bmLowBit( HB_U64 w )  /* w != 0 */
+{
+   HB_U32 ui = 0;
+
+   while( ! ( w & 1 ) )
+   {
+      w >>= 1;
+      ui++;
+   }
+   return ui;
+}
+
+static HB_U32 leto_bmHighBit( HB_U64 w )  /* w != 0 */
+{
+   HB_U32 ui = 0;
+
+   while( w >>= 1 )
+      ui++;
+   return ui;
+}
+#endif
+
+/* index of container with uiKey, or -( insert position ) - 1 */
+static long leto_bmFind( LETOBMAP * pBM, HB_U32 uiKey )
+{
+   long lLow = 0, lHigh = ( long ) pBM->uiConts - 1, lMid;
+
+   /* appending ascending record numbers is the common case */
+   if( lHigh >= 0 && pBM->pCont[ lHigh ].uiKey < uiKey )
+      return -( lHigh + 1 ) - 1;
+
+   while( lLow <= lHigh )
+   {
+      lMid = ( lLow + lHigh ) >> 1;
+      if( pBM->pCont[ lMid ].uiKey < uiKey )
+         lLow = lMid + 1;
+      else if( pBM->pCont[ lMid ].uiKey > uiKey )
+         lHigh = lMid - 1;
+      else
+         return lMid;
+   }
+   return -lLow - 1;
+}
+
+/* position of first array value >= uiLow */
+static HB_U32 leto_bmArrayPos( const HB_U16 * pArr, HB_U32 uiCard, HB_U32 uiLow )
+{
+   HB_U32 uiFirst = 0, uiLast = uiCard, uiMid;
+
+   while( uiFirst < uiLast )
+   {
+      uiMid = ( uiFirst + uiLast ) >> 1;
+      if( pArr[ uiMid ] < uiLow )
+         uiFirst = uiMid + 1;
+      else
+         uiLast = uiMid;
+   }
+   return uiFirst;
+}
+
+static LETOBMCONT * leto_bmInsert( LETOBMAP * pBM, HB_U32 uiPos, HB_U32 uiKey )
+{
+   LETOBMCONT * pCont;
+
+   if( pBM->uiConts == pBM->uiAlloc )
+   {
+      pBM->uiAlloc = pBM->uiAlloc ? pBM->uiAlloc << 1 : 4;
+      pBM->pCont = ( LETOBMCONT * ) hb_xrealloc( pBM->pCont, sizeof( LETOBMCONT ) * pBM->uiAlloc );
+   }
+   if( uiPos < pBM->uiConts )
+      memmove( pBM->pCont + uiPos + 1, pBM->pCont + uiPos, sizeof( LETOBMCONT ) * ( pBM->uiConts - uiPos ) );
+   pBM->uiConts++;
+
+   pCont = pBM->pCont + uiPos;
+   pCont->uiKey = uiKey;
+   pCont->uiCard = 0;
+   pCont->uiAlloc = 8;
+   pCont->pData = hb_xgrab( sizeof( HB_U16 ) * 8 );
+   return pCont;
+}
+
+static void leto_bmRemove( LETOBMAP * pBM, HB_U32 uiPos )
+{
+   hb_xfree( pBM->pCont[ uiPos ].pData );
+   pBM->uiConts--;
+   if( uiPos < pBM->uiConts )
+      memmove( pBM->pCont + uiPos, pBM->pCont + uiPos + 1, sizeof( LETOBMCONT ) * ( pBM->uiConts - uiPos ) );
+}
+
+static void leto_bmToWords( LETOBMCONT * pCont, HB_U64 * pWords )
+{
+   if( LETOBM_ISBITS( pCont ) )
+      memcpy( pWords, pCont->pData, sizeof( HB_U64 ) * LETOBM_WORDS );
+   else
+   {
+      const HB_U16 * pArr = ( const HB_U16 * ) pCont->pData;
+      HB_U32         ui;
+
+      memset( pWords, 0, sizeof( HB_U64 ) * LETOBM_WORDS );
+      for( ui = 0; ui < pCont->uiCard; ui++ )
+         pWords[ pArr[ ui ] >> 6 ] |= ( HB_U64 ) 1 << ( pArr[ ui ] & 63 );
+   }
+}
+
+/* replace container content with pWords, choosing the smaller representation */
+static void leto_bmFromWords( LETOBMCONT * pCont, const HB_U64 * pWords )
+{
+   HB_U32 uiCard = 0, ui;
+
+   for( ui = 0; ui < LETOBM_WORDS; ui++ )
+   {
+      if( pWords[ ui ] )
+         uiCard += leto_bmPopCount( pWords[ ui ] );
+   }
+
+   if( uiCard > LETOBM_ARRAYMAX )
+   {
+      if( ! LETOBM_ISBITS( pCont ) )
+      {
+         hb_xfree( pCont->pData );
+         pCont->pData = hb_xgrab( sizeof( HB_U64 ) * LETOBM_WORDS );
+         pCont->uiAlloc = 0;
+      }
+      if( pCont->pData != ( const void * ) pWords )
+         memcpy( pCont->pData, pWords, sizeof( HB_U64 ) * LETOBM_WORDS );
+   }
+   else
+   {
+      HB_U16 * pArr;
+      HB_U32   uiPos = 0;
+      HB_BOOL  fNew = LETOBM_ISBITS( pCont ) || pCont->uiAlloc < uiCard;
+
+      /* pWords may be the old bitmap of this container */
+      if( fNew )
+         pArr = ( HB_U16 * ) hb_xgrab( sizeof( HB_U16 ) * ( uiCard ? uiCard : 8 ) );
+      else
+         pArr = ( HB_U16 * ) pCont->pData;
+      for( ui = 0; ui < LETOBM_WORDS; ui++ )
+      {
+         HB_U64 w = pWords[ ui ];
+
+         while( w )
+         {
+            pArr[ uiPos++ ] = ( HB_U16 ) ( ( ui << 6 ) + leto_bmLowBit( w ) );
+            w &= w - 1;
+         }
+      }
+      if( fNew )
+      {
+         hb_xfree( pCont->pData );
+         pCont->pData = pArr;
+         pCont->uiAlloc = uiCard ? uiCard : 8;
+      }
+   }
+   pCont->uiCard = uiCard;
+}
+
+/* first value >= uiLow in container, or -1 */
+static long leto_bmContNext( LETOBMCONT * pCont, HB_U32 uiLow )
+{
+   if( LETOBM_ISBITS( pCont ) )
+   {
+      const HB_U64 * pWords = ( const HB_U64 * ) pCont->pData;
+      HB_U32         ui = uiLow >> 6;
+      HB_U64         w = pWords[ ui ] & ( ~( HB_U64 ) 0 << ( uiLow & 63 ) );
+
+      for( ;; )
+      {
+         if( w )
+            return ( long ) ( ( ui << 6 ) + leto_bmLowBit( w ) );
+         if( ++ui >= LETOBM_WORDS )
+            break;
+         w = pWords[ ui ];
+      }
+   }
+   else
+   {
+      HB_U32 uiPos = leto_bmArrayPos( ( const HB_U16 * ) pCont->pData, pCont->uiCard, uiLow );
+
+      if( uiPos < pCont->uiCard )
+         return ( ( const HB_U16 * ) pCont->pData )[ uiPos ];
+   }
+   return -1;
+}
+
+/* last value <= uiLow in container, or -1 */
+static long leto_bmContPrev( LETOBMCONT * pCont, HB_U32 uiLow )
+{
+   if( LETOBM_ISBITS( pCont ) )
+   {
+      const HB_U64 * pWords = ( const HB_U64 * ) pCont->pData;
+      long           l = ( long ) ( uiLow >> 6 );
+      HB_U64         w = pWords[ l ] & ( ~( HB_U64 ) 0 >> ( 63 - ( uiLow & 63 ) ) );
+
+      for( ;; )
+      {
+         if( w )
+            return ( l << 6 ) + ( long ) leto_bmHighBit( w );
+         if( --l < 0 )
+            break;
+         w = pWords[ l ];
+      }
+   }
+   else
+   {
+      HB_U32 uiPos = leto_bmArrayPos( ( const HB_U16 * ) pCont->pData, pCont->uiCard, uiLow + 1 );
+
+      if( uiPos )
+         return ( ( const HB_U16 * ) pCont->pData )[ uiPos - 1 ];
+   }
+   return -1;
+}
+
+void * leto_BmNew( void )
+{
+   return hb_xgrabz( sizeof( LETOBMAP ) );
+}
+
+void leto_BmFree( void * pBitmap )
+{
+   LETOBMAP * pBM = ( LETOBMAP * ) pBitmap;
+   HB_U32     ui;
+
+   for( ui = 0; ui < pBM->uiConts; ui++ )
+      hb_xfree( pBM->pCont[ ui ].pData );
+   if( pBM->pCont )
+      hb_xfree( pBM->pCont );
+   hb_xfree( pBM );
+}
+
+HB_ULONG leto_BmCount( void * pBitmap )
+{
+   return ( ( LETOBMAP * ) pBitmap )->ulCount;
+}
+
+/* independent copy of pBitmap */
+void * leto_BmCopy( void * pBitmap )
+{
+   LETOBMAP * pBM = ( LETOBMAP * ) pBitmap;
+   LETOBMAP * pCopy = ( LETOBMAP * ) hb_xgrabz( sizeof( LETOBMAP ) );
+   HB_U32     ui;
+
+   if( pBM->uiConts )
+   {
+      pCopy->pCont = ( LETOBMCONT * ) hb_xgrab( sizeof( LETOBMCONT ) * pBM->uiConts );
+      pCopy->uiConts = pCopy->uiAlloc = pBM->uiConts;
+      pCopy->ulCount = pBM->ulCount;
+      for( ui = 0; ui < pBM->uiConts; ui++ )
+      {
+         LETOBMCONT * pCont = pBM->pCont + ui;
+         HB_SIZE      nSize = LETOBM_ISBITS( pCont ) ? sizeof( HB_U64 ) * LETOBM_WORDS :
+                                                       sizeof( HB_U16 ) * pCont->uiAlloc;
+
+         pCopy->pCont[ ui ] = *pCont;
+         pCopy->pCont[ ui ].pData = hb_xgrab( nSize );
+         memcpy( pCopy->pCont[ ui ].pData, pCont->pData, nSize );
+      }
+   }
+   return pCopy;
+}
+
+/* allocated bytes of pBitmap */
+HB_SIZE leto_BmSize( void * pBitmap )
+{
+   LETOBMAP * pBM = ( LETOBMAP * ) pBitmap;
+   HB_SIZE    nSize = sizeof( LETOBMAP ) + sizeof( LETOBMCONT ) * pBM->uiAlloc;
+   HB_U32     ui;
+
+   for( ui = 0; ui < pBM->uiConts; ui++ )
+   {
+      LETOBMCONT * pCont = pBM->pCont + ui;
+
+      nSize += LETOBM_ISBITS( pCont ) ? sizeof( HB_U64 ) * LETOBM_WORDS : sizeof( HB_U16 ) * pCont->uiAlloc;
+   }
+   return nSize;
+}
+
+void leto_BmAdd( void * pBitmap, HB_ULONG ulRecNo )
+{
+   LETOBMAP *   pBM = ( LETOBMAP * ) pBitmap;
+   LETOBMCONT * pCont;
+   HB_U32       uiLow = ( HB_U32 ) ( ulRecNo & 0xFFFF );
+   long         lPos;
+
+   if( ! ulRecNo || ulRecNo > 0xFFFFFFFF )
+      return;
+
+   lPos = leto_bmFind( pBM, ( HB_U32 ) ( ulRecNo >> 16 ) );
+   if( lPos < 0 )
+      pCont = leto_bmInsert( pBM, ( HB_U32 ) ( -lPos - 1 ), ( HB_U32 ) ( ulRecNo >> 16 ) );
+   else
+      pCont = pBM->pCont + lPos;
+
+   if( LETOBM_ISBITS( pCont ) )
+   {
+      HB_U64 * pWord = ( HB_U64 * ) pCont->pData + ( uiLow >> 6 );
+      HB_U64   wBit = ( HB_U64 ) 1 << ( uiLow & 63 );
+
+      if( *pWord & wBit )
+         return;
+      *pWord |= wBit;
+   }
+   else
+   {
+      HB_U16 * pArr = ( HB_U16 * ) pCont->pData;
+      HB_U32   uiPos;
+
+      if( ! pCont->uiCard || pArr[ pCont->uiCard - 1 ] < uiLow )
+         uiPos = pCont->uiCard;
+      else
+      {
+         uiPos = leto_bmArrayPos( pArr, pCont->uiCard, uiLow );
+         if( pArr[ uiPos ] == uiLow )
+            return;
+      }
+
+      if( pCont->uiCard == LETOBM_ARRAYMAX )
+      {
+         HB_U64 * pWords = ( HB_U64 * ) hb_xgrab( sizeof( HB_U64 ) * LETOBM_WORDS );
+
+         leto_bmToWords( pCont, pWords );
+         pWords[ uiLow >> 6 ] |= ( HB_U64 ) 1 << ( uiLow & 63 );
+         hb_xfree( pCont->pData );
+         pCont->pData = pWords;
+         pCont->uiAlloc = 0;
+      }
+      else
+      {
+         if( pCont->uiCard == pCont->uiAlloc )
+         {
+            pCont->uiAlloc = HB_MIN( pCont->uiAlloc << 1, LETOBM_ARRAYMAX );
+            pCont->pData = pArr = ( HB_U16 * ) hb_xrealloc( pArr, sizeof( HB_U16 ) * pCont->uiAlloc );
+         }
+         if( uiPos < pCont->uiCard )
+            memmove( pArr + uiPos + 1, pArr + uiPos, sizeof( HB_U16 ) * ( pCont->uiCard - uiPos ) );
+         pArr[ uiPos ] = ( HB_U16 ) uiLow;
+      }
+   }
+   pCont->uiCard++;
+   pBM->ulCount++;
+}
+
+void leto_BmDel( void * pBitmap, HB_ULONG ulRecNo )
+{
+   LETOBMAP *   pBM = ( LETOBMAP * ) pBitmap;
+   LETOBMCONT * pCont;
+   HB_U32       uiLow = ( HB_U32 ) ( ulRecNo & 0xFFFF );
+   long         lPos;
+
+   if( ! ulRecNo || ulRecNo > 0xFFFFFFFF )
+      return;
+
+   lPos = leto_bmFind( pBM, ( HB_U32 ) ( ulRecNo >> 16 ) );
+   if( lPos < 0 )
+      return;
+   pCont = pBM->pCont + lPos;
+
+   if( LETOBM_ISBITS( pCont ) )
+   {
+      HB_U64 * pWord = ( HB_U64 * ) pCont->pData + ( uiLow >> 6 );
+      HB_U64   wBit = ( HB_U64 ) 1 << ( uiLow & 63 );
+
+      if( ! ( *pWord & wBit ) )
+         return;
+      *pWord &= ~wBit;
+      if( pCont->uiCard - 1 <= LETOBM_ARRAYMAX / 2 )  /* shrink with some hysteresis */
+         leto_bmFromWords( pCont, ( HB_U64 * ) pCont->pData );
+      else
+         pCont->uiCard--;
+   }
+   else
+   {
+      HB_U16 * pArr = ( HB_U16 * ) pCont->pData;
+      HB_U32   uiPos = leto_bmArrayPos( pArr, pCont->uiCard, uiLow );
+
+      if( uiPos >= pCont->uiCard || pArr[ uiPos ] != uiLow )
+         return;
+      pCont->uiCard--;
+      if( uiPos < pCont->uiCard )
+         memmove( pArr + uiPos, pArr + uiPos + 1, sizeof( HB_U16 ) * ( pCont->uiCard - uiPos ) );
+   }
+   pBM->ulCount--;
+   if( ! pCont->uiCard )
+      leto_bmRemove( pBM, ( HB_U32 ) lPos );
+}
+
+HB_BOOL leto_BmHas( void * pBitmap, HB_ULONG ulRecNo )
+{
+   LETOBMAP *   pBM = ( LETOBMAP * ) pBitmap;
+   LETOBMCONT * pCont;
+   HB_U32       uiLow = ( HB_U32 ) ( ulRecNo & 0xFFFF );
+   long         lPos;
+
+   if( ! ulRecNo || ulRecNo > 0xFFFFFFFF )
+      return HB_FALSE;
+
+   lPos = leto_bmFind( pBM, ( HB_U32 ) ( ulRecNo >> 16 ) );
+   if( lPos < 0 )
+      return HB_FALSE;
+   pCont = pBM->pCont + lPos;
+
+   if( LETOBM_ISBITS( pCont ) )
+      return ( ( ( HB_U64 * ) pCont->pData )[ uiLow >> 6 ] >> ( uiLow & 63 ) ) & 1;
+   else
+   {
+      HB_U32 uiPos = leto_bmArrayPos( ( HB_U16 * ) pCont->pData, pCont->uiCard, uiLow );
+
+      return uiPos < pCont->uiCard && ( ( HB_U16 * ) pCont->pData )[ uiPos ] == uiLow;
+   }
+}
+
+/* smallest value > ulRecNo, 0 if none */
+HB_ULONG leto_BmNext( void * pBitmap, HB_ULONG ulRecNo )
+{
+   LETOBMAP * pBM = ( LETOBMAP * ) pBitmap;
+   HB_U32     uiPos;
+   long       lPos, lLow;
+
+   if( ulRecNo >= 0xFFFFFFFF )
+      return 0;
+   ulRecNo++;
+
+   lPos = leto_bmFind( pBM, ( HB_U32 ) ( ulRecNo >> 16 ) );
+   if( lPos >= 0 )
+   {
+      lLow = leto_bmContNext( pBM->pCont + lPos, ( HB_U32 ) ( ulRecNo & 0xFFFF ) );
+      if( lLow >= 0 )
+         return ( ( HB_ULONG ) pBM->pCont[ lPos ].uiKey << 16 ) + ( HB_ULONG ) lLow;
+      uiPos = ( HB_U32 ) lPos + 1;
+   }
+   else
+      uiPos = ( HB_U32 ) ( -lPos - 1 );
+
+   if( uiPos < pBM->uiConts )  /* containers are never empty */
+      return ( ( HB_ULONG ) pBM->pCont[ uiPos ].uiKey << 16 ) +
+             ( HB_ULONG ) leto_bmContNext( pBM->pCont + uiPos, 0 );
+   return 0;
+}
+
+/* largest value < ulRecNo, 0 if none */
+HB_ULONG leto_BmPrev( void * pBitmap, HB_ULONG ulRecNo )
+{
+   LETOBMAP * pBM = ( LETOBMAP * ) pBitmap;
+   long       lPos, lLow;
+
+   if( ! ulRecNo )
+      return 0;
+   if( ulRecNo > 0xFFFFFFFF )
+      ulRecNo = 0xFFFFFFFF;
+   else
+      ulRecNo--;
+
+   lPos = leto_bmFind( pBM, ( HB_U32 ) ( ulRecNo >> 16 ) );
+   if( lPos >= 0 )
+   {
+      lLow = leto_bmContPrev( pBM->pCont + lPos, ( HB_U32 ) ( ulRecNo & 0xFFFF ) );
+      if( lLow >= 0 )
+         return ( ( HB_ULONG ) pBM->pCont[ lPos ].uiKey << 16 ) + ( HB_ULONG ) lLow;
+   }
+   else
+      lPos = -lPos - 1;
+
+   if( lPos > 0 )
+   {
+      lPos--;
+      return ( ( HB_ULONG ) pBM->pCont[ lPos ].uiKey << 16 ) +
+             ( HB_ULONG ) leto_bmContPrev( pBM->pCont + lPos, 0xFFFF );
+   }
+   return 0;
+}
+
+/* count of values <= ulRecNo */
+HB_ULONG leto_BmRank( void * pBitmap, HB_ULONG ulRecNo )
+{
+   LETOBMAP * pBM = ( LETOBMAP * ) pBitmap;
+   HB_ULONG   ulRank = 0;
+   HB_U32     ui, uiKey;
+
+   if( ulRecNo >= 0xFFFFFFFF )
+      return pBM->ulCount;
+
+   uiKey = ( HB_U32 ) ( ulRecNo >> 16 );
+   for( ui = 0; ui < pBM->uiConts && pBM->pCont[ ui ].uiKey < uiKey; ui++ )
+      ulRank += pBM->pCont[ ui ].uiCard;
+
+   if( ui < pBM->uiConts && pBM->pCont[ ui ].uiKey == uiKey )
+   {
+      LETOBMCONT * pCont = pBM->pCont + ui;
+      HB_U32       uiLow = ( HB_U32 ) ( ulRecNo & 0xFFFF );
+
+      if( LETOBM_ISBITS( pCont ) )
+      {
+         const HB_U64 * pWords = ( const HB_U64 * ) pCont->pData;
+
+         for( ui = 0; ui < ( uiLow >> 6 ); ui++ )
+         {
+            if( pWords[ ui ] )
+               ulRank += leto_bmPopCount( pWords[ ui ] );
+         }
+         ulRank += leto_bmPopCount( pWords[ ui ] & ( ~( HB_U64 ) 0 >> ( 63 - ( uiLow & 63 ) ) ) );
+      }
+      else
+         ulRank += leto_bmArrayPos( ( const HB_U16 * ) pCont->pData, pCont->uiCard, uiLow + 1 );
+   }
+   return ulRank;
+}
+
+/* pBitmap := pBitmap .AND. pOther */
+void leto_BmAnd( void * pBitmap, void * pOther )
+{
+   LETOBMAP * pBM = ( LETOBMAP * ) pBitmap;
+   LETOBMAP * pBM2 = ( LETOBMAP * ) pOther;
+   HB_U64 *   pWords = NULL, * pWords2 = NULL;
+   HB_U32     ui = 0, uiW;
+   long       lPos;
+
+   while( ui < pBM->uiConts )
+   {
+      LETOBMCONT * pCont = pBM->pCont + ui;
+
+      lPos = leto_bmFind( pBM2, pCont->uiKey );
+      if( lPos >= 0 )
+      {
+         if( ! pWords )
+         {
+            pWords = ( HB_U64 * ) hb_xgrab( sizeof( HB_U64 ) * LETOBM_WORDS * 2 );
+            pWords2 = pWords + LETOBM_WORDS;
+         }
+         pBM->ulCount -= pCont->uiCard;
+         leto_bmToWords( pCont, pWords );
+         leto_bmToWords( pBM2->pCont + lPos, pWords2 );
+         for( uiW = 0; uiW < LETOBM_WORDS; uiW++ )
+            pWords[ uiW ] &= pWords2[ uiW ];
+         leto_bmFromWords( pCont, pWords );
+         pBM->ulCount += pCont->uiCard;
+      }
+      else
+      {
+         pBM->ulCount -= pCont->uiCard;
+         pCont->uiCard = 0;
+      }
+
+      if( pCont->uiCard )
+         ui++;
+      else
+         leto_bmRemove( pBM, ui );
+   }
+   if( pWords )
+      hb_xfree( pWords );
+}
+
+/* pBitmap := pBitmap .OR. pOther */
+void leto_BmOr( void * pBitmap, void * pOther )
+{
+   LETOBMAP * pBM = ( LETOBMAP * ) pBitmap;
+   LETOBMAP * pBM2 = ( LETOBMAP * ) pOther;
+   HB_U64 *   pWords = NULL, * pWords2 = NULL;
+   HB_U32     ui, uiW;
+   long       lPos;
+
+   for( ui = 0; ui < pBM2->uiConts; ui++ )
+   {
+      LETOBMCONT * pCont2 = pBM2->pCont + ui;
+      LETOBMCONT * pCont;
+
+      if( ! pWords )
+      {
+         pWords = ( HB_U64 * ) hb_xgrab( sizeof( HB_U64 ) * LETOBM_WORDS * 2 );
+         pWords2 = pWords + LETOBM_WORDS;
+      }
+      lPos = leto_bmFind( pBM, pCont2->uiKey );
+      if( lPos < 0 )
+      {
+         pCont = leto_bmInsert( pBM, ( HB_U32 ) ( -lPos - 1 ), pCont2->uiKey );
+         leto_bmToWords( pCont2, pWords );
+      }
+      else
+      {
+         pCont = pBM->pCont + lPos;
+         pBM->ulCount -= pCont->uiCard;
+         leto_bmToWords( pCont, pWords );
+         leto_bmToWords( pCont2, pWords2 );
+         for( uiW = 0; uiW < LETOBM_WORDS; uiW++ )
+            pWords[ uiW ] |= pWords2[ uiW ];
+      }
+      leto_bmFromWords( pCont, pWords );
+      pBM->ulCount += pCont->uiCard;
+   }
+   if( pWords )
+      hb_xfree( pWords );
+}
+
+/* pBitmap := pBitmap .AND. .NOT. pOther */
+void leto_BmAndNot( void * pBitmap, void * pOther )
+{
+   LETOBMAP * pBM = ( LETOBMAP * ) pBitmap;
+   LETOBMAP * pBM2 = ( LETOBMAP * ) pOther;
+   HB_U64 *   pWords = NULL, * pWords2 = NULL;
+   HB_U32     ui = 0, uiW;
+   long       lPos;
+
+   while( ui < pBM->uiConts )
+   {
+      LETOBMCONT * pCont = pBM->pCont + ui;
+
+      lPos = leto_bmFind( pBM2, pCont->uiKey );
+      if( lPos >= 0 )
+      {
+         if( ! pWords )
+         {
+            pWords = ( HB_U64 * ) hb_xgrab( sizeof( HB_U64 ) * LETOBM_WORDS * 2 );
+            pWords2 = pWords + LETOBM_WORDS;
+         }
+         pBM->ulCount -= pCont->uiCard;
+         leto_bmToWords( pCont, pWords );
+         leto_bmToWords( pBM2->pCont + lPos, pWords2 );
+         for( uiW = 0; uiW < LETOBM_WORDS; uiW++ )
+            pWords[ uiW ] &= ~pWords2[ uiW ];
+         leto_bmFromWords( pCont, pWords );
+         pBM->ulCount += pCont->uiCard;
+      }
+
+      if( pCont->uiCard )
+         ui++;
+      else
+         leto_bmRemove( pBM, ui );
+   }
+   if( pWords )
+      hb_xfree( pWords );
+}
+
+/* new bitmap from array of record numbers, non numeric items are ignored */
+void * leto_BmFromArray( PHB_ITEM pArray )
+{
+   void *  pBitmap = leto_BmNew();
+   HB_SIZE nLen = hb_arrayLen( pArray ), n;
+
+   for( n = 1; n <= nLen; n++ )
+   {
+      if( hb_arrayGetType( pArray, n ) & HB_IT_NUMERIC )
+         leto_BmAdd( pBitmap, ( HB_ULONG ) hb_arrayGetNL( pArray, n ) );
+   }
+   return pBitmap;
+}
+
+/* new array with all record numbers in ascending order */
+PHB_ITEM leto_BmToArray( void * pBitmap )
+{
+   LETOBMAP * pBM = ( LETOBMAP * ) pBitmap;
+   PHB_ITEM   pArray = hb_itemArrayNew( pBM->ulCount );
+   HB_SIZE    n = 1;
+   HB_U32     ui, uiW;
+
+   for( ui = 0; ui < pBM->uiConts; ui++ )
+   {
+      LETOBMCONT * pCont = pBM->pCont + ui;
+      HB_ULONG     ulBase = ( HB_ULONG ) pCont->uiKey << 16;
+
+      if( LETOBM_ISBITS( pCont ) )
+      {
+         const HB_U64 * pWords = ( const HB_U64 * ) pCont->pData;
+
+         for( uiW = 0; uiW < LETOBM_WORDS; uiW++ )
+         {
+            HB_U64 w = pWords[ uiW ];
+
+            while( w )
+            {
+               hb_arraySetNL( pArray, n++, ( long ) ( ulBase + ( uiW << 6 ) + leto_bmLowBit( w ) ) );
+               w &= w - 1;
+            }
+         }
+      }
+      else
+      {
+         const HB_U16 * pArr = ( const HB_U16 * ) pCont->pData;
+
+         for( uiW = 0; uiW < pCont->uiCard; uiW++ )
+            hb_arraySetNL( pArray, n++, ( long ) ( ulBase + pArr[ uiW ] ) );
+      }
+   }
+   return pArray;
+}
@@ -0,0 +1,377 @@
+/*
+ * Leto db server filter result cache
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307 USA (or visit the web site http://www.gnu.org/).
+ *
+ * As a special exception, the Harbour Project gives permission for
+ * additional uses of the text contained in its release of Harbour.
+ *
+ * The exception is that, if you link the Harbour libraries with other
+ * files to produce an executable, this does not by itself cause the
+ * resulting executable to be covered by the GNU General Public License.
+ * Your use of that executable is in no way restricted on account of
+ * linking the Harbour library code into it.
+ *
+ * This exception does not however invalidate any other reasons why
+ * the executable file might be covered by the GNU General Public License.
+ *
+ * This exception applies only to the code released by the Harbour
+ * Project under the name Harbour.  If you copy code from other
+ * Harbour Project or Free Software Foundation releases into a copy of
+ * Harbour, as the General Public License permits, the exception does
+ * not apply to the code that you add in this way.  To avoid misleading
+ * anyone as to the status of such modified files, you must delete
+ * this exception notice from them.
+ *
+ * If you write modifications of your own for Harbour, it is your choice
+ * whether to permit this exception to apply to your modifications.
+ * If you do not wish that, delete this exception notice.
+ *
+ */
+
+/*
+ * Cache of LBM_DbSetFilter() results shared by all connections, keyed by table, order, scopes,
+ * filter text and the SETs the filter result depends on. Each GLOBESTRU counts changes of its table in ulVersion, an entry
+ * is valid as long as its stamp equals that version plus the epoch of untracked changes ( UDF ).
+ * Entries in natural order or without scope and with a native filter are patched at record
+ * changes by evaluating the new record image, all others are dropped.
+ * Size is bounded by leto_FCacheSetSize(), least recently used entries are removed first.
+ */
+
+#include "srvleto.h"
+#include "hbapicdp.h"
+
+typedef struct _LETOFCACHE
+{
+   PGLOBESTRU           pGlobe;
+   char *               szKey;
+   HB_SIZE              nKeyLen;
+   PHB_CODEPAGE         cdp;
+   HB_ULONG             ulStamp;          /* pGlobe->ulVersion + s_ulEpoch at result time */
+   void *               pBitmap;
+   void *               pFltPrg;          /* for patching, NULL = all records */
+   HB_BOOL              fPatch;           /* result only depends on record itself */
+   HB_BOOL              fDeleted;         /* SET DELETED was on */
+   HB_BOOL              fExact;           /* SET EXACT was on, for patching */
+   HB_SIZE              nBytes;
+   struct _LETOFCACHE * pPrev;            /* more recently used */
+   struct _LETOFCACHE * pNext;
+} LETOFCACHE;
+
+static HB_CRITICAL_NEW( s_FCacheMtx );
+static LETOFCACHE * s_pFCacheHead = NULL;
+static LETOFCACHE * s_pFCacheTail = NULL;
+static HB_SIZE      s_nFCacheMax = 0;     /* 0 = no cache */
+static HB_SIZE      s_nFCacheBytes = 0;
+static HB_ULONG     s_ulFCacheEntries = 0;
+static HB_ULONG     s_ulEpoch = 0;
+static HB_U64       s_ullFCacheHits = 0;
+static HB_U64       s_ullFCacheMisses = 0;
+static HB_U64       s_ullFCachePatched = 0;
+
+extern void * leto_BmCopy( void * pBitmap );
+extern HB_SIZE leto_BmSize( void * pBitmap );
+extern void leto_BmFree( void * pBitmap );
+extern void leto_BmAdd( void * pBitmap, HB_ULONG ulRecNo );
+extern void leto_BmDel( void * pBitmap, HB_ULONG ulRecNo );
+extern int leto_FltEval( void * pFltPrg, const HB_BYTE * pRecord );
+extern void leto_FltFree( void * pFltPrg );
+
+static void leto_fcacheSetExact( HB_BOOL fExact )
+{
+   PHB_ITEM pItem = hb_itemPutL( NULL, fExact );
+
+   hb_setSetItem( HB_SET_EXACT, pItem );
+   hb_itemRelease( pItem );
+}
+
+static void leto_fcacheUnlink( LETOFCACHE * pEntry )
+{
+   if( pEntry->pPrev )
+      pEntry->pPrev->pNext = pEntry->pNext;
+   else
+      s_pFCacheHead = pEntry->pNext;
+   if( pEntry->pNext )
+      pEntry->pNext->pPrev = pEntry->pPrev;
+   else
+      s_pFCacheTail = pEntry->pPrev;
+   pEntry->pPrev = pEntry->pNext = NULL;
+}
+
+static void leto_fcacheLinkHead( LETOFCACHE * pEntry )
+{
+   pEntry->pPrev = NULL;
+   pEntry->pNext = s_pFCacheHead;
+   if( s_pFCacheHead )
+      s_pFCacheHead->pPrev = pEntry;
+   else
+      s_pFCacheTail = pEntry;
+   s_pFCacheHead = pEntry;
+}
+
+/* mutex must be hold by caller */
+static void leto_fcacheDrop( LETOFCACHE * pEntry )
+{
+   leto_fcacheUnlink( pEntry );
+   s_nFCacheBytes -= pEntry->nBytes;
+   s_ulFCacheEntries--;
+   leto_BmFree( pEntry->pBitmap );
+   if( pEntry->pFltPrg )
+      leto_FltFree( pEntry->pFltPrg );
+   hb_xfree( pEntry->szKey );
+   hb_xfree( pEntry );
+}
+
+static void leto_fcacheShrink( HB_SIZE nMax )
+{
+   while( s_pFCacheTail && s_nFCacheBytes > nMax )
+      leto_fcacheDrop( s_pFCacheTail );
+}
+
+static LETOFCACHE * leto_fcacheFind( PGLOBESTRU pGlobe, const char * szKey, HB_SIZE nKeyLen, PHB_CODEPAGE cdp )
+{
+   LETOFCACHE * pEntry = s_pFCacheHead;
+
+   while( pEntry )
+   {
+      if( pEntry->pGlobe == pGlobe && pEntry->nKeyLen == nKeyLen && pEntry->cdp == cdp &&
+          ! memcmp( pEntry->szKey, szKey, nKeyLen ) )
+         break;
+      pEntry = pEntry->pNext;
+   }
+   return pEntry;
+}
+
+/* max. bytes of all entries, 0 disables the cache */
+void leto_FCacheSetSize( HB_SIZE nMax )
+{
+   hb_threadEnterCriticalSection( &s_FCacheMtx );
+   s_nFCacheMax = nMax;
+   leto_fcacheShrink( nMax );
+   hb_threadLeaveCriticalSection( &s_FCacheMtx );
+}
+
+HB_BOOL leto_FCacheActive( void )
+{
+   return s_nFCacheMax > 0;
+}
+
+/* version to remember before a result is computed, for leto_FCachePut() */
+HB_ULONG leto_FCacheStamp( PGLOBESTRU pGlobe )
+{
+   HB_ULONG ulStamp;
+
+   hb_threadEnterCriticalSection( &s_FCacheMtx );
+   ulStamp = pGlobe->ulVersion + s_ulEpoch;
+   hb_threadLeaveCriticalSection( &s_FCacheMtx );
+
+   return ulStamp;
+}
+
+/* copy of a valid cached result, or NULL */
+void * leto_FCacheGet( PGLOBESTRU pGlobe, const char * szKey, HB_SIZE nKeyLen )
+{
+   LETOFCACHE * pEntry;
+   void *       pBitmap = NULL;
+
+   if( ! s_nFCacheMax )
+      return NULL;
+
+   hb_threadEnterCriticalSection( &s_FCacheMtx );
+   pEntry = leto_fcacheFind( pGlobe, szKey, nKeyLen, hb_vmCDP() );
+   if( pEntry && pEntry->ulStamp != pGlobe->ulVersion + s_ulEpoch )
+   {
+      leto_fcacheDrop( pEntry );
+      pEntry = NULL;
+   }
+   if( pEntry )
+   {
+      leto_fcacheUnlink( pEntry );
+      leto_fcacheLinkHead( pEntry );
+      pBitmap = leto_BmCopy( pEntry->pBitmap );
+      s_ullFCacheHits++;
+   }
+   else
+      s_ullFCacheMisses++;
+   hb_threadLeaveCriticalSection( &s_FCacheMtx );
+
+   return pBitmap;
+}
+
+/* store a copy of pBitmap computed at ulStamp, takes ownership of pFltPrg */
+void leto_FCachePut( PGLOBESTRU pGlobe, const char * szKey, HB_SIZE nKeyLen, HB_ULONG ulStamp,
+                     void * pBitmap, void * pFltPrg, HB_BOOL fPatch, HB_BOOL fDeleted, HB_BOOL fExact )
+{
+   LETOFCACHE * pEntry = NULL;
+   HB_SIZE      nBytes = sizeof( LETOFCACHE ) + nKeyLen + leto_BmSize( pBitmap );
+
+   hb_threadEnterCriticalSection( &s_FCacheMtx );
+   if( nBytes <= s_nFCacheMax / 4 && ulStamp == pGlobe->ulVersion + s_ulEpoch )
+   {
+      pEntry = leto_fcacheFind( pGlobe, szKey, nKeyLen, hb_vmCDP() );
+      if( pEntry )
+         leto_fcacheDrop( pEntry );
+      leto_fcacheShrink( s_nFCacheMax - nBytes );
+
+      pEntry = ( LETOFCACHE * ) hb_xgrabz( sizeof( LETOFCACHE ) );
+      pEntry->pGlobe = pGlobe;
+      pEntry->szKey = ( char * ) hb_xgrab( nKeyLen );
+      memcpy( pEntry->szKey, szKey, nKeyLen );
+      pEntry->nKeyLen = nKeyLen;
+      pEntry->cdp = hb_vmCDP();
+      pEntry->ulStamp = ulStamp;
+      pEntry->pBitmap = leto_BmCopy( pBitmap );
+      pEntry->pFltPrg = pFltPrg;
+      pEntry->fPatch = fPatch;
+      pEntry->fDeleted = fDeleted;
+      pEntry->fExact = fExact;
+      pEntry->nBytes = nBytes;
+      leto_fcacheLinkHead( pEntry );
+      s_nFCacheBytes += nBytes;
+      s_ulFCacheEntries++;
+   }
+   hb_threadLeaveCriticalSection( &s_FCacheMtx );
+
+   if( ! pEntry && pFltPrg )
+      leto_FltFree( pFltPrg );
+}
+
+/* record ulRecNo of table pGlobe changed to image pRecord, entries which can't be patched are dropped;
+ * ulRecNo 0 for unknown changes of the table, pGlobe NULL for unknown changes of any table.
+ * Versions are also counted with disabled cache, for the index plans of filters */
+void leto_FCacheTouch( PGLOBESTRU pGlobe, HB_ULONG ulRecNo, const HB_BYTE * pRecord )
+{
+   LETOFCACHE * pEntry, * pNext;
+   HB_ULONG     ulStamp;
+   HB_BOOL      fExact = hb_setGetExact(), fSetExact = fExact;
+
+   hb_threadEnterCriticalSection( &s_FCacheMtx );
+   if( ! pGlobe )
+   {
+      s_ulEpoch++;
+      while( s_pFCacheHead )
+         leto_fcacheDrop( s_pFCacheHead );
+   }
+   else
+   {
+      ulStamp = pGlobe->ulVersion + s_ulEpoch;
+      pGlobe->ulVersion++;
+      pGlobe->ulTouchStamp[ ( ulStamp + 1 ) % LETO_TOUCHLOG ] = ulStamp + 1;
+      pGlobe->ulTouchRec[ ( ulStamp + 1 ) % LETO_TOUCHLOG ] = ulRecNo;
+      for( pEntry = s_pFCacheHead; pEntry; pEntry = pNext )
+      {
+         pNext = pEntry->pNext;
+         if( pEntry->pGlobe != pGlobe )
+            continue;
+
+         if( pEntry->fPatch && ulRecNo && pRecord && pEntry->ulStamp == ulStamp && pEntry->cdp == hb_vmCDP() )
+         {
+            int iValid;
+
+            /* string compares as at result time, not as SET in the thread changing the record */
+            if( pEntry->pFltPrg && pEntry->fExact != fSetExact )
+            {
+               fSetExact = pEntry->fExact;
+               leto_fcacheSetExact( fSetExact );
+            }
+            iValid = pEntry->fDeleted && pRecord[ 0 ] == '*' ? 0 :
+                     ( pEntry->pFltPrg ? leto_FltEval( pEntry->pFltPrg, pRecord ) : 1 );
+
+            if( iValid >= 0 )
+            {
+               if( iValid )
+                  leto_BmAdd( pEntry->pBitmap, ulRecNo );
+               else
+                  leto_BmDel( pEntry->pBitmap, ulRecNo );
+               s_nFCacheBytes -= pEntry->nBytes;
+               pEntry->nBytes = sizeof( LETOFCACHE ) + pEntry->nKeyLen + leto_BmSize( pEntry->pBitmap );
+               s_nFCacheBytes += pEntry->nBytes;
+               pEntry->ulStamp = ulStamp + 1;
+               s_ullFCachePatched++;
+               continue;
+            }
+         }
+         leto_fcacheDrop( pEntry );
+      }
+      leto_fcacheShrink( s_nFCacheMax );
+   }
+   hb_threadLeaveCriticalSection( &s_FCacheMtx );
+
+   if( fSetExact != fExact )
+      leto_fcacheSetExact( fExact );
+}
+
+/* records of table pGlobe changed after *pulStamp are added to pBitmap and *pulStamp is actualized;
+ * false if a change is not known by its record, then the bitmap must be built again */
+HB_BOOL leto_FCacheChanges( PGLOBESTRU pGlobe, HB_ULONG * pulStamp, void * pBitmap )
+{
+   HB_ULONG ulStamp, ulChanges, ul;
+   HB_BOOL  fKnown;
+
+   hb_threadEnterCriticalSection( &s_FCacheMtx );
+   ulStamp = pGlobe->ulVersion + s_ulEpoch;
+   ulChanges = ulStamp - *pulStamp;
+   fKnown = ulChanges <= LETO_TOUCHLOG;
+   for( ul = 1; ul <= ulChanges && fKnown; ul++ )
+   {
+      int iSlot = ( int ) ( ( *pulStamp + ul ) % LETO_TOUCHLOG );
+
+      fKnown = pGlobe->ulTouchStamp[ iSlot ] == *pulStamp + ul && pGlobe->ulTouchRec[ iSlot ];
+   }
+   if( fKnown )
+   {
+      for( ul = 1; ul <= ulChanges; ul++ )
+         leto_BmAdd( pBitmap, pGlobe->ulTouchRec[ ( *pulStamp + ul ) % LETO_TOUCHLOG ] );
+      *pulStamp = ulStamp;
+   }
+   hb_threadLeaveCriticalSection( &s_FCacheMtx );
+
+   return fKnown;
+}
+
+/* the table is closed, pGlobe will be re-used */
+void leto_FCacheDrop( PGLOBESTRU pGlobe )
+{
+   LETOFCACHE * pEntry, * pNext;
+
+   if( ! s_pFCacheHead )
+      return;
+
+   hb_threadEnterCriticalSection( &s_FCacheMtx );
+   for( pEntry = s_pFCacheHead; pEntry; pEntry = pNext )
+   {
+      pNext = pEntry->pNext;
+      if( pEntry->pGlobe == pGlobe )
+         leto_fcacheDrop( pEntry );
+   }
+   hb_threadLeaveCriticalSection( &s_FCacheMtx );
+}
+
+void leto_FCacheInfo( HB_ULONG * pulEntries, HB_SIZE * pnBytes, HB_U64 * pullHits, HB_U64 * pullMisses, HB_U64 * pullPatched )
+{
+   hb_threadEnterCriticalSection( &s_FCacheMtx );
+   *pulEntries = s_ulFCacheEntries;
+   *pnBytes = s_nFCacheBytes;
+   *pullHits = s_ullFCacheHits;
+   *pullMisses = s_ullFCacheMisses;
+   *pullPatched = s_ullFCachePatched;
+   hb_threadLeaveCriticalSection( &s_FCacheMtx );
+}
+
+void leto_FCacheRelease( void )
+{
+   leto_FCacheSetSize( 0 );
+}
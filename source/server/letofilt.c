@@ -0,0 +1,1164 @@
+/*
+ * Leto db server native filter predicates
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307 USA (or visit the web site http://www.gnu.org/).
+ *
+ * As a special exception, the Harbour Project gives permission for
+ * additional uses of the text contained in its release of Harbour.
+ *
+ * The exception is that, if you link the Harbour libraries with other
+ * files to produce an executable, this does not by itself cause the
+ * resulting executable to be covered by the GNU General Public License.
+ * Your use of that executable is in no way restricted on account of
+ * linking the Harbour library code into it.
+ *
+ * This exception does not however invalidate any other reasons why
+ * the executable file might be covered by the GNU General Public License.
+ *
+ * This exception applies only to the code released by the Harbour
+ * Project under the name Harbour.  If you copy code from other
+ * Harbour Project or Free Software Foundation releases into a copy of
+ * Harbour, as the General Public License permits, the exception does
+ * not apply to the code that you add in this way.  To avoid misleading
+ * anyone as to the status of such modified files, you must delete
+ * this exception notice from them.
+ *
+ * If you write modifications of your own for Harbour, it is your choice
+ * whether to permit this exception to apply to your modifications.
+ * If you do not wish that, delete this exception notice.
+ *
+ */
+
+/*
+ * Filter expressions accepted by leto_Filter() are compiled to a small stack program, evaluated
+ * direct at the raw DBF record buffer without the HVM. The area filter codeblock then is only
+ * {|| LETO_FLTNATIVE( nAreaID ) }, for anything not understood here the Harbour codeblock is used.
+ *
+ * supported: fields of type C, N, F, I, B, D, L; string, number, date and logical constants;
+ *            = == != <> # < <= > >= $ .AND. .OR. .NOT. ! ( )
+ *            Upper(), Left(), SubStr(), Trim(), RTrim(), LTrim(), AllTrim(), DToS(), SToD(),
+ *            Empty(), Deleted(), leto_VarGet(), leto_VarGetCached()
+ */
+
+#include "srvleto.h"
+#include "hbapicdp.h"
+#include "hbstack.h"
+
+#define LETOFLT_MAXDEEP     16     /* max. values at stack */
+
+#define LETOFLT_FLD_C        1     /* field values */
+#define LETOFLT_FLD_N        2
+#define LETOFLT_FLD_I        3
+#define LETOFLT_FLD_B        4
+#define LETOFLT_FLD_D        5
+#define LETOFLT_FLD_DBIN     6
+#define LETOFLT_FLD_L        7
+#define LETOFLT_CONST        8
+#define LETOFLT_VAR          9     /* leto_Var*() function */
+#define LETOFLT_UPPER       10
+#define LETOFLT_SUBSTR      11
+#define LETOFLT_RTRIM       12
+#define LETOFLT_LTRIM       13
+#define LETOFLT_DTOS        14
+#define LETOFLT_EMPTY       15
+#define LETOFLT_DELETED     16
+#define LETOFLT_NOT         17
+#define LETOFLT_AND         18     /* jump if false, else drop value */
+#define LETOFLT_OR          19     /* jump if true, else drop value */
+#define LETOFLT_EQ          20
+#define LETOFLT_EXEQ        21
+#define LETOFLT_NE          22
+#define LETOFLT_LT          23
+#define LETOFLT_LE          24
+#define LETOFLT_GT          25
+#define LETOFLT_GE          26
+#define LETOFLT_IN          27
+
+typedef struct
+{
+   const char *   pStr;                /* C: string, D: "YYYYMMDD" */
+   HB_SIZE        nLen;
+   double         dNum;                /* N: number, D: julian */
+   HB_BOOL        fLog;
+} LETOFLTVAL;
+
+typedef struct
+{
+   HB_BYTE        bOp;
+   char           cType;               /* type of result */
+   char           cArgType;            /* type of operands for Empty() and compare */
+   HB_USHORT      uiOffset;            /* field offset in record buffer */
+   HB_USHORT      uiLen;               /* field length, SubStr() start */
+   HB_USHORT      uiCount;             /* SubStr() count, jump target */
+   HB_USHORT      uiDec;               /* I field decimals */
+   LETOFLTVAL     val;                 /* constant */
+   char *         pBuf;                /* Upper() buffer, string constant */
+   HB_SIZE        nBufLen;
+   char           szDate[ 9 ];
+   PHB_DYNS       pDynSym;             /* leto_Var*() */
+   PHB_ITEM       pParams;
+   PHB_ITEM       pResult;
+} LETOFLTOP;
+
+typedef struct
+{
+   AREAP          pArea;               /* compiled for fields of */
+   LETOFLTOP *    pOps;
+   HB_USHORT      uiOps;
+   HB_USHORT      uiAlloc;
+   HB_BOOL        fBroken;             /* type of leto_Var*() changed, use codeblock */
+} LETOFLTPRG;
+
+typedef struct
+{
+   LETOFLTPRG *   pPrg;
+   const char *   ptr;
+   const char *   pEnd;
+   int            iDeep;
+   HB_BOOL        fCustomCdp;
+} LETOFLTCOMP;
+
+extern PUSERSTRU letoGetsUStru( void );  /* fetch the static TLS in letofunc */
+extern PAREASTRU letoFindArea( PUSERSTRU pUStru, HB_ULONG ulAreaID );
+
+static char leto_fltOr( LETOFLTCOMP * pComp );
+
+void leto_FltFree( void * pFltPrg )
+{
+   LETOFLTPRG * pPrg = ( LETOFLTPRG * ) pFltPrg;
+   HB_USHORT    ui;
+
+   for( ui = 0; ui < pPrg->uiOps; ui++ )
+   {
+      if( pPrg->pOps[ ui ].pBuf )
+         hb_xfree( pPrg->pOps[ ui ].pBuf );
+      if( pPrg->pOps[ ui ].pParams )
+         hb_itemRelease( pPrg->pOps[ ui ].pParams );
+      if( pPrg->pOps[ ui ].pResult )
+         hb_itemRelease( pPrg->pOps[ ui ].pResult );
+   }
+   if( pPrg->pOps )
+      hb_xfree( pPrg->pOps );
+   hb_xfree( pPrg );
+}
+
+static LETOFLTOP * leto_fltEmit( LETOFLTCOMP * pComp, HB_BYTE bOp, char cType )
+{
+   LETOFLTPRG * pPrg = pComp->pPrg;
+   LETOFLTOP *  pOp;
+
+   if( pPrg->uiOps == pPrg->uiAlloc )
+   {
+      pPrg->uiAlloc += 16;
+      pPrg->pOps = ( LETOFLTOP * ) hb_xrealloc( pPrg->pOps, pPrg->uiAlloc * sizeof( LETOFLTOP ) );
+   }
+   pOp = pPrg->pOps + pPrg->uiOps++;
+   memset( pOp, 0, sizeof( LETOFLTOP ) );
+   pOp->bOp = bOp;
+   pOp->cType = cType;
+
+   return pOp;
+}
+
+/* value pushed: check stack depth */
+static HB_BOOL leto_fltPush( LETOFLTCOMP * pComp )
+{
+   return ++pComp->iDeep <= LETOFLT_MAXDEEP;
+}
+
+static void leto_fltSpace( LETOFLTCOMP * pComp )
+{
+   while( pComp->ptr < pComp->pEnd && HB_ISSPACE( *pComp->ptr ) )
+      pComp->ptr++;
+}
+
+/* case insensitive test for szWord at actual position, which then is skipped */
+static HB_BOOL leto_fltWord( LETOFLTCOMP * pComp, const char * szWord )
+{
+   HB_SIZE nLen = strlen( szWord );
+
+   leto_fltSpace( pComp );
+   if( ( HB_SIZE ) ( pComp->pEnd - pComp->ptr ) >= nLen && ! hb_strnicmp( pComp->ptr, szWord, nLen ) )
+   {
+      pComp->ptr += nLen;
+      return HB_TRUE;
+   }
+   return HB_FALSE;
+}
+
+static HB_BOOL leto_fltNumber( LETOFLTCOMP * pComp, double * pdNum )
+{
+   const char * ptr;
+   HB_MAXINT    lVal;
+   double       dVal;
+   HB_BOOL      fNeg = HB_FALSE;
+
+   leto_fltSpace( pComp );
+   ptr = pComp->ptr;
+   if( ptr < pComp->pEnd && ( *ptr == '-' || *ptr == '+' ) )
+   {
+      fNeg = ( *ptr == '-' );
+      ptr++;
+   }
+   if( ptr >= pComp->pEnd || ! ( HB_ISDIGIT( *ptr ) || *ptr == '.' ) )
+      return HB_FALSE;
+   pComp->ptr = ptr;
+   while( ptr < pComp->pEnd && ( HB_ISDIGIT( *ptr ) || *ptr == '.' ) )
+      ptr++;
+   if( ! hb_strnToNum( pComp->ptr, ptr - pComp->ptr, &lVal, &dVal ) )
+      dVal = ( double ) lVal;
+   pComp->ptr = ptr;
+   *pdNum = fNeg ? -dVal : dVal;
+
+   return HB_TRUE;
+}
+
+static HB_BOOL leto_fltString( LETOFLTCOMP * pComp, const char ** pszStr, HB_SIZE * pnLen )
+{
+   char cQuo;
+
+   leto_fltSpace( pComp );
+   if( pComp->ptr >= pComp->pEnd || ( *pComp->ptr != '"' && *pComp->ptr != '\'' && *pComp->ptr != '[' ) )
+      return HB_FALSE;
+   cQuo = *pComp->ptr == '[' ? ']' : *pComp->ptr;
+   *pszStr = ++pComp->ptr;
+   while( pComp->ptr < pComp->pEnd && *pComp->ptr != cQuo )
+      pComp->ptr++;
+   if( pComp->ptr >= pComp->pEnd )
+      return HB_FALSE;
+   *pnLen = pComp->ptr++ - *pszStr;
+
+   return HB_TRUE;
+}
+
+static HB_BOOL leto_fltComma( LETOFLTCOMP * pComp )
+{
+   leto_fltSpace( pComp );
+   if( pComp->ptr < pComp->pEnd && *pComp->ptr == ',' )
+   {
+      pComp->ptr++;
+      return HB_TRUE;
+   }
+   return HB_FALSE;
+}
+
+static HB_BOOL leto_fltClose( LETOFLTCOMP * pComp )
+{
+   leto_fltSpace( pComp );
+   if( pComp->ptr < pComp->pEnd && *pComp->ptr == ')' )
+   {
+      pComp->ptr++;
+      return HB_TRUE;
+   }
+   return HB_FALSE;
+}
+
+static void leto_fltDateConst( LETOFLTOP * pOp, long lJulian )
+{
+   pOp->val.dNum = ( double ) lJulian;
+   hb_dateDecStr( pOp->szDate, lJulian );
+   pOp->val.pStr = pOp->szDate;
+   pOp->val.nLen = 8;
+}
+
+/* item to value of expected type, false for other type */
+static HB_BOOL leto_fltItemVal( PHB_ITEM pItem, LETOFLTOP * pOp, LETOFLTVAL * pVal )
+{
+   switch( pOp->cType )
+   {
+      case 'C':
+         if( ! HB_IS_STRING( pItem ) )
+            return HB_FALSE;
+         pVal->pStr = hb_itemGetCPtr( pItem );
+         pVal->nLen = hb_itemGetCLen( pItem );
+         break;
+
+      case 'N':
+         if( ! HB_IS_NUMERIC( pItem ) )
+            return HB_FALSE;
+         pVal->dNum = hb_itemGetND( pItem );
+         break;
+
+      case 'D':
+         if( ! HB_IS_DATE( pItem ) )
+            return HB_FALSE;
+         pVal->dNum = ( double ) hb_itemGetDL( pItem );
+         hb_dateDecStr( pOp->szDate, hb_itemGetDL( pItem ) );
+         pVal->pStr = pOp->szDate;
+         pVal->nLen = 8;
+         break;
+
+      case 'L':
+         if( ! HB_IS_LOGICAL( pItem ) )
+            return HB_FALSE;
+         pVal->fLog = hb_itemGetL( pItem );
+         break;
+
+      default:
+         return HB_FALSE;
+   }
+   return HB_TRUE;
+}
+
+/* call of leto_Var*() function, result kept in pOp->pResult */
+static PHB_ITEM leto_fltVarCall( LETOFLTOP * pOp )
+{
+   HB_SIZE nLen = pOp->pParams ? hb_arrayLen( pOp->pParams ) : 0, n;
+
+   hb_vmPushDynSym( pOp->pDynSym );
+   hb_vmPushNil();
+   for( n = 1; n <= nLen; n++ )
+      hb_vmPush( hb_arrayGetItemPtr( pOp->pParams, n ) );
+   hb_vmFunction( ( HB_USHORT ) nLen );
+   if( ! pOp->pResult )
+      pOp->pResult = hb_itemNew( NULL );
+   hb_itemCopy( pOp->pResult, hb_stackReturnItem() );
+
+   return pOp->pResult;
+}
+
+static char leto_fltField( LETOFLTCOMP * pComp, const char * szName, HB_SIZE nLen )
+{
+   AREAP       pArea = pComp->pPrg->pArea;
+   char        szField[ HB_SYMBOL_NAME_LEN + 1 ];
+   HB_USHORT   uiField;
+   LPFIELD     pField;
+   LETOFLTOP * pOp;
+
+   if( nLen > HB_SYMBOL_NAME_LEN )
+      return 0;
+   memcpy( szField, szName, nLen );
+   szField[ nLen ] = '\0';
+   uiField = hb_rddFieldIndex( pArea, szField );
+   if( ! uiField || ! leto_fltPush( pComp ) )
+      return 0;
+
+   pField = pArea->lpFields + uiField - 1;
+   switch( pField->uiType )
+   {
+      case HB_FT_STRING:
+         if( pField->uiFlags & HB_FF_UNICODE )
+            return 0;
+         pOp = leto_fltEmit( pComp, LETOFLT_FLD_C, 'C' );
+         break;
+
+      case HB_FT_LONG:
+      case HB_FT_FLOAT:
+         pOp = leto_fltEmit( pComp, LETOFLT_FLD_N, 'N' );
+         break;
+
+      case HB_FT_INTEGER:
+         if( pField->uiLen != 1 && pField->uiLen != 2 && pField->uiLen != 3 && pField->uiLen != 4 && pField->uiLen != 8 )
+            return 0;
+         pOp = leto_fltEmit( pComp, LETOFLT_FLD_I, 'N' );
+         pOp->uiDec = pField->uiDec;
+         break;
+
+      case HB_FT_DOUBLE:
+         pOp = leto_fltEmit( pComp, LETOFLT_FLD_B, 'N' );
+         break;
+
+      case HB_FT_DATE:
+         if( pField->uiLen == 8 )
+            pOp = leto_fltEmit( pComp, LETOFLT_FLD_D, 'D' );
+         else if( pField->uiLen == 3 || pField->uiLen == 4 )
+            pOp = leto_fltEmit( pComp, LETOFLT_FLD_DBIN, 'D' );
+         else
+            return 0;
+         break;
+
+      case HB_FT_LOGICAL:
+         pOp = leto_fltEmit( pComp, LETOFLT_FLD_L, 'L' );
+         break;
+
+      default:
+         return 0;
+   }
+   pOp->uiOffset = ( HB_USHORT ) ( ( DBFAREAP ) pArea )->pFieldOffset[ uiField - 1 ];
+   pOp->uiLen = pField->uiLen;
+
+   return pOp->cType;
+}
+
+static char leto_fltFunction( LETOFLTCOMP * pComp, const char * szName, HB_SIZE nLen )
+{
+   char        szFunc[ 24 ];
+   char        cType = 0;
+   LETOFLTOP * pOp;
+
+   if( nLen >= sizeof( szFunc ) )
+      return 0;
+   memcpy( szFunc, szName, nLen );
+   szFunc[ nLen ] = '\0';
+   hb_strUpper( szFunc, nLen );
+
+   if( ! strcmp( szFunc, "UPPER" ) )
+   {
+      if( pComp->fCustomCdp || leto_fltOr( pComp ) != 'C' )
+         return 0;
+      pOp = leto_fltEmit( pComp, LETOFLT_UPPER, 'C' );
+      cType = 'C';
+   }
+   else if( ! strcmp( szFunc, "LEFT" ) || ! strcmp( szFunc, "SUBSTR" ) )
+   {
+      HB_BOOL fLeft = ( szFunc[ 0 ] == 'L' );
+      double  dStart = 1, dCount = 0xFFFF;
+
+      if( leto_fltOr( pComp ) != 'C' || ! leto_fltComma( pComp ) )
+         return 0;
+      if( fLeft )
+      {
+         if( ! leto_fltNumber( pComp, &dCount ) )
+            return 0;
+      }
+      else
+      {
+         if( ! leto_fltNumber( pComp, &dStart ) )
+            return 0;
+         if( leto_fltComma( pComp ) && ! leto_fltNumber( pComp, &dCount ) )
+            return 0;
+      }
+      if( dStart < 1 || dStart > 0xFFFF || dCount < 0 || dCount > 0xFFFF )
+         return 0;
+      pOp = leto_fltEmit( pComp, LETOFLT_SUBSTR, 'C' );
+      pOp->uiLen = ( HB_USHORT ) dStart;
+      pOp->uiCount = ( HB_USHORT ) dCount;
+      cType = 'C';
+   }
+   else if( ! strcmp( szFunc, "TRIM" ) || ! strcmp( szFunc, "RTRIM" ) ||
+            ! strcmp( szFunc, "LTRIM" ) || ! strcmp( szFunc, "ALLTRIM" ) )
+   {
+      if( leto_fltOr( pComp ) != 'C' )
+         return 0;
+      if( szFunc[ 0 ] != 'L' )
+         leto_fltEmit( pComp, LETOFLT_RTRIM, 'C' );
+      if( szFunc[ 0 ] != 'T' && szFunc[ 0 ] != 'R' )
+         leto_fltEmit( pComp, LETOFLT_LTRIM, 'C' );
+      cType = 'C';
+   }
+   else if( ! strcmp( szFunc, "DTOS" ) )
+   {
+      if( leto_fltOr( pComp ) != 'D' )
+         return 0;
+      leto_fltEmit( pComp, LETOFLT_DTOS, 'C' );
+      cType = 'C';
+   }
+   else if( ! strcmp( szFunc, "STOD" ) )
+   {
+      const char * szDate;
+      HB_SIZE      nDateLen;
+      char         szBuf[ 9 ];
+
+      if( ! leto_fltString( pComp, &szDate, &nDateLen ) || ! leto_fltPush( pComp ) )
+         return 0;
+      memset( szBuf, ' ', 8 );
+      memcpy( szBuf, szDate, HB_MIN( nDateLen, 8 ) );
+      szBuf[ 8 ] = '\0';
+      pOp = leto_fltEmit( pComp, LETOFLT_CONST, 'D' );
+      leto_fltDateConst( pOp, hb_dateEncStr( szBuf ) );
+      cType = 'D';
+   }
+   else if( ! strcmp( szFunc, "EMPTY" ) )
+   {
+      char cArgType = leto_fltOr( pComp );
+
+      if( ! cArgType )
+         return 0;
+      leto_fltEmit( pComp, LETOFLT_EMPTY, 'L' )->cArgType = cArgType;
+      cType = 'L';
+   }
+   else if( ! strcmp( szFunc, "DELETED" ) )
+   {
+      if( ! leto_fltPush( pComp ) )
+         return 0;
+      leto_fltEmit( pComp, LETOFLT_DELETED, 'L' );
+      cType = 'L';
+   }
+   else if( ! strcmp( szFunc, "LETO_VARGET" ) || ! strcmp( szFunc, "LETO_VARGETCACHED" ) )
+   {
+      PHB_DYNS pDynSym = hb_dynsymFindName( szFunc );
+      PHB_ITEM pResult;
+
+      if( ! pDynSym || ! hb_dynsymIsFunction( pDynSym ) || ! leto_fltPush( pComp ) )
+         return 0;
+      pOp = leto_fltEmit( pComp, LETOFLT_VAR, 0 );
+      pOp->pDynSym = pDynSym;
+      if( szFunc[ 11 ] == '\0' )  /* leto_VarGet( cGroup, cVar ) */
+      {
+         const char * szGroup, * szVar;
+         HB_SIZE      nGroupLen, nVarLen;
+
+         if( ! leto_fltString( pComp, &szGroup, &nGroupLen ) || ! leto_fltComma( pComp ) ||
+             ! leto_fltString( pComp, &szVar, &nVarLen ) )
+            return 0;
+         pOp->pParams = hb_itemArrayNew( 2 );
+         hb_arraySetCL( pOp->pParams, 1, szGroup, nGroupLen );
+         hb_arraySetCL( pOp->pParams, 2, szVar, nVarLen );
+      }
+
+      /* type of variable must stay as now */
+      pResult = leto_fltVarCall( pOp );
+      if( HB_IS_STRING( pResult ) )
+         pOp->cType = 'C';
+      else if( HB_IS_NUMERIC( pResult ) )
+         pOp->cType = 'N';
+      else if( HB_IS_DATE( pResult ) )
+         pOp->cType = 'D';
+      else if( HB_IS_LOGICAL( pResult ) )
+         pOp->cType = 'L';
+      else
+         return 0;
+      cType = pOp->cType;
+   }
+
+   if( cType && ! leto_fltClose( pComp ) )
+      cType = 0;
+   return cType;
+}
+
+static char leto_fltValue( LETOFLTCOMP * pComp )
+{
+   const char * ptr;
+   LETOFLTOP *  pOp;
+   double       dNum;
+   char         c;
+
+   leto_fltSpace( pComp );
+   if( pComp->ptr >= pComp->pEnd )
+      return 0;
+   c = *pComp->ptr;
+
+   if( c == '(' )
+   {
+      char cType;
+
+      pComp->ptr++;
+      cType = leto_fltOr( pComp );
+      if( ! cType || ! leto_fltClose( pComp ) )
+         return 0;
+      return cType;
+   }
+   else if( c == '"' || c == '\'' || c == '[' )
+   {
+      const char * szStr;
+      HB_SIZE      nLen;
+
+      if( ! leto_fltString( pComp, &szStr, &nLen ) || ! leto_fltPush( pComp ) )
+         return 0;
+      pOp = leto_fltEmit( pComp, LETOFLT_CONST, 'C' );
+      pOp->pBuf = ( char * ) hb_xgrab( nLen + 1 );
+      memcpy( pOp->pBuf, szStr, nLen );
+      pOp->pBuf[ nLen ] = '\0';
+      pOp->val.pStr = pOp->pBuf;
+      pOp->val.nLen = nLen;
+      return 'C';
+   }
+   else if( c == '.' && pComp->pEnd - pComp->ptr >= 3 && pComp->ptr[ 2 ] == '.' &&
+            strchr( "TtFfYyNn", pComp->ptr[ 1 ] ) )
+   {
+      if( ! leto_fltPush( pComp ) )
+         return 0;
+      pOp = leto_fltEmit( pComp, LETOFLT_CONST, 'L' );
+      pOp->val.fLog = ( strchr( "TtYy", pComp->ptr[ 1 ] ) != NULL );
+      pComp->ptr += 3;
+      return 'L';
+   }
+   else if( c == '0' && pComp->pEnd - pComp->ptr >= 10 && ( pComp->ptr[ 1 ] == 'd' || pComp->ptr[ 1 ] == 'D' ) )
+   {
+      char szBuf[ 9 ];
+
+      if( ! leto_fltPush( pComp ) )
+         return 0;
+      memcpy( szBuf, pComp->ptr + 2, 8 );
+      szBuf[ 8 ] = '\0';
+      pComp->ptr += 10;
+      pOp = leto_fltEmit( pComp, LETOFLT_CONST, 'D' );
+      leto_fltDateConst( pOp, hb_dateEncStr( szBuf ) );
+      return 'D';
+   }
+   else if( HB_ISDIGIT( c ) || c == '.' || c == '-' || c == '+' )
+   {
+      if( ! leto_fltNumber( pComp, &dNum ) || ! leto_fltPush( pComp ) )
+         return 0;
+      pOp = leto_fltEmit( pComp, LETOFLT_CONST, 'N' );
+      pOp->val.dNum = dNum;
+      return 'N';
+   }
+   else if( HB_ISFIRSTIDCHAR( c ) )
+   {
+      HB_SIZE nLen;
+
+      ptr = pComp->ptr;
+      while( pComp->ptr < pComp->pEnd && HB_ISNEXTIDCHAR( *pComp->ptr ) )
+         pComp->ptr++;
+      nLen = pComp->ptr - ptr;
+      leto_fltSpace( pComp );
+      if( pComp->ptr < pComp->pEnd && *pComp->ptr == '(' )
+      {
+         pComp->ptr++;
+         return leto_fltFunction( pComp, ptr, nLen );
+      }
+      else if( pComp->pEnd - pComp->ptr >= 2 && pComp->ptr[ 0 ] == '-' && pComp->ptr[ 1 ] == '>' )
+      {
+         if( ! ( ( nLen == 5 && ! hb_strnicmp( ptr, "FIELD", 5 ) ) || ( nLen == 6 && ! hb_strnicmp( ptr, "_FIELD", 6 ) ) ) )
+            return 0;
+         pComp->ptr += 2;
+         leto_fltSpace( pComp );
+         ptr = pComp->ptr;
+         while( pComp->ptr < pComp->pEnd && HB_ISNEXTIDCHAR( *pComp->ptr ) )
+            pComp->ptr++;
+         nLen = pComp->ptr - ptr;
+      }
+      return nLen ? leto_fltField( pComp, ptr, nLen ) : 0;
+   }
+
+   return 0;
+}
+
+static char leto_fltCompare( LETOFLTCOMP * pComp )
+{
+   char    cType = leto_fltValue( pComp ), cType2;
+   HB_BYTE bOp = 0;
+
+   if( ! cType )
+      return 0;
+   leto_fltSpace( pComp );
+   if( pComp->pEnd - pComp->ptr >= 2 )
+   {
+      if( pComp->ptr[ 0 ] == '=' && pComp->ptr[ 1 ] == '=' )
+         bOp = LETOFLT_EXEQ;
+      else if( ( pComp->ptr[ 0 ] == '!' && pComp->ptr[ 1 ] == '=' ) || ( pComp->ptr[ 0 ] == '<' && pComp->ptr[ 1 ] == '>' ) )
+         bOp = LETOFLT_NE;
+      else if( pComp->ptr[ 0 ] == '<' && pComp->ptr[ 1 ] == '=' )
+         bOp = LETOFLT_LE;
+      else if( pComp->ptr[ 0 ] == '>' && pComp->ptr[ 1 ] == '=' )
+         bOp = LETOFLT_GE;
+      if( bOp )
+         pComp->ptr += 2;
+   }
+   if( ! bOp && pComp->ptr < pComp->pEnd )
+   {
+      switch( *pComp->ptr )
+      {
+         case '=':
+            bOp = LETOFLT_EQ;
+            break;
+         case '#':
+            bOp = LETOFLT_NE;
+            break;
+         case '<':
+            bOp = LETOFLT_LT;
+            break;
+         case '>':
+            bOp = LETOFLT_GT;
+            break;
+         case '$':
+            bOp = LETOFLT_IN;
+            break;
+      }
+      if( bOp )
+         pComp->ptr++;
+   }
+   if( ! bOp )
+      return cType;
+
+   cType2 = leto_fltValue( pComp );
+   if( cType2 != cType )
+      return 0;
+   if( ( bOp == LETOFLT_IN && cType != 'C' ) ||
+       ( cType == 'L' && bOp != LETOFLT_EQ && bOp != LETOFLT_EXEQ && bOp != LETOFLT_NE ) )
+      return 0;
+   leto_fltEmit( pComp, bOp, 'L' )->cArgType = cType;
+   pComp->iDeep--;
+
+   return 'L';
+}
+
+static char leto_fltNot( LETOFLTCOMP * pComp )
+{
+   HB_BOOL fNot = leto_fltWord( pComp, ".NOT." );
+
+   if( ! fNot && pComp->ptr < pComp->pEnd && *pComp->ptr == '!' &&
+       ( pComp->ptr + 1 >= pComp->pEnd || pComp->ptr[ 1 ] != '=' ) )
+   {
+      pComp->ptr++;
+      fNot = HB_TRUE;
+   }
+   if( fNot )
+   {
+      if( leto_fltNot( pComp ) != 'L' )
+         return 0;
+      leto_fltEmit( pComp, LETOFLT_NOT, 'L' );
+      return 'L';
+   }
+   return leto_fltCompare( pComp );
+}
+
+/* short-circuit: value stays for jump, else it's dropped before next condition */
+static char leto_fltLogic( LETOFLTCOMP * pComp, HB_BOOL fAnd )
+{
+   char      cType = fAnd ? leto_fltNot( pComp ) : leto_fltLogic( pComp, HB_TRUE );
+   HB_USHORT uiJump;
+
+   while( cType && leto_fltWord( pComp, fAnd ? ".AND." : ".OR." ) )
+   {
+      if( cType != 'L' )
+         return 0;
+      uiJump = pComp->pPrg->uiOps;
+      leto_fltEmit( pComp, fAnd ? LETOFLT_AND : LETOFLT_OR, 'L' );
+      pComp->iDeep--;
+      cType = fAnd ? leto_fltNot( pComp ) : leto_fltLogic( pComp, HB_TRUE );
+      if( cType != 'L' )
+         return 0;
+      pComp->pPrg->pOps[ uiJump ].uiCount = pComp->pPrg->uiOps;
+   }
+   return cType;
+}
+
+static char leto_fltOr( LETOFLTCOMP * pComp )
+{
+   return leto_fltLogic( pComp, HB_FALSE );
+}
+
+/* NULL if expression contains something not supported, then codeblock must be used */
+void * leto_FltCompile( AREAP pArea, const char * szExpr, HB_ULONG ulLen )
+{
+#if defined( __HARBOUR30__ )
+   HB_SYMBOL_UNUSED( pArea );
+   HB_SYMBOL_UNUSED( szExpr );
+   HB_SYMBOL_UNUSED( ulLen );
+
+   return NULL;
+#else
+   LETOFLTCOMP  comp;
+   LETOFLTPRG * pPrg;
+   char         cType;
+
+   if( ! pArea || ! pArea->uiFieldCount || pArea->cdPage != hb_vmCDP() )  /* no translation of strings */
+      return NULL;
+
+   pPrg = ( LETOFLTPRG * ) hb_xgrabz( sizeof( LETOFLTPRG ) );
+   pPrg->pArea = pArea;
+   comp.pPrg = pPrg;
+   comp.ptr = szExpr;
+   comp.pEnd = szExpr + ulLen;
+   comp.iDeep = 0;
+   comp.fCustomCdp = HB_CDP_ISCUSTOM( hb_vmCDP() );
+
+   cType = leto_fltOr( &comp );
+   leto_fltSpace( &comp );
+   if( cType != 'L' || comp.ptr != comp.pEnd || comp.iDeep != 1 )
+   {
+      leto_FltFree( pPrg );
+      pPrg = NULL;
+   }
+
+   return pPrg;
+#endif
+}
+
+/* private copy for a parallel scan thread, NULL if the HVM is needed [ leto_Var*() ] */
+void * leto_FltClone( void * pFltPrg )
+{
+   LETOFLTPRG * pPrg = ( LETOFLTPRG * ) pFltPrg;
+   LETOFLTPRG * pClone;
+   LETOFLTOP *  pOp;
+   HB_USHORT    ui;
+
+   if( pPrg->fBroken )
+      return NULL;
+   for( ui = 0; ui < pPrg->uiOps; ui++ )
+   {
+      if( pPrg->pOps[ ui ].bOp == LETOFLT_VAR )
+         return NULL;
+   }
+
+   pClone = ( LETOFLTPRG * ) hb_xgrabz( sizeof( LETOFLTPRG ) );
+   pClone->pArea = pPrg->pArea;
+   pClone->uiOps = pClone->uiAlloc = pPrg->uiOps;
+   pClone->pOps = ( LETOFLTOP * ) hb_xgrab( pPrg->uiOps * sizeof( LETOFLTOP ) );
+   memcpy( pClone->pOps, pPrg->pOps, pPrg->uiOps * sizeof( LETOFLTOP ) );
+   for( ui = 0; ui < pClone->uiOps; ui++ )
+   {
+      pOp = pClone->pOps + ui;
+      if( pOp->bOp == LETOFLT_CONST && pOp->pBuf )
+      {
+         pOp->pBuf = ( char * ) hb_xgrab( pOp->val.nLen + 1 );
+         memcpy( pOp->pBuf, pPrg->pOps[ ui ].pBuf, pOp->val.nLen + 1 );
+         pOp->val.pStr = pOp->pBuf;
+      }
+      else
+      {
+         pOp->pBuf = NULL;
+         pOp->nBufLen = 0;
+         if( pOp->val.pStr == pPrg->pOps[ ui ].szDate )
+            pOp->val.pStr = pOp->szDate;
+      }
+   }
+
+   return pClone;
+}
+
+#if ! defined( __HARBOUR30__ )
+
+/* hb_itemStrCmp() for not terminated strings */
+static int leto_fltStrCmp( const char * szFirst, HB_SIZE nLenFirst, const char * szSecond, HB_SIZE nLenSecond, HB_BOOL fExact )
+{
+   PHB_CODEPAGE cdp;
+   HB_SIZE      nMinLen;
+   int          iRet = 0;
+
+   if( ! fExact && hb_setGetExact() )
+   {
+      while( nLenFirst > nLenSecond && szFirst[ nLenFirst - 1 ] == ' ' )
+         nLenFirst--;
+      while( nLenSecond > nLenFirst && szSecond[ nLenSecond - 1 ] == ' ' )
+         nLenSecond--;
+      fExact = HB_TRUE;
+   }
+
+   nMinLen = nLenFirst < nLenSecond ? nLenFirst : nLenSecond;
+   if( nMinLen )
+   {
+      cdp = hb_vmCDP();
+      if( cdp && ! HB_CDP_ISBINSORT( cdp ) )
+         iRet = hb_cdpcmp( szFirst, nLenFirst, szSecond, nLenSecond, cdp, fExact );
+      else
+      {
+         iRet = memcmp( szFirst, szSecond, nMinLen );
+         if( iRet )
+            iRet = iRet < 0 ? -1 : 1;
+         else if( nLenFirst != nLenSecond && ( fExact || nLenSecond > nLenFirst ) )
+            iRet = nLenFirst < nLenSecond ? -1 : 1;
+      }
+   }
+   else if( nLenFirst != nLenSecond )
+   {
+      if( fExact )
+         iRet = nLenFirst < nLenSecond ? -1 : 1;
+      else
+         iRet = nLenSecond == 0 ? 0 : -1;
+   }
+
+   return iRet;
+}
+
+static int leto_fltCmp( const LETOFLTVAL * pVal1, const LETOFLTVAL * pVal2, char cType )
+{
+   switch( cType )
+   {
+      case 'C':
+         return leto_fltStrCmp( pVal1->pStr, pVal1->nLen, pVal2->pStr, pVal2->nLen, HB_FALSE );
+
+      case 'L':
+         return ( pVal1->fLog ? 1 : 0 ) - ( pVal2->fLog ? 1 : 0 );
+   }
+   return pVal1->dNum < pVal2->dNum ? -1 : ( pVal1->dNum > pVal2->dNum ? 1 : 0 );
+}
+
+/* 1 = record is valid, 0 = not, -1 = can't be evaluated native */
+static int leto_fltRun( LETOFLTPRG * pPrg, const HB_BYTE * pRecord )
+{
+   LETOFLTVAL  stack[ LETOFLT_MAXDEEP ];
+   LETOFLTVAL * pVal = stack - 1;
+   LETOFLTOP * pOp;
+   HB_USHORT   uiPc = 0;
+
+   while( uiPc < pPrg->uiOps )
+   {
+      pOp = pPrg->pOps + uiPc++;
+      switch( pOp->bOp )
+      {
+         case LETOFLT_FLD_C:
+            ++pVal;
+            pVal->pStr = ( const char * ) pRecord + pOp->uiOffset;
+            pVal->nLen = pOp->uiLen;
+            break;
+
+         case LETOFLT_FLD_N:
+         {
+            HB_MAXINT lVal;
+            double    dVal;
+
+            ++pVal;
+            if( hb_strnToNum( ( const char * ) pRecord + pOp->uiOffset, pOp->uiLen, &lVal, &dVal ) )
+               pVal->dNum = dVal;
+            else
+               pVal->dNum = ( double ) lVal;
+            break;
+         }
+
+         case LETOFLT_FLD_I:
+         {
+            const HB_BYTE * ptr = pRecord + pOp->uiOffset;
+            double          dVal;
+
+            switch( pOp->uiLen )
+            {
+               case 1:
+                  dVal = ( HB_SCHAR ) *ptr;
+                  break;
+               case 2:
+                  dVal = HB_GET_LE_INT16( ptr );
+                  break;
+               case 3:
+                  dVal = HB_GET_LE_INT24( ptr );
+                  break;
+               case 4:
+                  dVal = HB_GET_LE_INT32( ptr );
+                  break;
+               default:
+                  dVal = ( double ) HB_GET_LE_INT64( ptr );
+            }
+            if( pOp->uiDec )
+               dVal = hb_numDecConv( dVal, ( int ) pOp->uiDec );
+            ++pVal;
+            pVal->dNum = dVal;
+            break;
+         }
+
+         case LETOFLT_FLD_B:
+            ++pVal;
+            pVal->dNum = HB_GET_LE_DOUBLE( pRecord + pOp->uiOffset );
+            break;
+
+         case LETOFLT_FLD_D:
+            ++pVal;
+            pVal->pStr = ( const char * ) pRecord + pOp->uiOffset;
+            pVal->nLen = 8;
+            pVal->dNum = ( double ) hb_dateEncStr( pVal->pStr );
+            break;
+
+         case LETOFLT_FLD_DBIN:
+         {
+            long lJulian = pOp->uiLen == 3 ? ( long ) HB_GET_LE_UINT24( pRecord + pOp->uiOffset ) :
+                                             ( long ) HB_GET_LE_UINT32( pRecord + pOp->uiOffset );
+
+            ++pVal;
+            pVal->dNum = ( double ) lJulian;
+            hb_dateDecStr( pOp->szDate, lJulian );
+            pVal->pStr = pOp->szDate;
+            pVal->nLen = 8;
+            break;
+         }
+
+         case LETOFLT_FLD_L:
+         {
+            char c = ( char ) pRecord[ pOp->uiOffset ];
+
+            ++pVal;
+            pVal->fLog = ( c == 'T' || c == 't' || c == 'Y' || c == 'y' );
+            break;
+         }
+
+         case LETOFLT_CONST:
+            *( ++pVal ) = pOp->val;
+            break;
+
+         case LETOFLT_VAR:
+            ++pVal;
+            if( ! leto_fltItemVal( leto_fltVarCall( pOp ), pOp, pVal ) )
+               return -1;
+            break;
+
+         case LETOFLT_UPPER:
+            if( pOp->nBufLen < pVal->nLen + 1 )
+            {
+               pOp->nBufLen = pVal->nLen + 1;
+               pOp->pBuf = ( char * ) hb_xrealloc( pOp->pBuf, pOp->nBufLen );
+            }
+            pVal->nLen = hb_cdpnDup2Upper( hb_vmCDP(), pVal->pStr, pVal->nLen, pOp->pBuf, pOp->nBufLen );
+            pVal->pStr = pOp->pBuf;
+            break;
+
+         case LETOFLT_SUBSTR:
+            if( pOp->uiLen > pVal->nLen )
+               pVal->nLen = 0;
+            else
+            {
+               pVal->pStr += pOp->uiLen - 1;
+               pVal->nLen -= pOp->uiLen - 1;
+               if( pVal->nLen > pOp->uiCount )
+                  pVal->nLen = pOp->uiCount;
+            }
+            break;
+
+         case LETOFLT_RTRIM:
+            while( pVal->nLen && pVal->pStr[ pVal->nLen - 1 ] == ' ' )
+               pVal->nLen--;
+            break;
+
+         case LETOFLT_LTRIM:
+            while( pVal->nLen && HB_ISSPACE( *pVal->pStr ) )
+            {
+               pVal->pStr++;
+               pVal->nLen--;
+            }
+            break;
+
+         case LETOFLT_DTOS:
+            if( ! pVal->dNum )
+               pVal->pStr = "        ";
+            pVal->nLen = 8;
+            break;
+
+         case LETOFLT_EMPTY:
+            switch( pOp->cArgType )
+            {
+               case 'C':
+                  pVal->fLog = hb_strEmpty( pVal->pStr, pVal->nLen );
+                  break;
+               case 'L':
+                  pVal->fLog = ! pVal->fLog;
+                  break;
+               default:
+                  pVal->fLog = ( pVal->dNum == 0 );
+            }
+            break;
+
+         case LETOFLT_DELETED:
+            ++pVal;
+            pVal->fLog = ( pRecord[ 0 ] == '*' );
+            break;
+
+         case LETOFLT_NOT:
+            pVal->fLog = ! pVal->fLog;
+            break;
+
+         case LETOFLT_AND:
+            if( ! pVal->fLog )
+               uiPc = pOp->uiCount;
+            else
+               pVal--;
+            break;
+
+         case LETOFLT_OR:
+            if( pVal->fLog )
+               uiPc = pOp->uiCount;
+            else
+               pVal--;
+            break;
+
+         case LETOFLT_IN:
+            pVal--;
+            pVal->fLog = ( hb_strAt( pVal->pStr, pVal->nLen, pVal[ 1 ].pStr, pVal[ 1 ].nLen ) != 0 );
+            break;
+
+         default:  /* compare */
+         {
+            int iCmp;
+
+            pVal--;
+            if( pOp->bOp == LETOFLT_EXEQ && pOp->cArgType == 'C' )
+               iCmp = ! ( pVal->nLen == pVal[ 1 ].nLen && ! memcmp( pVal->pStr, pVal[ 1 ].pStr, pVal->nLen ) );
+            else
+               iCmp = leto_fltCmp( pVal, pVal + 1, pOp->cArgType );
+
+            switch( pOp->bOp )
+            {
+               case LETOFLT_EQ:
+               case LETOFLT_EXEQ:
+                  pVal->fLog = ( iCmp == 0 );
+                  break;
+               case LETOFLT_NE:
+                  pVal->fLog = ( iCmp != 0 );
+                  break;
+               case LETOFLT_LT:
+                  pVal->fLog = ( iCmp < 0 );
+                  break;
+               case LETOFLT_LE:
+                  pVal->fLog = ( iCmp <= 0 );
+                  break;
+               case LETOFLT_GT:
+                  pVal->fLog = ( iCmp > 0 );
+                  break;
+               case LETOFLT_GE:
+                  pVal->fLog = ( iCmp >= 0 );
+                  break;
+            }
+         }
+      }
+   }
+
+   return pVal->fLog ? 1 : 0;
+}
+
+#endif
+
+/* 1 = record is valid, 0 = not, -1 = can't be evaluated native */
+int leto_FltEval( void * pFltPrg, const HB_BYTE * pRecord )
+{
+#if defined( __HARBOUR30__ )
+   HB_SYMBOL_UNUSED( pFltPrg );
+   HB_SYMBOL_UNUSED( pRecord );
+
+   return -1;
+#else
+   return leto_fltRun( ( LETOFLTPRG * ) pFltPrg, pRecord );
+#endif
+}
+
+/* current record of pArea for the compiled filter of pAStru: 1 = valid, 0 = not,
+ * -1 = can't be evaluated native, the caller has to use pAStru->itmFltExpr */
+int leto_FltAreaEval( PAREASTRU pAStru, AREAP pArea )
+{
+   int iRet = -1;
+
+#if defined( __HARBOUR30__ )
+   HB_SYMBOL_UNUSED( pAStru );
+   HB_SYMBOL_UNUSED( pArea );
+#else
+   LETOFLTPRG * pPrg = ( LETOFLTPRG * ) pAStru->pFltPrg;
+
+   if( pPrg && ! pPrg->fBroken )
+   {
+      HB_BYTE * pRecord;
+
+      if( SELF_GETREC( pArea, &pRecord ) == HB_SUCCESS )
+         iRet = leto_fltRun( pPrg, pRecord );
+      if( iRet < 0 )
+         pPrg->fBroken = HB_TRUE;
+   }
+#endif
+   return iRet;
+}
+
+/* the filter codeblock {|| LETO_FLTNATIVE( nAreaID ) } of areas with a compiled filter,
+ * evaluated for the area it belongs to, which is not always the current one, e.g. a child of a relation */
+HB_FUNC( LETO_FLTNATIVE )
+{
+   PUSERSTRU pUStru = letoGetsUStru();
+   HB_ULONG  ulAreaID = ( HB_ULONG ) hb_parnl( 1 );
+   PAREASTRU pAStru = pUStru ? pUStru->pCurAStru : NULL;
+   AREAP     pArea = NULL;
+
+   if( ! ( pAStru && pAStru->ulAreaID == ulAreaID ) )
+      pAStru = letoFindArea( pUStru, ulAreaID );
+   if( pAStru && pAStru->pFltPrg )  /* the filtered WA, not the current one */
+      pArea = ( ( LETOFLTPRG * ) pAStru->pFltPrg )->pArea;
+
+   if( ! pAStru || ! pAStru->itmFltExpr )  /* block outlived its area: no guess about the result */
+      hb_errRT_BASE_SubstR( EG_ARG, 3012, NULL, HB_ERR_FUNCNAME, HB_ERR_ARGS_BASEPARAMS );
+   else
+   {
+      int iRet = pArea ? leto_FltAreaEval( pAStru, pArea ) : -1;
+
+      if( iRet < 0 )
+         hb_vmEvalBlock( pAStru->itmFltExpr );  /* result is already the return value */
+      else
+         hb_retl( iRet > 0 );
+   }
+}
@@ -47,9 +47,14 @@
  */
 
 #include "srvleto.h"
+#include "hbstack.h"
 
 #define PARSE_MAXDEEP            5   /* used in leto_ParseFilter() */
 #define SHIFT_FOR_LEN            3
+#define MEMOINLINE_MAX      0x4000        /* max. memo length send inline with record */
+#define SKIPBUF_MIN              2        /* adaptive skip buffer: lower limit for random access */
+#define SKIPBUF_GROW            16        /* upper limit: multiple of AREASTRU->uiSkipBuf ... */
+#define SKIPBUF_MAXBYTES   0x40000        /* ... and max. size of data */
 
 typedef void ( *CMDSET )( PUSERSTRU, char * );
 static CMDSET s_cmdSet[ LETOCMD_SETLEN ] = { NULL };
@@ -107,6 +112,8 @@ static HB_BOOL   s_bAnyExt = HB_FALSE;
 static HB_USHORT s_uiLockExtended = HB_FALSE;  /* default versus extended mode ( DBFLOCK_CLIPPER2, DBFLOCK_HB32 ) */
 static HB_BOOL   s_bUdfEnabled = HB_FALSE;
 static HB_USHORT s_uiCacheRecords = 10;
+static int       s_iScanThreads = 4;          /* max. threads of a parallel leto_Sum() / leto_GroupBy() */
+static HB_BOOL   s_bFltPlan = HB_TRUE;        /* filters walk only records of index ranges of their conditions */
 static HB_BOOL   s_bOptimize = HB_TRUE;
 static HB_BOOL   s_bForceOpt = HB_FALSE;
 static int       s_iAutOrder = 0;
@@ -187,6 +194,23 @@ static HB_CRITICAL_NEW( s_TStruMtx );    /* also used for s_uiIndexCurr */
    #define HB_GC_UNLOCKU()     hb_threadLeaveCriticalSection( &s_UStruMtx )
 #endif
 
+/* table change notify subscribers, the notes are queued by leto_ErrSockQueue() */
+static HB_CRITICAL_NEW( s_NotifyMtx );
+#define HB_GC_LOCKN()       hb_threadEnterCriticalSection( &s_NotifyMtx )
+#define HB_GC_UNLOCKN()     hb_threadLeaveCriticalSection( &s_NotifyMtx )
+
+typedef struct
+{
+   PUSERSTRU         pUStru;
+   PAREASTRU         pAStru;
+   PTABLESTRU        pTStru;
+   HB_ULONG          ulAreaID;
+} NOTIFYSTRU;
+
+static NOTIFYSTRU * s_pNotify = NULL;        /* areas subscribed with DBI_NOTIFY for changes by others */
+static HB_ULONG     s_ulNotify = 0;
+static HB_ULONG     s_ulNotifyAlloc = 0;
+
 // #define LETO_SAVEMODE ( s_bNoSaveWA && ! pAStru->pTStru->bMemIO )
 
 /* two helper functions for statics from leto_2.c */
@@ -209,7 +233,11 @@ extern HB_BOOL leto_ConnectIsLock( int iLock );
 extern void leto_SendError( PUSERSTRU pUStru, const char * szData, HB_ULONG ulLen );
 extern void leto_SendAnswer( PUSERSTRU pUStru, const char * szData, HB_ULONG ulLen );
 extern void leto_SendAnswer2( PUSERSTRU pUStru, const char * szData, HB_ULONG ulLen, HB_BOOL bAllFine, int iError );
-extern HB_BOOL leto_AskAnswer( HB_SOCKET hSocket );
+extern HB_BOOL leto_SendFileAble( PUSERSTRU pUStru, HB_ULONG ulLen );
+extern HB_BOOL leto_SendFileChunk( PUSERSTRU pUStru, HB_FHANDLE hFile, HB_FOFFSET nOffset, HB_ULONG ulLen );
+extern HB_BOOL leto_AskAnswer( PUSERSTRU pUStru );
+extern HB_BOOL leto_ErrSockQueue( PUSERSTRU pUStru, const char * pData, HB_ULONG ulLen );
+extern void leto_ErrSockClose( PUSERSTRU pUStru );
 extern void leto_Admin( PUSERSTRU pUStru, char * szData );
 
 extern void leto_Variables( PUSERSTRU pUStru, char * szData );
@@ -217,6 +245,50 @@ extern void leto_setVarsMax( HB_ULONG ulMaxVars, HB_ULONG ulMaxVarLen );
 extern void leto_varsown_release( PUSERSTRU pUStru );
 extern void leto_vars_release( void );
 
+extern void * leto_FltCompile( AREAP pArea, const char * szExpr, HB_ULONG ulLen );
+extern void leto_FltFree( void * pFltPrg );
+extern int leto_FltAreaEval( PAREASTRU pAStru, AREAP pArea );
+
+extern void * leto_BmNew( void );
+extern void leto_BmFree( void * pBitmap );
+extern HB_ULONG leto_BmCount( void * pBitmap );
+extern void leto_BmAdd( void * pBitmap, HB_ULONG ulRecNo );
+extern HB_BOOL leto_BmHas( void * pBitmap, HB_ULONG ulRecNo );
+extern HB_ULONG leto_BmNext( void * pBitmap, HB_ULONG ulRecNo );
+extern HB_ULONG leto_BmPrev( void * pBitmap, HB_ULONG ulRecNo );
+extern HB_ULONG leto_BmRank( void * pBitmap, HB_ULONG ulRecNo );
+extern void leto_BmAnd( void * pBitmap, void * pOther );
+extern void leto_BmOr( void * pBitmap, void * pOther );
+extern void leto_BmAndNot( void * pBitmap, void * pOther );
+extern void * leto_BmFromArray( PHB_ITEM pArray );
+extern PHB_ITEM leto_BmToArray( void * pBitmap );
+
+extern void * leto_ScanNew( AREAP pArea, int iThreads, HB_BOOL fDeleted, void * pRBM, HB_ULONG ulTimeout );
+extern void leto_ScanFree( void * pScanData );
+extern HB_BOOL leto_ScanFilter( void * pScanData, void * pFltPrg );
+extern HB_BOOL leto_ScanField( void * pScanData, AREAP pArea, HB_USHORT uiField, HB_BOOL fDouble );
+extern HB_BOOL leto_ScanGroupBy( void * pScanData, AREAP pArea, HB_USHORT uiField );
+extern int leto_ScanRun( void * pScanData );
+extern HB_ULONG leto_ScanGroups( void * pScanData );
+extern void leto_ScanGroupKey( void * pScanData, HB_ULONG ulGroup, PHB_ITEM pItem );
+extern void leto_ScanResult( void * pScanData, HB_ULONG ulGroup, HB_USHORT uiIndex, double * pdSum, HB_MAXINT * plSum );
+extern void * leto_FltClone( void * pFltPrg );
+extern void leto_FCacheSetSize( HB_SIZE nMax );
+extern HB_BOOL leto_FCacheActive( void );
+extern HB_ULONG leto_FCacheStamp( PGLOBESTRU pGlobe );
+extern void * leto_FCacheGet( PGLOBESTRU pGlobe, const char * szKey, HB_SIZE nKeyLen );
+extern void leto_FCachePut( PGLOBESTRU pGlobe, const char * szKey, HB_SIZE nKeyLen, HB_ULONG ulStamp,
+                            void * pBitmap, void * pFltPrg, HB_BOOL fPatch, HB_BOOL fDeleted, HB_BOOL fExact );
+extern void leto_FCacheTouch( PGLOBESTRU pGlobe, HB_ULONG ulRecNo, const HB_BYTE * pRecord );
+extern HB_BOOL leto_FCacheChanges( PGLOBESTRU pGlobe, HB_ULONG * pulStamp, void * pBitmap );
+extern void leto_FCacheDrop( PGLOBESTRU pGlobe );
+extern void leto_FCacheInfo( HB_ULONG * pulEntries, HB_SIZE * pnBytes, HB_U64 * pullHits, HB_U64 * pullMisses, HB_U64 * pullPatched );
+extern void leto_FCacheRelease( void );
+extern void * leto_PlanNew( LETOTAG * pTag, const char * szFilter, HB_SIZE nLen );
+extern void * leto_PlanRun( void * pPlan, AREAP pArea );
+extern char * leto_PlanExplain( void * pPlan, AREAP pArea, void * pBitmap, HB_SIZE * pnLen );
+extern void leto_PlanFree( void * pPlan );
+
 extern void letoListInit( PLETO_LIST pList, HB_ULONG ulSize );
 extern void letoListFree( PLETO_LIST pList );
 extern HB_BOOL letoListEmptyTS( PLETO_LIST pList );
@@ -320,6 +392,11 @@ HB_USHORT leto_MaxUsers( void )
    return s_uiUsersAlloc;  /* changes only at startup */
 }
 
+HB_BOOL leto_NoSaveWA( void )
+{
+   return s_bNoSaveWA;
+}
+
 HB_BOOL leto_CheckPass( int iType )
 {
    if( iType == 1 )
@@ -912,6 +989,12 @@ static PAREASTRU leto_FindArea( PUSERSTRU pUStru, HB_ULONG ulAreaID )
    return NULL;
 }
 
+/* leto_FindArea() for the other server modules */
+PAREASTRU letoFindArea( PUSERSTRU pUStru, HB_ULONG ulAreaID )
+{
+   return pUStru ? leto_FindArea( pUStru, ulAreaID ) : NULL;
+}
+
 /* search for the from client view workarea ID */
 static PAREASTRU leto_FindUdfArea( PUSERSTRU pUStru, HB_ULONG ulAreaID )
 {
@@ -1007,6 +1090,58 @@ static void leto_FreeArea( PUSERSTRU pUStru, HB_ULONG ulAreaID, HB_BOOL bAllOthe
    }
 }
 
+/* event mode: a worker thread serves many connections, so the thread specific environment
+ * of a connection ( SETs, codepage, default RDD, TLS pUStru ) is parked while another one is served */
+void * leto_SetsClone( void )
+{
+   return ( void * ) hb_setClone( hb_stackSetStruct() );
+}
+
+void leto_SetsRelease( void * pSet )
+{
+   hb_setRelease( ( PHB_SET_STRUCT ) pSet );
+   hb_xfree( pSet );
+}
+
+void leto_ParkUS( PUSERSTRU pUStru )
+{
+   if( pUStru->pCurAStru )
+      leto_FreeCurrArea( pUStru );
+   leto_FreeArea( pUStru, 0, HB_FALSE );
+
+   if( pUStru->pHbSet )
+      leto_SetsRelease( pUStru->pHbSet );
+   pUStru->pHbSet = leto_SetsClone();
+   hb_strncpy( pUStru->szRddDef, hb_rddDefaultDrv( NULL ), HB_RDD_MAX_DRIVERNAME_LEN );
+   memset( &pUStru->hThreadID, 0, sizeof( HB_THREAD_ID ) );
+   letoSetUStru( NULL );
+}
+
+/* pSetInit and cdpInit are the worker defaults used for a fresh connection */
+void leto_UnparkUS( PUSERSTRU pUStru, void * pSetInit, PHB_CODEPAGE cdpInit )
+{
+   PHB_SET_STRUCT pSet = hb_stackSetStruct();
+   PHB_SET_STRUCT pSetNew;
+
+   if( pUStru->pHbSet )
+   {
+      pSetNew = ( PHB_SET_STRUCT ) pUStru->pHbSet;
+      pUStru->pHbSet = NULL;
+   }
+   else
+      pSetNew = hb_setClone( ( PHB_SET_STRUCT ) pSetInit );
+
+   /* take over the content, the clone shell itself is no more needed */
+   hb_setRelease( pSet );
+   memcpy( pSet, pSetNew, sizeof( HB_SET_STRUCT ) );
+   hb_xfree( pSetNew );
+
+   hb_vmSetCDP( pUStru->cdpage ? pUStru->cdpage : cdpInit );
+   hb_rddDefaultDrv( *pUStru->szRddDef ? pUStru->szRddDef : leto_Driver( s_uiDriverDef ) );
+   pUStru->hThreadID = HB_THREAD_SELF();
+   letoSetUStru( pUStru );
+}
+
 static AREAP leto_SelectArea( PUSERSTRU pUStru, HB_ULONG ulAreaID )
 {
    AREAP pArea = NULL;
@@ -1684,6 +1819,19 @@ HB_FUNC( LETO_SETAPPOPTIONS )  /* during server startup */
    }
    if( HB_ISLOG( 30 ) )
       s_bSendBackupInfo = hb_parl( 30 );
+   if( HB_ISNUM( 32 ) )
+   {
+      s_iScanThreads = hb_parni( 32 );
+      if( s_iScanThreads < 0 )
+         s_iScanThreads = 0;
+   }
+   /* external processes may change shared tables unnoticed */
+   if( HB_ISNUM( 33 ) && hb_parnl( 33 ) >= 0 )
+      leto_FCacheSetSize( s_bShareTables ? 0 : ( HB_SIZE ) hb_parnl( 33 ) * 1024 * 1024 );
+   if( HB_ISLOG( 34 ) )
+      s_bFltPlan = hb_parl( 34 );
+   if( s_bShareTables )
+      s_bFltPlan = HB_FALSE;
 
    if( hb_parclen( 31 ) )
    {
@@ -2168,7 +2316,7 @@ static void leto_IsRecLockedUS( PUSERSTRU pUStru, char * szData )
 }
 
 /* return the possible theoretic maximum length of send record data */
-static _HB_INLINE_ HB_ULONG leto_recLen( PTABLESTRU pTStru )
+static _HB_INLINE_ HB_ULONG leto_recLen( PAREASTRU pAStru )
 {
 /*
  *   3 -- HB_UINT24 len of data
@@ -2193,9 +2341,102 @@ static _HB_INLINE_ HB_ULONG leto_recLen( PTABLESTRU pTStru )
  *  5 -- HB_UINT32 DBOI_POSITION + ';'
  *  5 -- HB_UINT32 DBOI_KEYCOUNT + ';'
  *
+ *  if ulMemoInline: '&' + for each memo field HB_UINT16 field + HB_UINT24 length + memo
+ *
  * ==> pTStru->uiRecordlen + 24 + 1 elch reserve + ( pTStru->uiFields * 3 )
  */
-   return pTStru->uiRecordLen + 25 + ( pTStru->uiFields * 3 );
+   PTABLESTRU pTStru = pAStru->pTStru;
+   HB_ULONG   ulLen = pTStru->uiRecordLen + 25 + ( pTStru->uiFields * 3 );
+
+   if( pAStru->ulMemoInline )
+      ulLen += 1 + pAStru->uiMemoFields * ( pAStru->ulMemoInline + 5 );
+
+   return ulLen;
+}
+
+/* contents of not empty memo fields up to ulMemoInline length, so no extra request is needed */
+static char * leto_recMemoInline( PAREASTRU pAStru, AREAP pArea, const HB_BYTE * pRecord, const HB_BYTE * pSel, char * pData )
+{
+   const HB_BYTE * pRecordField = pRecord + 1;
+   LPFIELD         pField = pArea->lpFields;
+   PHB_ITEM        pItem = hb_itemNew( NULL );
+   char *          pStart = pData;
+   HB_USHORT       ui;
+   HB_ULONG        ulLen;
+
+   *pData++ = '&';
+   for( ui = 0; ui < pArea->uiFieldCount; ui++, pRecordField += pField->uiLen, pField++ )
+   {
+      if( ( pSel && ! pSel[ ui ] ) ||
+          ( pField->uiType != HB_FT_MEMO && pField->uiType != HB_FT_BLOB &&
+            pField->uiType != HB_FT_PICTURE && pField->uiType != HB_FT_OLE ) )
+         continue;
+      if( pField->uiLen == 4 ? ! HB_GET_LE_UINT32( pRecordField ) : pRecordField[ pField->uiLen - 1 ] == ' ' )
+         continue;  /* empty */
+#ifndef __HARBOUR30__
+      if( SELF_FIELDINFO( pArea, ui + 1, DBS_BLOB_LEN, pItem ) != HB_SUCCESS ||
+          ( HB_ULONG ) hb_itemGetNL( pItem ) > pAStru->ulMemoInline )
+         continue;  /* too big, requested when needed */
+#endif
+      if( SELF_GETVALUE( pArea, ui + 1, pItem ) == HB_SUCCESS && HB_IS_STRING( pItem ) &&
+          ( ulLen = ( HB_ULONG ) hb_itemGetCLen( pItem ) ) <= pAStru->ulMemoInline )
+      {
+         HB_PUT_LE_UINT16( pData, ui + 1 );
+         HB_PUT_LE_UINT24( pData + 2, ulLen );
+         memcpy( pData + 5, hb_itemGetCPtr( pItem ), ulLen );
+         pData += 5 + ulLen;
+      }
+   }
+   hb_itemRelease( pItem );
+
+   return pData - pStart > 1 ? pData : pStart;
+}
+
+/* OrdKeyCount() with only a bitmap filter is the count of its record numbers,
+ * if the order has one key for each record: no scope, FOR condition, UNIQUE or custom */
+static HB_BOOL leto_BmKeyCount( PAREASTRU pAStru, AREAP pArea, HB_ULONG * pulKeyCount )
+{
+   HB_BOOL fAll = HB_FALSE;
+
+   if( pAStru->pRBM && ! pAStru->itmFltExpr && ! hb_setGetDeleted() &&
+       pArea->dbfi.fFilter && pArea->dbfi.itmCobExpr == pAStru->itmFltBM )
+   {
+      DBORDERINFO pInfo;
+
+      memset( &pInfo, 0, sizeof( DBORDERINFO ) );
+      pInfo.itmResult = hb_itemNew( NULL );
+      SELF_ORDINFO( pArea, DBOI_SCOPETOP, &pInfo );
+      if( HB_IS_NIL( pInfo.itmResult ) )
+      {
+         SELF_ORDINFO( pArea, DBOI_SCOPEBOTTOM, &pInfo );
+         fAll = HB_IS_NIL( pInfo.itmResult );
+      }
+      if( fAll )
+      {
+         SELF_ORDINFO( pArea, DBOI_ISCOND, &pInfo );
+         fAll = ! hb_itemGetL( pInfo.itmResult );
+      }
+      if( fAll )
+      {
+         SELF_ORDINFO( pArea, DBOI_UNIQUE, &pInfo );
+         fAll = ! hb_itemGetL( pInfo.itmResult );
+      }
+      if( fAll )
+      {
+         SELF_ORDINFO( pArea, DBOI_CUSTOM, &pInfo );
+         fAll = ! hb_itemGetL( pInfo.itmResult );
+      }
+      hb_itemRelease( pInfo.itmResult );
+
+      if( fAll )
+      {
+         HB_ULONG ulRecCount;
+
+         SELF_RECCOUNT( pArea, &ulRecCount );
+         *pulKeyCount = leto_BmRank( pAStru->pRBM, ulRecCount );
+      }
+   }
+   return fAll;
 }
 
 static HB_ULONG leto_rec( PUSERSTRU pUStru, PAREASTRU pAStru, AREAP pArea, char * szData, HB_ULONG * ulRelPos )
@@ -2209,6 +2450,7 @@ static HB_ULONG leto_rec( PUSERSTRU pUStru, PAREASTRU pAStru, AREAP pArea, char
       HB_BYTE * pRecord;
       HB_ULONG  ulRecNo;
       HB_ULONG  ulRecCount;
+      HB_BYTE * pSel = ( pAStru->pFieldSel && ! pAStru->bFullRec && ! pArea->fEof ) ? pAStru->pFieldSel : NULL;
 
       SELF_GETREC( pArea, &pRecord );
       ulRecNo = ( ( DBFAREAP ) pArea )->ulRecNo;
@@ -2232,12 +2474,31 @@ static HB_ULONG leto_rec( PUSERSTRU pUStru, PAREASTRU pAStru, AREAP pArea, char
       }
       else
          *pData |= LETO_FLG_EOF;
+      if( pSel )
+         *pData |= LETO_FLG_PARTIAL;
 
       HB_PUT_LE_UINT32( ( HB_BYTE * ) ++pData, ulRecNo );
       pData += 4;
       *pData++ = ';';
 
-      if( pUStru->iZipRecord >= 0 )
+      if( pUStru->iZipRecord >= 0 && pSel )  /* delete flag plus raw data of selected fields */
+      {
+         const HB_BYTE * pRecordField = pRecord + 1;
+         LPFIELD         pField = pArea->lpFields;
+         HB_USHORT       ui;
+
+         *pData++ = pRecord[ 0 ];
+         for( ui = 0; ui < uiFieldCount; ui++, pField++ )
+         {
+            if( pSel[ ui ] )
+            {
+               memcpy( pData, pRecordField, pField->uiLen );
+               pData += pField->uiLen;
+            }
+            pRecordField += pField->uiLen;
+         }
+      }
+      else if( pUStru->iZipRecord >= 0 )
       {
          HB_USHORT uiRecordLen = pAStru->pTStru->uiRecordLen;
 
@@ -2249,6 +2510,8 @@ static HB_ULONG leto_rec( PUSERSTRU pUStru, PAREASTRU pAStru, AREAP pArea, char
          memset( pData, '\0', uiFieldCount );
          pData += uiFieldCount;
       }
+      else if( ! pSel && pAStru->pTStru->pRecPlan )
+         pData = leto_RecPlanEncode( pAStru->pTStru->pRecPlan, pRecord, pData );
       else
       {
          const char * pRecordField = ( char * ) pRecord + 1;  /* first byte is delete flag */
@@ -2262,6 +2525,8 @@ static HB_ULONG leto_rec( PUSERSTRU pUStru, PAREASTRU pAStru, AREAP pArea, char
                pRecordField += pField->uiLen;  /* pField from last loop */
             ptr = pRecordField;
             pField = pArea->lpFields + ui;
+            if( pSel && ! pSel[ ui ] )  /* not in projection */
+               continue;
 
             switch( pField->uiType )
             {
@@ -2269,12 +2534,7 @@ static HB_ULONG leto_rec( PUSERSTRU pUStru, PAREASTRU pAStru, AREAP pArea, char
                   if( pField->uiFlags )  /* binary, compressed, encrypted, ... */
                      ulRealLen = pField->uiLen;
                   else  /* Trimmed field length */
-                  {
-                     ptrEnd = ptr + pField->uiLen - 1;
-                     while( ptrEnd > ptr && *ptrEnd == ' ' )
-                        ptrEnd--;
-                     ulRealLen = ptrEnd - ptr + ( *ptrEnd == ' ' ? 0 : 1 );
-                  }
+                     ulRealLen = ( HB_ULONG ) leto_RTrimLen( ptr, pField->uiLen );
                   if( pField->uiLen < 256 )
                   {
                      pData[ 0 ] = ( HB_BYTE ) ulRealLen & 0xFF;
@@ -2448,10 +2708,16 @@ static HB_ULONG leto_rec( PUSERSTRU pUStru, PAREASTRU pAStru, AREAP pArea, char
          }
          if( pUStru->bBufKeyCount )
          {
+            HB_ULONG ulKeyCount;
+
             *pData++ = '$';
-            pOrderInfo.itmResult = hb_itemPutNL( pOrderInfo.itmResult, 0 );
-            SELF_ORDINFO( pArea, DBOI_KEYCOUNT, &pOrderInfo );
-            HB_PUT_LE_UINT32( ( HB_BYTE * ) pData, hb_itemGetNL( pOrderInfo.itmResult ) );
+            if( ! leto_BmKeyCount( pAStru, pArea, &ulKeyCount ) )
+            {
+               pOrderInfo.itmResult = hb_itemPutNL( pOrderInfo.itmResult, 0 );
+               SELF_ORDINFO( pArea, DBOI_KEYCOUNT, &pOrderInfo );
+               ulKeyCount = hb_itemGetNL( pOrderInfo.itmResult );
+            }
+            HB_PUT_LE_UINT32( ( HB_BYTE * ) pData, ulKeyCount );
             pData += 4;
          }
 
@@ -2460,6 +2726,9 @@ static HB_ULONG leto_rec( PUSERSTRU pUStru, PAREASTRU pAStru, AREAP pArea, char
       else
          *pData++ = '#';
 
+      if( pAStru->ulMemoInline && pAStru->uiMemoFields && ! pArea->fEof )
+         pData = leto_recMemoInline( pAStru, pArea, pRecord, pSel, pData );
+
       ulRealLen = pData - szData;
       HB_PUT_LE_UINT24( szData, ( HB_U32 ) ulRealLen - SHIFT_FOR_LEN );
    }
@@ -2972,6 +3241,7 @@ static void leto_CloseGlobe( PGLOBESTRU pGStru )
    else
       pGStru->ulAreas = 0;
 
+   leto_FCacheDrop( pGStru );
    if( pGStru->szTable )
    {
       hb_xfree( pGStru->szTable );
@@ -3002,6 +3272,18 @@ static void leto_CloseTable( PTABLESTRU pTStru )
       hb_xfree( pTStru->szDriver );
       pTStru->szDriver = NULL;
    }
+   if( pTStru->pLZ4Dict )
+   {
+      hb_xfree( pTStru->pLZ4Dict );
+      pTStru->pLZ4Dict = NULL;
+      pTStru->ulLZ4Dict = 0;
+      pTStru->ulLZ4DictRecs = 0;
+   }
+   if( pTStru->pRecPlan )
+   {
+      leto_RecPlanFree( pTStru->pRecPlan );
+      pTStru->pRecPlan = NULL;
+   }
    letoListFree( &pTStru->LocksList );
    if( pTStru->uiIndexCount )
    {
@@ -3176,6 +3458,17 @@ static int leto_InitTable( HB_ULONG ulAreaID, const char * szName, const char *
          break;
       }
    }
+   pTStru->pRecPlan = leto_RecPlanNew( pTStru->uiFields );
+   for( ui = 0; ui < pTStru->uiFields; ui++ )
+   {
+      pField = pArea->lpFields + ui;
+      if( ! leto_RecPlanAdd( pTStru->pRecPlan, pField->uiType, pField->uiLen, pField->uiFlags ) )
+      {
+         leto_RecPlanFree( pTStru->pRecPlan );
+         pTStru->pRecPlan = NULL;
+         break;
+      }
+   }
 
    pTStru->ulFlags = 0;
    pTStru->uiIndexCount = 0;
@@ -3351,11 +3644,101 @@ static void leto_TableUnlock( PAREASTRU pAStru, HB_BOOL bOnlyRecLocks, AREAP pAr
 }
 
 /* HB_GC_LOCKT() moved into this from callers */
+static void leto_NotifyAdd( PUSERSTRU pUStru, PAREASTRU pAStru )
+{
+   HB_GC_LOCKN();
+   if( s_ulNotify == s_ulNotifyAlloc )
+   {
+      s_ulNotifyAlloc += 16;
+      s_pNotify = ( NOTIFYSTRU * ) hb_xrealloc( s_pNotify, sizeof( NOTIFYSTRU ) * s_ulNotifyAlloc );
+   }
+   s_pNotify[ s_ulNotify ].pUStru = pUStru;
+   s_pNotify[ s_ulNotify ].pAStru = pAStru;
+   s_pNotify[ s_ulNotify ].pTStru = pAStru->pTStru;
+   s_pNotify[ s_ulNotify ].ulAreaID = pAStru->ulAreaID;
+   s_ulNotify++;
+   pAStru->bNotify = HB_TRUE;
+   HB_GC_UNLOCKN();
+}
+
+/* remove subscription of pAStru, or with NULL all of pUStru */
+static void leto_NotifyDel( PUSERSTRU pUStru, PAREASTRU pAStru )
+{
+   HB_ULONG ul = 0;
+
+   HB_GC_LOCKN();
+   while( ul < s_ulNotify )
+   {
+      if( pAStru ? s_pNotify[ ul ].pAStru == pAStru : s_pNotify[ ul ].pUStru == pUStru )
+      {
+         s_pNotify[ ul ].pAStru->bNotify = HB_FALSE;
+         s_pNotify[ ul ] = s_pNotify[ --s_ulNotify ];
+      }
+      else
+         ul++;
+   }
+   HB_GC_UNLOCKN();
+}
+
+/* tell subscribers of same table, except pAStru itself, about changed records at second socket:
+ * cType: 'U' update of ulFrom - ulTo, 'A' append, 'Z' zap, 'P' pack, 'X' unknown changes
+ * The notes are only queued, subscriptions of a given up second socket are dropped */
+static void leto_Notify( PAREASTRU pAStru, char cType, HB_ULONG ulFrom, HB_ULONG ulTo )
+{
+   NOTIFYSTRU * pNote;
+   HB_ULONG     ul = 0;
+   char         szMsg[ 64 ];
+   HB_ULONG     ulLen;
+
+   if( ! s_ulNotify || ! pAStru )  /* quick pre-test without mutex */
+      return;
+
+   hb_vmUnlock();
+   HB_GC_LOCKN();
+   while( ul < s_ulNotify )
+   {
+      pNote = s_pNotify + ul;
+      if( pNote->pTStru == pAStru->pTStru && pNote->pAStru != pAStru )
+      {
+         ulLen = eprintf( szMsg + LETO_MSGSIZE_LEN, "!N;%lu;%c;%lu;%lu;", pNote->ulAreaID, cType, ulFrom, ulTo );
+         HB_PUT_LE_UINT32( szMsg, ulLen );
+         if( ! leto_ErrSockQueue( pNote->pUStru, szMsg, ulLen + LETO_MSGSIZE_LEN ) )
+         {
+            pNote->pAStru->bNotify = HB_FALSE;
+            s_pNotify[ ul ] = s_pNotify[ --s_ulNotify ];
+            continue;
+         }
+      }
+      ul++;
+   }
+   HB_GC_UNLOCKN();
+   hb_vmLock();
+}
+
+/* tell the filter result cache and index plans about changes of the current record [ bRecord ] or any of the table */
+static void leto_FCacheChanged( PAREASTRU pAStru, AREAP pArea, HB_BOOL bRecord )
+{
+   DBFAREAP pDbfArea = ( DBFAREAP ) pArea;
+
+   if( ! ( leto_FCacheActive() || s_bFltPlan ) || ! pAStru )
+      return;
+
+   if( pDbfArea->fTrigger )  /* may have changed other tables */
+      leto_FCacheTouch( NULL, 0, NULL );
+   else if( bRecord && pDbfArea->fValidBuffer && ! pDbfArea->pCryptKey )
+      leto_FCacheTouch( pAStru->pTStru->pGlobe, pDbfArea->ulRecNo, pDbfArea->pRecord );
+   else
+      leto_FCacheTouch( pAStru->pTStru->pGlobe, 0, NULL );
+}
+
 static HB_BOOL leto_CloseArea( PUSERSTRU pUStru, PAREASTRU pAStru )
 {
    PTABLESTRU pTStru = pAStru->pTStru;
    HB_BOOL    bOk = HB_TRUE;
 
+   if( pAStru->bNotify )
+      leto_NotifyDel( pUStru, pAStru );
+
    HB_GC_LOCKT();
 
    pTStru->ulAreas--;
@@ -3455,10 +3838,22 @@ static HB_BOOL leto_CloseArea( PUSERSTRU pUStru, PAREASTRU pAStru )
 
       if( pAStru->itmFltExpr )
          hb_itemRelease( pAStru->itmFltExpr );
+      if( pAStru->itmFltNative )
+         hb_itemRelease( pAStru->itmFltNative );
+      if( pAStru->pFltPrg )
+         leto_FltFree( pAStru->pFltPrg );
+      if( pAStru->itmFltBM )
+         hb_itemRelease( pAStru->itmFltBM );
+      if( pAStru->pRBM )
+         leto_BmFree( pAStru->pRBM );
+      if( pAStru->pPlan )
+         leto_PlanFree( pAStru->pPlan );
 #ifdef __BM
       if( pAStru->pBM )
          hb_xfree( pAStru->pBM );
 #endif
+      if( pAStru->pFieldSel )
+         hb_xfree( pAStru->pFieldSel );
       if( pUStru->pCurAStru == pAStru )
       {
          pUStru->ulCurAreaID = 0;
@@ -3800,8 +4195,16 @@ void leto_CloseUS( PUSERSTRU pUStru )
       hb_xfree( pUStru->szDateFormat );
       pUStru->szDateFormat = NULL;
    }
+   if( pUStru->pHbSet )
+   {
+      leto_SetsRelease( pUStru->pHbSet );
+      pUStru->pHbSet = NULL;
+   }
 
    leto_CloseAll4Us( pUStru );  /* HB_GC_LOCKU() in leto_FindUserStru() leto_wUsLog( NULL ) */
+   if( s_ulNotify )
+      leto_NotifyDel( pUStru, NULL );
+   leto_ErrSockClose( pUStru );
 
    if( pUStru->pBufCrypt )
    {
@@ -4078,9 +4481,10 @@ int leto_PingForZombies( long lTimeInactive )
       /* to prevent this client log out during Zombie check */
       hb_threadEnterCriticalSection( &pUStru->pMutex );
 
-      if( pUStru->iUserStru && pUStru->hSocketErr != HB_NO_SOCKET )
+      /* a given up second socket can't answer */
+      if( pUStru->iUserStru && pUStru->hSocketErr != HB_NO_SOCKET && ! pUStru->bErrSockDrop )
       {
-         if( ! leto_AskAnswer( pUStru->hSocketErr ) )
+         if( ! leto_AskAnswer( pUStru ) )
          {
             /* wake up the serving thread for this dead connection */
             if( hb_socketShutdown( pUStru->hSocket, HB_SOCKET_SHUT_RDWR ) != 0 )
@@ -4415,6 +4819,7 @@ HB_FUNC( LETO_RELEASEDATA )  /* during server down */
 
       leto_acc_release();  // with leto_acc_flush() before
       leto_vars_release();
+      leto_FCacheRelease();
 
       if( s_szServerAddr )
          hb_xfree( s_szServerAddr );
@@ -5426,6 +5831,80 @@ static void leto_FilePathClean( char * pFullPath )
       memmove( pFullPath, pFullPath + nS2 + nS3, strlen( pFullPath ) - ( nS2 + nS3 ) + 1 );
 }
 
+/* FileRead as stream: answer '+T;<bytes>;' followed by messages with leading 'D' and up to ulStep bytes each,
+ * for uncompressed traffic send with sendfile() without copy into a buffer. Returns HB_FALSE with error answer
+ * in szErr, if nothing is send */
+static HB_BOOL leto_FileStream( PUSERSTRU pUStru, const char * szFile, HB_ULONG ulStart, HB_ULONG ulLen, HB_ULONG ulStep, char * szErr )
+{
+   HB_FHANDLE hFile;
+   HB_FOFFSET nSize;
+   HB_ULONG   ulSent = 0, ulChunk, ulBytesSend;
+   HB_BOOL    bSendFile;
+   char *     pBuffer = NULL;
+   char       szAnswer[ 32 ];
+
+   if( strstr( szFile, "mem:" ) )  /* client falls back to step by step FileRead */
+   {
+      strcpy( szErr, "+F;1;" );
+      return HB_FALSE;
+   }
+
+   hFile = hb_fsOpen( szFile, FO_READ | FO_SHARED );
+   if( hFile == FS_ERROR )
+   {
+      sprintf( szErr, "+F;%d;", hb_fsError() );
+      return HB_FALSE;
+   }
+
+   nSize = hb_fsSeekLarge( hFile, 0, FS_END );
+   if( ( HB_FOFFSET ) ulStart > nSize )
+      ulStart = ( HB_ULONG ) nSize;
+   if( ! ulLen || ( HB_FOFFSET ) ulStart + ulLen > nSize )
+      ulLen = ( HB_ULONG ) ( nSize - ulStart );
+   if( ulStep < 0x1000 || ulStep > LETO_FILESTREAM_MAXSTEP )
+      ulStep = LETO_FILESTREAM_STEP;
+
+   sprintf( szAnswer, "+T;%lu;", ulLen );
+   leto_SendAnswer( pUStru, szAnswer, strlen( szAnswer ) );
+   ulBytesSend = pUStru->ulBytesSend;
+   bSendFile = leto_SendFileAble( pUStru, ulStep );
+
+   while( ulSent < ulLen && pUStru->ulBytesSend )
+   {
+      ulChunk = HB_MIN( ulStep, ulLen - ulSent );
+      if( bSendFile )
+      {
+         if( ! leto_SendFileChunk( pUStru, hFile, ( HB_FOFFSET ) ulStart + ulSent, ulChunk ) )
+            break;  /* message incomplete: connection is closed after this request */
+      }
+      else
+      {
+         if( ! pBuffer )
+            pBuffer = ( char * ) hb_xgrab( HB_MIN( ulStep, ulLen ) + 2 );
+         if( hb_fsReadAt( hFile, pBuffer + 1, ulChunk, ( HB_FOFFSET ) ulStart + ulSent ) == ulChunk )
+         {
+            pBuffer[ 0 ] = 'D';
+            leto_SendAnswer( pUStru, pBuffer, ulChunk + 1 );
+         }
+         else  /* file shrinked meanwhile: end stream with error */
+         {
+            sprintf( szAnswer, "+F;%d;", hb_fsError() ? hb_fsError() : 1 );
+            leto_SendAnswer( pUStru, szAnswer, strlen( szAnswer ) );
+            break;
+         }
+      }
+      ulBytesSend += pUStru->ulBytesSend;
+      ulSent += ulChunk;
+   }
+
+   hb_fsClose( hFile );
+   if( pBuffer )
+      hb_xfree( pBuffer );
+   pUStru->ulBytesSend = ulBytesSend;  /* for statistics */
+
+   return HB_TRUE;
+}
+
 static void leto_FileFunc( PUSERSTRU pUStru, char * szData )
 {
    char * pSrcFile, * pp2, * pp3 = NULL;
@@ -5442,6 +5921,7 @@ static void leto_FileFunc( PUSERSTRU pUStru, char * szData )
       HB_ULONG ulLen = 0;
       char *   pBuffer = NULL;
       HB_BOOL  bFreeBuf = HB_FALSE;
+      HB_BOOL  bStreamed = HB_FALSE;
 
       leto_DataPath( pSrcFile, szFile );
 
@@ -5935,6 +6415,14 @@ static void leto_FileFunc( PUSERSTRU pUStru, char * szData )
                break;
             }
 
+            case '9':  /* FileRead as stream of messages, one request for whole file */
+               if( nParam < 4 )
+                  strcpy( szData1, "+F;1;" );
+               else
+                  bStreamed = leto_FileStream( pUStru, szFile, strtoul( pp2, NULL, 10 ), strtoul( pp3, NULL, 10 ),
+                                               strtoul( pp3 + strlen( pp3 ) + 1, NULL, 10 ), szData1 );
+               break;
+
             default:
                strcpy( szData1, "+F;1;" );
                break;
@@ -5957,7 +6445,7 @@ static void leto_FileFunc( PUSERSTRU pUStru, char * szData )
             pUStru->ulBufCryptLen = 0;
          }
       }
-      else
+      else if( ! bStreamed )  /* else already answered */
          leto_SendAnswer( pUStru, szData1, strlen( szData1 ) );
    }
 }
@@ -6344,7 +6832,7 @@ HB_FUNC( LETO_RECUNLOCK )
 /* result freed by caller */
 static char * leto_recWithAlloc( AREAP pArea, PUSERSTRU pUStru, PAREASTRU pAStru, HB_ULONG * pulLen )
 {
-   HB_ULONG ulRecLen = leto_recLen( pAStru->pTStru );
+   HB_ULONG ulRecLen = leto_recLen( pAStru );
    char *   szData = ulRecLen ? ( char * ) hb_xgrab( ulRecLen + 1 ) : NULL;
 
    if( szData )
@@ -6951,6 +7439,14 @@ static void leto_UpdateRec( PUSERSTRU pUStru, const char * szData, HB_BOOL bAppe
       iRes = leto_UpdateRecord( pUStru, szData, bAppend, &ulRecNo, NULL, NULL );
       if( bFlush && ( iRes == 0 || iRes == 1 ) )
          SELF_FLUSH( ( AREAP ) hb_rddGetCurrentWorkAreaPointer() );
+      if( ! iRes )
+         leto_FCacheChanged( pUStru->pCurAStru, ( AREAP ) hb_rddGetCurrentWorkAreaPointer(), HB_TRUE );
+      if( ! iRes && s_ulNotify )
+      {
+         if( ! bAppend )
+            SELF_RECNO( ( AREAP ) hb_rddGetCurrentWorkAreaPointer(), &ulRecNo );
+         leto_Notify( pUStru->pCurAStru, bAppend ? 'A' : 'U', ulRecNo, ulRecNo );
+      }
       switch( iRes )
       {
          case 0:
@@ -7234,6 +7730,51 @@ HB_FUNC( LETO_FTS )  /* Full Text Search in all fields ( default plus memos ) */
       hb_retl( nPos != 0 );
 }
 
+static void leto_PlanDrop( PAREASTRU pAStru )
+{
+   if( pAStru->pPlan )
+   {
+      leto_PlanFree( pAStru->pPlan );
+      pAStru->pPlan = NULL;
+      if( pAStru->pRBM )
+      {
+         leto_BmFree( pAStru->pRBM );
+         pAStru->pRBM = NULL;
+      }
+   }
+}
+
+/* candidates of index plan as bitmap filter pRBM. Records changed since are added, they stay a superset
+ * as the complete filter is evaluated for each; walked again if a change is not known by its record */
+static void leto_PlanFilter( PAREASTRU pAStru, AREAP pArea )
+{
+   HB_ULONG ulStamp;
+   void *   pBitmap;
+
+   if( pAStru->pRBM && leto_FCacheChanges( pAStru->pTStru->pGlobe, &pAStru->ulPlanStamp, pAStru->pRBM ) )
+      return;
+
+   ulStamp = leto_FCacheStamp( pAStru->pTStru->pGlobe );
+
+   if( pAStru->pRBM )
+   {
+      leto_BmFree( pAStru->pRBM );
+      pAStru->pRBM = NULL;
+   }
+   pBitmap = leto_PlanRun( pAStru->pPlan, pArea );
+   if( pBitmap && pAStru->itmFltBM )
+   {
+      pAStru->pRBM = pBitmap;
+      pAStru->ulPlanStamp = ulStamp;
+   }
+   else  /* an order was closed or changed, or ranges are too wide */
+   {
+      if( pBitmap )
+         leto_BmFree( pBitmap );
+      leto_PlanDrop( pAStru );
+   }
+}
+
 static void leto_SetFilter( PAREASTRU pAStru, AREAP pArea, PUSERSTRU pUStru )
 {
    if( pAStru->itmFltExpr )
@@ -7248,16 +7789,25 @@ static void leto_SetFilter( PAREASTRU pAStru, AREAP pArea, PUSERSTRU pUStru )
          pUStru->iHbError = 0;
          hb_itemRelease( pAStru->itmFltExpr );
          pAStru->itmFltExpr = NULL;
+         leto_PlanDrop( pAStru );
          pArea->dbfi.fFilter = HB_FALSE;
          leto_wUsLog( pUStru, -1, "ERROR leto_SetFilter! now invalid filter for WA %s removed", pAStru->szAlias );
       }
       else
       {
-         pArea->dbfi.itmCobExpr = pAStru->itmFltExpr;
+         if( pAStru->pPlan )
+            leto_PlanFilter( pAStru, pArea );
+         pArea->dbfi.itmCobExpr = pAStru->itmFltNative ? pAStru->itmFltNative : pAStru->itmFltExpr;
          pArea->dbfi.fOptimized = HB_FALSE;
          pArea->dbfi.fFilter = HB_TRUE;
       }
    }
+   if( pAStru->pRBM )  /* includes above itmFltExpr */
+   {
+      pArea->dbfi.itmCobExpr = pAStru->itmFltBM;
+      pArea->dbfi.fOptimized = HB_FALSE;
+      pArea->dbfi.fFilter = HB_TRUE;
+   }
 #ifdef __BM
    if( pAStru->pBM )
       leto_BMRestore( pArea, pAStru );
@@ -7273,77 +7823,230 @@ static void leto_ClearFilter( AREAP pArea )
 #endif
 }
 
-static void leto_ScopeCommand( AREAP pArea, HB_USHORT uiCommand, PHB_ITEM pKey )
+/* bitmap filter active: walk along its record numbers, or along active order with RDD filter suspended */
+static _HB_INLINE_ HB_BOOL leto_BmWalk( PAREASTRU pAStru, AREAP pArea )
 {
-   DBORDERINFO pInfo;
-
-   memset( &pInfo, 0, sizeof( DBORDERINFO ) );
-   pInfo.itmNewVal = pKey;
-   pInfo.itmResult = hb_itemNew( NULL );
-   SELF_ORDINFO( pArea, uiCommand, &pInfo );
-   hb_itemRelease( pInfo.itmResult );
+   return pAStru->pRBM && pArea->dbfi.fFilter && pArea->dbfi.itmCobExpr == pAStru->itmFltBM;
 }
 
-static void leto_SetScope( AREAP pArea, LETOTAG * pTag, HB_BOOL bTop, HB_BOOL bSet )
+/* filter condition of bitmap filter for current record, compiled one if available */
+static HB_BOOL leto_BmCond( PAREASTRU pAStru, AREAP pArea )
 {
-   PHB_ITEM pKey = ( bTop ? pTag->pTopScope : pTag->pBottomScope );
+   int iRet = pAStru->itmFltNative ? leto_FltAreaEval( pAStru, pArea ) : -1;
 
-   if( pKey )
+   if( iRet < 0 )
    {
-      HB_USHORT uiCommand;
+      PHB_ITEM pResult = hb_vmEvalBlock( pAStru->itmFltExpr );
 
-      if( bSet )
-         uiCommand = ( bTop ? DBOI_SCOPETOP : DBOI_SCOPEBOTTOM );
-      else
-         uiCommand = ( bTop ? DBOI_SCOPETOPCLEAR : DBOI_SCOPEBOTTOMCLEAR );
-      leto_ScopeCommand( pArea, uiCommand, ( bSet ? pKey : NULL ) );
+      iRet = HB_IS_LOGICAL( pResult ) && hb_itemGetL( pResult );
    }
+   return iRet > 0;
 }
 
-static _HB_INLINE_ void leto_SetFocusIf( PAREASTRU pAStru, AREAP pArea, const char * szOrder )
+/* current record, known to be in bitmap, valid for SET DELETED and a filter condition */
+static HB_BOOL leto_BmValid( PAREASTRU pAStru, AREAP pArea )
 {
-   if( ! pAStru->pTagCurrent || leto_stricmp( pAStru->pTagCurrent->szTagName, szOrder ) )
+   HB_BOOL fValid = HB_TRUE;
+
+   if( hb_setGetDeleted() )
    {
-      if( *szOrder )
-      {
-         if( leto_FindTag( pAStru, szOrder ) && ! leto_SetFocus( pArea, szOrder ) )
-            pAStru->pTagCurrent = NULL;
-      }
-      else if( pAStru->pTagCurrent )
-      {
-         leto_SetFocus( pArea, "" );
-         pAStru->pTagCurrent = NULL;
-      }
+      SELF_DELETED( pArea, &fValid );
+      fValid = ! fValid;
    }
-   else if( ! ( s_bNoSaveWA && ! pAStru->pTStru->bMemIO ) )
-      leto_SetFocusQuick( pArea, szOrder );
+   if( fValid && pAStru->itmFltExpr )
+      fValid = leto_BmCond( pAStru, pArea );
+   return fValid;
 }
 
-static void leto_SetAreaEnv( PAREASTRU pAStru, AREAP pArea, PUSERSTRU pUStru )
+/* RDD moves in active order without evaluating the filter codeblock, SET DELETED is still done by it */
+static void leto_bmOrdSuspend( AREAP pArea, PHB_ITEM * pitmCobExpr )
 {
-   LETOTAG * pTag = pAStru->pTagCurrent;
+   *pitmCobExpr = pArea->dbfi.itmCobExpr;
+   pArea->dbfi.itmCobExpr = NULL;
+   pArea->dbfi.fFilter = HB_FALSE;
+}
 
-   if( pTag )
+static void leto_bmOrdResume( AREAP pArea, PHB_ITEM itmCobExpr )
+{
+   pArea->dbfi.itmCobExpr = itmCobExpr;
+   pArea->dbfi.fFilter = HB_TRUE;
+}
+
+/* from current order position skip to first record in bitmap and valid, filter suspended */
+static HB_ERRCODE leto_bmOrdValid( PAREASTRU pAStru, AREAP pArea, HB_BOOL fForward )
+{
+   while( ! pArea->fEof && ! pArea->fBof )
    {
-      leto_SetFocusQuick( pArea, pTag->szTagName );
-      if( pTag->pTopScope )
-         leto_SetScope( pArea, pTag, HB_TRUE, HB_TRUE );   /* set TopScope */
-      if( pTag->pBottomScope )
-         leto_SetScope( pArea, pTag, HB_FALSE, HB_TRUE );  /* set BotScope */
+      if( leto_BmHas( pAStru->pRBM, ( ( DBFAREAP ) pArea )->ulRecNo ) && leto_BmValid( pAStru, pArea ) )
+         break;
+      if( SELF_SKIP( pArea, fForward ? 1 : -1 ) != HB_SUCCESS )
+         return HB_FAILURE;
    }
-   else
-      leto_SetFocusQuick( pArea, "" );
-
-   leto_SetFilter( pAStru, pArea, pUStru );
+   return HB_SUCCESS;
 }
 
-static void leto_ClearAreaEnv( AREAP pArea, LETOTAG * pTag )
+static HB_ERRCODE leto_BmGoTop( PAREASTRU pAStru, AREAP pArea, HB_BOOL bTop )
 {
-   leto_ClearFilter( pArea );
+   HB_ULONG ulRecCount, ulRecNo;
 
-   if( pTag )
+   if( leto_GetOrdInfoNL( pArea, DBOI_NUMBER ) )
    {
-      if( pTag->pTopScope )
+      PHB_ITEM   itmCobExpr;
+      HB_ERRCODE errCode;
+
+      leto_bmOrdSuspend( pArea, &itmCobExpr );
+      errCode = bTop ? SELF_GOTOP( pArea ) : SELF_GOBOTTOM( pArea );
+      if( errCode == HB_SUCCESS )
+         errCode = leto_bmOrdValid( pAStru, pArea, bTop );
+      if( errCode == HB_SUCCESS && pArea->fBof )
+         errCode = SELF_GOTO( pArea, 0 );
+      leto_bmOrdResume( pArea, itmCobExpr );
+      return errCode;
+   }
+
+   SELF_RECCOUNT( pArea, &ulRecCount );
+   ulRecNo = bTop ? 0 : ulRecCount + 1;
+   for( ;; )
+   {
+      ulRecNo = bTop ? leto_BmNext( pAStru->pRBM, ulRecNo ) : leto_BmPrev( pAStru->pRBM, ulRecNo );
+      if( ! ulRecNo || ulRecNo > ulRecCount )
+         break;
+      if( SELF_GOTO( pArea, ulRecNo ) != HB_SUCCESS )
+         return HB_FAILURE;
+      if( leto_BmValid( pAStru, pArea ) )
+         return HB_SUCCESS;
+   }
+   return SELF_GOTO( pArea, 0 );
+}
+
+static HB_ERRCODE leto_BmSkip( PAREASTRU pAStru, AREAP pArea, HB_LONG lSkip )
+{
+   HB_ULONG ulRecCount, ulRecNo = ( ( DBFAREAP ) pArea )->ulRecNo;
+   HB_BOOL  fForward = lSkip > 0;
+
+   if( ! lSkip )
+      return SELF_SKIP( pArea, 0 );
+
+   if( leto_GetOrdInfoNL( pArea, DBOI_NUMBER ) )
+   {
+      PHB_ITEM   itmCobExpr;
+      HB_ERRCODE errCode = HB_SUCCESS;
+
+      leto_bmOrdSuspend( pArea, &itmCobExpr );
+      while( lSkip )
+      {
+         if( ( errCode = SELF_SKIP( pArea, fForward ? 1 : -1 ) ) != HB_SUCCESS || pArea->fEof || pArea->fBof )
+            break;
+         if( leto_BmHas( pAStru->pRBM, ( ( DBFAREAP ) pArea )->ulRecNo ) && leto_BmValid( pAStru, pArea ) )
+            lSkip += fForward ? -1 : 1;
+      }
+      leto_bmOrdResume( pArea, itmCobExpr );
+      if( errCode != HB_SUCCESS || ! lSkip || fForward )
+         return errCode;
+   }
+   else
+   {
+      SELF_RECCOUNT( pArea, &ulRecCount );
+      if( ulRecNo > ulRecCount )
+         ulRecNo = ulRecCount + 1;
+      while( lSkip )
+      {
+         ulRecNo = fForward ? leto_BmNext( pAStru->pRBM, ulRecNo ) : leto_BmPrev( pAStru->pRBM, ulRecNo );
+         if( ! ulRecNo || ulRecNo > ulRecCount )
+            break;
+         if( SELF_GOTO( pArea, ulRecNo ) != HB_SUCCESS )
+            return HB_FAILURE;
+         if( leto_BmValid( pAStru, pArea ) )
+            lSkip += fForward ? -1 : 1;
+      }
+      if( ! lSkip )
+         return HB_SUCCESS;
+      if( fForward )
+         return SELF_GOTO( pArea, 0 );
+   }
+
+   if( leto_BmGoTop( pAStru, pArea, HB_TRUE ) != HB_SUCCESS )
+      return HB_FAILURE;
+   pArea->fBof = HB_TRUE;  /* as done by RDD skipping before first valid record */
+   return HB_SUCCESS;
+}
+
+static _HB_INLINE_ HB_ERRCODE leto_SkipIf( PAREASTRU pAStru, AREAP pArea, HB_BOOL bBmWalk, HB_LONG lSkip )
+{
+   return bBmWalk ? leto_BmSkip( pAStru, pArea, lSkip ) : SELF_SKIP( pArea, lSkip );
+}
+
+static void leto_ScopeCommand( AREAP pArea, HB_USHORT uiCommand, PHB_ITEM pKey )
+{
+   DBORDERINFO pInfo;
+
+   memset( &pInfo, 0, sizeof( DBORDERINFO ) );
+   pInfo.itmNewVal = pKey;
+   pInfo.itmResult = hb_itemNew( NULL );
+   SELF_ORDINFO( pArea, uiCommand, &pInfo );
+   hb_itemRelease( pInfo.itmResult );
+}
+
+static void leto_SetScope( AREAP pArea, LETOTAG * pTag, HB_BOOL bTop, HB_BOOL bSet )
+{
+   PHB_ITEM pKey = ( bTop ? pTag->pTopScope : pTag->pBottomScope );
+
+   if( pKey )
+   {
+      HB_USHORT uiCommand;
+
+      if( bSet )
+         uiCommand = ( bTop ? DBOI_SCOPETOP : DBOI_SCOPEBOTTOM );
+      else
+         uiCommand = ( bTop ? DBOI_SCOPETOPCLEAR : DBOI_SCOPEBOTTOMCLEAR );
+      leto_ScopeCommand( pArea, uiCommand, ( bSet ? pKey : NULL ) );
+   }
+}
+
+static _HB_INLINE_ void leto_SetFocusIf( PAREASTRU pAStru, AREAP pArea, const char * szOrder )
+{
+   if( ! pAStru->pTagCurrent || leto_stricmp( pAStru->pTagCurrent->szTagName, szOrder ) )
+   {
+      if( *szOrder )
+      {
+         if( leto_FindTag( pAStru, szOrder ) && ! leto_SetFocus( pArea, szOrder ) )
+            pAStru->pTagCurrent = NULL;
+      }
+      else if( pAStru->pTagCurrent )
+      {
+         leto_SetFocus( pArea, "" );
+         pAStru->pTagCurrent = NULL;
+      }
+   }
+   else if( ! ( s_bNoSaveWA && ! pAStru->pTStru->bMemIO ) )
+      leto_SetFocusQuick( pArea, szOrder );
+}
+
+static void leto_SetAreaEnv( PAREASTRU pAStru, AREAP pArea, PUSERSTRU pUStru )
+{
+   LETOTAG * pTag = pAStru->pTagCurrent;
+
+   if( pTag )
+   {
+      leto_SetFocusQuick( pArea, pTag->szTagName );
+      if( pTag->pTopScope )
+         leto_SetScope( pArea, pTag, HB_TRUE, HB_TRUE );   /* set TopScope */
+      if( pTag->pBottomScope )
+         leto_SetScope( pArea, pTag, HB_FALSE, HB_TRUE );  /* set BotScope */
+   }
+   else
+      leto_SetFocusQuick( pArea, "" );
+
+   leto_SetFilter( pAStru, pArea, pUStru );
+}
+
+static void leto_ClearAreaEnv( AREAP pArea, LETOTAG * pTag )
+{
+   leto_ClearFilter( pArea );
+
+   if( pTag )
+   {
+      if( pTag->pTopScope )
          leto_SetScope( pArea, pTag, HB_TRUE, HB_FALSE );   /* clear TopScope */
       if( pTag->pBottomScope )
          leto_SetScope( pArea, pTag, HB_FALSE, HB_FALSE );  /* clear BotScope */
@@ -7418,6 +8121,101 @@ static void leto_Seek( PUSERSTRU pUStru, char * szData )
       hb_xfree( szData1 );
 }
 
+/* szData: "cFlags;nCount;" + nCount * ( key length byte + binary key ) for the active order
+ * answer for each key in same order a record as in skip buffer, with 0x02 flag only flags byte + HB_UINT32 RecNo */
+static void leto_SeekList( PUSERSTRU pUStru, char * szData )
+{
+   AREAP        pArea = ( AREAP ) hb_rddGetCurrentWorkAreaPointer();
+   PAREASTRU    pAStru = pUStru->pCurAStru;
+   const char * pEnd = ( const char * ) pUStru->pBuffer + pUStru->ulDataLen;
+   char *       szData1 = NULL, * ptr = NULL;
+   const char * pData = NULL;
+   HB_ULONG     ulLen = 4, ulCount = 0;
+
+   if( szData + 4 <= pEnd && szData[ 1 ] == ';' )
+      ulCount = strtoul( szData + 2, &ptr, 10 );
+   if( ! pArea || ! ulCount || ulCount > LETO_SEEKLIST_MAX || *ptr != ';' )
+      pData = szErr2;
+   else if( ! pAStru->pTagCurrent )
+      pData = szErr4;
+   else
+   {
+      const char * pKey = ptr + 1;
+      HB_BOOL      bSoftSeek = ( *szData & 0x10 );
+      HB_BOOL      bFindLast = ( *szData & 0x20 );
+      HB_BOOL      bRecNoOnly = ( *szData & 0x02 );
+      HB_BOOL      bMutex = ( ( s_bNoSaveWA && ! pAStru->pTStru->bMemIO ) && pAStru->itmFltExpr );
+      char         cKeyType = pAStru->pTagCurrent->pIStru->cKeyType;
+      HB_ULONG     ulLenAll = 0, ulLenRec, ul;
+      PHB_ITEM     pKeyItem;
+      int          iKeyLen;
+
+      if( pUStru->bDeleted != ( *szData & 0x01 ) )
+      {
+         pUStru->bDeleted = ( *szData & 0x01 );
+         leto_setSetDeleted( pUStru->bDeleted );
+      }
+      szData1 = ( char * ) hb_xgrab( ( bRecNoOnly ? 5 : leto_recLen( pAStru ) ) * ulCount + 1 );
+
+      if( ! ( s_bNoSaveWA && ! pAStru->pTStru->bMemIO ) )
+         leto_SetAreaEnv( pAStru, pArea, pUStru );
+      /* see note in leto_Skip(), here the same */
+      if( bMutex )
+         HB_GC_LOCKA();
+      for( ul = 0; ul < ulCount; ul++ )
+      {
+         iKeyLen = pKey < pEnd ? ( ( ( HB_UCHAR ) *pKey++ ) & 0xFF ) : 0;
+         if( pKey + iKeyLen > pEnd ||
+             ( pKeyItem = leto_KeyToItem( pArea, pKey, iKeyLen, NULL, cKeyType ) ) == NULL )
+         {
+            pData = szErr2;
+            break;
+         }
+         pKey += iKeyLen;
+         if( SELF_SEEK( pArea, bSoftSeek, pKeyItem, bFindLast ) != HB_SUCCESS )
+         {
+            hb_itemRelease( pKeyItem );
+            pData = szErr101;
+            break;
+         }
+         hb_itemRelease( pKeyItem );
+
+         if( bRecNoOnly )
+         {
+            ptr = szData1 + 1 + ulLenAll;
+            *ptr = ( char ) ( ( pArea->fEof ? LETO_FLG_EOF : 0 ) | ( pArea->fFound ? LETO_FLG_FOUND : 0 ) );
+            HB_PUT_LE_UINT32( ptr + 1, pArea->fEof ? 0 : ( ( DBFAREAP ) pArea )->ulRecNo );
+            ulLenAll += 5;
+         }
+         else
+         {
+            ulLenRec = leto_rec( pUStru, pAStru, pArea, szData1 + 1 + ulLenAll, NULL );
+            if( ! ulLenRec )
+            {
+               pData = szErr3;
+               break;
+            }
+            ulLenAll += ulLenRec;
+         }
+      }
+      if( bMutex )
+         HB_GC_UNLOCKA();
+      if( ! ( s_bNoSaveWA && ! pAStru->pTStru->bMemIO ) )
+         leto_ClearAreaEnv( pArea, pAStru->pTagCurrent );
+
+      if( pData == NULL )  /* success */
+      {
+         ulLen = ulLenAll + 1;
+         szData1[ 0 ] = '+';
+         pData = szData1;
+      }
+   }
+
+   leto_SendAnswer( pUStru, pData, ulLen );
+   if( szData1 )
+      hb_xfree( szData1 );
+}
+
 static void leto_Scope( PUSERSTRU pUStru, char * szData )
 {
    AREAP        pArea = ( AREAP ) hb_rddGetCurrentWorkAreaPointer();
@@ -7502,6 +8300,29 @@ static void leto_Scope( PUSERSTRU pUStru, char * szData )
    leto_SendAnswer( pUStru, pData, 4 );
 }
 
+/* adaptive skip buffer size: double it for a request continuing last sent buffer in same direction,
+ * halve it for a request from elsewhere, aka random access */
+static HB_USHORT leto_SkipBufAdapt( PAREASTRU pAStru, HB_ULONG ulRecNo, HB_LONG lSkip )
+{
+   HB_ULONG  ulMax = HB_MIN( ( HB_ULONG ) pAStru->uiSkipBuf * SKIPBUF_GROW, 1000 );
+   HB_USHORT uiMin = HB_MIN( pAStru->uiSkipBuf, SKIPBUF_MIN );
+   char      cDir = lSkip > 0 ? 1 : -1;
+
+   ulMax = HB_MIN( ulMax, SKIPBUF_MAXBYTES / leto_recLen( pAStru ) );
+   if( ulMax < pAStru->uiSkipBuf )
+      ulMax = pAStru->uiSkipBuf;
+
+   if( ! pAStru->uiSkipCur )
+      pAStru->uiSkipCur = pAStru->uiSkipBuf;
+   else if( ulRecNo && ulRecNo == pAStru->ulSkipLast && cDir == pAStru->cSkipDir )
+      pAStru->uiSkipCur = ( HB_USHORT ) HB_MIN( ( HB_ULONG ) pAStru->uiSkipCur * 2, ulMax );
+   else if( pAStru->uiSkipCur > uiMin )
+      pAStru->uiSkipCur = HB_MAX( pAStru->uiSkipCur / 2, uiMin );
+   pAStru->cSkipDir = cDir;
+
+   return pAStru->uiSkipCur;
+}
+
 static void leto_Skip( PUSERSTRU pUStru, char * szData )
 {
    AREAP        pArea = ( AREAP ) hb_rddGetCurrentWorkAreaPointer();
@@ -7510,7 +8331,7 @@ static void leto_Skip( PUSERSTRU pUStru, char * szData )
    const char * pData = NULL;
    HB_ULONG     ulRecNo, ulLen = 4;
    HB_LONG      lSkip = strtol( szData, &ptr, 10 );
-   HB_BOOL      bMutex, bHotBuffer;
+   HB_BOOL      bMutex, bHotBuffer, bWindow, bBmWalk;
 
    if( *ptr != ';' )
       pData = szErr2;
@@ -7525,11 +8346,13 @@ static void leto_Skip( PUSERSTRU pUStru, char * szData )
       }
       ptr += 2;
       bHotBuffer = *ptr == 'T';
+      bWindow = bHotBuffer && ptr[ 1 ] == ';' && ptr[ 2 ] == '1';  /* client accepts records before target */
       bMutex = ( ( s_bNoSaveWA && ! pAStru->pTStru->bMemIO ) && pAStru->itmFltExpr );
 
       if( ! ( s_bNoSaveWA && ! pAStru->pTStru->bMemIO ) )
          leto_SetAreaEnv( pAStru, pArea, pUStru );
       leto_GotoIf( pArea, ulRecNo );
+      bBmWalk = leto_BmWalk( pAStru, pArea );
       if( pArea->dbfi.fFilter )  /* adjust to next valid record one down, one up if EOF */
       {
          HB_BOOL  bFlag;
@@ -7537,10 +8360,13 @@ static void leto_Skip( PUSERSTRU pUStru, char * szData )
          SELF_EOF( pArea, &bFlag );
          if( ! bFlag )
          {
-            SELF_SKIPFILTER( pArea, 1 );
+            if( ! bBmWalk )
+               SELF_SKIPFILTER( pArea, 1 );
+            else if( ! leto_BmHas( pAStru->pRBM, ( ( DBFAREAP ) pArea )->ulRecNo ) || ! leto_BmValid( pAStru, pArea ) )
+               leto_BmSkip( pAStru, pArea, 1 );
             SELF_EOF( pArea, &bFlag );
             if( bFlag )
-               SELF_SKIP( pArea, -1 );
+               leto_SkipIf( pAStru, pArea, bBmWalk, -1 );
          }
       }
 
@@ -7548,11 +8374,18 @@ static void leto_Skip( PUSERSTRU pUStru, char * szData )
        * it drastically improves performance to NOT let them do that simultanous */
       if( bMutex )
          HB_GC_LOCKA();
-      if( SELF_SKIP( pArea, lSkip ) == HB_SUCCESS )
+      if( leto_SkipIf( pAStru, pArea, bBmWalk, lSkip ) == HB_SUCCESS )
       {
-         HB_ULONG ulLenAll, ulRelPos = 0;
+         HB_ULONG  ulLenAll, ulRelPos = 0;
+         HB_USHORT uiSkipBuf = 1, uiWindow = 0;
 
-         szData1 = ( char * ) hb_xgrab( ( leto_recLen( pAStru->pTStru ) * pAStru->uiSkipBuf ) + 1 );
+         if( lSkip && bHotBuffer && pAStru->bUseSkipBuffer )
+         {
+            uiSkipBuf = leto_SkipBufAdapt( pAStru, ulRecNo, lSkip );
+            if( bWindow && ( lSkip == 1 || lSkip == -1 ) )
+               uiWindow = HB_MIN( uiSkipBuf, pAStru->uiSkipBuf ) / 2;
+         }
+         szData1 = ( char * ) hb_xgrab( ( leto_recLen( pAStru ) * ( uiSkipBuf + uiWindow ) ) + SHIFT_FOR_LEN + 1 );
          ulLenAll = leto_rec( pUStru, pAStru, pArea, szData1 + 1, &ulRelPos );
          if( ! ulLenAll )
             pData = szErr2;
@@ -7562,9 +8395,11 @@ static void leto_Skip( PUSERSTRU pUStru, char * szData )
          {
             HB_USHORT i = 1;
             HB_ULONG  ulLenRec;
+            HB_ULONG  ulTarget = ( pArea->fEof || pArea->fBof ) ? 0 : ( ( DBFAREAP ) pArea )->ulRecNo;
+            HB_ULONG  ulRelTarget = ulRelPos;
 
             ulRelPos += lSkip;
-            while( i++ < pAStru->uiSkipBuf )
+            while( i++ < uiSkipBuf )
             {
                if( lSkip > 0 )
                {
@@ -7577,7 +8412,7 @@ static void leto_Skip( PUSERSTRU pUStru, char * szData )
                      break;
                }
 
-               if( SELF_SKIP( pArea, lSkip ) == HB_SUCCESS )
+               if( leto_SkipIf( pAStru, pArea, bBmWalk, lSkip ) == HB_SUCCESS )
                {
                   if( lSkip < 0 )
                   {
@@ -7599,6 +8434,30 @@ static void leto_Skip( PUSERSTRU pUStru, char * szData )
                   break;
                }
             }
+            /* sequential continuation is detected by client asking from last record of this buffer */
+            pAStru->ulSkipLast = ( pArea->fEof || pArea->fBof ) ? 0 : ( ( DBFAREAP ) pArea )->ulRecNo;
+
+            /* window of records on other side of target, separated by an empty UINT24,
+             * so a browse changing direction finds them in client buffer */
+            if( uiWindow && ulTarget && pData == NULL && SELF_GOTO( pArea, ulTarget ) == HB_SUCCESS )
+            {
+               char * pWin = szData1 + 1 + ulLenAll;
+
+               HB_PUT_LE_UINT24( pWin, 0 );
+               ulLenAll += SHIFT_FOR_LEN;
+               ulRelPos = ulRelTarget;
+               for( i = 0; i < uiWindow; i++ )
+               {
+                  if( leto_SkipIf( pAStru, pArea, bBmWalk, -lSkip ) != HB_SUCCESS || pArea->fBof || pArea->fEof )
+                     break;
+                  if( ulRelPos )
+                     ulRelPos -= lSkip;
+                  ulLenRec = leto_rec( pUStru, pAStru, pArea, szData1 + 1 + ulLenAll, &ulRelPos );
+                  if( ! ulLenRec )
+                     break;
+                  ulLenAll += ulLenRec;
+               }
+            }
 #if 0  /* re-sync with client ? */
             if( s_bNoSaveWA )
                leto_GotoIf( pArea, ulRecNo );
@@ -9374,6 +10233,11 @@ static void leto_Dbeval( PUSERSTRU pUStru, char * szData )
       }
 
       errCode = leto_dbEval( pUStru, pArea, &pEvalInfo, bNeedLock ? pUStru->iLockTimeOut : -1, bStay );
+      if( ! pUStru->pCurAStru->pTStru->bReadonly )  /* the block may have changed any record */
+      {
+         leto_Notify( pUStru->pCurAStru, 'X', 0, 0 );
+         leto_FCacheTouch( NULL, 0, NULL );  /* .. or of other tables */
+      }
    }
 
    if( errCode == HB_SUCCESS )
@@ -10095,7 +10959,12 @@ static void leto_Goto( PUSERSTRU pUStru, char * szData )
    else
    {
       if( lRecNo > 0 )
+      {
+         /* 0x02 flag: client wants all fields, ignoring its projection */
+         if( pAStru->pFieldSel && ( ptr[ 1 ] & 0x02 ) )
+            pAStru->bFullRec = HB_TRUE;
          errCode = SELF_GOTO( pArea, ( HB_ULONG ) lRecNo );
+      }
       else if( ( lRecNo == -1 ) || ( lRecNo == -2 ) )
       {
          HB_BOOL bTop = lRecNo == -1;
@@ -10108,7 +10977,9 @@ static void leto_Goto( PUSERSTRU pUStru, char * szData )
          }
          if( ! ( s_bNoSaveWA && ! pAStru->pTStru->bMemIO ) )
             leto_SetAreaEnv( pAStru, pArea, pUStru );
-         if( bTop )
+         if( leto_BmWalk( pAStru, pArea ) )
+            errCode = leto_BmGoTop( pAStru, pArea, bTop );
+         else if( bTop )
             errCode = SELF_GOTOP( pArea );
          else
             errCode = SELF_GOBOTTOM( pArea );
@@ -10135,6 +11006,61 @@ static void leto_Goto( PUSERSTRU pUStru, char * szData )
             pData = szErr2;
          }
       }
+      pAStru->bFullRec = HB_FALSE;
+   }
+
+   leto_SendAnswer( pUStru, pData, ulLen );
+   if( szData1 )
+      hb_xfree( szData1 );
+}
+
+/* szData: "nCount;nRecNo1,nRecNo2,...;" -- answer: records one after the other as in skip buffer,
+ * RecNo beyond RecCount() are left out */
+static void leto_GotoList( PUSERSTRU pUStru, char * szData )
+{
+   AREAP        pArea = ( AREAP ) hb_rddGetCurrentWorkAreaPointer();
+   PAREASTRU    pAStru = pUStru->pCurAStru;
+   char *       szData1 = NULL, * ptr;
+   const char * pData = NULL;
+   HB_ULONG     ulLen = 4, ulCount = strtoul( szData, &ptr, 10 );
+
+   if( *ptr != ';' || ! ulCount || ulCount > LETO_GOTOLIST_MAX )
+      pData = szErr2;
+   else
+   {
+      HB_ULONG ulLenAll = 0, ulLenRec, ulRecNo, ul;
+
+      szData1 = ( char * ) hb_xgrab( ( leto_recLen( pAStru ) * ulCount ) + 1 );
+      for( ul = 0; ul < ulCount; ul++ )
+      {
+         ulRecNo = strtoul( ptr + 1, &ptr, 10 );
+         if( ! ulRecNo || ( *ptr != ',' && *ptr != ';' ) )
+         {
+            pData = szErr2;
+            break;
+         }
+         if( SELF_GOTO( pArea, ulRecNo ) != HB_SUCCESS )
+         {
+            pData = szErr101;
+            break;
+         }
+         if( pArea->fEof )
+            continue;
+         ulLenRec = leto_rec( pUStru, pAStru, pArea, szData1 + 1 + ulLenAll, NULL );
+         if( ! ulLenRec )
+         {
+            pData = szErr2;
+            break;
+         }
+         ulLenAll += ulLenRec;
+      }
+
+      if( pData == NULL )  /* success */
+      {
+         ulLen = ulLenAll + 1;
+         szData1[ 0 ] = '+';
+         pData = szData1;
+      }
    }
 
    leto_SendAnswer( pUStru, pData, ulLen );
@@ -10244,7 +11170,11 @@ static int leto_Memo( PUSERSTRU pUStru, char * szData, TRANSACTSTRU * pTA, AREAP
                   else
                   {
                      if( SELF_PUTVALUE( pArea, uiField, pMemoText ) == HB_SUCCESS )
+                     {
                         pData = szOk;
+                        leto_Notify( pAStru, 'U', ulRecNo, ulRecNo );
+                        leto_FCacheChanged( pAStru, pArea, HB_TRUE );
+                     }
                      else
                      {
                         leto_wUsLog( pUStru, -1, "ERROR leto_Memo( %s:%lu:%d ) put value failed",
@@ -10757,7 +11687,10 @@ static void leto_Ordfunc( PUSERSTRU pUStru, char * szData )
                {
                   case '1':  /* ordKeyCount */
                   {
-                     HB_ULONG ulKeyCount = leto_GetOrdInfoNL( pArea, DBOI_KEYCOUNT );
+                     HB_ULONG ulKeyCount;
+
+                     if( ! leto_BmKeyCount( pAStru, pArea, &ulKeyCount ) )
+                        ulKeyCount = leto_GetOrdInfoNL( pArea, DBOI_KEYCOUNT );
 
                      szData1[ 0 ] = '+';
                      ulLen = ultostr( ulKeyCount, szData1 + 1 ) + 1;
@@ -11048,7 +11981,12 @@ static void leto_Mgmt( PUSERSTRU pUStru, char * szData )
          case '0':   /* LETO_MGGETINFO */
          {
             char      s[ HB_PATH_MAX + HB_PATH_MAX ];
-            char      s1[ 21 ], s2[ 21 ], s3[ 21 ], s4[ 21 ];
+            char      s1[ 21 ], s2[ 21 ], s3[ 21 ], s4[ 21 ], s5[ 21 ], s6[ 21 ], s7[ 21 ], s8[ 21 ], s9[ 21 ];
+            char      s10[ 21 ], s11[ 21 ], s12[ 21 ], s13[ 21 ];
+            HB_U64    ullOps, ullSysCalls, ullZipIn, ullZipOut, ullZipPacked;
+            HB_U64    ullCacheHits, ullCacheMisses, ullCachePatched;
+            HB_SIZE   nCacheBytes;
+            HB_ULONG  ulCacheEntries;
             HB_UINT   uiTablesCurr, uiTablesMax, uiIndexCurr, uiIndexMax;
             HB_USHORT uiUsersCurr, uiUsersMax;
             HB_ULONG  ulLen;
@@ -11064,18 +12002,39 @@ static void leto_Mgmt( PUSERSTRU pUStru, char * szData )
             uiIndexCurr = s_uiIndexCurr;
             uiIndexMax = s_uiIndexMax;
             /* end of PFLL games .. */
-            ultostr( leto_Statistics( 1 ), s1 );
+            ullOps = leto_Statistics( 1 );
+            ullSysCalls = leto_Statistics( 5 );
+            ultostr( ullOps, s1 );
             ultostr( leto_Statistics( 2 ), s2 );
             ultostr( leto_Statistics( 3 ), s3 );
             ultostr( leto_Statistics( 4 ), s4 );
+            ultostr( ullSysCalls, s5 );
+            /* LZ4 compression policy, all 0 without LZ4 */
+            ullZipIn = leto_Statistics( 6 );
+            ullZipOut = leto_Statistics( 7 );
+            ullZipPacked = leto_Statistics( 8 );
+            ultostr( ullZipPacked, s6 );
+            ultostr( leto_Statistics( 9 ), s7 );
+            ultostr( leto_Statistics( 10 ), s8 );
+            ultostr( ullZipIn > ullZipOut ? ullZipIn - ullZipOut : 0, s9 );
+            /* filter result cache */
+            leto_FCacheInfo( &ulCacheEntries, &nCacheBytes, &ullCacheHits, &ullCacheMisses, &ullCachePatched );
+            ultostr( nCacheBytes, s10 );
+            ultostr( ullCacheHits, s11 );
+            ultostr( ullCacheMisses, s12 );
+            ultostr( ullCachePatched, s13 );
             /* ToDo: divide these values into high and low frequent changing */
-            ulLen = sprintf( s, "+%d;%d;%d;%d;%f;%s;%s;%s;%u;%u;%s;%s;%d;%lu;%lu;%d;%d;%d;",
+            ulLen = sprintf( s, "+%d;%d;%d;%d;%f;%s;%s;%s;%u;%u;%s;%s;%d;%lu;%lu;%d;%d;%d;%s;%.2f;%s;%s;%s;%s;%.1f;%lu;%s;%s;%s;%s;",
                              uiUsersCurr, uiUsersMax, uiTablesCurr, uiTablesMax,
                              0.0,
                              s1, s3, s2, uiIndexCurr, uiIndexMax,
                              ( s_pDataPath ? s_pDataPath : "" ), s4, leto_CPUCores(),
                              s_ulTransAll, s_ulTransOK, 0 /*ullFreeRam*/, 0 /*hb_xquery( 1002 )*/,
-                             leto_CPULoad() );
+                             leto_CPULoad(), s5,
+                             ullOps ? ( double ) ullSysCalls / ( double ) ullOps : 0.0,
+                             s6, s7, s8, s9,
+                             ullZipPacked ? ( double ) leto_Statistics( 11 ) / ( double ) ullZipPacked : 0.0,
+                             ulCacheEntries, s10, s11, s12, s13 );
             HB_GC_UNLOCKT();
             leto_SendAnswer( pUStru, s, ulLen );
             break;
@@ -12457,7 +13416,11 @@ static void leto_Pack( PUSERSTRU pUStru, char * szData )
    if( pUStru->iHbError )
       pData = szErr101;
    else
+   {
       pData = szOk;
+      leto_Notify( pUStru->pCurAStru, 'P', 0, 0 );
+      leto_FCacheChanged( pUStru->pCurAStru, pArea, HB_FALSE );
+   }
 
    leto_SendAnswer( pUStru, pData, 4 );
 }
@@ -12474,7 +13437,11 @@ static void leto_Zap( PUSERSTRU pUStru, char * szData )
    if( pUStru->iHbError )
       pData = szErr101;
    else
+   {
       pData = szOk;
+      leto_Notify( pUStru->pCurAStru, 'Z', 0, 0 );
+      leto_FCacheChanged( pUStru->pCurAStru, pArea, HB_FALSE );
+   }
 
    leto_SendAnswer( pUStru, pData, 4 );
 }
@@ -12519,7 +13486,10 @@ static void leto_Set( PUSERSTRU pUStru, char * szData )
                int       iSkipBuf = atoi( pSkipBuf );
 
                if( pAStru != NULL && iSkipBuf >= 1 )
+               {
                   pAStru->uiSkipBuf = ( HB_USHORT ) iSkipBuf;
+                  pAStru->uiSkipCur = 0;  /* restart adaption with new size */
+               }
                else
                   leto_wUsLog( pUStru, -1, "ERROR leto_Set! set SkipBuffer for area: %d to: %d failed",
                                ulAreaID, iSkipBuf );
@@ -12781,6 +13751,8 @@ static void leto_Transaction( PUSERSTRU pUStru, char * szData )
             }
             if( pTA[ i ].uiItems && pTA[ i ].pAStru->pTStru->bModStamp && ! pTA[ i ].pAStru->pTStru->bShared )
                SELF_FLUSH( pArea );
+            leto_Notify( pTA[ i ].pAStru, pTA[ i ].bAppend ? 'A' : 'U', pTA[ i ].ulRecNo, pTA[ i ].ulRecNo );
+            leto_FCacheChanged( pTA[ i ].pAStru, pArea, HB_TRUE );
          }
 
          /* unlocking all appended records, nowbody else knew about these locks */
@@ -12921,6 +13893,31 @@ static void leto_ResetFilter( PAREASTRU pAStru )
       pAStru->itmFltExpr = NULL;
       pAStru->itmFltOptimized = HB_FALSE;
    }
+   if( pAStru->itmFltNative )
+   {
+      hb_itemRelease( pAStru->itmFltNative );
+      pAStru->itmFltNative = NULL;
+   }
+   if( pAStru->pFltPrg )
+   {
+      leto_FltFree( pAStru->pFltPrg );
+      pAStru->pFltPrg = NULL;
+   }
+   if( pAStru->itmFltBM )
+   {
+      hb_itemRelease( pAStru->itmFltBM );
+      pAStru->itmFltBM = NULL;
+   }
+   if( pAStru->pRBM )
+   {
+      leto_BmFree( pAStru->pRBM );
+      pAStru->pRBM = NULL;
+   }
+   if( pAStru->pPlan )
+   {
+      leto_PlanFree( pAStru->pPlan );
+      pAStru->pPlan = NULL;
+   }
 
 #ifdef __BM
    if( pAStru->pBM )
@@ -12982,6 +13979,36 @@ static void leto_Filter( PUSERSTRU pUStru, char * szData )
       {
          pAStru->itmFltOptimized = HB_TRUE;
          pAStru->itmFltExpr = pFilterBlock;
+
+         /* evaluated direct at record buffer, if the expression is simple enough */
+         pAStru->pFltPrg = leto_FltCompile( pArea, szFilter, ulLen );
+         if( pAStru->pFltPrg )
+         {
+            char szBlock[ 32 ];
+            int  iLen = sprintf( szBlock, "LETO_FLTNATIVE(%lu)", pAStru->ulAreaID );
+
+            pAStru->itmFltNative = leto_mkCodeBlock( pUStru, szBlock, iLen, HB_FALSE );
+            if( ! pAStru->itmFltNative )
+            {
+               leto_FltFree( pAStru->pFltPrg );
+               pAStru->pFltPrg = NULL;
+            }
+         }
+
+         /* index ranges of conditions, walked at leto_SetFilter() per request */
+         if( s_bFltPlan && pAStru->pTag && ! ( s_bNoSaveWA && ! pAStru->pTStru->bMemIO ) &&
+             ( pAStru->pPlan = leto_PlanNew( pAStru->pTag, szFilter, ulLen ) ) != NULL )
+         {
+            char szBlock[ 32 ];
+            int  iLen = sprintf( szBlock, "LETO_BMFILTER(%lu)", pAStru->ulAreaID );
+
+            pAStru->itmFltBM = leto_mkCodeBlock( pUStru, szBlock, iLen, HB_FALSE );
+            if( ! pAStru->itmFltBM )
+            {
+               leto_PlanFree( pAStru->pPlan );
+               pAStru->pPlan = NULL;
+            }
+         }
       }
 
       if( ! bRes && bForce )
@@ -13003,7 +14030,8 @@ static void leto_Filter( PUSERSTRU pUStru, char * szData )
          if( pAStru->itmFltOptimized )
          {
             if( s_iDebugMode > 10 )
-               leto_wUsLog( pUStru, -1, "DEBUG leto_Filter! [ ForceOpt(%d) ] accepted: %s", bForce, szFilter);
+               leto_wUsLog( pUStru, -1, "DEBUG leto_Filter! [ ForceOpt(%d) ] accepted%s%s: %s", bForce,
+                            pAStru->pFltPrg ? " native" : "", pAStru->pPlan ? " indexed" : "", szFilter );
             leto_SendAnswer( pUStru, "++++", 4 );
             if( s_bNoSaveWA && ! pAStru->pTStru->bMemIO )
                leto_SetFilter( pAStru, pArea, pUStru );
@@ -13177,13 +14205,362 @@ HB_FUNC( LETO_BMSAVE )
 }
 #endif
 
-static void letoPutDouble( char * ptr, PHB_ITEM pItem, double dSum, HB_SHORT iDec )
+/* WA of an attached pAStru, without to select it */
+static AREAP leto_AStruArea( PAREASTRU pAStru )
 {
-   HB_SIZE nLen;
-   HB_BOOL bFreeReq;
-   char *  buffer, * bufstr;
+   AREAP pArea = NULL;
 
-   hb_itemPutNDDec( pItem, dSum, iDec );
+   if( pAStru->bNotDetached )
+   {
+      int iArea;
+
+      if( s_bNoSaveWA && ! pAStru->pTStru->bMemIO )
+         iArea = ( int ) pAStru->ulAreaID;
+      else
+      {
+         PHB_DYNS pSymAlias = hb_dynsymFind( pAStru->pTStru->szLetoAlias );
+
+         iArea = pSymAlias ? hb_dynsymAreaHandle( pSymAlias ) : 0;
+      }
+      if( iArea > 0 )
+         pArea = ( AREAP ) hb_rddGetWorkAreaPointer( iArea );
+   }
+
+   return pArea;
+}
+
+/* filter codeblock of the bitmap filter, only evaluated by RDD if not walked by leto_BmSkip(),
+ * e.g. for a child of a relation or a DbEval() with the filtered WA selected;
+ * record number is taken from the WA owning pRBM, which needs not to be the current one */
+HB_FUNC( LETO_BMFILTER )
+{
+   PUSERSTRU pUStru = letoGetUStru();
+   HB_ULONG  ulAreaID = ( HB_ULONG ) hb_parnl( 1 );
+   PAREASTRU pAStru = pUStru ? pUStru->pCurAStru : NULL;
+   AREAP     pArea;
+
+   if( pUStru && ! ( pAStru && pAStru->ulAreaID == ulAreaID ) )
+      pAStru = leto_FindArea( pUStru, ulAreaID );
+   pArea = pAStru ? leto_AStruArea( pAStru ) : NULL;
+
+   if( ! pArea || ! pAStru )  /* block outlived its area: no guess about the result */
+      hb_errRT_BASE_SubstR( EG_ARG, 3012, NULL, HB_ERR_FUNCNAME, HB_ERR_ARGS_BASEPARAMS );
+   else if( ! pAStru->pRBM )
+      hb_retl( HB_TRUE );
+   else if( ! leto_BmHas( pAStru->pRBM, ( ( DBFAREAP ) pArea )->ulRecNo ) )
+      hb_retl( HB_FALSE );
+   else
+      hb_retl( ! pAStru->itmFltExpr || leto_BmCond( pAStru, pArea ) );
+}
+
+/* the filter codeblocks of pAStru are released, so remove them from WA if active */
+static void leto_BmResetFilter( PAREASTRU pAStru, AREAP pArea )
+{
+   if( pArea->dbfi.itmCobExpr && ( pArea->dbfi.itmCobExpr == pAStru->itmFltBM ||
+       pArea->dbfi.itmCobExpr == pAStru->itmFltExpr || pArea->dbfi.itmCobExpr == pAStru->itmFltNative ) )
+      leto_ClearFilter( pArea );
+   leto_ResetFilter( pAStru );
+}
+
+/* pBitmap becomes the bitmap filter of WA, or is freed if empty */
+static HB_BOOL leto_BmSetFilter( PUSERSTRU pUStru, PAREASTRU pAStru, AREAP pArea, void * pBitmap )
+{
+   if( pBitmap != pAStru->pRBM )
+   {
+      leto_PlanDrop( pAStru );
+      if( pAStru->pRBM )
+         leto_BmFree( pAStru->pRBM );
+      pAStru->pRBM = pBitmap;
+   }
+
+   if( leto_BmCount( pBitmap ) && ! pAStru->itmFltBM )
+   {
+      char szBlock[ 32 ];
+      int  iLen = sprintf( szBlock, "LETO_BMFILTER(%lu)", pAStru->ulAreaID );
+
+      pAStru->itmFltBM = leto_mkCodeBlock( pUStru, szBlock, iLen, HB_FALSE );
+   }
+
+   if( ! leto_BmCount( pBitmap ) || ! pAStru->itmFltBM )
+   {
+      leto_BmResetFilter( pAStru, pArea );
+      return HB_FALSE;
+   }
+   leto_SetFilter( pAStru, pArea, pUStru );
+   return HB_TRUE;
+}
+
+static PAREASTRU leto_BmArea( PUSERSTRU pUStru, AREAP pArea )
+{
+   return ( pUStru && pArea ) ? pUStru->pCurAStru : NULL;
+}
+
+/* leto_udf() LBM_DbGetFilterArray() --> aFilterRec */
+HB_FUNC( LBM_DBGETFILTERARRAY )
+{
+   AREAP     pArea = ( AREAP ) hb_rddGetCurrentWorkAreaPointer();
+   PAREASTRU pAStru = leto_BmArea( letoGetUStru(), pArea );
+
+   if( pAStru && pAStru->pRBM && ! pAStru->pPlan )
+      hb_itemReturnRelease( leto_BmToArray( pAStru->pRBM ) );
+   else
+      hb_reta( 0 );
+}
+
+/* leto_udf() LBM_DbSetFilterArray( aFilterRec ) --> lFilterActive, replaces any filter */
+HB_FUNC( LBM_DBSETFILTERARRAY )
+{
+   PUSERSTRU pUStru = letoGetUStru();
+   AREAP     pArea = ( AREAP ) hb_rddGetCurrentWorkAreaPointer();
+   PAREASTRU pAStru = leto_BmArea( pUStru, pArea );
+   PHB_ITEM  pArray = hb_param( 1, HB_IT_ARRAY );
+   HB_BOOL   bRet = HB_FALSE;
+
+   if( pAStru && pArray && hb_arrayLen( pArray ) )
+   {
+      leto_BmResetFilter( pAStru, pArea );
+      bRet = leto_BmSetFilter( pUStru, pAStru, pArea, leto_BmFromArray( pArray ) );
+   }
+   hb_retl( bRet );
+}
+
+/* leto_udf() LBM_DbSetFilterArray[Add|Del|And]( aFilterRec ) --> lFilterActive
+ * set operation OR, AND NOT, AND with active bitmap filter, which is removed if result is empty */
+static void leto_BmSetOp( int iOp )
+{
+   PUSERSTRU pUStru = letoGetUStru();
+   AREAP     pArea = ( AREAP ) hb_rddGetCurrentWorkAreaPointer();
+   PAREASTRU pAStru = leto_BmArea( pUStru, pArea );
+   PHB_ITEM  pArray = hb_param( 1, HB_IT_ARRAY );
+   HB_BOOL   bRet = HB_FALSE;
+
+   if( pAStru && pArray && hb_arrayLen( pArray ) )
+   {
+      void * pOther = leto_BmFromArray( pArray );
+
+      if( ! pAStru->pRBM || pAStru->pPlan )  /* bitmap of an index plan is no LBM filter */
+      {
+         if( iOp == 0 )
+         {
+            bRet = leto_BmSetFilter( pUStru, pAStru, pArea, pOther );
+            pOther = NULL;
+         }
+      }
+      else
+      {
+         if( iOp == 0 )
+            leto_BmOr( pAStru->pRBM, pOther );
+         else if( iOp == 1 )
+            leto_BmAndNot( pAStru->pRBM, pOther );
+         else
+            leto_BmAnd( pAStru->pRBM, pOther );
+         bRet = leto_BmSetFilter( pUStru, pAStru, pArea, pAStru->pRBM );
+      }
+      if( pOther )
+         leto_BmFree( pOther );
+   }
+   else if( pAStru && pAStru->pRBM && ! pAStru->pPlan )
+      bRet = HB_TRUE;
+   hb_retl( bRet );
+}
+
+HB_FUNC( LBM_DBSETFILTERARRAYADD )
+{
+   leto_BmSetOp( 0 );
+}
+
+HB_FUNC( LBM_DBSETFILTERARRAYDEL )
+{
+   leto_BmSetOp( 1 );
+}
+
+HB_FUNC( LBM_DBSETFILTERARRAYAND )
+{
+   leto_BmSetOp( 2 );
+}
+
+/* key of the result for the filter result cache with the environment of LBM_DbSetFilter() set,
+ * NULL if not cacheable: filter of WA not set by Leto_SetEnv(), filter with UDF or variables, custom order.
+ * *ppFltPrg is a private program for patching the result, NULL for all records or if not patchable */
+static char * leto_BmCacheKey( PAREASTRU pAStru, AREAP pArea, HB_SIZE * pnLen, void ** ppFltPrg, HB_BOOL * pfPatch )
+{
+   PHB_ITEM    pKey = hb_itemArrayNew( 9 );
+   DBORDERINFO pOrderInfo;
+   void *      pFltPrg = NULL;
+   HB_BOOL     fCache = HB_TRUE, fPatch = HB_TRUE;
+   char *      szKey = NULL;
+
+   hb_arraySetL( pKey, 1, hb_setGetDeleted() );
+   hb_arraySetL( pKey, 7, hb_setGetExact() );  /* SETs used for evaluating the filter */
+   hb_arraySetC( pKey, 8, hb_setGetDateFormat() );
+   hb_arraySetNI( pKey, 9, hb_setGetEpoch() );
+   if( pArea->dbfi.fFilter && ( pArea->dbfi.itmCobExpr == pAStru->itmFltBM ||
+       pArea->dbfi.itmCobExpr == pAStru->itmFltExpr || pArea->dbfi.itmCobExpr == pAStru->itmFltNative ) )
+      fCache = HB_FALSE;  /* abFilterText is not of this */
+   else if( pArea->dbfi.fFilter )
+   {
+      HB_SIZE nLen = hb_itemGetCLen( pArea->dbfi.abFilterText );
+      void *  pPrg = nLen ? leto_FltCompile( pArea, hb_itemGetCPtr( pArea->dbfi.abFilterText ), nLen ) : NULL;
+
+      if( pPrg )
+      {
+         pFltPrg = leto_FltClone( pPrg );
+         leto_FltFree( pPrg );
+      }
+      if( pFltPrg )
+         hb_arraySet( pKey, 2, pArea->dbfi.abFilterText );
+      else
+         fCache = HB_FALSE;
+   }
+
+   memset( &pOrderInfo, 0, sizeof( DBORDERINFO ) );
+   pOrderInfo.itmResult = hb_itemNew( NULL );
+   if( fCache && SELF_ORDINFO( pArea, DBOI_NUMBER, &pOrderInfo ) == HB_SUCCESS && hb_itemGetNI( pOrderInfo.itmResult ) > 0 )
+   {
+      static const HB_USHORT s_uiInfo[] = { DBOI_CUSTOM, DBOI_ISCOND, DBOI_UNIQUE, DBOI_FULLPATH, DBOI_NAME,
+                                            DBOI_SCOPETOP, DBOI_SCOPEBOTTOM };
+      int i;
+
+      for( i = 0; i < ( int ) HB_SIZEOFARRAY( s_uiInfo ) && fCache; i++ )
+      {
+         hb_itemClear( pOrderInfo.itmResult );
+         if( SELF_ORDINFO( pArea, s_uiInfo[ i ], &pOrderInfo ) != HB_SUCCESS )
+            fCache = HB_FALSE;
+         else if( i == 0 )  /* custom keys are not derived from records */
+            fCache = ! hb_itemGetL( pOrderInfo.itmResult );
+         else if( i < 3 )
+         {
+            if( hb_itemGetL( pOrderInfo.itmResult ) )
+               fPatch = HB_FALSE;
+         }
+         else
+         {
+            if( i > 4 && ! HB_IS_NIL( pOrderInfo.itmResult ) )
+               fPatch = HB_FALSE;
+            hb_arraySet( pKey, i, pOrderInfo.itmResult );
+         }
+      }
+   }
+   hb_itemRelease( pOrderInfo.itmResult );
+
+   if( fCache )
+      szKey = hb_itemSerialize( pKey, HB_SERIALIZE_NUMSIZE, pnLen );
+   hb_itemRelease( pKey );
+
+   if( pFltPrg && ! ( szKey && fPatch ) )
+   {
+      leto_FltFree( pFltPrg );
+      pFltPrg = NULL;
+   }
+   *ppFltPrg = pFltPrg;
+   *pfPatch = fPatch;
+
+   return szKey;
+}
+
+/*
+ * LBM_DbSetFilter set bitmap filter by order <xOrder>, and for condition,
+ * defined in <xScope>, <xScopeBottom>, <cFilter>, <lDeleted> parameters
+ * Returns first filtered record
+ * Results are shared by all connections with the filter result cache, as long as the table is unchanged
+ * Function call from client:
+ *
+ *  DbGoTo( leto_Udf( 'LBM_DbSetFilter', <xScope>, <xScopeBottom>, <xOrder>, <cFilter>, <lDeleted> ) )
+ */
+HB_FUNC( LBM_DBSETFILTER )
+{
+   PUSERSTRU pUStru = letoGetUStru();
+   AREAP     pArea = ( AREAP ) hb_rddGetCurrentWorkAreaPointer();
+   PAREASTRU pAStru = leto_BmArea( pUStru, pArea );
+   PHB_DYNS  pSetEnv = hb_dynsymFindName( "LETO_SETENV" );
+   PHB_DYNS  pClearEnv = hb_dynsymFindName( "LETO_CLEARENV" );
+   HB_ULONG  ulFirst = 0;
+
+   if( pAStru && pSetEnv && pClearEnv )
+   {
+      PGLOBESTRU pGlobe = pAStru->pTStru->pGlobe;
+      void *     pBitmap = NULL;
+      PHB_ITEM   pForceOpt = hb_itemPutL( NULL, hb_setGetForceOpt() );
+      PHB_ITEM   pItem = hb_itemPutL( NULL, HB_FALSE );
+      HB_BOOL    bEof = HB_FALSE;
+      char *     szKey = NULL;
+      HB_SIZE    nKeyLen = 0;
+      void *     pFltPrg = NULL;
+      HB_BOOL    fPatch = HB_FALSE;
+      HB_ULONG   ulStamp = 0;
+      int        i;
+
+      hb_setSetItem( HB_SET_FORCEOPT, pItem );
+      if( HB_ISCHAR( 4 ) )  /* filter will be replaced, ours must not be released by RDD */
+         leto_BmResetFilter( pAStru, pArea );
+
+      hb_vmPushDynSym( pSetEnv );
+      hb_vmPushNil();
+      for( i = 1; i <= 5; i++ )
+      {
+         if( i <= hb_pcount() )
+            hb_vmPush( hb_param( i, HB_IT_ANY ) );
+         else
+            hb_vmPushNil();
+      }
+      hb_vmDo( 5 );
+
+      if( leto_FCacheActive() && ( szKey = leto_BmCacheKey( pAStru, pArea, &nKeyLen, &pFltPrg, &fPatch ) ) != NULL )
+      {
+         pBitmap = leto_FCacheGet( pGlobe, szKey, nKeyLen );
+         if( ! pBitmap )
+            ulStamp = leto_FCacheStamp( pGlobe );
+      }
+
+      if( ! pBitmap )
+      {
+         pBitmap = leto_BmNew();
+         if( SELF_GOTOP( pArea ) == HB_SUCCESS )
+         {
+            while( SELF_EOF( pArea, &bEof ) == HB_SUCCESS && ! bEof )
+            {
+               leto_BmAdd( pBitmap, ( ( DBFAREAP ) pArea )->ulRecNo );
+               if( SELF_SKIP( pArea, 1 ) != HB_SUCCESS )
+                  break;
+            }
+         }
+         if( szKey && bEof && ! pUStru->iHbError )  /* complete result */
+         {
+            leto_FCachePut( pGlobe, szKey, nKeyLen, ulStamp, pBitmap, pFltPrg, fPatch, hb_setGetDeleted(), hb_setGetExact() );
+            pFltPrg = NULL;
+         }
+      }
+      if( pFltPrg )
+         leto_FltFree( pFltPrg );
+      if( szKey )
+         hb_xfree( szKey );
+
+      hb_vmPushDynSym( pClearEnv );
+      hb_vmPushNil();
+      hb_vmDo( 0 );
+
+      /* a filter set by RDD for Leto_SetEnv() is released by RDD */
+      if( pArea->dbfi.fFilter && pArea->dbfi.itmCobExpr && pArea->dbfi.itmCobExpr != pAStru->itmFltBM &&
+          pArea->dbfi.itmCobExpr != pAStru->itmFltExpr && pArea->dbfi.itmCobExpr != pAStru->itmFltNative )
+         SELF_CLEARFILTER( pArea );
+      leto_BmResetFilter( pAStru, pArea );
+      ulFirst = leto_BmNext( pBitmap, 0 );
+      leto_BmSetFilter( pUStru, pAStru, pArea, pBitmap );
+
+      hb_setSetItem( HB_SET_FORCEOPT, pForceOpt );
+      hb_itemRelease( pForceOpt );
+      hb_itemRelease( pItem );
+   }
+   hb_retnl( ulFirst );
+}
+
+static void letoPutDouble( char * ptr, PHB_ITEM pItem, double dSum, HB_SHORT iDec )
+{
+   HB_SIZE nLen;
+   HB_BOOL bFreeReq;
+   char *  buffer, * bufstr;
+
+   hb_itemPutNDDec( pItem, dSum, iDec );
    buffer = hb_itemString( pItem, &nLen, &bFreeReq );
    bufstr = buffer;
    while( *bufstr && *bufstr == ' ' )
@@ -13194,6 +14571,57 @@ static void letoPutDouble( char * ptr, PHB_ITEM pItem, double dSum, HB_SHORT iDe
       hb_xfree( buffer );
 }
 
+/* optional thread count for a parallel scan, behind flag byte and the two length prefixed scope keys */
+static int leto_ScanThreads( PUSERSTRU pUStru, const char * pFlag )
+{
+   const char * pEnd = ( const char * ) pUStru->pBuffer + pUStru->ulDataLen;
+   const char * ptr = pFlag + 2;
+   int          i;
+
+   for( i = 0; i < 2 && ptr < pEnd; i++ )
+      ptr += ( ( HB_UCHAR ) *ptr & 0xFF ) + 1;
+
+   return ptr < pEnd ? atoi( ptr ) : 0;
+}
+
+/* parallel scan requested with iThreads, NULL for the serial scan */
+static void * leto_ScanPrepare( PUSERSTRU pUStru, AREAP pArea, const char * pFilter, char cFlag, int iThreads )
+{
+   PAREASTRU pAStru = pUStru->pCurAStru;
+   LETOTAG * pTag = pAStru->pTagCurrent;
+   void *    pFltPrg = NULL;
+   void *    pScan;
+
+   if( iThreads > s_iScanThreads )
+      iThreads = s_iScanThreads;
+   if( iThreads < 2 || pAStru->pTStru->bMemIO || ( pTag && ( pTag->pTopScope || pTag->pBottomScope ) ) )
+      return NULL;
+
+   if( *pFilter )  /* temporary filter replaces the active one */
+   {
+      pFltPrg = leto_FltCompile( pArea, pFilter, strlen( pFilter ) );
+      if( ! pFltPrg )
+         return NULL;
+   }
+   else if( pAStru->itmFltExpr && ! pAStru->pFltPrg )
+      return NULL;
+   else if( pAStru->pPlan )
+      leto_PlanFilter( pAStru, pArea );
+
+   /* the records of a bitmap filter [ LBM or index plan ] must also pass an active filter condition */
+   pScan = leto_ScanNew( pArea, iThreads, ( cFlag & 0x01 ) != 0, *pFilter ? NULL : pAStru->pRBM, pUStru->ulActTimeout );
+   if( pScan && ( pFltPrg || pAStru->itmFltExpr ) &&
+       ! leto_ScanFilter( pScan, pFltPrg ? pFltPrg : pAStru->pFltPrg ) )
+   {
+      leto_ScanFree( pScan );
+      pScan = NULL;
+   }
+   if( pFltPrg )
+      leto_FltFree( pFltPrg );
+
+   return pScan;
+}
+
 static void leto_GroupBy( PUSERSTRU pUStru, char * szData )
 {
    AREAP        pArea = ( AREAP ) hb_rddGetCurrentWorkAreaPointer();
@@ -13231,6 +14659,7 @@ static void leto_GroupBy( PUSERSTRU pUStru, char * szData )
       PHB_ITEM     pHash = hb_hashNew( NULL );
       PHB_ITEM     pDefault = hb_itemNew( NULL );
       PHB_ITEM     pSubArray;
+      void *       pScan = NULL;
 
       if( pFields - pGroup - 1 < 12 )
       {
@@ -13349,6 +14778,26 @@ static void leto_GroupBy( PUSERSTRU pUStru, char * szData )
             }
          }
 
+         if( uiGroup && ! pTopScope && ! pBottomScope )
+         {
+            pScan = leto_ScanPrepare( pUStru, pArea, pFilter, *pFlag, leto_ScanThreads( pUStru, pFlag ) );
+            for( uiIndex = 0; uiIndex < uiCount && pScan; uiIndex++ )
+            {
+               if( pSumFields[ uiIndex ].pBlock ||
+                   ! leto_ScanField( pScan, pArea, pSumFields[ uiIndex ].Pos < 0 ? 0 : ( HB_USHORT ) pSumFields[ uiIndex ].Pos,
+                                     pSumFields[ uiIndex ].uDec > 0 ) )
+               {
+                  leto_ScanFree( pScan );
+                  pScan = NULL;
+               }
+            }
+            if( pScan && ! leto_ScanGroupBy( pScan, pArea, uiGroup ) )
+            {
+               leto_ScanFree( pScan );
+               pScan = NULL;
+            }
+         }
+
          hb_xvmSeqBegin();
 
          if( *pFilter != '\0' )
@@ -13358,7 +14807,45 @@ static void leto_GroupBy( PUSERSTRU pUStru, char * szData )
 
          while( ! pUStru->iHbError )
          {
-            leto_setSetDeleted( *pFlag == 0x41 );
+            if( pScan )
+            {
+               int iScan = leto_ScanRun( pScan );
+
+               if( iScan == 0 )
+               {
+                  if( s_iDebugMode > 0 )
+                     leto_wUsLog( pUStru, -1, "DEBUG leto_GroupBy parallel scan timed out" );
+                  pUStru->iHbError = 4;
+                  break;
+               }
+               else if( iScan > 0 )
+               {
+                  HB_ULONG  ulGroup, ulGroups = leto_ScanGroups( pScan );
+                  HB_MAXINT lValue;
+
+                  for( ulGroup = 0; ulGroup < ulGroups; ulGroup++ )
+                  {
+                     leto_ScanGroupKey( pScan, ulGroup, pGroupVal );
+                     pSubArray = hb_hashGetItemPtr( pHash, pGroupVal, HB_HASH_AUTOADD_ACCESS );
+                     if( ! pSubArray )
+                        break;
+                     if( HB_IS_NIL( hb_arrayGetItemPtr( pSubArray, 1 ) ) )
+                        hb_arraySet( pSubArray, 1, pGroupVal );
+
+                     for( uiIndex = 0; uiIndex < uiCount; uiIndex++ )
+                     {
+                        leto_ScanResult( pScan, ulGroup, uiIndex, &dValue, &lValue );
+                        if( HB_IS_DOUBLE( hb_arrayGetItemPtr( pSubArray, uiIndex + 2 ) ) )
+                           hb_arraySetND( pSubArray, uiIndex + 2, hb_arrayGetND( pSubArray, uiIndex + 2 ) + dValue );
+                        else
+                           hb_arraySetNL( pSubArray, uiIndex + 2, hb_arrayGetNL( pSubArray, uiIndex + 2 ) + ( long ) lValue );
+                     }
+                  }
+                  break;
+               }
+            }
+
+            leto_setSetDeleted( ( *pFlag & 0x01 ) != 0 );
             if( pTopScope )
                leto_ScopeCommand( pArea, DBOI_SCOPETOP, pTopScope );
             if( pBottomScope )
@@ -13604,6 +15091,8 @@ static void leto_GroupBy( PUSERSTRU pUStru, char * szData )
       hb_itemRelease( pGroupVal );
       hb_itemRelease( pHash );
       hb_itemRelease( pDefault );
+      if( pScan )
+         leto_ScanFree( pScan );
    }
 }
 
@@ -13644,6 +15133,7 @@ static void leto_Sum( PUSERSTRU pUStru, char * szData )
       const char * ptr, * pNext;
       double       dValue;
       PAREASTRU    pAStru = pUStru->pCurAStru;
+      void *       pScan = NULL;
 
       pSums = ( SUMSTRU * ) hb_xgrabz( sizeof( SUMSTRU ) * uiAllocated );
       ptr = pFields;
@@ -13725,6 +15215,21 @@ static void leto_Sum( PUSERSTRU pUStru, char * szData )
          }
       }
 
+      if( ! pTopScope && ! pBottomScope )
+      {
+         pScan = leto_ScanPrepare( pUStru, pArea, pFilter, *pFlag, leto_ScanThreads( pUStru, pFlag ) );
+         for( uiIndex = 0; uiIndex < uiCount && pScan; uiIndex++ )
+         {
+            if( ! pSums[ uiIndex ].Pos || pSums[ uiIndex ].pBlock ||
+                ! leto_ScanField( pScan, pArea, pSums[ uiIndex ].Pos < 0 ? 0 : ( HB_USHORT ) pSums[ uiIndex ].Pos,
+                                  pSums[ uiIndex ].uDec > 0 ) )
+            {
+               leto_ScanFree( pScan );
+               pScan = NULL;
+            }
+         }
+      }
+
       hb_xvmSeqBegin();
 
       if( *pFilter != '\0' )
@@ -13734,6 +15239,33 @@ static void leto_Sum( PUSERSTRU pUStru, char * szData )
 
       while( ! pUStru->iHbError )
       {
+         if( pScan )
+         {
+            int iScan = leto_ScanRun( pScan );
+
+            if( iScan == 0 )
+            {
+               if( s_iDebugMode > 0 )
+                  leto_wUsLog( pUStru, -1, "DEBUG leto_Sum parallel scan timed out" );
+               pUStru->iHbError = 4;
+               break;
+            }
+            else if( iScan > 0 )
+            {
+               HB_MAXINT lValue;
+
+               for( uiIndex = 0; uiIndex < uiCount; uiIndex++ )
+               {
+                  leto_ScanResult( pScan, 0, uiIndex, &dValue, &lValue );
+                  if( pSums[ uiIndex ].uDec > 0 )
+                     pSums[ uiIndex ].value.dSum = dValue;
+                  else
+                     pSums[ uiIndex ].value.lSum = ( HB_LONG ) lValue;
+               }
+               break;
+            }
+         }
+
          if( pFilterBlock )  /* temporary filter */
          {
             pValFilter = hb_vmEvalBlock( pFilterBlock );
@@ -13746,7 +15278,7 @@ static void leto_Sum( PUSERSTRU pUStru, char * szData )
             pArea->dbfi.fOptimized = HB_FALSE;
             pArea->dbfi.fFilter = HB_TRUE;
          }
-         leto_setSetDeleted( *pFlag == 0x41 );
+         leto_setSetDeleted( ( *pFlag & 0x01 ) != 0 );
          if( pTopScope )
             leto_ScopeCommand( pArea, DBOI_SCOPETOP, pTopScope );
          if( pBottomScope )
@@ -13886,6 +15418,8 @@ static void leto_Sum( PUSERSTRU pUStru, char * szData )
       }
       hb_xfree( pSums );
       hb_itemRelease( pItem );
+      if( pScan )
+         leto_ScanFree( pScan );
    }
 }
 
@@ -14258,7 +15792,7 @@ static void leto_Trans( PUSERSTRU pUStru, char * szData, HB_BOOL bSort )
                HB_ULONG  ulLen;
                char *    szData1;
 
-               ulLen = leto_recLen( pAStruDst->pTStru );
+               ulLen = leto_recLen( pAStruDst );
                szData1 = ( char * ) hb_xgrab( ulLen + 6 );
                memcpy( szData1, szOk, 4 );
                szData1[ 4 ] = ';';
@@ -14358,6 +15892,7 @@ static HB_THREAD_STARTFUNC( threadX )
          leto_writelog( NULL, -1, "ERROR task %s() ended with ERROR: ", ( const char * ) pUStru->szLastRequest,
                         pUStru->szHbError ? pUStru->szHbError : "??" );
       pUStru->bBeQuiet = HB_FALSE;
+      leto_FCacheTouch( NULL, 0, NULL );  /* unknown changes of the task */
       break;
    }
 
@@ -14568,6 +16103,10 @@ static void leto_Udf( PUSERSTRU pUStru, char * szData, HB_ULONG ulAreaID )
                   leto_SendError( pUStru, szErr4, 4 );
                hb_vmRequestRestore();
 
+               /* unknown changes of the UDF, LBM_*() functions only read */
+               if( ! pSym || hb_strnicmp( pp4, "LBM_", 4 ) )
+                  leto_FCacheTouch( NULL, 0, NULL );
+
                /* detach all areas new requested by LETO_ALIAS() */
                if( ulAreaID )
                   leto_FreeArea( pUStru, ulAreaID, HB_TRUE );
@@ -14621,6 +16160,56 @@ static void leto_UdfDbf( PUSERSTRU pUStru, char * szData )
    leto_Udf( pUStru, szData, pUStru->ulCurAreaID );
 }
 
+#ifdef USE_LZ4
+/* LZ4 dictionary from records spread over the table, sampled in the leto_rec() format as send with
+ * active compression, re-sampled after the table has grown by factor LETO_LZ4DICT_GROWTH */
+static void leto_LZ4DictBuild( PUSERSTRU pUStru, PAREASTRU pAStru, AREAP pArea )
+{
+   PTABLESTRU pTStru = pAStru->pTStru;
+   HB_ULONG   ulRecCount = 0, ulRecNo = 0, ulStep, ulLen = 0, ulRecLen, ul;
+   HB_BYTE *  pDict;
+   char *     szRec;
+
+   if( SELF_RECCOUNT( pArea, &ulRecCount ) != HB_SUCCESS || ! ulRecCount )
+      return;
+   if( pTStru->pLZ4Dict && ulRecCount < pTStru->ulLZ4DictRecs * LETO_LZ4DICT_GROWTH )
+      return;
+   if( ( ulRecLen = leto_recLen( pAStru ) ) == 0 )
+      return;
+
+   pDict = ( HB_BYTE * ) hb_xgrab( LETO_LZ4DICT_SIZE );
+   szRec = ( char * ) hb_xgrab( ulRecLen + 1 );
+   SELF_RECNO( pArea, &ulRecNo );
+   ulStep = HB_MAX( ulRecCount / ( LETO_LZ4DICT_SIZE / ulRecLen + 1 ), 1 );
+   for( ul = 1; ul <= ulRecCount && ulLen < LETO_LZ4DICT_SIZE; ul += ulStep )
+   {
+      HB_ULONG ulRec;
+
+      if( SELF_GOTO( pArea, ul ) != HB_SUCCESS || ( ulRec = leto_rec( pUStru, pAStru, pArea, szRec, NULL ) ) == 0 )
+         break;
+      ulRec = HB_MIN( ulRec, LETO_LZ4DICT_SIZE - ulLen );
+      memcpy( pDict + ulLen, szRec, ulRec );
+      ulLen += ulRec;
+   }
+   SELF_GOTO( pArea, ulRecNo );
+   hb_xfree( szRec );
+
+   HB_GC_LOCKT();
+   if( ulLen && ( ! pTStru->pLZ4Dict || ulRecCount >= pTStru->ulLZ4DictRecs * LETO_LZ4DICT_GROWTH ) )
+   {
+      HB_BYTE * pOld = pTStru->pLZ4Dict;
+
+      pTStru->pLZ4Dict = pDict;
+      pTStru->ulLZ4Dict = ulLen;
+      pTStru->ulLZ4DictRecs = ulRecCount;
+      pDict = pOld;
+   }
+   HB_GC_UNLOCKT();
+   if( pDict )
+      hb_xfree( pDict );
+}
+#endif
+
 static void leto_Info( PUSERSTRU pUStru, char * szData )
 {
    char * pp1 = NULL;
@@ -14876,6 +16465,182 @@ static void leto_Info( PUSERSTRU pUStru, char * szData )
          }
 #endif
 
+         case DBI_LETOFIELDS:  /* comma separated field numbers, empty = all fields */
+         {
+            PAREASTRU pAStru = pUStru->pCurAStru;
+            HB_USHORT uiCount = 0;
+            char      szData1[ 16 ];
+
+            if( pAStru )
+            {
+               if( pAStru->pFieldSel )
+               {
+                  hb_xfree( pAStru->pFieldSel );
+                  pAStru->pFieldSel = NULL;
+               }
+               if( pp1 && *pp1 )
+               {
+                  HB_BYTE * pSel = ( HB_BYTE * ) hb_xgrabz( pArea->uiFieldCount );
+                  char *    ptr = pp1;
+                  HB_USHORT uiField;
+
+                  while( *ptr )
+                  {
+                     uiField = ( HB_USHORT ) strtoul( ptr, &ptr, 10 );
+                     if( uiField && uiField <= pArea->uiFieldCount && ! pSel[ uiField - 1 ] )
+                     {
+                        pSel[ uiField - 1 ] = 1;
+                        uiCount++;
+                     }
+                     if( *ptr == ',' )
+                        ptr++;
+                     else
+                        break;
+                  }
+                  if( uiCount && uiCount < pArea->uiFieldCount )
+                     pAStru->pFieldSel = pSel;
+                  else  /* none or all fields */
+                  {
+                     hb_xfree( pSel );
+                     uiCount = 0;
+                  }
+               }
+            }
+            leto_SendAnswer( pUStru, szData1, eprintf( szData1, "+%u;", uiCount ) );
+            break;
+         }
+
+         case DBI_MEMOINLINE:  /* max. length of memo content send inline with record, 0 = off */
+         {
+            PAREASTRU pAStru = pUStru->pCurAStru;
+            HB_ULONG  ulMemoInline = 0;
+            char      szData1[ 24 ];
+
+            if( pAStru && pp1 && *pp1 )
+            {
+               HB_USHORT ui;
+
+               ulMemoInline = HB_MIN( strtoul( pp1, NULL, 10 ), MEMOINLINE_MAX );
+               pAStru->uiMemoFields = 0;
+               for( ui = 0; ui < pArea->uiFieldCount; ui++ )
+               {
+                  switch( pArea->lpFields[ ui ].uiType )
+                  {
+                     case HB_FT_MEMO:
+                     case HB_FT_BLOB:
+                     case HB_FT_PICTURE:
+                     case HB_FT_OLE:
+                        pAStru->uiMemoFields++;
+                        break;
+                  }
+               }
+               if( ! pAStru->uiMemoFields )
+                  ulMemoInline = 0;
+               pAStru->ulMemoInline = ulMemoInline;
+               pAStru->uiSkipCur = 0;  /* record length changed */
+            }
+            leto_SendAnswer( pUStru, szData1, eprintf( szData1, "+%lu;", ulMemoInline ) );
+            break;
+         }
+
+         case DBI_NOTIFY:  /* "1" subscribe, "0" unsubscribe change notes, answer if possible */
+         {
+            PAREASTRU pAStru = pUStru->pCurAStru;
+            HB_BOOL   bNotify = HB_FALSE;
+
+            if( pAStru && pp1 && *pp1 )
+            {
+               bNotify = ( *pp1 == '1' && pUStru->hSocketErr != HB_NO_SOCKET && ! pUStru->bErrSockDrop );
+               if( bNotify && ! pAStru->bNotify )
+                  leto_NotifyAdd( pUStru, pAStru );
+               else if( ! bNotify && pAStru->bNotify )
+                  leto_NotifyDel( pUStru, pAStru );
+            }
+            leto_SendAnswer( pUStru, bNotify ? "+1;" : "+0;", 3 );
+            break;
+         }
+
+         case DBI_FILTEREXPLAIN:  /* how the server filter of WA is evaluated */
+         {
+            PAREASTRU pAStru = pUStru->pCurAStru;
+            char *    szExplain = NULL;
+            HB_SIZE   nLen = 0;
+
+            if( pAStru && pAStru->pPlan )
+               leto_PlanFilter( pAStru, pArea );  /* actual candidates */
+            if( pAStru && pAStru->pPlan )
+               szExplain = leto_PlanExplain( pAStru->pPlan, pArea, pAStru->pRBM, &nLen );
+            else
+            {
+               szExplain = ( char * ) hb_xgrab( 80 );
+               if( pAStru && pAStru->pRBM )
+                  nLen = sprintf( szExplain, "BITMAP FILTER %lu RECORDS%s", leto_BmCount( pAStru->pRBM ),
+                                  pAStru->itmFltExpr ? "; RESIDUAL FILTER" : "" );
+               else if( pAStru && pAStru->itmFltExpr )
+                  nLen = sprintf( szExplain, "FULL SCAN; %s FILTER", pAStru->pFltPrg ? "NATIVE" : "CODEBLOCK" );
+            }
+
+            szExplain = ( char * ) hb_xrealloc( szExplain, nLen + 2 );
+            memmove( szExplain + 1, szExplain, nLen );
+            szExplain[ 0 ] = '+';
+            szExplain[ nLen + 1 ] = '\0';
+            leto_SendAnswer( pUStru, szExplain, nLen + 1 );
+            hb_xfree( szExplain );
+            break;
+         }
+
+#ifdef USE_LZ4
+         case DBI_LZ4DICT:
+         {
+            PAREASTRU  pAStru = pUStru->pCurAStru;
+            PTABLESTRU pTStru = pAStru ? pAStru->pTStru : NULL;
+            PHB_LZ4NET pStream = ( PHB_LZ4NET ) pUStru->zstream;
+            char *     szData1 = NULL;
+            HB_ULONG   ulLen = 0;
+            int        iID = 0;
+
+            /* only with negotiated LZ4 compression, else the dictionary would be useless ballast */
+            if( pTStru && pStream && pUStru->iZipRecord > 0 )
+            {
+               leto_LZ4DictBuild( pUStru, pAStru, pArea );
+               HB_GC_LOCKT();
+               if( pTStru->pLZ4Dict )
+               {
+                  /* the client already knows an equal one registered for another area */
+                  iID = hb_lz4netDictFind( pStream, ( const char * ) pTStru->pLZ4Dict, pTStru->ulLZ4Dict );
+                  if( ! iID && ( iID = hb_lz4netDictAdd( pStream, 0, ( const char * ) pTStru->pLZ4Dict, pTStru->ulLZ4Dict ) ) != 0 )
+                  {
+                     szData1 = ( char * ) hb_xgrab( pTStru->ulLZ4Dict + 32 );
+                     ulLen = sprintf( szData1, "+%d;%lu;", iID, pTStru->ulLZ4Dict );
+                     memcpy( szData1 + ulLen, pTStru->pLZ4Dict, pTStru->ulLZ4Dict );
+                     ulLen += pTStru->ulLZ4Dict;
+                  }
+               }
+               HB_GC_UNLOCKT();
+            }
+
+            if( szData1 )
+            {
+               /* client can't know the dictionary before this answer */
+               pAStru->iLZ4Dict = 0;
+               leto_SendAnswer( pUStru, szData1, ulLen );
+               pAStru->iLZ4Dict = iID;
+               hb_xfree( szData1 );
+            }
+            else if( iID )
+            {
+               char szAnswer[ 16 ];
+
+               ulLen = sprintf( szAnswer, "+%d;0;", iID );
+               leto_SendAnswer( pUStru, szAnswer, ulLen );
+               pAStru->iLZ4Dict = iID;
+            }
+            else
+               leto_SendAnswer( pUStru, "+0;", 3 );
+            break;
+         }
+#endif
+
          default:
             leto_SendAnswer( pUStru, szErr4, 4 );
       }
@@ -15706,7 +17471,7 @@ static void leto_OpenTable( PUSERSTRU pUStru, char * szRawData )
 
          /* add record data */
          ulLenLen = ptr - szReply;
-         ulRecLen = leto_recLen( pUStru->pCurAStru->pTStru );
+         ulRecLen = leto_recLen( pUStru->pCurAStru );
          if( ulRecLen > 0 )
          {
             HB_ULONG ulRealLen;
@@ -16309,7 +18074,7 @@ static void leto_CreateTable( PUSERSTRU pUStru, char * szRawData )
          *ptr++ = ';';
 
          ulLenLen = ptr - szReply;
-         ulRecLen = leto_recLen( pUStru->pCurAStru->pTStru );
+         ulRecLen = leto_recLen( pUStru->pCurAStru );
          if( ulRecLen > 0 )
          {
             char *   szTmp = ( char * ) hb_xgrab( ulRecLen );
@@ -16715,7 +18480,7 @@ static void leto_OpenIndex( PUSERSTRU pUStru, char * szRawData )
 
          szTmp = leto_IndexesInfo( pUStru, szFile, pArea );
          ulLen = strlen( szTmp );
-         ulRecLen = leto_recLen( pUStru->pCurAStru->pTStru );
+         ulRecLen = leto_recLen( pUStru->pCurAStru );
 
          if( ulRecLen + ulLen > uiReplyBufLen )
          {
@@ -17350,7 +19115,7 @@ static void leto_CreateIndex( PUSERSTRU pUStru, char * szRawData )
       }
       else
       {
-         HB_ULONG ulRecLen = leto_recLen( pUStru->pCurAStru->pTStru );
+         HB_ULONG ulRecLen = leto_recLen( pUStru->pCurAStru );
          char *   szTmp = leto_IndexesInfo( pUStru, "*", pArea );
          HB_ULONG ulLen = strlen( szTmp );
 
@@ -18221,6 +19986,7 @@ void leto_ActionReplay( PUSERSTRU pUStru, const char * szFile,
       hb_itemRelease( pAutOpen );
    }
    s_bProtocol = bProtocol;
+   leto_FCacheTouch( NULL, 0, NULL );
 
    HB_GC_UNLOCKG();
 
@@ -18516,6 +20282,7 @@ void leto_CommandSetInit()
    s_cmdSet[ LETOCMD_dbeval  - LETOCMD_OFFSET ] = leto_Dbeval;
    s_cmdSet[ LETOCMD_flush   - LETOCMD_OFFSET ] = leto_Flush;
    s_cmdSet[ LETOCMD_goto    - LETOCMD_OFFSET ] = leto_Goto;
+   s_cmdSet[ LETOCMD_golist  - LETOCMD_OFFSET ] = leto_GotoList;
    s_cmdSet[ LETOCMD_group   - LETOCMD_OFFSET ] = leto_GroupBy;
    s_cmdSet[ LETOCMD_islock  - LETOCMD_OFFSET ] = leto_IsRecLockedUS;
    s_cmdSet[ LETOCMD_lock    - LETOCMD_OFFSET ] = leto_Lock;
@@ -18529,6 +20296,7 @@ void leto_CommandSetInit()
    s_cmdSet[ LETOCMD_skip    - LETOCMD_OFFSET ] = leto_Skip;
    s_cmdSet[ LETOCMD_sort    - LETOCMD_OFFSET ] = leto_TransSort;
    s_cmdSet[ LETOCMD_seek    - LETOCMD_OFFSET ] = leto_Seek;
+   s_cmdSet[ LETOCMD_seeklist - LETOCMD_OFFSET ] = leto_SeekList;
    s_cmdSet[ LETOCMD_sum     - LETOCMD_OFFSET ] = leto_Sum;
    s_cmdSet[ LETOCMD_trans   - LETOCMD_OFFSET ] = leto_TransNoSort;
    s_cmdSet[ LETOCMD_unlock  - LETOCMD_OFFSET ] = leto_Unlock;
@@ -0,0 +1,727 @@
+/*
+ * Leto db server index aware filter planner
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307 USA (or visit the web site http://www.gnu.org/).
+ *
+ * As a special exception, the Harbour Project gives permission for
+ * additional uses of the text contained in its release of Harbour.
+ *
+ * The exception is that, if you link the Harbour libraries with other
+ * files to produce an executable, this does not by itself cause the
+ * resulting executable to be covered by the GNU General Public License.
+ * Your use of that executable is in no way restricted on account of
+ * linking the Harbour library code into it.
+ *
+ * This exception does not however invalidate any other reasons why
+ * the executable file might be covered by the GNU General Public License.
+ *
+ * This exception applies only to the code released by the Harbour
+ * Project under the name Harbour.  If you copy code from other
+ * Harbour Project or Free Software Foundation releases into a copy of
+ * Harbour, as the General Public License permits, the exception does
+ * not apply to the code that you add in this way.  To avoid misleading
+ * anyone as to the status of such modified files, you must delete
+ * this exception notice from them.
+ *
+ * If you write modifications of your own for Harbour, it is your choice
+ * whether to permit this exception to apply to your modifications.
+ * If you do not wish that, delete this exception notice.
+ *
+ */
+
+/*
+ * Filters accepted by leto_Filter() are split into their top level .AND. conditions. A condition
+ * comparing an index key expression with a constant ( = == < <= > >= ) gives a key range of that
+ * order, several conditions on the same order are merged into one range. The record numbers of
+ * each range are collected by walking the order with scopes set, ranges of different orders are
+ * intersected as bitmaps. The result is a superset of the filtered records: the area walks only
+ * these candidates and still evaluates the complete filter for them ( residual filter ).
+ * A range with more keys than 1 / LETOPLAN_MAXPART of the records is not walked to its end and not used,
+ * if no range is selective enough, the plain filter is used.
+ * Orders with FOR condition, UNIQUE, custom or descending keys are not used.
+ */
+
+#include "srvleto.h"
+
+#define LETOPLAN_ENOUGH       64         /* candidates left, further ranges are not scanned */
+#define LETOPLAN_MAXPART      4          /* max. part of records in a used range */
+
+#define LETOPLAN_EQ           1
+#define LETOPLAN_LT           2
+#define LETOPLAN_LE           3
+#define LETOPLAN_GT           4
+#define LETOPLAN_GE           5
+
+typedef struct
+{
+   char *      szTag;                    /* name of order */
+   char *      szKey;                    /* normalized key expression */
+   char        cKeyType;
+   PHB_ITEM    pTop;                     /* lower bound, NULL = none */
+   PHB_ITEM    pBottom;                  /* upper bound, NULL = none */
+   HB_BOOL     fEqual;                   /* range from = or == */
+   char *      szCond;                   /* conditions of the range, for leto_PlanExplain() */
+   HB_ULONG    ulKeys;                   /* keys in range at last run */
+   HB_BOOL     fScanned;                 /* else skipped at last run */
+   HB_BOOL     fWide;                    /* not used at last run, more than ulMaxKeys */
+} LETOPLANTAG;
+
+typedef struct
+{
+   LETOPLANTAG * pTags;
+   int           iTags;
+   int           iConds;                 /* top level conditions of filter */
+   int           iUsed;                  /* of them with an index range */
+   HB_ULONG      ulRecords;              /* candidates at last run */
+   HB_ULONG      ulRecCount;
+   HB_ULONG      ulRuns;
+} LETOPLAN;
+
+extern void * leto_BmNew( void );
+extern void leto_BmFree( void * pBitmap );
+extern HB_ULONG leto_BmCount( void * pBitmap );
+extern void leto_BmAdd( void * pBitmap, HB_ULONG ulRecNo );
+extern void leto_BmAnd( void * pBitmap, void * pOther );
+
+static HB_BOOL leto_planIdent( char c )
+{
+   return HB_ISALNUM( c ) || c == '_';
+}
+
+/* closing quote of a string starting at szExpr[ n ], or nLen if not terminated */
+static HB_SIZE leto_planQuote( const char * szExpr, HB_SIZE nLen, HB_SIZE n )
+{
+   char cQuo = szExpr[ n ] == '[' ? ']' : szExpr[ n ];
+
+   while( ++n < nLen && szExpr[ n ] != cQuo )
+      ;
+   return n;
+}
+
+/* expression in upper case without spaces and FIELD-> outside of strings, for comparing with key expressions */
+static char * leto_planNormalize( const char * szExpr, HB_SIZE nLen, HB_SIZE * pnLen )
+{
+   char *  szNorm = ( char * ) hb_xgrab( nLen + 1 );
+   HB_SIZE n, nEnd, nNorm = 0;
+
+   for( n = 0; n < nLen; n++ )
+   {
+      char c = szExpr[ n ];
+
+      if( c == '"' || c == '\'' || c == '[' )
+      {
+         nEnd = leto_planQuote( szExpr, nLen, n );
+         if( nEnd >= nLen )
+         {
+            hb_xfree( szNorm );
+            return NULL;
+         }
+         memcpy( szNorm + nNorm, szExpr + n, nEnd - n + 1 );
+         nNorm += nEnd - n + 1;
+         n = nEnd;
+      }
+      else if( ! HB_ISSPACE( c ) )
+      {
+         szNorm[ nNorm++ ] = HB_TOUPPER( c );
+         if( c == '>' && nNorm >= 7 && ! memcmp( szNorm + nNorm - 7, "FIELD->", 7 ) )
+         {
+            HB_SIZE nStart = nNorm - 7;
+
+            if( nStart && szNorm[ nStart - 1 ] == '_' )
+               nStart--;
+            if( ! nStart || ! leto_planIdent( szNorm[ nStart - 1 ] ) )
+               nNorm = nStart;
+         }
+      }
+   }
+   szNorm[ nNorm ] = '\0';
+   *pnLen = nNorm;
+
+   return szNorm;
+}
+
+/* position of matching ')' for '(' at szExpr[ n ], or nLen */
+static HB_SIZE leto_planParen( const char * szExpr, HB_SIZE nLen, HB_SIZE n )
+{
+   int iDepth = 0;
+
+   for( ; n < nLen; n++ )
+   {
+      char c = szExpr[ n ];
+
+      if( c == '"' || c == '\'' || c == '[' )
+         n = leto_planQuote( szExpr, nLen, n );
+      else if( c == '(' || c == '{' )
+         iDepth++;
+      else if( ( c == ')' || c == '}' ) && --iDepth == 0 )
+         break;
+   }
+   return n;
+}
+
+/* constant of normalized operand, NULL if it is none */
+static PHB_ITEM leto_planConst( const char * szVal, HB_SIZE nLen )
+{
+   if( nLen >= 2 && ( *szVal == '"' || *szVal == '\'' || *szVal == '[' ) )
+   {
+      if( leto_planQuote( szVal, nLen, 0 ) == nLen - 1 )
+         return hb_itemPutCL( NULL, szVal + 1, nLen - 2 );
+   }
+   else if( nLen == 3 && szVal[ 0 ] == '.' && szVal[ 2 ] == '.' && strchr( "TFYN", szVal[ 1 ] ) )
+      return hb_itemPutL( NULL, szVal[ 1 ] == 'T' || szVal[ 1 ] == 'Y' );
+   else if( ( nLen == 10 && ! memcmp( szVal, "0D", 2 ) ) ||
+            ( nLen >= 8 && nLen <= 16 && ! memcmp( szVal, "STOD(", 5 ) && szVal[ nLen - 1 ] == ')' ) )
+   {
+      const char * szDate = szVal + 2;
+      HB_SIZE      nDate = 8, n;
+      char         szBuf[ 9 ];
+
+      if( *szVal == 'S' )
+      {
+         if( leto_planQuote( szVal, nLen, 5 ) != nLen - 2 )
+            return NULL;
+         szDate = szVal + 6;
+         nDate = nLen - 8;
+      }
+      for( n = 0; n < nDate; n++ )
+      {
+         if( ! HB_ISDIGIT( szDate[ n ] ) )
+            return NULL;
+      }
+      memset( szBuf, ' ', 8 );
+      memcpy( szBuf, szDate, nDate );
+      szBuf[ 8 ] = '\0';
+      return hb_itemPutDL( NULL, hb_dateEncStr( szBuf ) );
+   }
+   else if( nLen )
+   {
+      HB_SIZE n = ( *szVal == '-' || *szVal == '+' ) ? 1 : 0;
+      HB_BOOL fDigit = HB_FALSE;
+      HB_MAXINT lVal;
+      double  dVal;
+
+      for( ; n < nLen; n++ )
+      {
+         if( HB_ISDIGIT( szVal[ n ] ) )
+            fDigit = HB_TRUE;
+         else if( szVal[ n ] != '.' )
+            return NULL;
+      }
+      if( ! fDigit )
+         return NULL;
+      if( hb_strnToNum( szVal, nLen, &lVal, &dVal ) )
+         return hb_itemPutND( NULL, dVal );
+      return hb_itemPutNInt( NULL, lVal );
+   }
+   return NULL;
+}
+
+static HB_BOOL leto_planType( PHB_ITEM pItem, char cKeyType )
+{
+   switch( cKeyType )
+   {
+      case 'C':
+         return HB_IS_STRING( pItem );
+      case 'N':
+         return HB_IS_NUMERIC( pItem );
+      case 'D':
+         return HB_IS_DATE( pItem );
+      case 'L':
+         return HB_IS_LOGICAL( pItem );
+   }
+   return HB_FALSE;
+}
+
+static void leto_planAddCond( LETOPLANTAG * pPlanTag, const char * szCond, HB_SIZE nLen )
+{
+   HB_SIZE nOld = pPlanTag->szCond ? strlen( pPlanTag->szCond ) : 0;
+
+   pPlanTag->szCond = ( char * ) hb_xrealloc( pPlanTag->szCond, nOld + nLen + 7 + 1 );
+   if( nOld )
+   {
+      memcpy( pPlanTag->szCond + nOld, " .AND. ", 7 );
+      nOld += 7;
+   }
+   memcpy( pPlanTag->szCond + nOld, szCond, nLen );
+   pPlanTag->szCond[ nOld + nLen ] = '\0';
+}
+
+/* one normalized top level condition, merged into the range of an order with this key expression */
+static void leto_planCond( LETOPLAN * pPlan, const char * szCond, HB_SIZE nLen )
+{
+   HB_SIZE  n, nOp = 0, nOpLen = 0;
+   int      iOp = 0, iOps = 0, iDepth = 0, i;
+   PHB_ITEM pConst;
+   const char * szKey;
+   HB_SIZE  nKeyLen;
+
+   pPlan->iConds++;
+   for( n = 0; n < nLen; n++ )
+   {
+      char c = szCond[ n ];
+      int  iThis = 0, iLen = 1;
+
+      if( c == '"' || c == '\'' || c == '[' )
+         n = leto_planQuote( szCond, nLen, n );
+      else if( c == '(' || c == '{' )
+         iDepth++;
+      else if( c == ')' || c == '}' )
+         iDepth--;
+      else if( iDepth )
+         continue;
+      else if( c == '-' && n + 1 < nLen && szCond[ n + 1 ] == '>' )  /* alias */
+         n++;
+      else if( c == '=' )
+      {
+         iThis = LETOPLAN_EQ;
+         if( n + 1 < nLen && szCond[ n + 1 ] == '=' )
+            iLen = 2;
+      }
+      else if( c == '<' || c == '>' )
+      {
+         iThis = c == '<' ? LETOPLAN_LT : LETOPLAN_GT;
+         if( n + 1 < nLen && szCond[ n + 1 ] == '=' )
+         {
+            iThis++;
+            iLen = 2;
+         }
+         else if( c == '<' && n + 1 < nLen && szCond[ n + 1 ] == '>' )
+         {
+            iThis = -1;
+            iLen = 2;
+         }
+      }
+      else if( c == '#' || c == '$' )
+         iThis = -1;
+      else if( ( c == '!' || c == ':' ) && n + 1 < nLen && szCond[ n + 1 ] == '=' )
+      {
+         iThis = -1;
+         iLen = 2;
+      }
+
+      if( iThis )
+      {
+         iOp = iThis;
+         iOps++;
+         nOp = n;
+         nOpLen = iLen;
+         n += iLen - 1;
+      }
+   }
+   if( iOps != 1 || iOp < 0 || ! nOp || nOp + nOpLen >= nLen )
+      return;
+
+   /* constant at right or left side */
+   szKey = szCond;
+   nKeyLen = nOp;
+   pConst = leto_planConst( szCond + nOp + nOpLen, nLen - nOp - nOpLen );
+   if( ! pConst )
+   {
+      pConst = leto_planConst( szCond, nOp );
+      if( ! pConst )
+         return;
+      szKey = szCond + nOp + nOpLen;
+      nKeyLen = nLen - nOp - nOpLen;
+      if( iOp != LETOPLAN_EQ )  /* mirror: 5 < X is X > 5 */
+         iOp = iOp <= LETOPLAN_LE ? iOp + 2 : iOp - 2;
+   }
+
+   for( i = 0; i < pPlan->iTags; i++ )
+   {
+      LETOPLANTAG * pPlanTag = pPlan->pTags + i;
+
+      if( strlen( pPlanTag->szKey ) == nKeyLen && ! memcmp( pPlanTag->szKey, szKey, nKeyLen ) )
+      {
+         if( ! leto_planType( pConst, pPlanTag->cKeyType ) )
+            break;
+
+         /* string compare with SET EXACT OFF, and scopes of character keys are prefixes */
+         if( iOp == LETOPLAN_EQ && ! pPlanTag->fEqual )
+         {
+            if( pPlanTag->pTop )
+               hb_itemRelease( pPlanTag->pTop );
+            if( pPlanTag->pBottom )
+               hb_itemRelease( pPlanTag->pBottom );
+            pPlanTag->pTop = hb_itemNew( pConst );
+            pPlanTag->pBottom = hb_itemNew( pConst );
+            pPlanTag->fEqual = HB_TRUE;
+         }
+         else if( pPlanTag->fEqual )
+            ;
+         else if( ( iOp == LETOPLAN_GT || iOp == LETOPLAN_GE ) && ! pPlanTag->pTop )
+            pPlanTag->pTop = hb_itemNew( pConst );
+         else if( ( iOp == LETOPLAN_LT || iOp == LETOPLAN_LE ) && ! pPlanTag->pBottom )
+            pPlanTag->pBottom = hb_itemNew( pConst );
+         leto_planAddCond( pPlanTag, szCond, nLen );
+         pPlan->iUsed++;
+         break;
+      }
+   }
+   hb_itemRelease( pConst );
+}
+
+/* position of szOper outside of parentheses and strings, from nStart on, or nLen */
+static HB_SIZE leto_planFind( const char * szExpr, HB_SIZE nLen, const char * szOper, HB_SIZE nStart )
+{
+   HB_SIZE n, nOper = strlen( szOper );
+   int     iDepth = 0;
+
+   for( n = nStart; n < nLen; n++ )
+   {
+      char c = szExpr[ n ];
+
+      if( c == '"' || c == '\'' || c == '[' )
+         n = leto_planQuote( szExpr, nLen, n );
+      else if( c == '(' || c == '{' )
+         iDepth++;
+      else if( c == ')' || c == '}' )
+         iDepth--;
+      else if( ! iDepth && nLen - n > nOper && ! memcmp( szExpr + n, szOper, nOper ) )
+         break;
+   }
+   return HB_MIN( n, nLen );
+}
+
+/* top level .AND. conditions of normalized expression, a condition with .OR. is not used */
+static void leto_planSplit( LETOPLAN * pPlan, const char * szExpr, HB_SIZE nLen )
+{
+   HB_SIZE n, nStart = 0;
+
+   while( nLen > 2 && *szExpr == '(' && leto_planParen( szExpr, nLen, 0 ) == nLen - 1 )
+   {
+      szExpr++;
+      nLen -= 2;
+   }
+
+   /* .OR. binds weaker than .AND., then the whole expression is an alternative */
+   if( leto_planFind( szExpr, nLen, ".OR.", 0 ) < nLen )
+   {
+      pPlan->iConds++;
+      return;
+   }
+   while( ( n = leto_planFind( szExpr, nLen, ".AND.", nStart ) ) < nLen )
+   {
+      leto_planSplit( pPlan, szExpr + nStart, n - nStart );
+      nStart = n + 5;
+   }
+   if( nStart )
+      leto_planSplit( pPlan, szExpr + nStart, nLen - nStart );
+   else
+      leto_planCond( pPlan, szExpr, nLen );
+}
+
+void leto_PlanFree( void * pPlanPtr )
+{
+   LETOPLAN * pPlan = ( LETOPLAN * ) pPlanPtr;
+   int        i;
+
+   for( i = 0; i < pPlan->iTags; i++ )
+   {
+      LETOPLANTAG * pPlanTag = pPlan->pTags + i;
+
+      hb_xfree( pPlanTag->szTag );
+      hb_xfree( pPlanTag->szKey );
+      if( pPlanTag->pTop )
+         hb_itemRelease( pPlanTag->pTop );
+      if( pPlanTag->pBottom )
+         hb_itemRelease( pPlanTag->pBottom );
+      if( pPlanTag->szCond )
+         hb_xfree( pPlanTag->szCond );
+   }
+   if( pPlan->pTags )
+      hb_xfree( pPlan->pTags );
+   hb_xfree( pPlan );
+}
+
+/* plan for filter szFilter with the orders pTag of area, NULL if no order is usable */
+void * leto_PlanNew( LETOTAG * pTag, const char * szFilter, HB_SIZE nLen )
+{
+   LETOPLAN * pPlan;
+   LETOTAG *  pCount;
+   char *     szNorm;
+   HB_SIZE    nNorm;
+   int        i, iTags = 0;
+
+   for( pCount = pTag; pCount; pCount = pCount->pNext )
+   {
+      if( pCount->pIStru && pCount->pIStru->szOrdKey && pCount->pIStru->cKeyType && strchr( "CNDL", pCount->pIStru->cKeyType ) )
+         iTags++;
+   }
+   if( ! iTags || ( szNorm = leto_planNormalize( szFilter, nLen, &nNorm ) ) == NULL )
+      return NULL;
+
+   pPlan = ( LETOPLAN * ) hb_xgrabz( sizeof( LETOPLAN ) );
+   pPlan->pTags = ( LETOPLANTAG * ) hb_xgrabz( iTags * sizeof( LETOPLANTAG ) );
+   for( ; pTag; pTag = pTag->pNext )
+   {
+      PINDEXSTRU pIStru = pTag->pIStru;
+      HB_SIZE    nKey;
+      char *     szKey;
+
+      if( ! pIStru || ! pIStru->szOrdKey || ! pIStru->cKeyType || ! strchr( "CNDL", pIStru->cKeyType ) ||
+          ( szKey = leto_planNormalize( pIStru->szOrdKey, strlen( pIStru->szOrdKey ), &nKey ) ) == NULL )
+         continue;
+      for( i = 0; i < pPlan->iTags && strcmp( pPlan->pTags[ i ].szKey, szKey ); i++ )
+         ;
+      if( i < pPlan->iTags || ! nKey )  /* same key as an order before */
+      {
+         hb_xfree( szKey );
+         continue;
+      }
+      pPlan->pTags[ pPlan->iTags ].szTag = hb_strdup( pTag->szTagName );
+      pPlan->pTags[ pPlan->iTags ].szKey = szKey;
+      pPlan->pTags[ pPlan->iTags ].cKeyType = pIStru->cKeyType;
+      pPlan->iTags++;
+   }
+
+   leto_planSplit( pPlan, szNorm, nNorm );
+   hb_xfree( szNorm );
+
+   /* only orders with a range */
+   for( i = 0; i < pPlan->iTags; )
+   {
+      LETOPLANTAG * pPlanTag = pPlan->pTags + i;
+
+      if( ! pPlanTag->szCond )
+      {
+         hb_xfree( pPlanTag->szTag );
+         hb_xfree( pPlanTag->szKey );
+         memmove( pPlanTag, pPlanTag + 1, ( pPlan->iTags - i - 1 ) * sizeof( LETOPLANTAG ) );
+         pPlan->iTags--;
+      }
+      else
+         i++;
+   }
+   if( ! pPlan->iTags )
+   {
+      leto_PlanFree( pPlan );
+      pPlan = NULL;
+   }
+
+   return pPlan;
+}
+
+static void leto_planOrdInfo( AREAP pArea, HB_USHORT uiIndex, PHB_ITEM pNewVal, PHB_ITEM pResult )
+{
+   DBORDERINFO pInfo;
+
+   memset( &pInfo, 0, sizeof( DBORDERINFO ) );
+   pInfo.itmNewVal = pNewVal;
+   pInfo.itmResult = pResult;
+   hb_itemClear( pResult );
+   SELF_ORDINFO( pArea, uiIndex, &pInfo );
+}
+
+/* record numbers of the key range, the order is already focused; NULL if the order is not usable,
+ * or with pPlanTag->fWide if the range has more than ulMaxKeys */
+static void * leto_planScan( AREAP pArea, LETOPLANTAG * pPlanTag, HB_ULONG ulMaxKeys )
+{
+   PHB_ITEM pItem = hb_itemNew( NULL );
+   PHB_ITEM pOldTop, pOldBottom;
+   void *   pBitmap = NULL;
+   HB_BOOL  fUsable, fEof = HB_FALSE;
+   HB_SIZE  nKey;
+   char *   szKey;
+
+   leto_planOrdInfo( pArea, DBOI_NUMBER, NULL, pItem );
+   fUsable = hb_itemGetNI( pItem ) > 0;
+   if( fUsable )  /* order may be re-created since plan */
+   {
+      leto_planOrdInfo( pArea, DBOI_EXPRESSION, NULL, pItem );
+      szKey = leto_planNormalize( hb_itemGetCPtr( pItem ), hb_itemGetCLen( pItem ), &nKey );
+      fUsable = szKey && ! strcmp( szKey, pPlanTag->szKey );
+      if( szKey )
+         hb_xfree( szKey );
+   }
+   if( fUsable )  /* each record has its key */
+   {
+      static const HB_USHORT s_uiInfo[] = { DBOI_ISCOND, DBOI_UNIQUE, DBOI_CUSTOM, DBOI_ISDESC };
+      int i;
+
+      for( i = 0; i < ( int ) HB_SIZEOFARRAY( s_uiInfo ) && fUsable; i++ )
+      {
+         leto_planOrdInfo( pArea, s_uiInfo[ i ], NULL, pItem );
+         fUsable = ! hb_itemGetL( pItem );
+      }
+   }
+   hb_itemRelease( pItem );
+   if( ! fUsable )
+      return NULL;
+
+   pOldTop = hb_itemNew( NULL );
+   pOldBottom = hb_itemNew( NULL );
+   leto_planOrdInfo( pArea, pPlanTag->pTop ? DBOI_SCOPETOP : DBOI_SCOPETOPCLEAR, pPlanTag->pTop, pOldTop );
+   leto_planOrdInfo( pArea, pPlanTag->pBottom ? DBOI_SCOPEBOTTOM : DBOI_SCOPEBOTTOMCLEAR, pPlanTag->pBottom, pOldBottom );
+
+   pBitmap = leto_BmNew();
+   pPlanTag->ulKeys = 0;
+   if( SELF_GOTOP( pArea ) == HB_SUCCESS )
+   {
+      while( SELF_EOF( pArea, &fEof ) == HB_SUCCESS && ! fEof )
+      {
+         if( ++pPlanTag->ulKeys > ulMaxKeys )
+         {
+            pPlanTag->fWide = HB_TRUE;
+            break;
+         }
+         leto_BmAdd( pBitmap, ( ( DBFAREAP ) pArea )->ulRecNo );
+         if( SELF_SKIP( pArea, 1 ) != HB_SUCCESS )
+            break;
+      }
+   }
+   if( ! fEof )
+   {
+      leto_BmFree( pBitmap );
+      pBitmap = NULL;
+   }
+
+   pItem = hb_itemNew( NULL );
+   leto_planOrdInfo( pArea, HB_IS_NIL( pOldTop ) ? DBOI_SCOPETOPCLEAR : DBOI_SCOPETOP,
+                     HB_IS_NIL( pOldTop ) ? NULL : pOldTop, pItem );
+   leto_planOrdInfo( pArea, HB_IS_NIL( pOldBottom ) ? DBOI_SCOPEBOTTOMCLEAR : DBOI_SCOPEBOTTOM,
+                     HB_IS_NIL( pOldBottom ) ? NULL : pOldBottom, pItem );
+   hb_itemRelease( pItem );
+   hb_itemRelease( pOldTop );
+   hb_itemRelease( pOldBottom );
+
+   return pBitmap;
+}
+
+static void leto_planFocus( AREAP pArea, PHB_ITEM pOrder )
+{
+   DBORDERINFO pInfo;
+
+   memset( &pInfo, 0, sizeof( DBORDERINFO ) );
+   pInfo.itmOrder = pOrder;
+   pInfo.itmResult = hb_itemNew( NULL );
+   SELF_ORDLSTFOCUS( pArea, &pInfo );
+   hb_itemRelease( pInfo.itmResult );
+}
+
+/* bitmap of candidate records, NULL if an order of plan is no longer usable or no range is selective.
+ * Order, scopes, filter and position of area are restored, deleted records are included */
+void * leto_PlanRun( void * pPlanPtr, AREAP pArea )
+{
+   LETOPLAN * pPlan = ( LETOPLAN * ) pPlanPtr;
+   void *     pBitmap = NULL;
+   PHB_ITEM   pDeleted = hb_itemPutL( NULL, hb_setGetDeleted() );
+   PHB_ITEM   pItem = hb_itemPutL( NULL, HB_FALSE );
+   PHB_ITEM   pOrder = hb_itemNew( NULL );
+   HB_ULONG   ulRecNo = ( ( DBFAREAP ) pArea )->ulRecNo;
+   PHB_ITEM   itmCobExpr = pArea->dbfi.itmCobExpr;
+   HB_BOOL    fFilter = pArea->dbfi.fFilter;
+   HB_BOOL    fFail = HB_FALSE;
+   HB_ULONG   ulMaxKeys;
+   int        iPass, i;
+
+   SELF_RECCOUNT( pArea, &pPlan->ulRecCount );
+   ulMaxKeys = HB_MAX( pPlan->ulRecCount / LETOPLAN_MAXPART, LETOPLAN_ENOUGH );
+   leto_planOrdInfo( pArea, DBOI_NUMBER, NULL, pOrder );
+   hb_setSetItem( HB_SET_DELETED, pItem );
+   pArea->dbfi.itmCobExpr = NULL;  /* RDD evaluates it also with fFilter off */
+   pArea->dbfi.fFilter = HB_FALSE;
+
+   /* equal ranges first, they are most selective */
+   for( iPass = 0; iPass < 2 && ! fFail; iPass++ )
+   {
+      for( i = 0; i < pPlan->iTags; i++ )
+      {
+         LETOPLANTAG * pPlanTag = pPlan->pTags + i;
+         void *        pRange;
+
+         if( pPlanTag->fEqual != ( iPass == 0 ) )
+            continue;
+         pPlanTag->fScanned = pPlanTag->fWide = HB_FALSE;
+         if( pBitmap && leto_BmCount( pBitmap ) <= LETOPLAN_ENOUGH )
+            continue;
+
+         leto_planFocus( pArea, hb_itemPutC( pItem, pPlanTag->szTag ) );
+         pRange = leto_planScan( pArea, pPlanTag, ulMaxKeys );
+         if( ! pRange && pPlanTag->fWide )
+            continue;
+         else if( ! pRange )
+         {
+            fFail = HB_TRUE;
+            break;
+         }
+         pPlanTag->fScanned = HB_TRUE;
+         if( ! pBitmap )
+            pBitmap = pRange;
+         else
+         {
+            leto_BmAnd( pBitmap, pRange );
+            leto_BmFree( pRange );
+         }
+      }
+   }
+
+   leto_planFocus( pArea, pOrder );
+   pArea->dbfi.itmCobExpr = itmCobExpr;
+   pArea->dbfi.fFilter = fFilter;
+   hb_setSetItem( HB_SET_DELETED, pDeleted );
+   SELF_GOTO( pArea, ulRecNo );
+   hb_itemRelease( pOrder );
+   hb_itemRelease( pItem );
+   hb_itemRelease( pDeleted );
+
+   if( fFail && pBitmap )
+   {
+      leto_BmFree( pBitmap );
+      pBitmap = NULL;
+   }
+   if( pBitmap )
+   {
+      pPlan->ulRecords = leto_BmCount( pBitmap );
+      pPlan->ulRuns++;
+   }
+
+   return pBitmap;
+}
+
+/* readable description of plan and its last run, with the actual candidates pBitmap of area */
+char * leto_PlanExplain( void * pPlanPtr, AREAP pArea, void * pBitmap, HB_SIZE * pnLen )
+{
+   LETOPLAN * pPlan = ( LETOPLAN * ) pPlanPtr;
+   HB_SIZE    nLen = 256, nPos = 0;
+   char *     szText;
+   int        i;
+
+   for( i = 0; i < pPlan->iTags; i++ )
+      nLen += strlen( pPlan->pTags[ i ].szTag ) + strlen( pPlan->pTags[ i ].szCond ) + 48;
+   szText = ( char * ) hb_xgrab( nLen );
+   if( pBitmap )  /* records changed since the run are added */
+   {
+      pPlan->ulRecords = leto_BmCount( pBitmap );
+      SELF_RECCOUNT( pArea, &pPlan->ulRecCount );
+   }
+
+   for( i = 0; i < pPlan->iTags; i++ )
+   {
+      LETOPLANTAG * pPlanTag = pPlan->pTags + i;
+
+      if( pPlanTag->fScanned )
+         nPos += sprintf( szText + nPos, "INDEX %s: %s -> %lu KEYS; ", pPlanTag->szTag, pPlanTag->szCond, pPlanTag->ulKeys );
+      else if( pPlanTag->fWide )
+         nPos += sprintf( szText + nPos, "INDEX %s: %s -> TOO WIDE; ", pPlanTag->szTag, pPlanTag->szCond );
+      else
+         nPos += sprintf( szText + nPos, "INDEX %s: %s -> SKIPPED; ", pPlanTag->szTag, pPlanTag->szCond );
+   }
+   nPos += sprintf( szText + nPos, "BITMAP %lu OF %lu RECORDS; RESIDUAL FILTER ( %d OF %d CONDITIONS INDEXED ); RUNS %lu",
+                    pPlan->ulRecords, pPlan->ulRecCount, pPlan->iUsed, pPlan->iConds, pPlan->ulRuns );
+   *pnLen = nPos;
+
+   return szText;
+}
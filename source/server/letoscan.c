@@ -0,0 +1,631 @@
+/*
+ * Leto db server parallel partitioned table scan
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307 USA (or visit the web site http://www.gnu.org/).
+ *
+ * As a special exception, the Harbour Project gives permission for
+ * additional uses of the text contained in its release of Harbour.
+ *
+ * The exception is that, if you link the Harbour libraries with other
+ * files to produce an executable, this does not by itself cause the
+ * resulting executable to be covered by the GNU General Public License.
+ * Your use of that executable is in no way restricted on account of
+ * linking the Harbour library code into it.
+ *
+ * This exception does not however invalidate any other reasons why
+ * the executable file might be covered by the GNU General Public License.
+ *
+ * This exception applies only to the code released by the Harbour
+ * Project under the name Harbour.  If you copy code from other
+ * Harbour Project or Free Software Foundation releases into a copy of
+ * Harbour, as the General Public License permits, the exception does
+ * not apply to the code that you add in this way.  To avoid misleading
+ * anyone as to the status of such modified files, you must delete
+ * this exception notice from them.
+ *
+ * If you write modifications of your own for Harbour, it is your choice
+ * whether to permit this exception to apply to your modifications.
+ * If you do not wish that, delete this exception notice.
+ *
+ */
+
+/*
+ * leto_Sum() and leto_GroupBy() with a requested thread count read the DBF file direct,
+ * split into RecNo ranges each scanned by an own thread with an own file handle.
+ * Records are validated with private copies of a program compiled by leto_FltCompile(),
+ * sums [ and groups keyed by raw field value ] are accumulated per thread and merged at end.
+ * Only plain numeric fields and native filters are possible, else the caller uses the serial scan.
+ */
+
+#include "srvleto.h"
+#include "hbapicdp.h"
+
+#define LETOSCAN_MAXTHREADS   31         /* max. threads of one scan */
+#define LETOSCAN_MINRECS      10000      /* min. records per thread */
+#define LETOSCAN_BUFSIZE      0x40000    /* read buffer of a thread */
+
+typedef struct
+{
+   double    dSum;                       /* also non integer values of a field without decimals */
+   HB_MAXINT lSum;
+} LETOSCANSUM;
+
+typedef struct
+{
+   HB_USHORT uiType;                     /* HB_FT_*, 0 = count of records */
+   HB_USHORT uiOffset;
+   HB_USHORT uiLen;
+   HB_USHORT uiDec;
+   HB_BOOL   fDouble;                    /* sum as double, else as integer */
+} LETOSCANFLD;
+
+typedef struct
+{
+   HB_ULONG      ulKeys;
+   HB_ULONG      ulSlots;                /* power of 2, at least twice ulKeys */
+   HB_ULONG *    pSlots;                 /* key index + 1, 0 = empty */
+   HB_BYTE *     pKeys;                  /* raw field values */
+   LETOSCANSUM * pSums;                  /* uiFields per key */
+} LETOSCANGRP;
+
+typedef struct _LETOSCAN LETOSCAN;
+
+typedef struct
+{
+   LETOSCAN *       pScan;
+   HB_ULONG         ulFrom;
+   HB_ULONG         ulTo;
+   HB_FHANDLE       hFile;
+   void *           pFltPrg;
+   LETOSCANSUM *    pSums;
+   LETOSCANGRP      group;
+   HB_THREAD_HANDLE th_h;
+   int              iResult;             /* 1 = done, 0 = timeout, -1 = failed */
+} LETOSCANPART;
+
+struct _LETOSCAN
+{
+   char           szFile[ HB_PATH_MAX ];
+   PHB_CODEPAGE   cdp;
+   HB_FOFFSET     nHeaderLen;
+   HB_USHORT      uiRecordLen;
+   HB_ULONG       ulRecCount;
+   HB_BOOL        fDeleted;
+   void *         pRBM;
+   HB_ULONG       ulTimeout;
+   HB_U64         ullStart;
+   volatile int   iAbort;
+   LETOSCANFLD *  pFields;
+   HB_USHORT      uiFields;
+   LETOSCANFLD    grpField;
+   HB_BOOL        fGroup;
+   int            iParts;
+   LETOSCANPART * pParts;
+};
+
+extern HB_BOOL leto_BmHas( void * pBitmap, HB_ULONG ulRecNo );
+extern void * leto_FltClone( void * pFltPrg );
+extern int leto_FltEval( void * pFltPrg, const HB_BYTE * pRecord );
+extern void leto_FltFree( void * pFltPrg );
+
+/* NULL if not possible for this area, then use serial scan */
+void * leto_ScanNew( AREAP pArea, int iThreads, HB_BOOL fDeleted, void * pRBM, HB_ULONG ulTimeout )
+{
+   DBFAREAP   pDbfArea = ( DBFAREAP ) pArea;
+   LETOSCAN * pScan;
+   DBORDERINFO pOrderInfo;
+   HB_ULONG   ulRecCount = 0;
+   HB_BOOL    fOrder = HB_FALSE;
+   int        i;
+
+   if( iThreads > LETOSCAN_MAXTHREADS )
+      iThreads = LETOSCAN_MAXTHREADS;
+   if( iThreads < 2 || ! pArea || ! pArea->uiFieldCount || pArea->cdPage != hb_vmCDP() ||
+       SELF_GOCOLD( pArea ) != HB_SUCCESS || SELF_RECCOUNT( pArea, &ulRecCount ) != HB_SUCCESS )
+      return NULL;
+   if( ( HB_ULONG ) iThreads > ulRecCount / LETOSCAN_MINRECS )
+      iThreads = ( int ) ( ulRecCount / LETOSCAN_MINRECS );
+   if( iThreads < 2 || ! pDbfArea->szDataFileName || strlen( pDbfArea->szDataFileName ) >= HB_PATH_MAX )
+      return NULL;
+
+   /* encrypted table, or an order not containing all records */
+   memset( &pOrderInfo, 0, sizeof( DBORDERINFO ) );
+   pOrderInfo.itmResult = hb_itemNew( NULL );
+   if( SELF_INFO( pArea, DBI_ISENCRYPTED, pOrderInfo.itmResult ) != HB_SUCCESS || hb_itemGetL( pOrderInfo.itmResult ) )
+      fOrder = HB_TRUE;
+   else if( SELF_ORDINFO( pArea, DBOI_NUMBER, &pOrderInfo ) == HB_SUCCESS && hb_itemGetNI( pOrderInfo.itmResult ) > 0 )
+   {
+      static const HB_USHORT s_uiChecks[] = { DBOI_ISCOND, DBOI_CUSTOM, DBOI_SCOPETOP, DBOI_SCOPEBOTTOM };
+
+      for( i = 0; i < ( int ) HB_SIZEOFARRAY( s_uiChecks ) && ! fOrder; i++ )
+      {
+         hb_itemClear( pOrderInfo.itmResult );
+         if( SELF_ORDINFO( pArea, s_uiChecks[ i ], &pOrderInfo ) != HB_SUCCESS )
+            fOrder = HB_TRUE;
+         else if( i < 2 )
+            fOrder = hb_itemGetL( pOrderInfo.itmResult );
+         else
+            fOrder = ! HB_IS_NIL( pOrderInfo.itmResult );
+      }
+   }
+   hb_itemRelease( pOrderInfo.itmResult );
+   if( fOrder )
+      return NULL;
+
+   pScan = ( LETOSCAN * ) hb_xgrabz( sizeof( LETOSCAN ) );
+   hb_strncpy( pScan->szFile, pDbfArea->szDataFileName, HB_PATH_MAX - 1 );
+   pScan->cdp = hb_vmCDP();
+   pScan->nHeaderLen = ( HB_FOFFSET ) pDbfArea->uiHeaderLen;
+   pScan->uiRecordLen = pDbfArea->uiRecordLen;
+   pScan->ulRecCount = ulRecCount;
+   pScan->fDeleted = fDeleted;
+   pScan->pRBM = pRBM;
+   pScan->ulTimeout = ulTimeout;
+   pScan->iParts = iThreads;
+   pScan->pParts = ( LETOSCANPART * ) hb_xgrabz( sizeof( LETOSCANPART ) * iThreads );
+   for( i = 0; i < iThreads; i++ )
+   {
+      pScan->pParts[ i ].pScan = pScan;
+      pScan->pParts[ i ].hFile = FS_ERROR;
+   }
+
+   return pScan;
+}
+
+void leto_ScanFree( void * pScanData )
+{
+   LETOSCAN *     pScan = ( LETOSCAN * ) pScanData;
+   LETOSCANPART * pPart;
+   int            i;
+
+   for( i = 0; i < pScan->iParts; i++ )
+   {
+      pPart = pScan->pParts + i;
+      if( pPart->hFile != FS_ERROR )
+         hb_fsClose( pPart->hFile );
+      if( pPart->pFltPrg )
+         leto_FltFree( pPart->pFltPrg );
+      if( pPart->pSums )
+         hb_xfree( pPart->pSums );
+      if( pPart->group.pSlots )
+         hb_xfree( pPart->group.pSlots );
+      if( pPart->group.pKeys )
+         hb_xfree( pPart->group.pKeys );
+      if( pPart->group.pSums )
+         hb_xfree( pPart->group.pSums );
+   }
+   hb_xfree( pScan->pParts );
+   if( pScan->pFields )
+      hb_xfree( pScan->pFields );
+   hb_xfree( pScan );
+}
+
+/* the record condition, each thread gets an own copy of the program */
+HB_BOOL leto_ScanFilter( void * pScanData, void * pFltPrg )
+{
+   LETOSCAN * pScan = ( LETOSCAN * ) pScanData;
+   int        i;
+
+   for( i = 0; i < pScan->iParts; i++ )
+   {
+      pScan->pParts[ i ].pFltPrg = leto_FltClone( pFltPrg );
+      if( ! pScan->pParts[ i ].pFltPrg )
+         return HB_FALSE;
+   }
+
+   return HB_TRUE;
+}
+
+static HB_BOOL leto_scanFieldDef( AREAP pArea, HB_USHORT uiField, LETOSCANFLD * pFld, HB_BOOL fGroup )
+{
+   LPFIELD pField;
+
+   memset( pFld, 0, sizeof( LETOSCANFLD ) );
+   if( ! uiField )
+      return ! fGroup;
+   if( uiField > pArea->uiFieldCount )
+      return HB_FALSE;
+
+   pField = pArea->lpFields + uiField - 1;
+   switch( pField->uiType )
+   {
+      case HB_FT_LONG:
+      case HB_FT_FLOAT:
+      case HB_FT_DOUBLE:
+         break;
+
+      case HB_FT_INTEGER:
+         if( pField->uiLen != 1 && pField->uiLen != 2 && pField->uiLen != 3 && pField->uiLen != 4 && pField->uiLen != 8 )
+            return HB_FALSE;
+         break;
+
+      case HB_FT_STRING:
+         if( ! fGroup || ( pField->uiFlags & HB_FF_UNICODE ) )
+            return HB_FALSE;
+         break;
+
+      case HB_FT_DATE:
+         if( ! fGroup || ( pField->uiLen != 8 && pField->uiLen != 3 && pField->uiLen != 4 ) )
+            return HB_FALSE;
+         break;
+
+      case HB_FT_LOGICAL:
+         if( ! fGroup )
+            return HB_FALSE;
+         break;
+
+      default:
+         return HB_FALSE;
+   }
+   pFld->uiType = pField->uiType;
+   pFld->uiOffset = ( HB_USHORT ) ( ( DBFAREAP ) pArea )->pFieldOffset[ uiField - 1 ];
+   pFld->uiLen = pField->uiLen;
+   pFld->uiDec = pField->uiDec;
+
+   return HB_TRUE;
+}
+
+/* field to sum, 0 for the count of records; false if not possible */
+HB_BOOL leto_ScanField( void * pScanData, AREAP pArea, HB_USHORT uiField, HB_BOOL fDouble )
+{
+   LETOSCAN *  pScan = ( LETOSCAN * ) pScanData;
+   LETOSCANFLD fld;
+
+   if( ! leto_scanFieldDef( pArea, uiField, &fld, HB_FALSE ) )
+      return HB_FALSE;
+   fld.fDouble = fDouble;
+   pScan->pFields = ( LETOSCANFLD * ) hb_xrealloc( pScan->pFields, sizeof( LETOSCANFLD ) * ( pScan->uiFields + 1 ) );
+   pScan->pFields[ pScan->uiFields++ ] = fld;
+
+   return HB_TRUE;
+}
+
+HB_BOOL leto_ScanGroupBy( void * pScanData, AREAP pArea, HB_USHORT uiField )
+{
+   LETOSCAN * pScan = ( LETOSCAN * ) pScanData;
+
+   pScan->fGroup = leto_scanFieldDef( pArea, uiField, &pScan->grpField, HB_TRUE );
+
+   return pScan->fGroup;
+}
+
+/* numeric field value as SELF_GETVALUE() gives it, true if double */
+static HB_BOOL leto_scanNum( const LETOSCANFLD * pFld, const HB_BYTE * ptr, HB_MAXINT * plVal, double * pdVal )
+{
+   switch( pFld->uiType )
+   {
+      case HB_FT_INTEGER:
+         switch( pFld->uiLen )
+         {
+            case 1:
+               *plVal = ( HB_SCHAR ) *ptr;
+               break;
+            case 2:
+               *plVal = HB_GET_LE_INT16( ptr );
+               break;
+            case 3:
+               *plVal = HB_GET_LE_INT24( ptr );
+               break;
+            case 4:
+               *plVal = HB_GET_LE_INT32( ptr );
+               break;
+            default:
+               *plVal = HB_GET_LE_INT64( ptr );
+         }
+         if( pFld->uiDec )
+         {
+            *pdVal = hb_numDecConv( ( double ) *plVal, ( int ) pFld->uiDec );
+            return HB_TRUE;
+         }
+         return HB_FALSE;
+
+      case HB_FT_DOUBLE:
+         *pdVal = HB_GET_LE_DOUBLE( ptr );
+         return HB_TRUE;
+   }
+
+   return hb_strnToNum( ( const char * ) ptr, pFld->uiLen, plVal, pdVal );
+}
+
+static void leto_scanAdd( const LETOSCAN * pScan, LETOSCANSUM * pSums, const HB_BYTE * pRecord )
+{
+   const LETOSCANFLD * pFld = pScan->pFields;
+   HB_MAXINT           lVal;
+   double              dVal;
+   HB_USHORT           ui;
+
+   for( ui = 0; ui < pScan->uiFields; ui++, pFld++ )
+   {
+      if( ! pFld->uiType )
+         pSums[ ui ].lSum++;
+      else if( leto_scanNum( pFld, pRecord + pFld->uiOffset, &lVal, &dVal ) )
+         pSums[ ui ].dSum += dVal;
+      else if( pFld->fDouble )
+         pSums[ ui ].dSum += ( double ) lVal;
+      else
+         pSums[ ui ].lSum += lVal;
+   }
+}
+
+/* FNV-1a */
+static HB_ULONG leto_scanHash( const HB_BYTE * pKey, HB_USHORT uiLen )
+{
+   HB_U32 uiHash = 2166136261U;
+
+   while( uiLen-- )
+      uiHash = ( uiHash ^ *pKey++ ) * 16777619U;
+
+   return ( HB_ULONG ) uiHash;
+}
+
+/* sums of the group with given raw key, added if new */
+static LETOSCANSUM * leto_scanGroup( LETOSCANGRP * pGroup, const HB_BYTE * pKey, HB_USHORT uiLen, HB_USHORT uiFields )
+{
+   HB_ULONG ulSlot, ulKey;
+
+   if( ( pGroup->ulKeys + 1 ) * 2 > pGroup->ulSlots )
+   {
+      HB_ULONG ulSlots = pGroup->ulSlots ? pGroup->ulSlots * 2 : 256;
+
+      if( pGroup->pSlots )
+         hb_xfree( pGroup->pSlots );
+      pGroup->pSlots = ( HB_ULONG * ) hb_xgrabz( sizeof( HB_ULONG ) * ulSlots );
+      pGroup->ulSlots = ulSlots;
+      for( ulKey = 0; ulKey < pGroup->ulKeys; ulKey++ )
+      {
+         ulSlot = leto_scanHash( pGroup->pKeys + ulKey * uiLen, uiLen ) & ( ulSlots - 1 );
+         while( pGroup->pSlots[ ulSlot ] )
+            ulSlot = ( ulSlot + 1 ) & ( ulSlots - 1 );
+         pGroup->pSlots[ ulSlot ] = ulKey + 1;
+      }
+      pGroup->pKeys = ( HB_BYTE * ) hb_xrealloc( pGroup->pKeys, ( HB_SIZE ) uiLen * ( ulSlots / 2 ) );
+      pGroup->pSums = ( LETOSCANSUM * ) hb_xrealloc( pGroup->pSums, sizeof( LETOSCANSUM ) * ( HB_SIZE ) uiFields * ( ulSlots / 2 ) );
+   }
+
+   ulSlot = leto_scanHash( pKey, uiLen ) & ( pGroup->ulSlots - 1 );
+   while( ( ulKey = pGroup->pSlots[ ulSlot ] ) != 0 )
+   {
+      if( ! memcmp( pGroup->pKeys + ( ulKey - 1 ) * uiLen, pKey, uiLen ) )
+         return pGroup->pSums + ( ulKey - 1 ) * uiFields;
+      ulSlot = ( ulSlot + 1 ) & ( pGroup->ulSlots - 1 );
+   }
+
+   ulKey = pGroup->ulKeys++;
+   pGroup->pSlots[ ulSlot ] = ulKey + 1;
+   memcpy( pGroup->pKeys + ulKey * uiLen, pKey, uiLen );
+   memset( pGroup->pSums + ulKey * uiFields, 0, sizeof( LETOSCANSUM ) * uiFields );
+
+   return pGroup->pSums + ulKey * uiFields;
+}
+
+static HB_THREAD_STARTFUNC( leto_scanThread )
+{
+   LETOSCANPART * pPart = ( LETOSCANPART * ) Cargo;
+   LETOSCAN *     pScan = pPart->pScan;
+   HB_USHORT      uiRecordLen = pScan->uiRecordLen;
+   HB_ULONG       ulBufRecs = HB_MAX( 1, LETOSCAN_BUFSIZE / uiRecordLen );
+   HB_ULONG       ulRecNo = pPart->ulFrom, ulRecs, ul;
+   HB_BYTE *      pBuffer;
+   const HB_BYTE * pRecord;
+   int            iValid;
+
+   hb_vmThreadInit( NULL );
+   hb_vmSetCDP( pScan->cdp );
+   hb_vmUnlock();  /* no HVM access below, don't hold up the GC of other threads */
+
+   pBuffer = ( HB_BYTE * ) hb_xgrab( ulBufRecs * uiRecordLen );
+   pPart->iResult = 1;
+   while( ulRecNo <= pPart->ulTo && ! pScan->iAbort )
+   {
+      ulRecs = HB_MIN( ulBufRecs, pPart->ulTo - ulRecNo + 1 );
+      if( hb_fsReadAt( pPart->hFile, pBuffer, ulRecs * uiRecordLen,
+                       pScan->nHeaderLen + ( HB_FOFFSET ) ( ulRecNo - 1 ) * uiRecordLen ) != ulRecs * uiRecordLen )
+      {
+         pPart->iResult = -1;
+         break;
+      }
+
+      for( ul = 0, pRecord = pBuffer; ul < ulRecs; ul++, ulRecNo++, pRecord += uiRecordLen )
+      {
+         if( pScan->fDeleted && *pRecord == '*' )
+            continue;
+         if( pScan->pRBM && ! leto_BmHas( pScan->pRBM, ulRecNo ) )
+            continue;
+         if( pPart->pFltPrg )
+         {
+            iValid = leto_FltEval( pPart->pFltPrg, pRecord );
+            if( iValid < 0 )
+            {
+               pPart->iResult = -1;
+               break;
+            }
+            else if( ! iValid )
+               continue;
+         }
+
+         if( pScan->fGroup )
+            leto_scanAdd( pScan, leto_scanGroup( &pPart->group, pRecord + pScan->grpField.uiOffset,
+                                                 pScan->grpField.uiLen, pScan->uiFields ), pRecord );
+         else
+            leto_scanAdd( pScan, pPart->pSums, pRecord );
+      }
+
+      if( pPart->iResult < 0 )
+         break;
+      if( leto_MilliSec() - pScan->ullStart > pScan->ulTimeout )
+      {
+         pPart->iResult = 0;
+         break;
+      }
+   }
+   if( pPart->iResult < 1 )
+      pScan->iAbort = 1;
+   hb_xfree( pBuffer );
+
+   hb_vmLock();
+   hb_vmThreadQuit();
+   HB_THREAD_END
+}
+
+/* 1 = done, 0 = timed out, -1 = not possible, use serial scan */
+int leto_ScanRun( void * pScanData )
+{
+   LETOSCAN *     pScan = ( LETOSCAN * ) pScanData;
+   LETOSCANPART * pPart;
+   HB_THREAD_ID   th_id;
+   HB_ULONG       ulPart = pScan->ulRecCount / pScan->iParts, ulKey;
+   HB_USHORT      ui;
+   int            i, iStarted = 0, iResult = 1;
+
+   if( ! pScan->uiFields )
+      return -1;
+
+   for( i = 0; i < pScan->iParts; i++ )
+   {
+      pPart = pScan->pParts + i;
+      pPart->ulFrom = ( HB_ULONG ) i * ulPart + 1;
+      pPart->ulTo = ( i == pScan->iParts - 1 ) ? pScan->ulRecCount : pPart->ulFrom + ulPart - 1;
+      pPart->pSums = ( LETOSCANSUM * ) hb_xgrabz( sizeof( LETOSCANSUM ) * pScan->uiFields );
+      pPart->hFile = hb_fsOpen( pScan->szFile, FO_READ | FO_DENYNONE );
+      if( pPart->hFile == FS_ERROR )
+         return -1;
+   }
+
+   pScan->ullStart = leto_MilliSec();
+   for( i = 0; i < pScan->iParts; i++ )
+   {
+      pPart = pScan->pParts + i;
+      pPart->th_h = hb_threadCreate( &th_id, leto_scanThread, ( void * ) pPart );
+      if( ! pPart->th_h )
+      {
+         pScan->iAbort = 1;
+         iResult = -1;
+         break;
+      }
+      iStarted++;
+   }
+
+   hb_vmUnlock();
+   for( i = 0; i < iStarted; i++ )
+      hb_threadJoin( pScan->pParts[ i ].th_h );
+   hb_vmLock();
+
+   for( i = 0; i < iStarted && iResult > 0; i++ )
+   {
+      if( pScan->pParts[ i ].iResult < iResult )
+         iResult = pScan->pParts[ i ].iResult;
+   }
+   if( iResult < 1 )
+      return iResult;
+
+   /* merge into the first part */
+   pPart = pScan->pParts;
+   for( i = 1; i < pScan->iParts; i++ )
+   {
+      LETOSCANPART * pOther = pScan->pParts + i;
+      LETOSCANSUM *  pSrc, * pDst;
+
+      for( ulKey = 0; ulKey < ( pScan->fGroup ? pOther->group.ulKeys : 1 ); ulKey++ )
+      {
+         if( pScan->fGroup )
+         {
+            pSrc = pOther->group.pSums + ulKey * pScan->uiFields;
+            pDst = leto_scanGroup( &pPart->group, pOther->group.pKeys + ulKey * pScan->grpField.uiLen,
+                                   pScan->grpField.uiLen, pScan->uiFields );
+         }
+         else
+         {
+            pSrc = pOther->pSums;
+            pDst = pPart->pSums;
+         }
+         for( ui = 0; ui < pScan->uiFields; ui++ )
+         {
+            pDst[ ui ].dSum += pSrc[ ui ].dSum;
+            pDst[ ui ].lSum += pSrc[ ui ].lSum;
+         }
+      }
+   }
+
+   return 1;
+}
+
+/* count of groups after leto_ScanRun() */
+HB_ULONG leto_ScanGroups( void * pScanData )
+{
+   LETOSCAN * pScan = ( LETOSCAN * ) pScanData;
+
+   return pScan->fGroup ? pScan->pParts->group.ulKeys : 0;
+}
+
+/* value of the group field */
+void leto_ScanGroupKey( void * pScanData, HB_ULONG ulGroup, PHB_ITEM pItem )
+{
+   LETOSCAN *          pScan = ( LETOSCAN * ) pScanData;
+   const LETOSCANFLD * pFld = &pScan->grpField;
+   const HB_BYTE *     pKey = pScan->pParts->group.pKeys + ulGroup * pFld->uiLen;
+   HB_MAXINT           lVal;
+   double              dVal;
+
+   switch( pFld->uiType )
+   {
+      case HB_FT_STRING:
+         hb_itemPutCL( pItem, ( const char * ) pKey, pFld->uiLen );
+         break;
+
+      case HB_FT_DATE:
+         if( pFld->uiLen == 8 )
+            hb_itemPutDS( pItem, ( const char * ) pKey );
+         else
+            hb_itemPutDL( pItem, pFld->uiLen == 3 ? ( long ) HB_GET_LE_UINT24( pKey ) : ( long ) HB_GET_LE_UINT32( pKey ) );
+         break;
+
+      case HB_FT_LOGICAL:
+         hb_itemPutL( pItem, *pKey == 'T' || *pKey == 't' || *pKey == 'Y' || *pKey == 'y' );
+         break;
+
+      default:
+         if( leto_scanNum( pFld, pKey, &lVal, &dVal ) )
+         {
+            if( pFld->uiType == HB_FT_DOUBLE )
+               hb_itemPutNDLen( pItem, dVal, 20 - ( pFld->uiDec > 0 ? ( pFld->uiDec + 1 ) : 0 ), ( int ) pFld->uiDec );
+            else if( pFld->uiDec )
+               hb_itemPutNDLen( pItem, dVal, ( int ) ( pFld->uiLen - pFld->uiDec - 1 ), ( int ) pFld->uiDec );
+            else
+               hb_itemPutNDLen( pItem, dVal, ( int ) pFld->uiLen, 0 );
+         }
+         else
+            hb_itemPutNIntLen( pItem, lVal, ( int ) pFld->uiLen );
+   }
+}
+
+/* sum of field uiIndex for the group [ or total for leto_Sum() ] */
+void leto_ScanResult( void * pScanData, HB_ULONG ulGroup, HB_USHORT uiIndex, double * pdSum, HB_MAXINT * plSum )
+{
+   LETOSCAN *    pScan = ( LETOSCAN * ) pScanData;
+   LETOSCANSUM * pSum = pScan->fGroup ? pScan->pParts->group.pSums + ulGroup * pScan->uiFields + uiIndex :
+                                        pScan->pParts->pSums + uiIndex;
+
+   if( pScan->pFields[ uiIndex ].fDouble )
+   {
+      *pdSum = pSum->dSum;
+      *plSum = ( HB_MAXINT ) pSum->dSum;
+   }
+   else  /* truncated once for the total, not for each value */
+   {
+      *plSum = pSum->lSum + ( HB_MAXINT ) pSum->dSum;
+      *pdSum = ( double ) pSum->lSum + pSum->dSum;
+   }
+}
@@ -12,4 +12,5 @@ hbmk2 test_var.prg
 hbmk2 test_mem.prg -D__MEMIO__=1
 hbmk2 letoudf
 hbmk2 bug_info
+hbmk2 bench_sum
 
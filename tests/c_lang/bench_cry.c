@@ -0,0 +1,95 @@
+/* benchmark of network traffic encryption: Blowfish CBC vs. ChaCha20-Poly1305
+ * without compression, for typical sizes of a skip buffer answer
+ * needs LetoDBf client library build with LZ4 [ default ], no server is needed */
+
+/* set it before ! */
+#define __LETO_C_API__
+#include "letocl.h"
+
+#if defined( HB_OS_WIN )
+   #define _EOL_  "\r\n"
+#else
+   #define _EOL_  "\n"
+#endif
+
+/* from funcleto.h, which would need the LZ4 include path */
+typedef struct _HB_LZ4NET * PHB_LZ4NET;
+extern PHB_LZ4NET hb_lz4netOpen( int iLevel, int strategy );
+extern void hb_lz4netClose( PHB_LZ4NET pStream );
+extern void hb_lz4netCipher( PHB_LZ4NET pStream, int iCipher, const char * pSalt, HB_BOOL fServer );
+extern void hb_lz4netEncryptKey( PHB_LZ4NET pStream, const char * keydata, int keylen );
+extern HB_ULONG hb_lz4netEncrypt( PHB_LZ4NET pStream, char ** pData, HB_ULONG ulLen, HB_ULONG * pulDataLen, const char * szData );
+extern HB_ULONG hb_lz4netDecrypt( PHB_LZ4NET pStream, char ** pData, HB_ULONG ulLen, HB_ULONG * pulDataLen, HB_BOOL fCompressed );
+extern HB_U64 leto_MicroSec( void );
+
+#define BENCH_BYTES  ( 64 * 1024 * 1024 )  /* amount per cipher and size */
+
+static void bench( int iCipher, HB_ULONG ulSize )
+{
+   PHB_LZ4NET pEnc = hb_lz4netOpen( 0, 0 );
+   PHB_LZ4NET pDec = hb_lz4netOpen( 0, 0 );
+   char *     szMsg = ( char * ) hb_xgrab( ulSize );
+   HB_ULONG   ulSendLen = ulSize + 48, ulRecvLen = ulSize + 48;
+   char *     pSend = ( char * ) hb_xgrab( ulSendLen + 1 );
+   char *     pRecv = ( char * ) hb_xgrab( ulRecvLen + 1 );
+   HB_ULONG   ul, ulLoops = BENCH_BYTES / ulSize, ulLen;
+   HB_U64     ullEnc = 0, ullDec = 0, ullStart;
+   HB_BOOL    fOk = HB_TRUE;
+   char       szSalt[ 32 ];
+
+   for( ul = 0; ul < ulSize; ul++ )  /* something like records */
+      szMsg[ ul ] = ( char ) ( ( ul % 97 ) < 10 ? '0' + ul % 10 : 'A' + ul % 26 );
+
+   memset( szSalt, 'S', sizeof( szSalt ) );
+   hb_lz4netCipher( pEnc, iCipher, szSalt, HB_FALSE );  /* client to ... */
+   hb_lz4netCipher( pDec, iCipher, szSalt, HB_TRUE );   /* ... server direction */
+   hb_lz4netEncryptKey( pEnc, "bench!password", 14 );
+   hb_lz4netEncryptKey( pDec, "bench!password", 14 );
+
+   for( ul = 0; ul < ulLoops && fOk; ul++ )
+   {
+      ullStart = leto_MicroSec();
+      ulLen = hb_lz4netEncrypt( pEnc, &pSend, ulSize, &ulSendLen, szMsg );
+      ullEnc += leto_MicroSec() - ullStart;
+
+      ulLen -= 4;
+      memcpy( pRecv, pSend + 4, ulLen );
+      ullStart = leto_MicroSec();
+      ulLen = hb_lz4netDecrypt( pDec, &pRecv, ulLen, &ulRecvLen, HB_FALSE );
+      ullDec += leto_MicroSec() - ullStart;
+      fOk = ( ulLen == ulSize && ! memcmp( pRecv, szMsg, ulSize ) );
+   }
+
+   if( fOk )
+      printf( "%-10s %6lu bytes: encrypt %8.1f MB/s  decrypt %8.1f MB/s" _EOL_,
+              iCipher ? "ChaCha20P" : "Blowfish", ulSize,
+              ( double ) ulLoops * ulSize / ( ullEnc ? ullEnc : 1 ),
+              ( double ) ulLoops * ulSize / ( ullDec ? ullDec : 1 ) );
+   else
+      printf( "%-10s %6lu bytes: FAILED round trip" _EOL_, iCipher ? "ChaCha20P" : "Blowfish", ulSize );
+
+   hb_xfree( szMsg );
+   hb_xfree( pSend );
+   hb_xfree( pRecv );
+   hb_lz4netClose( pEnc );
+   hb_lz4netClose( pDec );
+}
+
+int main( int argc, char *argv[] )
+{
+   HB_ULONG aSizes[] = { 512, 2048, 8192, 32768, 65536 };
+   int      i, iCipher;
+
+   HB_SYMBOL_UNUSED( argc );
+   HB_SYMBOL_UNUSED( argv );
+
+   LetoInit();
+   for( i = 0; i < ( int ) ( sizeof( aSizes ) / sizeof( HB_ULONG ) ); i++ )
+   {
+      for( iCipher = 0; iCipher <= 1; iCipher++ )
+         bench( iCipher, aSizes[ i ] );
+   }
+   LetoExit( 1 );
+
+   return 0;
+}
@@ -0,0 +1,228 @@
+/* benchmark of server record encoding for skip buffers [ iZipRecord < 0 ]:
+ * field by field type switch as before vs. precompiled per table encoding plan
+ * needs LetoDBf client library, which contains the common encoder, no server is needed */
+
+/* set it before ! */
+#define __LETO_C_API__
+#include "letocl.h"
+
+#if defined( HB_OS_WIN )
+   #define _EOL_  "\r\n"
+#else
+   #define _EOL_  "\n"
+#endif
+
+/* from funcleto.h */
+typedef struct
+{
+   HB_USHORT uiOp;
+   HB_USHORT uiOffset;
+   HB_USHORT uiLen;
+} LETORECOP;
+typedef struct
+{
+   HB_USHORT   uiOps;
+   HB_USHORT   uiOffset;
+   LETORECOP * pOps;
+} LETORECPLAN, * PLETORECPLAN;
+extern PLETORECPLAN leto_RecPlanNew( HB_USHORT uiFields );
+extern HB_BOOL leto_RecPlanAdd( PLETORECPLAN pPlan, HB_USHORT uiType, HB_USHORT uiLen, HB_USHORT uiFlags );
+extern char * leto_RecPlanEncode( const LETORECPLAN * pPlan, const HB_BYTE * pRecord, char * pData );
+extern void leto_RecPlanFree( PLETORECPLAN pPlan );
+extern HB_UCHAR leto_n2b( char * s, HB_U32 n );
+extern HB_U64 leto_MicroSec( void );
+
+#define BENCH_LOOPS    20000
+#define BENCH_RECORDS  50      /* records per skip buffer */
+
+typedef struct
+{
+   HB_USHORT uiType;
+   HB_USHORT uiLen;
+} BENCHFIELD;
+
+static const BENCHFIELD s_fields[] = {
+   { HB_FT_STRING,  10 }, { HB_FT_STRING,  40 }, { HB_FT_LONG,    10 }, { HB_FT_DATE,     8 },
+   { HB_FT_LOGICAL,  1 }, { HB_FT_INTEGER,  4 }, { HB_FT_DOUBLE,   8 }, { HB_FT_MEMO,    10 },
+   { HB_FT_STRING,  60 }, { HB_FT_INTEGER,  4 }, { HB_FT_INTEGER,  4 }, { HB_FT_STRING,  30 },
+   { HB_FT_STRING, 300 }, { HB_FT_LONG,    12 }, { HB_FT_LOGICAL,  1 }, { HB_FT_DATE,     8 } };
+#define BENCH_FIELDS  ( ( int ) ( sizeof( s_fields ) / sizeof( BENCHFIELD ) ) )
+
+/* field loop of leto_rec() as it was, for the types above */
+static char * encode_old( const HB_BYTE * pRecord, char * pData )
+{
+   const char * pRecordField = ( const char * ) pRecord + 1;
+   const char * ptr, * ptrEnd;
+   HB_ULONG     ulRealLen;
+   HB_USHORT    uiLen;
+   int          ui;
+
+   for( ui = 0; ui < BENCH_FIELDS; pRecordField += s_fields[ ui++ ].uiLen )
+   {
+      ptr = pRecordField;
+      switch( s_fields[ ui ].uiType )
+      {
+         case HB_FT_STRING:
+            ptrEnd = ptr + s_fields[ ui ].uiLen - 1;
+            while( ptrEnd > ptr && *ptrEnd == ' ' )
+               ptrEnd--;
+            ulRealLen = ptrEnd - ptr + ( *ptrEnd == ' ' ? 0 : 1 );
+            if( s_fields[ ui ].uiLen < 256 )
+            {
+               pData[ 0 ] = ( HB_BYTE ) ulRealLen & 0xFF;
+               uiLen = 1;
+            }
+            else
+            {
+               uiLen = leto_n2b( pData + 1, ulRealLen );
+               pData[ 0 ] = ( HB_BYTE ) uiLen & 0xFF;
+               uiLen++;
+            }
+            pData += uiLen;
+            if( ulRealLen > 0 )
+               memcpy( pData, ptr, ulRealLen );
+            pData += ulRealLen;
+            break;
+
+         case HB_FT_LONG:
+            ptrEnd = ptr + s_fields[ ui ].uiLen - 1;
+            while( ptrEnd > ptr && *ptr == ' ' )
+               ptr++;
+            ulRealLen = ptrEnd - ptr + 1;
+            while( ptrEnd > ptr && ( *ptrEnd == '0' || *ptrEnd == '.' ) )
+               ptrEnd--;
+            if( *ptrEnd == '0' || *ptrEnd == '.' )
+               *pData++ = '\0';
+            else
+            {
+               *pData++ = ( HB_BYTE ) ulRealLen & 0xFF;
+               memcpy( pData, ptr, ulRealLen );
+               pData += ulRealLen;
+            }
+            break;
+
+         case HB_FT_DATE:
+            if( *ptr <= ' ' )
+               *pData++ = '\0';
+            else
+            {
+               memcpy( pData, ptr, 8 );
+               pData += 8;
+            }
+            break;
+
+         case HB_FT_LOGICAL:
+            *pData++ = *ptr;
+            break;
+
+         case HB_FT_MEMO:
+            *pData++ = ptr[ s_fields[ ui ].uiLen - 1 ] == ' ' ? '\0' : '1';
+            break;
+
+         default:  /* binary fields */
+            memcpy( pData, ptr, s_fields[ ui ].uiLen );
+            pData += s_fields[ ui ].uiLen;
+            break;
+      }
+   }
+
+   return pData;
+}
+
+int main( int argc, char *argv[] )
+{
+   PLETORECPLAN pPlan;
+   HB_BYTE *    pRecords, * pRec;
+   char *       pOld, * pNew, * pEndOld = NULL, * pEndNew = NULL;
+   HB_USHORT    uiRecLen = 1;
+   HB_U64       ullOld, ullNew, ullStart;
+   int          i, k, r, iLen;
+
+   HB_SYMBOL_UNUSED( argc );
+   HB_SYMBOL_UNUSED( argv );
+
+   LetoInit();
+
+   pPlan = leto_RecPlanNew( BENCH_FIELDS );
+   for( i = 0; i < BENCH_FIELDS; i++ )
+   {
+      uiRecLen += s_fields[ i ].uiLen;
+      leto_RecPlanAdd( pPlan, s_fields[ i ].uiType, s_fields[ i ].uiLen, 0 );
+   }
+
+   /* strings filled 30 - 60 percent, rest blank padded like typical tables */
+   pRecords = ( HB_BYTE * ) hb_xgrab( uiRecLen * BENCH_RECORDS );
+   for( r = 0; r < BENCH_RECORDS; r++ )
+   {
+      pRec = pRecords + r * uiRecLen;
+      *pRec++ = ' ';
+      for( i = 0; i < BENCH_FIELDS; pRec += s_fields[ i++ ].uiLen )
+      {
+         iLen = s_fields[ i ].uiLen;
+         for( k = 0; k < iLen; k++ )
+         {
+            switch( s_fields[ i ].uiType )
+            {
+               case HB_FT_STRING:
+                  pRec[ k ] = ( char ) ( k < iLen * ( 3 + r % 4 ) / 10 ? 'A' + ( k + r ) % 26 : ' ' );
+                  break;
+               case HB_FT_LONG:
+                  pRec[ k ] = ( char ) ( k < iLen / 2 ? ' ' : '1' + ( k + r ) % 9 );
+                  break;
+               case HB_FT_DATE:
+                  pRec[ k ] = ( char ) ( '0' + k );
+                  break;
+               case HB_FT_LOGICAL:
+                  pRec[ k ] = r % 2 ? 'T' : 'F';
+                  break;
+               case HB_FT_MEMO:
+                  pRec[ k ] = ( char ) ( r % 3 ? ' ' : '1' );
+                  break;
+               default:
+                  pRec[ k ] = ( char ) ( k + r );
+            }
+         }
+      }
+   }
+
+   pOld = ( char * ) hb_xgrab( uiRecLen * BENCH_RECORDS * 2 );
+   pNew = ( char * ) hb_xgrab( uiRecLen * BENCH_RECORDS * 2 );
+
+   ullStart = leto_MicroSec();
+   for( i = 0; i < BENCH_LOOPS; i++ )
+   {
+      pEndOld = pOld;
+      for( r = 0; r < BENCH_RECORDS; r++ )
+         pEndOld = encode_old( pRecords + r * uiRecLen, pEndOld );
+   }
+   ullOld = leto_MicroSec() - ullStart;
+
+   ullStart = leto_MicroSec();
+   for( i = 0; i < BENCH_LOOPS; i++ )
+   {
+      pEndNew = pNew;
+      for( r = 0; r < BENCH_RECORDS; r++ )
+         pEndNew = leto_RecPlanEncode( pPlan, pRecords + r * uiRecLen, pEndNew );
+   }
+   ullNew = leto_MicroSec() - ullStart;
+
+   if( pEndOld - pOld != pEndNew - pNew || memcmp( pOld, pNew, pEndOld - pOld ) )
+      printf( "FAILED: encoders differ" _EOL_ );
+   else
+   {
+      printf( "%d skip buffers of %d records with %d fields, %d bytes encoded each" _EOL_,
+              BENCH_LOOPS, BENCH_RECORDS, BENCH_FIELDS, ( int ) ( pEndNew - pNew ) );
+      printf( "type switch per field: %8.1f ns/record" _EOL_,
+              ( double ) ullOld * 1000 / ( ( double ) BENCH_LOOPS * BENCH_RECORDS ) );
+      printf( "encoding plan:         %8.1f ns/record  ( %d ops )" _EOL_,
+              ( double ) ullNew * 1000 / ( ( double ) BENCH_LOOPS * BENCH_RECORDS ), pPlan->uiOps );
+   }
+
+   hb_xfree( pRecords );
+   hb_xfree( pOld );
+   hb_xfree( pNew );
+   leto_RecPlanFree( pPlan );
+   LetoExit( 1 );
+
+   return 0;
+}